@@ -576,6 +576,153 @@ public:
         BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
   }
 
+  /// Send a batch of datagrams to the specified endpoints.
+  /**
+   * This function is used to send several datagrams using as few system
+   * calls as possible. The function call will block until at least one
+   * datagram has been sent successfully or an error occurs.
+   *
+   * @param buffers A sequence of buffers, each of which holds the contents of
+   * a separate datagram.
+   *
+   * @param destinations An array of endpoints, one for each buffer in the
+   * sequence, giving the remote endpoint to which that datagram will be sent.
+   *
+   * @returns The number of datagrams sent. This may be fewer than the number
+   * of buffers, in which case the first datagrams have been sent.
+   *
+   * @throws boost::system::system_error Thrown on failure.
+   *
+   * @note The number of datagrams transferred by a single call is limited by
+   * the implementation. On Linux the datagrams are sent using @c sendmmsg.
+   * Other platforms send them one at a time.
+   */
+  template <typename ConstBufferSequence>
+  std::size_t send_to_batch(const ConstBufferSequence& buffers,
+      const endpoint_type* destinations)
+  {
+    boost::system::error_code ec;
+    std::size_t s = this->get_service().send_to_batch(
+        this->get_implementation(), buffers, destinations, 0, ec);
+    boost::asio::detail::throw_error(ec, "send_to_batch");
+    return s;
+  }
+
+  /// Send a batch of datagrams to the specified endpoints.
+  /**
+   * This function is used to send several datagrams using as few system
+   * calls as possible. The function call will block until at least one
+   * datagram has been sent successfully or an error occurs.
+   *
+   * @param buffers A sequence of buffers, each of which holds the contents of
+   * a separate datagram.
+   *
+   * @param destinations An array of endpoints, one for each buffer in the
+   * sequence, giving the remote endpoint to which that datagram will be sent.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @returns The number of datagrams sent.
+   */
+  template <typename ConstBufferSequence>
+  std::size_t send_to_batch(const ConstBufferSequence& buffers,
+      const endpoint_type* destinations, socket_base::message_flags flags,
+      boost::system::error_code& ec)
+  {
+    return this->get_service().send_to_batch(this->get_implementation(),
+        buffers, destinations, flags, ec);
+  }
+
+  /// Start an asynchronous batch send.
+  /**
+   * This function is used to asynchronously send several datagrams to the
+   * specified remote endpoints. The function call always returns immediately.
+   *
+   * @param buffers A sequence of buffers, each of which holds the contents of
+   * a separate datagram. Although the buffers object may be copied as
+   * necessary, ownership of the underlying memory blocks is retained by the
+   * caller, which must guarantee that they remain valid until the handler is
+   * called.
+   *
+   * @param destinations An array of endpoints, one for each buffer in the
+   * sequence. Ownership of the array is retained by the caller, which must
+   * guarantee that it remains valid until the handler is called.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t messages_transferred        // Number of datagrams sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   */
+  template <typename ConstBufferSequence, typename WriteHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+      void (boost::system::error_code, std::size_t))
+  async_send_to_batch(const ConstBufferSequence& buffers,
+      const endpoint_type* destinations,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WriteHandler.
+    BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+    return this->get_service().async_send_to_batch(
+        this->get_implementation(), buffers, destinations, 0,
+        BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+
+  /// Start an asynchronous batch send.
+  /**
+   * This function is used to asynchronously send several datagrams to the
+   * specified remote endpoints. The function call always returns immediately.
+   *
+   * @param buffers A sequence of buffers, each of which holds the contents of
+   * a separate datagram. Although the buffers object may be copied as
+   * necessary, ownership of the underlying memory blocks is retained by the
+   * caller, which must guarantee that they remain valid until the handler is
+   * called.
+   *
+   * @param destinations An array of endpoints, one for each buffer in the
+   * sequence. Ownership of the array is retained by the caller, which must
+   * guarantee that it remains valid until the handler is called.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t messages_transferred        // Number of datagrams sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   */
+  template <typename ConstBufferSequence, typename WriteHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+      void (boost::system::error_code, std::size_t))
+  async_send_to_batch(const ConstBufferSequence& buffers,
+      const endpoint_type* destinations, socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WriteHandler.
+    BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+    return this->get_service().async_send_to_batch(
+        this->get_implementation(), buffers, destinations, flags,
+        BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+
   /// Receive some data on a connected socket.
   /**
    * This function is used to receive data on the datagram socket. The function
@@ -943,6 +1090,187 @@ public:
         this->get_implementation(), buffers, sender_endpoint, flags,
         BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
   }
+
+  /// Receive a batch of datagrams with the endpoints of their senders.
+  /**
+   * This function is used to receive several datagrams using as few system
+   * calls as possible. The function call will block until at least one
+   * datagram has been received successfully or an error occurs. Datagrams
+   * that are already queued on the socket are then received without
+   * further blocking.
+   *
+   * @param buffers A sequence of buffers, each of which will receive a
+   * separate datagram.
+   *
+   * @param sender_endpoints An array of endpoints, one for each buffer in the
+   * sequence, that will receive the endpoint of the remote sender of the
+   * corresponding datagram.
+   *
+   * @param sizes An array, one element for each buffer in the sequence, that
+   * will receive the size of the corresponding datagram.
+   *
+   * @returns The number of datagrams received. Only the first elements of
+   * each array, up to this number, are updated.
+   *
+   * @throws boost::system::system_error Thrown on failure.
+   *
+   * @note The number of datagrams transferred by a single call is limited by
+   * the implementation. On Linux the datagrams are received using
+   * @c recvmmsg. Other platforms receive them one at a time.
+   */
+  template <typename MutableBufferSequence>
+  std::size_t receive_from_batch(const MutableBufferSequence& buffers,
+      endpoint_type* sender_endpoints, std::size_t* sizes)
+  {
+    boost::system::error_code ec;
+    std::size_t s = this->get_service().receive_from_batch(
+        this->get_implementation(), buffers, sender_endpoints, sizes, 0, ec);
+    boost::asio::detail::throw_error(ec, "receive_from_batch");
+    return s;
+  }
+
+  /// Receive a batch of datagrams with the endpoints of their senders.
+  /**
+   * This function is used to receive several datagrams using as few system
+   * calls as possible. The function call will block until at least one
+   * datagram has been received successfully or an error occurs.
+   *
+   * @param buffers A sequence of buffers, each of which will receive a
+   * separate datagram.
+   *
+   * @param sender_endpoints An array of endpoints, one for each buffer in the
+   * sequence, that will receive the endpoints of the remote senders.
+   *
+   * @param sizes An array, one element for each buffer in the sequence, that
+   * will receive the sizes of the datagrams.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @returns The number of datagrams received.
+   */
+  template <typename MutableBufferSequence>
+  std::size_t receive_from_batch(const MutableBufferSequence& buffers,
+      endpoint_type* sender_endpoints, std::size_t* sizes,
+      socket_base::message_flags flags, boost::system::error_code& ec)
+  {
+    return this->get_service().receive_from_batch(this->get_implementation(),
+        buffers, sender_endpoints, sizes, flags, ec);
+  }
+
+  /// Start an asynchronous batch receive.
+  /**
+   * This function is used to asynchronously receive several datagrams. The
+   * function call always returns immediately.
+   *
+   * @param buffers A sequence of buffers, each of which will receive a
+   * separate datagram. Although the buffers object may be copied as
+   * necessary, ownership of the underlying memory blocks is retained by the
+   * caller, which must guarantee that they remain valid until the handler is
+   * called.
+   *
+   * @param sender_endpoints An array of endpoints, one for each buffer in the
+   * sequence, that will receive the endpoints of the remote senders.
+   * Ownership of the array is retained by the caller, which must guarantee
+   * that it remains valid until the handler is called.
+   *
+   * @param sizes An array, one element for each buffer in the sequence, that
+   * will receive the sizes of the datagrams. Ownership of the array is
+   * retained by the caller, which must guarantee that it remains valid until
+   * the handler is called.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t messages_transferred        // Number of datagrams received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   *
+   * @par Example
+   * To receive up to 32 datagrams into a contiguous block of memory:
+   * @code
+   * char data[32][1500];
+   * std::vector<boost::asio::mutable_buffer> buffers;
+   * for (int i = 0; i < 32; ++i)
+   *   buffers.push_back(boost::asio::buffer(data[i]));
+   * boost::asio::ip::udp::endpoint senders[32];
+   * std::size_t sizes[32];
+   * socket.async_receive_from_batch(buffers, senders, sizes, handler);
+   * @endcode
+   */
+  template <typename MutableBufferSequence, typename ReadHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(ReadHandler,
+      void (boost::system::error_code, std::size_t))
+  async_receive_from_batch(const MutableBufferSequence& buffers,
+      endpoint_type* sender_endpoints, std::size_t* sizes,
+      BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a ReadHandler.
+    BOOST_ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
+
+    return this->get_service().async_receive_from_batch(
+        this->get_implementation(), buffers, sender_endpoints, sizes, 0,
+        BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+  }
+
+  /// Start an asynchronous batch receive.
+  /**
+   * This function is used to asynchronously receive several datagrams. The
+   * function call always returns immediately.
+   *
+   * @param buffers A sequence of buffers, each of which will receive a
+   * separate datagram. Although the buffers object may be copied as
+   * necessary, ownership of the underlying memory blocks is retained by the
+   * caller, which must guarantee that they remain valid until the handler is
+   * called.
+   *
+   * @param sender_endpoints An array of endpoints, one for each buffer in the
+   * sequence, that will receive the endpoints of the remote senders.
+   * Ownership of the array is retained by the caller, which must guarantee
+   * that it remains valid until the handler is called.
+   *
+   * @param sizes An array, one element for each buffer in the sequence, that
+   * will receive the sizes of the datagrams. Ownership of the array is
+   * retained by the caller, which must guarantee that it remains valid until
+   * the handler is called.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t messages_transferred        // Number of datagrams received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   */
+  template <typename MutableBufferSequence, typename ReadHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(ReadHandler,
+      void (boost::system::error_code, std::size_t))
+  async_receive_from_batch(const MutableBufferSequence& buffers,
+      endpoint_type* sender_endpoints, std::size_t* sizes,
+      socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a ReadHandler.
+    BOOST_ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
+
+    return this->get_service().async_receive_from_batch(
+        this->get_implementation(), buffers, sender_endpoints, sizes, flags,
+        BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+  }
 };
 
 } // namespace asio
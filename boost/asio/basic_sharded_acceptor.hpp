@@ -0,0 +1,199 @@
+//
+// basic_sharded_acceptor.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_BASIC_SHARDED_ACCEPTOR_HPP
+#define BOOST_ASIO_BASIC_SHARDED_ACCEPTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/detail/socket_types.hpp>
+
+#if defined(SO_REUSEPORT) || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <vector>
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+#include <boost/asio/detail/throw_error.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_service_pool.hpp>
+#include <boost/asio/socket_acceptor_service.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+/// Provides one listening socket for each io_service in an io_service_pool.
+/**
+ * The basic_sharded_acceptor class template opens, for each shard of an
+ * io_service_pool, an acceptor that is bound to the same endpoint using the
+ * @c SO_REUSEPORT socket option. The kernel distributes incoming connections
+ * between the acceptors, so each connection is accepted, and its handlers are
+ * executed, by a single shard for its entire lifetime.
+ *
+ * If the endpoint has a port number of zero, the port chosen for the first
+ * acceptor is used for the others.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe. Each acceptor should only be used from the
+ * thread that runs its shard.
+ *
+ * @note Only available on platforms that define @c SO_REUSEPORT.
+ */
+template <typename Protocol,
+    typename SocketAcceptorService = socket_acceptor_service<Protocol> >
+class basic_sharded_acceptor
+  : private noncopyable
+{
+public:
+  /// The type of the acceptor used for each shard.
+  typedef basic_socket_acceptor<Protocol, SocketAcceptorService> acceptor_type;
+
+  /// The protocol type.
+  typedef Protocol protocol_type;
+
+  /// The endpoint type.
+  typedef typename Protocol::endpoint endpoint_type;
+
+  /// Construct a sharded acceptor listening on the specified endpoint.
+  /**
+   * This constructor creates one acceptor on each io_service in the pool, and
+   * for each of them sets the @c reuse_address and @c reuse_port options,
+   * binds it to the endpoint and starts listening.
+   *
+   * @param pool The io_service_pool whose io_service objects will be used to
+   * dispatch handlers for the acceptors.
+   *
+   * @param endpoint An endpoint on the local machine on which the acceptors
+   * will listen for new connections.
+   *
+   * @param listen_backlog The maximum length of the queue of pending
+   * connections for each acceptor.
+   *
+   * @throws boost::system::system_error Thrown on failure.
+   */
+  basic_sharded_acceptor(io_service_pool& pool,
+      const endpoint_type& endpoint,
+      int listen_backlog = socket_base::max_connections)
+  {
+    acceptors_.reserve(pool.size());
+    try
+    {
+      endpoint_type bind_endpoint = endpoint;
+      for (std::size_t i = 0; i < pool.size(); ++i)
+      {
+        acceptors_.push_back(new acceptor_type(pool.get_io_service(i)));
+        acceptor_type& a = *acceptors_.back();
+        a.open(bind_endpoint.protocol());
+        a.set_option(socket_base::reuse_address(true));
+        a.set_option(socket_base::reuse_port(true));
+        a.bind(bind_endpoint);
+        a.listen(listen_backlog);
+        if (i == 0)
+          bind_endpoint = a.local_endpoint();
+      }
+    }
+    catch (...)
+    {
+      destroy();
+      throw;
+    }
+  }
+
+  /// Destroys the acceptors.
+  ~basic_sharded_acceptor()
+  {
+    destroy();
+  }
+
+  /// Get the number of acceptors.
+  std::size_t size() const
+  {
+    return acceptors_.size();
+  }
+
+  /// Get the acceptor for the shard at the given index.
+  /**
+   * The acceptor uses the io_service returned by
+   * <tt>pool.get_io_service(index)</tt>.
+   */
+  acceptor_type& acceptor(std::size_t index)
+  {
+    return *acceptors_[index];
+  }
+
+  /// Get the local endpoint on which the acceptors are listening.
+  /**
+   * @throws boost::system::system_error Thrown on failure.
+   */
+  endpoint_type local_endpoint() const
+  {
+    return acceptors_[0]->local_endpoint();
+  }
+
+  /// Close all of the acceptors.
+  /**
+   * Any asynchronous accept operations will be cancelled. This function must
+   * not be called while the pool is running, unless the pool has been
+   * stopped.
+   *
+   * @throws boost::system::system_error Thrown on failure.
+   */
+  void close()
+  {
+    boost::system::error_code ec;
+    close(ec);
+    boost::asio::detail::throw_error(ec, "close");
+  }
+
+  /// Close all of the acceptors.
+  /**
+   * @param ec Set to indicate what error occurred, if any. If more than one
+   * acceptor fails to close, the first error is reported.
+   */
+  boost::system::error_code close(boost::system::error_code& ec)
+  {
+    ec = boost::system::error_code();
+    for (std::size_t i = 0; i < acceptors_.size(); ++i)
+    {
+      boost::system::error_code close_ec;
+      acceptors_[i]->close(close_ec);
+      if (close_ec && !ec)
+        ec = close_ec;
+    }
+    return ec;
+  }
+
+private:
+  // Delete the acceptors.
+  void destroy()
+  {
+    for (std::size_t i = 0; i < acceptors_.size(); ++i)
+      delete acceptors_[i];
+    acceptors_.clear();
+  }
+
+  // The acceptors, one per shard.
+  std::vector<acceptor_type*> acceptors_;
+};
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(SO_REUSEPORT) || defined(GENERATING_DOCUMENTATION)
+
+#endif // BOOST_ASIO_BASIC_SHARDED_ACCEPTOR_HPP
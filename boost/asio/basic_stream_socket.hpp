@@ -19,6 +19,7 @@
 #include <cstddef>
 #include <boost/asio/async_result.hpp>
 #include <boost/asio/basic_socket.hpp>
+#include <boost/asio/detail/cstdint.hpp>
 #include <boost/asio/detail/handler_type_requirements.hpp>
 #include <boost/asio/detail/throw_error.hpp>
 #include <boost/asio/error.hpp>
@@ -413,6 +414,126 @@ public:
         BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
   }
 
+#if defined(BOOST_ASIO_HAS_SENDFILE) || defined(GENERATING_DOCUMENTATION)
+  /// Send a region of a file on the socket.
+  /**
+   * This function is used to send part of a file on the stream socket without
+   * copying the data through user-space buffers. The function call will block
+   * until all of the requested bytes have been sent, the end of the file is
+   * reached, or an error occurs.
+   *
+   * @param file The native descriptor of a file opened for reading. The file
+   * must support mmap-like operations, i.e. it may not be a socket.
+   *
+   * @param offset The position in the file at which to start reading.
+   *
+   * @param count The number of bytes to send.
+   *
+   * @returns The number of bytes sent.
+   *
+   * @throws boost::system::system_error Thrown on failure. An error code of
+   * boost::asio::error::eof indicates that the file ended before @c count
+   * bytes were sent.
+   *
+   * @note This function is implemented using @c sendfile() and is available
+   * on Linux only. Writing to a socket that has been shut down by the peer
+   * may raise @c SIGPIPE, which the application should ignore.
+   */
+  std::size_t send_file(int file, uint64_t offset, std::size_t count)
+  {
+    boost::system::error_code ec;
+    std::size_t s = this->get_service().send_file(
+        this->get_implementation(), file, offset, count, ec);
+    boost::asio::detail::throw_error(ec, "send_file");
+    return s;
+  }
+
+  /// Send a region of a file on the socket.
+  /**
+   * This function is used to send part of a file on the stream socket without
+   * copying the data through user-space buffers. The function call will block
+   * until all of the requested bytes have been sent, the end of the file is
+   * reached, or an error occurs.
+   *
+   * @param file The native descriptor of a file opened for reading. The file
+   * must support mmap-like operations, i.e. it may not be a socket.
+   *
+   * @param offset The position in the file at which to start reading.
+   *
+   * @param count The number of bytes to send.
+   *
+   * @param ec Set to indicate what error occurred, if any. An error code of
+   * boost::asio::error::eof indicates that the file ended before @c count
+   * bytes were sent.
+   *
+   * @returns The number of bytes sent.
+   *
+   * @note This function is implemented using @c sendfile() and is available
+   * on Linux only. Writing to a socket that has been shut down by the peer
+   * may raise @c SIGPIPE, which the application should ignore.
+   */
+  std::size_t send_file(int file, uint64_t offset, std::size_t count,
+      boost::system::error_code& ec)
+  {
+    return this->get_service().send_file(
+        this->get_implementation(), file, offset, count, ec);
+  }
+
+  /// Start an asynchronous send of a region of a file.
+  /**
+   * This function is used to asynchronously send part of a file on the stream
+   * socket without copying the data through user-space buffers. The function
+   * call always returns immediately. The operation continues after partial
+   * writes until all of the requested bytes have been sent, the end of the
+   * file is reached, or an error occurs.
+   *
+   * @param file The native descriptor of a file opened for reading. The file
+   * must support mmap-like operations, i.e. it may not be a socket. Ownership
+   * of the descriptor is retained by the caller, which must guarantee that it
+   * remains open until the handler is called.
+   *
+   * @param offset The position in the file at which to start reading.
+   *
+   * @param count The number of bytes to send.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const boost::system::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred           // Number of bytes sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. Invocation
+   * of the handler will be performed in a manner equivalent to using
+   * boost::asio::io_service::post().
+   *
+   * @note This function is implemented using @c sendfile() and is available
+   * on Linux only. Writing to a socket that has been shut down by the peer
+   * may raise @c SIGPIPE, which the application should ignore.
+   *
+   * @par Example
+   * @code
+   * int fd = ::open("index.html", O_RDONLY);
+   * socket.async_send_file(fd, 0, file_size, handler);
+   * @endcode
+   */
+  template <typename WriteHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+      void (boost::system::error_code, std::size_t))
+  async_send_file(int file, uint64_t offset, std::size_t count,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    // If you get an error on the following line it means that your handler does
+    // not meet the documented type requirements for a WriteHandler.
+    BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+    return this->get_service().async_send_file(
+        this->get_implementation(), file, offset, count,
+        BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+  }
+#endif // defined(BOOST_ASIO_HAS_SENDFILE) || defined(GENERATING_DOCUMENTATION)
+
   /// Receive some data on the socket.
   /**
    * This function is used to receive data on the stream socket. The function
@@ -0,0 +1,78 @@
+//
+// busy_poll.hpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_BUSY_POLL_HPP
+#define BOOST_ASIO_BUSY_POLL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+class io_service;
+
+/// Make the threads running an io_service poll for work before blocking.
+/**
+ * By default, a thread that runs an io_service and finds no ready handlers
+ * blocks in the reactor until an event arrives or another thread posts work.
+ * The wakeup adds latency to the first handler that becomes ready. When busy
+ * polling is enabled, the thread that runs the reactor first spins for up to
+ * @c spin_usec microseconds, repeatedly polling the reactor without blocking
+ * (for example, calling @c epoll_wait with a zero timeout) and checking for
+ * posted handlers. It blocks only if no work arrives within that period.
+ *
+ * Busy polling trades CPU time for latency: a spinning thread consumes a
+ * whole processor while the io_service is idle. It is only worthwhile when
+ * each thread that runs the io_service has a processor of its own.
+ *
+ * @param ios The io_service to configure.
+ *
+ * @param spin_usec The maximum time to spin before blocking, in microseconds.
+ * A value of zero disables busy polling, which is the default.
+ *
+ * @param adaptive If true, the spin period adapts to the traffic. Each spin
+ * that ends without finding work halves the period used for the next one, and
+ * each time the thread blocks but is woken within @c spin_usec the period is
+ * doubled, up to the maximum of @c spin_usec. A mostly idle io_service thus
+ * stops burning CPU, while one with steady traffic keeps spinning. If false,
+ * the thread always spins for the full period.
+ *
+ * @note Busy polling is implemented only by the reactor-based io_service.
+ * With the I/O completion port implementation on Windows, this function has
+ * no effect.
+ *
+ * @par Example
+ * @code
+ * boost::asio::io_service io_service(1);
+ * boost::asio::set_busy_poll(io_service, 50);
+ * ...
+ * io_service.run();
+ * @endcode
+ */
+BOOST_ASIO_DECL void set_busy_poll(io_service& ios,
+    std::size_t spin_usec, bool adaptive = true);
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#if defined(BOOST_ASIO_HEADER_ONLY)
+# include <boost/asio/impl/busy_poll.ipp>
+#endif // defined(BOOST_ASIO_HEADER_ONLY)
+
+#endif // BOOST_ASIO_BUSY_POLL_HPP
@@ -355,6 +355,34 @@ public:
     return init.result.get();
   }
 
+  /// Send a batch of datagrams to the specified endpoints.
+  template <typename ConstBufferSequence>
+  std::size_t send_to_batch(implementation_type& impl,
+      const ConstBufferSequence& buffers, const endpoint_type* destinations,
+      socket_base::message_flags flags, boost::system::error_code& ec)
+  {
+    return service_impl_.send_to_batch(impl, buffers, destinations, flags, ec);
+  }
+
+  /// Start an asynchronous batch send.
+  template <typename ConstBufferSequence, typename WriteHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+      void (boost::system::error_code, std::size_t))
+  async_send_to_batch(implementation_type& impl,
+      const ConstBufferSequence& buffers, const endpoint_type* destinations,
+      socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    detail::async_result_init<
+      WriteHandler, void (boost::system::error_code, std::size_t)> init(
+        BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+
+    service_impl_.async_send_to_batch(impl, buffers,
+        destinations, flags, init.handler);
+
+    return init.result.get();
+  }
+
   /// Receive some data from the peer.
   template <typename MutableBufferSequence>
   std::size_t receive(implementation_type& impl,
@@ -411,6 +439,37 @@ public:
     return init.result.get();
   }
 
+  /// Receive a batch of datagrams with the endpoints of their senders.
+  template <typename MutableBufferSequence>
+  std::size_t receive_from_batch(implementation_type& impl,
+      const MutableBufferSequence& buffers, endpoint_type* sender_endpoints,
+      std::size_t* sizes, socket_base::message_flags flags,
+      boost::system::error_code& ec)
+  {
+    return service_impl_.receive_from_batch(impl, buffers,
+        sender_endpoints, sizes, flags, ec);
+  }
+
+  /// Start an asynchronous batch receive that will get the endpoints of the
+  /// senders.
+  template <typename MutableBufferSequence, typename ReadHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(ReadHandler,
+      void (boost::system::error_code, std::size_t))
+  async_receive_from_batch(implementation_type& impl,
+      const MutableBufferSequence& buffers, endpoint_type* sender_endpoints,
+      std::size_t* sizes, socket_base::message_flags flags,
+      BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
+  {
+    detail::async_result_init<
+      ReadHandler, void (boost::system::error_code, std::size_t)> init(
+        BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+
+    service_impl_.async_receive_from_batch(impl, buffers,
+        sender_endpoints, sizes, flags, init.handler);
+
+    return init.result.get();
+  }
+
 private:
   // Destroy all user-defined handler objects owned by the service.
   void shutdown_service()
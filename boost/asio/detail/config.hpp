@@ -426,7 +426,16 @@
 # endif // defined(BOOST_ASIO_WINDOWS) || defined(__CYGWIN__)
 #endif // !defined(BOOST_ASIO_HAS_IOCP)
 
-// Linux: epoll, eventfd and timerfd.
+// Runtime metrics. Only collected by the reactor-based io_service.
+#if !defined(BOOST_ASIO_HAS_METRICS)
+# if defined(BOOST_ASIO_ENABLE_METRICS)
+#  if !defined(BOOST_ASIO_HAS_IOCP)
+#   define BOOST_ASIO_HAS_METRICS 1
+#  endif // !defined(BOOST_ASIO_HAS_IOCP)
+# endif // defined(BOOST_ASIO_ENABLE_METRICS)
+#endif // !defined(BOOST_ASIO_HAS_METRICS)
+
+// Linux: epoll, eventfd, timerfd, recvmmsg/sendmmsg and io_uring.
 #if defined(__linux__)
 # include <linux/version.h>
 # if !defined(BOOST_ASIO_HAS_EPOLL)
@@ -450,6 +459,38 @@
 #   endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 8)
 #  endif // defined(BOOST_ASIO_HAS_EPOLL)
 # endif // !defined(BOOST_ASIO_HAS_TIMERFD)
+# if !defined(BOOST_ASIO_HAS_MMSG)
+#  if !defined(BOOST_ASIO_DISABLE_MMSG)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(3,0,0)
+#    if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14)
+#     define BOOST_ASIO_HAS_MMSG 1
+#    endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14)
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(3,0,0)
+#  endif // !defined(BOOST_ASIO_DISABLE_MMSG)
+# endif // !defined(BOOST_ASIO_HAS_MMSG)
+# if !defined(BOOST_ASIO_HAS_SENDFILE)
+#  if !defined(BOOST_ASIO_DISABLE_SENDFILE)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,33)
+#    define BOOST_ASIO_HAS_SENDFILE 1
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,33)
+#  endif // !defined(BOOST_ASIO_DISABLE_SENDFILE)
+# endif // !defined(BOOST_ASIO_HAS_SENDFILE)
+# if !defined(BOOST_ASIO_HAS_SPLICE)
+#  if !defined(BOOST_ASIO_DISABLE_SPLICE)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,17)
+#    if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 5)
+#     define BOOST_ASIO_HAS_SPLICE 1
+#    endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 5)
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,17)
+#  endif // !defined(BOOST_ASIO_DISABLE_SPLICE)
+# endif // !defined(BOOST_ASIO_HAS_SPLICE)
+# if !defined(BOOST_ASIO_HAS_IO_URING)
+#  if defined(BOOST_ASIO_ENABLE_IO_URING)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(5,4,0)
+#    define BOOST_ASIO_HAS_IO_URING 1
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(5,4,0)
+#  endif // defined(BOOST_ASIO_ENABLE_IO_URING)
+# endif // !defined(BOOST_ASIO_HAS_IO_URING)
 #endif // defined(__linux__)
 
 // Mac OS X, FreeBSD, NetBSD, OpenBSD: kqueue.
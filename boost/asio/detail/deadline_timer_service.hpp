@@ -26,6 +26,7 @@
 #include <boost/asio/detail/socket_ops.hpp>
 #include <boost/asio/detail/socket_types.hpp>
 #include <boost/asio/detail/timer_queue.hpp>
+#include <boost/asio/detail/timer_queue_config.hpp>
 #include <boost/asio/detail/timer_scheduler.hpp>
 #include <boost/asio/detail/wait_handler.hpp>
 #include <boost/asio/detail/wait_op.hpp>
@@ -58,15 +59,26 @@ public:
 
   // Constructor.
   deadline_timer_service(boost::asio::io_service& io_service)
-    : scheduler_(boost::asio::use_service<timer_scheduler>(io_service))
+    : timer_queue_(boost::asio::use_service<
+        timer_queue_config>(io_service).wheel_resolution()),
+      scheduler_(boost::asio::use_service<timer_scheduler>(io_service))
+#if defined(BOOST_ASIO_HAS_METRICS)
+      , io_service_impl_(boost::asio::use_service<io_service_impl>(io_service))
+#endif // defined(BOOST_ASIO_HAS_METRICS)
   {
     scheduler_.init_task();
     scheduler_.add_timer_queue(timer_queue_);
+#if defined(BOOST_ASIO_HAS_METRICS)
+    io_service_impl_.register_timer_queue(timer_queue_);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
   }
 
   // Destructor.
   ~deadline_timer_service()
   {
+#if defined(BOOST_ASIO_HAS_METRICS)
+    io_service_impl_.unregister_timer_queue(timer_queue_);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
     scheduler_.remove_timer_queue(timer_queue_);
   }
 
@@ -206,6 +218,11 @@ private:
 
   // The object that schedules and executes timers. Usually a reactor.
   timer_scheduler& scheduler_;
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // The io_service that reports the number of timers in the queue.
+  io_service_impl& io_service_impl_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 } // namespace detail
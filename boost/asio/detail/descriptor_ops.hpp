@@ -85,6 +85,20 @@ BOOST_ASIO_DECL bool non_blocking_write(int d,
     const buf* bufs, std::size_t count,
     boost::system::error_code& ec, std::size_t& bytes_transferred);
 
+#if defined(BOOST_ASIO_HAS_SPLICE)
+
+BOOST_ASIO_DECL signed_size_type splice(int in, int out,
+    std::size_t count, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL std::size_t sync_splice(int in, int out,
+    std::size_t count, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL bool non_blocking_splice(int in, int out,
+    std::size_t& remaining, boost::system::error_code& ec,
+    std::size_t& bytes_transferred);
+
+#endif // defined(BOOST_ASIO_HAS_SPLICE)
+
 BOOST_ASIO_DECL int ioctl(int d, state_type& state, long cmd,
     ioctl_arg_type* arg, boost::system::error_code& ec);
 
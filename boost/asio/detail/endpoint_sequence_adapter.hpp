@@ -0,0 +1,119 @@
+//
+// detail/endpoint_sequence_adapter.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_ENDPOINT_SEQUENCE_ADAPTER_HPP
+#define BOOST_ASIO_DETAIL_ENDPOINT_SEQUENCE_ADAPTER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <boost/asio/detail/socket_types.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// Helper class to translate an array of endpoints, one per message, into the
+// native address representation used by the batched receive functions.
+template <typename Endpoint>
+class endpoint_sequence_adapter
+{
+public:
+  endpoint_sequence_adapter(Endpoint* endpoints, std::size_t count)
+    : endpoints_(endpoints),
+      count_(count < static_cast<std::size_t>(max_mmsg_batch)
+          ? count : max_mmsg_batch)
+  {
+    for (std::size_t i = 0; i < count_; ++i)
+    {
+      addrs_[i] = endpoints_[i].data();
+      addrlens_[i] = endpoints_[i].capacity();
+    }
+  }
+
+  socket_addr_type* const* addrs() const
+  {
+    return addrs_;
+  }
+
+  std::size_t* addrlens()
+  {
+    return addrlens_;
+  }
+
+  std::size_t count() const
+  {
+    return count_;
+  }
+
+  // Update the sizes of the first n endpoints from the received addresses.
+  void resize(std::size_t n)
+  {
+    for (std::size_t i = 0; i < n && i < count_; ++i)
+      endpoints_[i].resize(addrlens_[i]);
+  }
+
+private:
+  Endpoint* endpoints_;
+  std::size_t count_;
+  socket_addr_type* addrs_[max_mmsg_batch];
+  std::size_t addrlens_[max_mmsg_batch];
+};
+
+// Specialisation for the destination endpoints used by the batched send
+// functions.
+template <typename Endpoint>
+class endpoint_sequence_adapter<const Endpoint>
+{
+public:
+  endpoint_sequence_adapter(const Endpoint* endpoints, std::size_t count)
+    : count_(count < static_cast<std::size_t>(max_mmsg_batch)
+          ? count : max_mmsg_batch)
+  {
+    for (std::size_t i = 0; i < count_; ++i)
+    {
+      addrs_[i] = endpoints[i].data();
+      addrlens_[i] = endpoints[i].size();
+    }
+  }
+
+  const socket_addr_type* const* addrs() const
+  {
+    return addrs_;
+  }
+
+  const std::size_t* addrlens() const
+  {
+    return addrlens_;
+  }
+
+  std::size_t count() const
+  {
+    return count_;
+  }
+
+private:
+  std::size_t count_;
+  const socket_addr_type* addrs_[max_mmsg_batch];
+  std::size_t addrlens_[max_mmsg_batch];
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_ENDPOINT_SEQUENCE_ADAPTER_HPP
@@ -0,0 +1,73 @@
+//
+// detail/handler_memory_stats.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_HANDLER_MEMORY_STATS_HPP
+#define BOOST_ASIO_DETAIL_HANDLER_MEMORY_STATS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
+#include <boost/asio/detail/atomic_count.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// Process-wide counters for the default handler allocation hooks.
+class handler_memory_stats
+  : private noncopyable
+{
+public:
+  handler_memory_stats()
+    : allocations(0),
+      cache_hits(0),
+      deallocations(0),
+      cache_returns(0),
+      oversized(0)
+  {
+  }
+
+  static handler_memory_stats& instance()
+  {
+    static handler_memory_stats stats;
+    return stats;
+  }
+
+  atomic_count allocations;
+  atomic_count cache_hits;
+  atomic_count deallocations;
+  atomic_count cache_returns;
+  atomic_count oversized;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+# define BOOST_ASIO_HANDLER_MEMORY_STAT(counter) \
+  ++boost::asio::detail::handler_memory_stats::instance().counter
+
+#else // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
+# define BOOST_ASIO_HANDLER_MEMORY_STAT(counter) (void)0
+
+#endif // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
+#endif // BOOST_ASIO_DETAIL_HANDLER_MEMORY_STATS_HPP
@@ -320,6 +320,89 @@ bool non_blocking_write(int d, const buf* bufs, std::size_t count,
   }
 }
 
+#if defined(BOOST_ASIO_HAS_SPLICE)
+
+signed_size_type splice(int in, int out,
+    std::size_t count, boost::system::error_code& ec)
+{
+  if (in == -1 || out == -1)
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return -1;
+  }
+
+  errno = 0;
+  signed_size_type result = error_wrapper(::splice(in, 0, out, 0,
+        count, SPLICE_F_MOVE | SPLICE_F_NONBLOCK), ec);
+  if (result >= 0)
+    ec = boost::system::error_code();
+  return result;
+}
+
+std::size_t sync_splice(int in, int out,
+    std::size_t count, boost::system::error_code& ec)
+{
+  std::size_t total_transferred = 0;
+  while (!descriptor_ops::non_blocking_splice(
+        in, out, count, ec, total_transferred))
+  {
+    // Wait for the source to become readable if it has no data, otherwise for
+    // the sink to become writable.
+    if (descriptor_ops::poll_read(in, user_set_non_blocking, ec) == 0)
+    {
+      if (descriptor_ops::poll_read(in, 0, ec) < 0)
+        break;
+    }
+    else if (descriptor_ops::poll_write(out, 0, ec) < 0)
+      break;
+  }
+
+  return total_transferred;
+}
+
+bool non_blocking_splice(int in, int out,
+    std::size_t& remaining, boost::system::error_code& ec,
+    std::size_t& bytes_transferred)
+{
+  while (remaining > 0)
+  {
+    // Move as much data as both descriptors allow.
+    signed_size_type bytes = descriptor_ops::splice(in, out, remaining, ec);
+
+    // Continue with the rest of the data after a partial transfer.
+    if (bytes > 0)
+    {
+      bytes_transferred += bytes;
+      remaining -= bytes;
+      continue;
+    }
+
+    // Check for end of stream.
+    if (bytes == 0)
+    {
+      ec = boost::asio::error::eof;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation failed.
+    return true;
+  }
+
+  ec = boost::system::error_code();
+  return true;
+}
+
+#endif // defined(BOOST_ASIO_HAS_SPLICE)
+
 int ioctl(int d, state_type& state, long cmd,
     ioctl_arg_type* arg, boost::system::error_code& ec)
 {
@@ -0,0 +1,871 @@
+//
+// detail/impl/io_uring_reactor.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_IMPL_IO_URING_REACTOR_IPP
+#define BOOST_ASIO_DETAIL_IMPL_IO_URING_REACTOR_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_IO_URING)
+
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <boost/asio/detail/io_uring_reactor.hpp>
+#include <boost/asio/detail/throw_error.hpp>
+#include <boost/asio/error.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+io_uring_reactor::io_uring_reactor(boost::asio::io_service& io_service)
+  : boost::asio::detail::service_base<io_uring_reactor>(io_service),
+    io_service_(use_service<io_service_impl>(io_service)),
+    mutex_(),
+    interrupter_(),
+    ring_fd_(-1),
+    sq_ring_ptr_(0),
+    cq_ring_ptr_(0),
+    sqes_(0),
+    blocked_(false),
+    interrupter_armed_(false),
+    removals_pending_(false),
+    polls_pending_(false),
+    update_timeout_in_place_(false),
+    batch_(0),
+    shutdown_(false)
+{
+  do_ring_create();
+
+  // Watch the interrupter's descriptor.
+  mutex::scoped_lock lock(mutex_);
+  arm_interrupter();
+}
+
+io_uring_reactor::~io_uring_reactor()
+{
+  do_ring_destroy();
+}
+
+void io_uring_reactor::shutdown_service()
+{
+  mutex::scoped_lock lock(mutex_);
+  shutdown_ = true;
+  lock.unlock();
+
+  op_queue<operation> ops;
+
+  while (descriptor_state* state = registered_descriptors_.first())
+  {
+    for (int i = 0; i < max_ops; ++i)
+      ops.push(state->op_queue_[i]);
+    state->shutdown_ = true;
+    registered_descriptors_.free(state);
+  }
+
+  timer_queues_.get_all_timers(ops);
+
+  io_service_.abandon_operations(ops);
+}
+
+void io_uring_reactor::fork_service(
+    boost::asio::io_service::fork_event fork_ev)
+{
+  if (fork_ev == boost::asio::io_service::fork_child)
+  {
+    // The ring is shared with the parent, so it cannot be used by the child.
+    do_ring_destroy();
+    do_ring_create();
+
+    interrupter_.recreate();
+
+    mutex::scoped_lock lock(mutex_);
+    interrupter_armed_ = false;
+    removals_pending_ = false;
+    polls_pending_ = false;
+    arm_interrupter();
+    lock.unlock();
+
+    // Re-arm polls for all descriptors with pending operations.
+    mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+    descriptor_state* state = registered_descriptors_.first();
+    while (state)
+    {
+      descriptor_state* next = state->next_;
+      mutex::scoped_lock descriptor_lock(state->mutex_);
+      state->polls_armed_ = 0;
+      state->polls_pending_ = 0;
+      if (state->shutdown_)
+      {
+        // A deregistered descriptor was only waiting for the completions of
+        // polls on the old ring, which will never arrive.
+        descriptor_lock.unlock();
+        registered_descriptors_.free(state);
+      }
+      else
+      {
+        for (int j = 0; j < max_ops; ++j)
+          if (!state->op_queue_[j].empty())
+            arm_poll(state, j);
+      }
+      state = next;
+    }
+  }
+}
+
+void io_uring_reactor::init_task()
+{
+  io_service_.init_task();
+}
+
+int io_uring_reactor::register_descriptor(socket_type descriptor,
+    io_uring_reactor::per_descriptor_data& descriptor_data)
+{
+  descriptor_data = allocate_descriptor_state();
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  descriptor_data->reactor_ = this;
+  descriptor_data->descriptor_ = descriptor;
+  descriptor_data->shutdown_ = false;
+  descriptor_data->polls_armed_ = 0;
+  descriptor_data->polls_pending_ = 0;
+
+  // Polls are only requested once there is an operation waiting on the
+  // descriptor, so registration does not need a system call.
+  return 0;
+}
+
+int io_uring_reactor::register_internal_descriptor(
+    int op_type, socket_type descriptor,
+    io_uring_reactor::per_descriptor_data& descriptor_data, reactor_op* op)
+{
+  descriptor_data = allocate_descriptor_state();
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  descriptor_data->reactor_ = this;
+  descriptor_data->descriptor_ = descriptor;
+  descriptor_data->shutdown_ = false;
+  descriptor_data->polls_armed_ = 0;
+  descriptor_data->polls_pending_ = 0;
+  descriptor_data->op_queue_[op_type].push(op);
+  arm_poll(descriptor_data, op_type);
+
+  return 0;
+}
+
+void io_uring_reactor::move_descriptor(socket_type,
+    io_uring_reactor::per_descriptor_data& target_descriptor_data,
+    io_uring_reactor::per_descriptor_data& source_descriptor_data)
+{
+  target_descriptor_data = source_descriptor_data;
+  source_descriptor_data = 0;
+}
+
+void io_uring_reactor::start_op(int op_type, socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data, reactor_op* op,
+    bool is_continuation, bool allow_speculative)
+{
+  if (!descriptor_data)
+  {
+    op->ec_ = boost::asio::error::bad_descriptor;
+    post_immediate_completion(op, is_continuation);
+    return;
+  }
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  if (descriptor_data->shutdown_)
+  {
+    post_immediate_completion(op, is_continuation);
+    return;
+  }
+
+  if (descriptor_data->op_queue_[op_type].empty())
+  {
+    if (allow_speculative
+        && (op_type != read_op
+          || descriptor_data->op_queue_[except_op].empty()))
+    {
+      if (op->perform())
+      {
+        descriptor_lock.unlock();
+        io_service_.post_immediate_completion(op, is_continuation);
+        return;
+      }
+    }
+
+    arm_poll(descriptor_data, op_type);
+  }
+
+  descriptor_data->op_queue_[op_type].push(op);
+  io_service_.work_started();
+}
+
+void io_uring_reactor::cancel_ops(socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  op_queue<operation> ops;
+  for (int i = 0; i < max_ops; ++i)
+  {
+    while (reactor_op* op = descriptor_data->op_queue_[i].front())
+    {
+      op->ec_ = boost::asio::error::operation_aborted;
+      descriptor_data->op_queue_[i].pop();
+      ops.push(op);
+    }
+  }
+
+  descriptor_lock.unlock();
+
+  io_service_.post_deferred_completions(ops);
+}
+
+void io_uring_reactor::deregister_descriptor(socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data, bool)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  if (!descriptor_data->shutdown_)
+  {
+    op_queue<operation> ops;
+    for (int i = 0; i < max_ops; ++i)
+    {
+      while (reactor_op* op = descriptor_data->op_queue_[i].front())
+      {
+        op->ec_ = boost::asio::error::operation_aborted;
+        descriptor_data->op_queue_[i].pop();
+        ops.push(op);
+      }
+    }
+
+    descriptor_data->descriptor_ = -1;
+    descriptor_data->shutdown_ = true;
+
+    // A poll request holds a reference to the file, so any that are in flight
+    // must be removed even if the descriptor is about to be closed. The state
+    // is freed by run() once the last of them has completed.
+    bool in_flight = (descriptor_data->polls_armed_ != 0);
+    if (in_flight)
+      disarm_polls(descriptor_data);
+
+    descriptor_lock.unlock();
+
+    if (!in_flight)
+      free_descriptor_state(descriptor_data);
+    descriptor_data = 0;
+
+    io_service_.post_deferred_completions(ops);
+  }
+}
+
+void io_uring_reactor::deregister_internal_descriptor(socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  if (!descriptor_data->shutdown_)
+  {
+    op_queue<operation> ops;
+    for (int i = 0; i < max_ops; ++i)
+      ops.push(descriptor_data->op_queue_[i]);
+
+    descriptor_data->descriptor_ = -1;
+    descriptor_data->shutdown_ = true;
+
+    bool in_flight = (descriptor_data->polls_armed_ != 0);
+    if (in_flight)
+      disarm_polls(descriptor_data);
+
+    descriptor_lock.unlock();
+
+    if (!in_flight)
+      free_descriptor_state(descriptor_data);
+    descriptor_data = 0;
+  }
+}
+
+void io_uring_reactor::run(bool block, op_queue<operation>& ops)
+{
+  // This code relies on the fact that the task_io_service queues the reactor
+  // task behind all descriptor operations generated by this function. This
+  // means, that by the time we reach this point, any previously returned
+  // descriptor operations have already been dequeued. Therefore it is now safe
+  // for us to reuse and return them for the task_io_service to queue again.
+
+  mutex::scoped_lock lock(mutex_);
+
+  // Without a poll request for the interrupter, a blocked thread could not be
+  // woken. If one cannot be queued, poll for completions without blocking so
+  // that the request is retried once they have been reaped.
+  if (!interrupter_armed_)
+    arm_interrupter();
+  if (!interrupter_armed_)
+    block = false;
+
+  // Likewise, requests that did not fit in the submission ring are retried as
+  // soon as completions have been reaped.
+  if (removals_pending_ || polls_pending_)
+    block = false;
+
+  // Bound the wait by the earliest timer. The timeout request completes as
+  // soon as any other completion is posted, so that stale timeouts do not
+  // accumulate in the kernel.
+  unsigned min_complete = 0;
+  if (block)
+  {
+    long usec = timer_queues_.wait_duration_usec(5 * 60 * 1000 * 1000);
+    if (usec > 0)
+    {
+      if (io_uring_sqe* sqe = get_sqe())
+      {
+        timeout_.tv_sec = usec / 1000000;
+        timeout_.tv_nsec = (usec % 1000000) * 1000;
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<unsigned long>(&timeout_);
+        sqe->len = 1;
+        sqe->off = 1;
+        sqe->user_data = reinterpret_cast<unsigned long>(&timeout_);
+        commit_sqe();
+        min_complete = 1;
+      }
+    }
+  }
+
+  // Submit all poll requests queued since the last call and wait for
+  // completions with a single system call.
+  unsigned to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  blocked_ = (min_complete != 0);
+  lock.unlock();
+
+  // The kernel refuses new entries while completions that did not fit in the
+  // completion ring are waiting to be reaped (EBUSY), or when it is short of
+  // resources (EAGAIN). The entries then stay in the submission ring, and are
+  // submitted by the next run() once the completions below have been reaped.
+  // Any other failure means the ring cannot be used.
+  if (to_submit || min_complete)
+  {
+    if (do_enter(ring_fd_, to_submit, min_complete,
+          min_complete ? IORING_ENTER_GETEVENTS : 0) < 0
+        && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+    {
+      boost::system::error_code ec(errno,
+          boost::asio::error::get_system_category());
+      lock.lock();
+      blocked_ = false;
+      lock.unlock();
+      boost::asio::detail::throw_error(ec, "io_uring_enter");
+    }
+  }
+
+  lock.lock();
+  blocked_ = false;
+  ++batch_;
+  unsigned long batch = batch_;
+  bool retry_requests = removals_pending_ || polls_pending_;
+  removals_pending_ = false;
+  polls_pending_ = false;
+  lock.unlock();
+
+  // Dispatch the completions. The completion ring has a single consumer, as
+  // only one thread at a time runs the reactor task.
+  bool rearm_interrupter = false;
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head)
+  {
+    const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+    void* ptr = reinterpret_cast<void*>(cqe.user_data);
+    if (ptr == &interrupter_)
+    {
+      interrupter_.reset();
+      rearm_interrupter = true;
+    }
+    else if (ptr != &timeout_ && ptr != 0)
+    {
+      // The descriptor operation doesn't count as work in and of itself, so we
+      // don't call work_started() here. This still allows the io_service to
+      // stop if the only remaining operations are descriptor operations.
+      std::size_t tag = static_cast<std::size_t>(cqe.user_data & 3);
+      descriptor_state* descriptor_data = reinterpret_cast<descriptor_state*>(
+          static_cast<std::size_t>(cqe.user_data & ~static_cast<__u64>(3)));
+      mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+      descriptor_data->polls_armed_ &= ~(1u << tag);
+      if (descriptor_data->shutdown_)
+      {
+        if (descriptor_data->polls_armed_ == 0)
+        {
+          descriptor_lock.unlock();
+          free_descriptor_state(descriptor_data);
+        }
+      }
+      else
+      {
+        uint32_t events = cqe.res < 0 ? POLLERR : cqe.res;
+        if (descriptor_data->batch_ == batch)
+        {
+          descriptor_data->task_result_ |= events;
+        }
+        else
+        {
+          descriptor_data->batch_ = batch;
+          descriptor_data->set_ready_events(events);
+          ops.push(descriptor_data);
+        }
+      }
+    }
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+  // Queue the poll requests and removals that did not fit in the submission
+  // ring before.
+  if (retry_requests)
+  {
+    mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+    for (descriptor_state* state = registered_descriptors_.first();
+        state != 0; state = state->next_)
+    {
+      mutex::scoped_lock descriptor_lock(state->mutex_);
+      if (state->shutdown_)
+      {
+        if (state->polls_armed_ != 0)
+          disarm_polls(state);
+      }
+      else if (unsigned pending = state->polls_pending_)
+      {
+        state->polls_pending_ = 0;
+        for (int j = 0; j < max_ops; ++j)
+          if ((pending & (1u << j)) && !state->op_queue_[j].empty())
+            arm_poll(state, j);
+      }
+    }
+  }
+
+  lock.lock();
+  if (rearm_interrupter)
+  {
+    interrupter_armed_ = false;
+    arm_interrupter();
+  }
+  timer_queues_.get_ready_timers(ops);
+}
+
+void io_uring_reactor::interrupt()
+{
+  interrupter_.interrupt();
+}
+
+void io_uring_reactor::do_ring_create()
+{
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(
+      ::syscall(__NR_io_uring_setup, ring_size, &params));
+  if (ring_fd_ == -1)
+  {
+    boost::system::error_code ec(errno,
+        boost::asio::error::get_system_category());
+    boost::asio::detail::throw_error(ec, "io_uring");
+  }
+
+#if defined(IORING_FEAT_CQE_SKIP)
+  // Kernels that can skip completions (Linux 5.17) can also update timeouts.
+  update_timeout_in_place_ = (params.features & IORING_FEAT_CQE_SKIP) != 0;
+#endif // defined(IORING_FEAT_CQE_SKIP)
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes
+    + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if (cq_ring_size_ > sq_ring_size_)
+      sq_ring_size_ = cq_ring_size_;
+    cq_ring_size_ = sq_ring_size_;
+  }
+
+  sq_ring_ptr_ = ::mmap(0, sq_ring_size_, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (params.features & IORING_FEAT_SINGLE_MMAP)
+    cq_ring_ptr_ = sq_ring_ptr_;
+  else if (sq_ring_ptr_ != MAP_FAILED)
+    cq_ring_ptr_ = ::mmap(0, cq_ring_size_, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+  else
+    cq_ring_ptr_ = MAP_FAILED;
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe*>(::mmap(0, sqes_size_,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        ring_fd_, IORING_OFF_SQES));
+
+  if (sq_ring_ptr_ == MAP_FAILED || cq_ring_ptr_ == MAP_FAILED
+      || sqes_ == MAP_FAILED)
+  {
+    boost::system::error_code ec(errno,
+        boost::asio::error::get_system_category());
+    do_ring_destroy();
+    boost::asio::detail::throw_error(ec, "io_uring");
+  }
+
+  char* sq = static_cast<char*>(sq_ring_ptr_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  sq_entries_ = params.sq_entries;
+
+  char* cq = static_cast<char*>(cq_ring_ptr_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+void io_uring_reactor::do_ring_destroy()
+{
+  if (sqes_ != 0 && sqes_ != MAP_FAILED)
+    ::munmap(sqes_, sqes_size_);
+  if (cq_ring_ptr_ != 0 && cq_ring_ptr_ != MAP_FAILED
+      && cq_ring_ptr_ != sq_ring_ptr_)
+    ::munmap(cq_ring_ptr_, cq_ring_size_);
+  if (sq_ring_ptr_ != 0 && sq_ring_ptr_ != MAP_FAILED)
+    ::munmap(sq_ring_ptr_, sq_ring_size_);
+  if (ring_fd_ != -1)
+    ::close(ring_fd_);
+
+  ring_fd_ = -1;
+  sq_ring_ptr_ = 0;
+  cq_ring_ptr_ = 0;
+  sqes_ = 0;
+}
+
+io_uring_sqe* io_uring_reactor::get_sqe()
+{
+  unsigned tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+  {
+    submit_sqes();
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+      return 0;
+  }
+
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  std::memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+void io_uring_reactor::commit_sqe()
+{
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+int io_uring_reactor::submit_sqes()
+{
+  unsigned to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (to_submit == 0)
+    return 0;
+  if (do_enter(ring_fd_, to_submit, 0, 0) < 0)
+    return errno;
+  return 0;
+}
+
+int io_uring_reactor::do_enter(int fd, unsigned to_submit,
+    unsigned min_complete, unsigned flags)
+{
+  return static_cast<int>(::syscall(__NR_io_uring_enter,
+        fd, to_submit, min_complete, flags, 0, 0));
+}
+
+void io_uring_reactor::set_poll_events(io_uring_sqe* sqe, unsigned events)
+{
+#if defined(IORING_FEAT_POLL_32BITS)
+  sqe->poll32_events = events;
+#else // defined(IORING_FEAT_POLL_32BITS)
+  sqe->poll_events = static_cast<__u16>(events);
+#endif // defined(IORING_FEAT_POLL_32BITS)
+}
+
+void io_uring_reactor::flush_if_blocked()
+{
+  if (blocked_ && submit_sqes() != 0)
+    interrupt();
+}
+
+void io_uring_reactor::arm_interrupter()
+{
+  if (io_uring_sqe* sqe = get_sqe())
+  {
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = interrupter_.read_descriptor();
+    set_poll_events(sqe, POLLIN);
+    sqe->user_data = reinterpret_cast<unsigned long>(&interrupter_);
+    commit_sqe();
+    interrupter_armed_ = true;
+    flush_if_blocked();
+  }
+}
+
+void io_uring_reactor::arm_poll(
+    io_uring_reactor::descriptor_state* descriptor_data, int op_type)
+{
+  static const unsigned flag[max_ops] = { POLLIN, POLLOUT, POLLPRI };
+
+  if (descriptor_data->polls_armed_ & (1u << op_type))
+    return;
+
+  mutex::scoped_lock lock(mutex_);
+  io_uring_sqe* sqe = get_sqe();
+  if (!sqe)
+  {
+    // The operations stay queued on the descriptor until run() has reaped
+    // completions and the request fits. A blocked thread is woken to do so.
+    descriptor_data->polls_pending_ |= (1u << op_type);
+    polls_pending_ = true;
+    if (blocked_)
+      interrupt();
+    return;
+  }
+
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = descriptor_data->descriptor_;
+  set_poll_events(sqe, flag[op_type]);
+  sqe->user_data = reinterpret_cast<unsigned long>(descriptor_data) | op_type;
+  commit_sqe();
+  descriptor_data->polls_armed_ |= (1u << op_type);
+
+  flush_if_blocked();
+}
+
+void io_uring_reactor::disarm_polls(
+    io_uring_reactor::descriptor_state* descriptor_data)
+{
+  mutex::scoped_lock lock(mutex_);
+  for (int j = 0; j < max_ops; ++j)
+  {
+    if (descriptor_data->polls_armed_ & (1u << j))
+    {
+      if (io_uring_sqe* sqe = get_sqe())
+      {
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<unsigned long>(descriptor_data) | j;
+        sqe->user_data = 0;
+        commit_sqe();
+      }
+      else
+        removals_pending_ = true;
+    }
+  }
+
+  // Submit immediately so that a descriptor which is being closed is released
+  // by the kernel without waiting for the next run(). If the kernel refuses
+  // the entries, or some could not be queued, a blocked thread is woken to
+  // reap completions and retry.
+  if ((submit_sqes() != 0 || removals_pending_) && blocked_)
+    interrupt();
+}
+
+io_uring_reactor::descriptor_state*
+io_uring_reactor::allocate_descriptor_state()
+{
+  mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+  return registered_descriptors_.alloc();
+}
+
+void io_uring_reactor::free_descriptor_state(
+    io_uring_reactor::descriptor_state* s)
+{
+  mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+  registered_descriptors_.free(s);
+}
+
+void io_uring_reactor::do_add_timer_queue(timer_queue_base& queue)
+{
+  mutex::scoped_lock lock(mutex_);
+  timer_queues_.insert(&queue);
+}
+
+void io_uring_reactor::do_remove_timer_queue(timer_queue_base& queue)
+{
+  mutex::scoped_lock lock(mutex_);
+  timer_queues_.erase(&queue);
+}
+
+void io_uring_reactor::update_timeout()
+{
+  // A reactor that is not blocked computes the timeout on its next run().
+  if (!blocked_)
+    return;
+
+  // Change the pending timeout request, which is submitted straight away.
+  // Where the kernel supports it, the request is updated in place and no
+  // completion is posted for the update, so the blocked thread only wakes
+  // when the new timeout expires. Otherwise the request is removed, and the
+  // completion for the removal wakes the thread to compute a new timeout.
+  // Before Linux 5.5 the removal fails, and its completion wakes the thread.
+  if (io_uring_sqe* sqe = get_sqe())
+  {
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<unsigned long>(&timeout_);
+    sqe->user_data = 0;
+#if defined(IORING_FEAT_CQE_SKIP)
+    long usec = timer_queues_.wait_duration_usec(5 * 60 * 1000 * 1000);
+    if (update_timeout_in_place_ && usec > 0)
+    {
+      timeout_.tv_sec = usec / 1000000;
+      timeout_.tv_nsec = (usec % 1000000) * 1000;
+      sqe->addr2 = reinterpret_cast<unsigned long>(&timeout_);
+      sqe->timeout_flags = IORING_TIMEOUT_UPDATE;
+      sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    }
+#endif // defined(IORING_FEAT_CQE_SKIP)
+    commit_sqe();
+    if (submit_sqes() == 0)
+      return;
+  }
+
+  interrupt();
+}
+
+struct io_uring_reactor::perform_io_cleanup_on_block_exit
+{
+  explicit perform_io_cleanup_on_block_exit(io_uring_reactor* r)
+    : reactor_(r), first_op_(0)
+  {
+  }
+
+  ~perform_io_cleanup_on_block_exit()
+  {
+    if (first_op_)
+    {
+      // Post the remaining completed operations for invocation.
+      if (!ops_.empty())
+        reactor_->io_service_.post_deferred_completions(ops_);
+
+      // A user-initiated operation has completed, but there's no need to
+      // explicitly call work_finished() here. Instead, we'll take advantage of
+      // the fact that the task_io_service will call work_finished() once we
+      // return.
+    }
+    else
+    {
+      // No user-initiated operations have completed, so we need to compensate
+      // for the work_finished() call that the task_io_service will make once
+      // this operation returns.
+      reactor_->io_service_.work_started();
+    }
+  }
+
+  io_uring_reactor* reactor_;
+  op_queue<operation> ops_;
+  operation* first_op_;
+};
+
+io_uring_reactor::descriptor_state::descriptor_state()
+  : operation(&io_uring_reactor::descriptor_state::do_complete),
+    polls_armed_(0),
+    polls_pending_(0),
+    batch_(0)
+{
+}
+
+operation* io_uring_reactor::descriptor_state::perform_io(uint32_t events)
+{
+  mutex_.lock();
+  perform_io_cleanup_on_block_exit io_cleanup(reactor_);
+  mutex::scoped_lock descriptor_lock(mutex_, mutex::scoped_lock::adopt_lock);
+
+  // Exception operations must be processed first to ensure that any
+  // out-of-band data is read before normal data.
+  static const int flag[max_ops] = { POLLIN, POLLOUT, POLLPRI };
+  for (int j = max_ops - 1; j >= 0; --j)
+  {
+    if (events & (flag[j] | POLLERR | POLLHUP))
+    {
+      while (reactor_op* op = op_queue_[j].front())
+      {
+        if (op->perform())
+        {
+          op_queue_[j].pop();
+          io_cleanup.ops_.push(op);
+        }
+        else
+          break;
+      }
+    }
+  }
+
+  // Polls are one-shot, so request another for any operations still waiting.
+  if (!shutdown_)
+  {
+    for (int j = 0; j < max_ops; ++j)
+    {
+      if (!op_queue_[j].empty())
+        reactor_->arm_poll(this, j);
+    }
+  }
+
+  // The first operation will be returned for completion now. The others will
+  // be posted for later by the io_cleanup object's destructor.
+  io_cleanup.first_op_ = io_cleanup.ops_.front();
+  io_cleanup.ops_.pop();
+  return io_cleanup.first_op_;
+}
+
+void io_uring_reactor::descriptor_state::do_complete(
+    io_service_impl* owner, operation* base,
+    const boost::system::error_code& ec, std::size_t bytes_transferred)
+{
+  if (owner)
+  {
+    descriptor_state* descriptor_data = static_cast<descriptor_state*>(base);
+    uint32_t events = static_cast<uint32_t>(bytes_transferred);
+    if (operation* op = descriptor_data->perform_io(events))
+    {
+      op->complete(*owner, ec, 0);
+    }
+  }
+}
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_IO_URING)
+
+#endif // BOOST_ASIO_DETAIL_IMPL_IO_URING_REACTOR_IPP
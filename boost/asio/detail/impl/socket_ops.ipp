@@ -1071,6 +1071,130 @@ bool non_blocking_recvmsg(socket_type s,
 
 #endif // defined(BOOST_ASIO_HAS_IOCP)
 
+#if !defined(BOOST_ASIO_HAS_IOCP)
+
+signed_size_type recvmmsg(socket_type s, buf* bufs, size_t count,
+    int flags, socket_addr_type* const* addrs, std::size_t* addrlens,
+    std::size_t* sizes, boost::system::error_code& ec)
+{
+  clear_last_error();
+#if defined(BOOST_ASIO_HAS_MMSG)
+  // Receive up to one batch of messages, without waiting for more once the
+  // first has arrived.
+  mmsghdr msgs[max_mmsg_batch];
+  if (count > static_cast<size_t>(max_mmsg_batch))
+    count = max_mmsg_batch;
+  for (size_t i = 0; i < count; ++i)
+  {
+    msgs[i] = mmsghdr();
+    init_msghdr_msg_name(msgs[i].msg_hdr.msg_name, addrs[i]);
+    msgs[i].msg_hdr.msg_namelen = static_cast<int>(addrlens[i]);
+    msgs[i].msg_hdr.msg_iov = &bufs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  signed_size_type result = error_wrapper(::recvmmsg(s, msgs,
+        static_cast<unsigned int>(count), flags | MSG_WAITFORONE, 0), ec);
+  for (signed_size_type i = 0; i < result; ++i)
+  {
+    addrlens[i] = msgs[i].msg_hdr.msg_namelen;
+    sizes[i] = msgs[i].msg_len;
+  }
+  if (result >= 0)
+    ec = boost::system::error_code();
+  return result;
+#else // defined(BOOST_ASIO_HAS_MMSG)
+  // Emulate the batch with one call per message. Only the first call may
+  // block.
+  size_t n = 0;
+  for (; n < count; ++n)
+  {
+    signed_size_type bytes = socket_ops::recvfrom(
+        s, &bufs[n], 1, flags, addrs[n], &addrlens[n], ec);
+    if (bytes < 0)
+      break;
+    sizes[n] = bytes;
+#if defined(MSG_DONTWAIT)
+    flags |= MSG_DONTWAIT;
+#else // defined(MSG_DONTWAIT)
+    ++n;
+    break;
+#endif // defined(MSG_DONTWAIT)
+  }
+  if (n == 0)
+    return socket_error_retval;
+  ec = boost::system::error_code();
+  return static_cast<signed_size_type>(n);
+#endif // defined(BOOST_ASIO_HAS_MMSG)
+}
+
+size_t sync_recvmmsg(socket_type s, state_type state, buf* bufs,
+    size_t count, int flags, socket_addr_type* const* addrs,
+    std::size_t* addrlens, std::size_t* sizes, boost::system::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // Read some messages.
+  for (;;)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type messages = socket_ops::recvmmsg(
+        s, bufs, count, flags, addrs, addrlens, sizes, ec);
+
+    // Check if operation succeeded.
+    if (messages >= 0)
+      return messages;
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != boost::asio::error::would_block
+          && ec != boost::asio::error::try_again))
+      return 0;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_read(s, 0, ec) < 0)
+      return 0;
+  }
+}
+
+bool non_blocking_recvmmsg(socket_type s,
+    buf* bufs, size_t count, int flags, socket_addr_type* const* addrs,
+    std::size_t* addrlens, std::size_t* sizes,
+    boost::system::error_code& ec, size_t& messages_transferred)
+{
+  for (;;)
+  {
+    // Read some messages.
+    signed_size_type messages = socket_ops::recvmmsg(
+        s, bufs, count, flags, addrs, addrlens, sizes, ec);
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation is complete.
+    if (messages >= 0)
+    {
+      ec = boost::system::error_code();
+      messages_transferred = messages;
+    }
+    else
+      messages_transferred = 0;
+
+    return true;
+  }
+}
+
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
 signed_size_type send(socket_type s, const buf* bufs, size_t count,
     int flags, boost::system::error_code& ec)
 {
@@ -1303,6 +1427,231 @@ bool non_blocking_sendto(socket_type s,
 
 #endif // !defined(BOOST_ASIO_HAS_IOCP)
 
+#if !defined(BOOST_ASIO_HAS_IOCP)
+
+signed_size_type sendmmsg(socket_type s, const buf* bufs, size_t count,
+    int flags, const socket_addr_type* const* addrs,
+    const std::size_t* addrlens, boost::system::error_code& ec)
+{
+  clear_last_error();
+#if defined(__linux__)
+  flags |= MSG_NOSIGNAL;
+#endif // defined(__linux__)
+#if defined(BOOST_ASIO_HAS_MMSG)
+  mmsghdr msgs[max_mmsg_batch];
+  if (count > static_cast<size_t>(max_mmsg_batch))
+    count = max_mmsg_batch;
+  for (size_t i = 0; i < count; ++i)
+  {
+    msgs[i] = mmsghdr();
+    init_msghdr_msg_name(msgs[i].msg_hdr.msg_name, addrs[i]);
+    msgs[i].msg_hdr.msg_namelen = static_cast<int>(addrlens[i]);
+    msgs[i].msg_hdr.msg_iov = const_cast<buf*>(&bufs[i]);
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  signed_size_type result = error_wrapper(::sendmmsg(s, msgs,
+        static_cast<unsigned int>(count), flags), ec);
+  if (result >= 0)
+    ec = boost::system::error_code();
+  return result;
+#else // defined(BOOST_ASIO_HAS_MMSG)
+  // Emulate the batch with one call per message, stopping at the first
+  // failure.
+  size_t n = 0;
+  for (; n < count; ++n)
+  {
+    signed_size_type bytes = socket_ops::sendto(
+        s, &bufs[n], 1, flags, addrs[n], addrlens[n], ec);
+    if (bytes < 0)
+      break;
+  }
+  if (n == 0)
+    return socket_error_retval;
+  ec = boost::system::error_code();
+  return static_cast<signed_size_type>(n);
+#endif // defined(BOOST_ASIO_HAS_MMSG)
+}
+
+size_t sync_sendmmsg(socket_type s, state_type state, const buf* bufs,
+    size_t count, int flags, const socket_addr_type* const* addrs,
+    const std::size_t* addrlens, boost::system::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // Write some messages.
+  for (;;)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type messages = socket_ops::sendmmsg(
+        s, bufs, count, flags, addrs, addrlens, ec);
+
+    // Check if operation succeeded.
+    if (messages >= 0)
+      return messages;
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != boost::asio::error::would_block
+          && ec != boost::asio::error::try_again))
+      return 0;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_write(s, 0, ec) < 0)
+      return 0;
+  }
+}
+
+bool non_blocking_sendmmsg(socket_type s,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* const* addrs, const std::size_t* addrlens,
+    boost::system::error_code& ec, size_t& messages_transferred)
+{
+  for (;;)
+  {
+    // Write some messages.
+    signed_size_type messages = socket_ops::sendmmsg(
+        s, bufs, count, flags, addrs, addrlens, ec);
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation is complete.
+    if (messages >= 0)
+    {
+      ec = boost::system::error_code();
+      messages_transferred = messages;
+    }
+    else
+      messages_transferred = 0;
+
+    return true;
+  }
+}
+
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
+#if defined(BOOST_ASIO_HAS_SENDFILE)
+
+signed_size_type sendfile(socket_type s, int file,
+    uint64_t& offset, size_t count, boost::system::error_code& ec)
+{
+  clear_last_error();
+  off_t off = static_cast<off_t>(offset);
+  signed_size_type result = error_wrapper(
+      ::sendfile(s, file, &off, count), ec);
+  if (result >= 0)
+  {
+    offset = static_cast<uint64_t>(off);
+    ec = boost::system::error_code();
+  }
+  return result;
+}
+
+size_t sync_sendfile(socket_type s, state_type state, int file,
+    uint64_t offset, size_t count, boost::system::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = boost::asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // Send the file region.
+  size_t total_transferred = 0;
+  while (count > 0)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type bytes = socket_ops::sendfile(
+        s, file, offset, count, ec);
+
+    // Check if operation succeeded.
+    if (bytes > 0)
+    {
+      total_transferred += bytes;
+      count -= bytes;
+      continue;
+    }
+
+    // Check for end of file.
+    if (bytes == 0)
+    {
+      ec = boost::asio::error::eof;
+      return total_transferred;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != boost::asio::error::would_block
+          && ec != boost::asio::error::try_again))
+      return total_transferred;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_write(s, 0, ec) < 0)
+      return total_transferred;
+  }
+
+  ec = boost::system::error_code();
+  return total_transferred;
+}
+
+bool non_blocking_sendfile(socket_type s,
+    int file, uint64_t& offset, size_t& remaining,
+    boost::system::error_code& ec, size_t& bytes_transferred)
+{
+  while (remaining > 0)
+  {
+    // Send as much of the file region as the socket will accept.
+    signed_size_type bytes = socket_ops::sendfile(
+        s, file, offset, remaining, ec);
+
+    // Continue with the rest of the region after a partial write.
+    if (bytes > 0)
+    {
+      bytes_transferred += bytes;
+      remaining -= bytes;
+      continue;
+    }
+
+    // Check for end of file.
+    if (bytes == 0)
+    {
+      ec = boost::asio::error::eof;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == boost::asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == boost::asio::error::would_block
+        || ec == boost::asio::error::try_again)
+      return false;
+
+    // Operation failed.
+    return true;
+  }
+
+  ec = boost::system::error_code();
+  return true;
+}
+
+#endif // defined(BOOST_ASIO_HAS_SENDFILE)
+
 socket_type socket(int af, int type, int protocol,
     boost::system::error_code& ec)
 {
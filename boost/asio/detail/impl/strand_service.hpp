@@ -28,6 +28,67 @@ namespace boost {
 namespace asio {
 namespace detail {
 
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
+inline strand_service::strand_impl::strand_impl()
+  : operation(&strand_service::do_complete),
+    next_(0),
+    prev_(0),
+    service_(0),
+    ref_count_(0),
+    state_(0)
+{
+}
+
+inline strand_service::strand_impl::~strand_impl()
+{
+  operation* list = state_.load();
+  if (list != 0 && list != this)
+  {
+    op_queue<operation> ops;
+    strand_service::push_waiting(ops, list);
+  }
+}
+
+struct strand_service::on_dispatch_exit
+{
+  io_service_impl* io_service_;
+  strand_impl* impl_;
+
+  ~on_dispatch_exit()
+  {
+    if (strand_service::do_unlock(impl_))
+      io_service_->post_immediate_completion(impl_, false);
+    else
+      strand_service::do_release(impl_);
+  }
+};
+
+inline void strand_service::copy_construct(implementation_type& impl,
+    const implementation_type& other_impl)
+{
+  impl = other_impl;
+  ++impl->ref_count_;
+}
+
+inline void strand_service::move_construct(implementation_type& impl,
+    implementation_type& other_impl)
+{
+  impl = other_impl;
+  other_impl = 0;
+}
+
+inline void strand_service::destroy(implementation_type& impl)
+{
+  if (impl)
+  {
+    do_release(impl);
+    impl = 0;
+  }
+}
+
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 inline strand_service::strand_impl::strand_impl()
   : operation(&strand_service::do_complete),
     locked_(false)
@@ -51,6 +112,24 @@ struct strand_service::on_dispatch_exit
   }
 };
 
+inline void strand_service::copy_construct(implementation_type& impl,
+    const implementation_type& other_impl)
+{
+  impl = other_impl;
+}
+
+inline void strand_service::move_construct(implementation_type& impl,
+    implementation_type& other_impl)
+{
+  impl = other_impl;
+}
+
+inline void strand_service::destroy(implementation_type&)
+{
+}
+
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 template <typename Handler>
 void strand_service::dispatch(strand_service::implementation_type& impl,
     Handler& handler)
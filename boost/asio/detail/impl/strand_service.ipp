@@ -32,6 +32,12 @@ struct strand_service::on_do_complete_exit
 
   ~on_do_complete_exit()
   {
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+    if (strand_service::do_unlock(impl_))
+      owner_->post_immediate_completion(impl_, true);
+    else
+      strand_service::do_release(impl_);
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
     impl_->mutex_.lock();
     impl_->ready_queue_.push(impl_->waiting_queue_);
     bool more_handlers = impl_->locked_ = !impl_->ready_queue_.empty();
@@ -39,17 +45,54 @@ struct strand_service::on_do_complete_exit
 
     if (more_handlers)
       owner_->post_immediate_completion(impl_, true);
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
   }
 };
 
 strand_service::strand_service(boost::asio::io_service& io_service)
   : boost::asio::detail::service_base<strand_service>(io_service),
     io_service_(boost::asio::use_service<io_service_impl>(io_service)),
-    mutex_(),
-    salt_(0)
+    mutex_()
+#if !defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+    , salt_(0)
+#endif // !defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+{
+}
+
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
+void strand_service::shutdown_service()
+{
+  op_queue<operation> ops;
+
+  boost::asio::detail::mutex::scoped_lock lock(mutex_);
+
+  for (strand_impl* impl = implementations_.first(); impl; impl = impl->next_)
+  {
+    operation* list = impl->state_.load();
+    while (list != 0 && list != impl)
+    {
+      if (impl->state_.compare_exchange_weak(list, impl))
+      {
+        push_waiting(ops, list);
+        break;
+      }
+    }
+    ops.push(impl->ready_queue_);
+  }
+}
+
+void strand_service::construct(strand_service::implementation_type& impl)
 {
+  boost::asio::detail::mutex::scoped_lock lock(mutex_);
+
+  impl = implementations_.alloc();
+  impl->service_ = this;
+  ++impl->ref_count_;
 }
 
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 void strand_service::shutdown_service()
 {
   op_queue<operation> ops;
@@ -85,12 +128,136 @@ void strand_service::construct(strand_service::implementation_type& impl)
   impl = implementations_[index].get();
 }
 
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 bool strand_service::running_in_this_thread(
     const implementation_type& impl) const
 {
   return call_stack<strand_impl>::contains(impl) != 0;
 }
 
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
+bool strand_service::do_dispatch(implementation_type& impl, operation* op)
+{
+  // If we are running inside the io_service, and no other handler already
+  // holds the strand lock, then the handler can run immediately.
+  bool can_dispatch = io_service_.can_dispatch();
+  if (!do_lock(impl, op))
+  {
+    // Some other handler already holds the strand lock. The handler has been
+    // enqueued for later.
+    return false;
+  }
+
+  if (can_dispatch)
+  {
+    // Immediate invocation is allowed.
+    return true;
+  }
+
+  // The handler is acquiring the strand lock and so is responsible for
+  // scheduling the strand.
+  impl->ready_queue_.push(op);
+  io_service_.post_immediate_completion(impl, false);
+  return false;
+}
+
+void strand_service::do_post(implementation_type& impl,
+    operation* op, bool is_continuation)
+{
+  if (do_lock(impl, op))
+  {
+    // The handler is acquiring the strand lock and so is responsible for
+    // scheduling the strand.
+    impl->ready_queue_.push(op);
+    io_service_.post_immediate_completion(impl, is_continuation);
+  }
+}
+
+bool strand_service::do_lock(strand_impl* impl, operation* op)
+{
+  operation* state = impl->state_.load();
+  for (;;)
+  {
+    if (state == 0)
+    {
+      if (impl->state_.compare_exchange_weak(state, impl))
+      {
+        // The lock holds a reference so that the implementation outlives any
+        // strand objects that are destroyed while handlers are running.
+        ++impl->ref_count_;
+        return true;
+      }
+    }
+    else
+    {
+      op_queue_access::next(op,
+          state == impl ? static_cast<operation*>(0) : state);
+      if (impl->state_.compare_exchange_weak(state, op))
+        return false;
+    }
+  }
+}
+
+bool strand_service::do_unlock(strand_impl* impl)
+{
+  // Only the holder of the lock may remove the waiting list or unlock the
+  // strand, so the state is never zero here.
+  operation* state = impl->state_.load();
+  for (;;)
+  {
+    if (state != impl)
+    {
+      if (impl->state_.compare_exchange_weak(state, impl))
+      {
+        push_waiting(impl->ready_queue_, state);
+        return true;
+      }
+    }
+    else if (!impl->ready_queue_.empty())
+    {
+      return true;
+    }
+    else if (impl->state_.compare_exchange_weak(state, 0))
+    {
+      return false;
+    }
+  }
+}
+
+void strand_service::do_release(strand_impl* impl)
+{
+  if (--impl->ref_count_ == 0)
+  {
+    strand_service* service = impl->service_;
+    boost::asio::detail::mutex::scoped_lock lock(service->mutex_);
+    service->implementations_.free(impl);
+  }
+}
+
+void strand_service::push_waiting(op_queue<operation>& ops, operation* list)
+{
+  // The list is in reverse order of arrival.
+  operation* reversed = 0;
+  while (list)
+  {
+    operation* next = op_queue_access::next(list);
+    op_queue_access::next(list, reversed);
+    reversed = list;
+    list = next;
+  }
+
+  while (reversed)
+  {
+    operation* next = op_queue_access::next(reversed);
+    ops.push(reversed);
+    reversed = next;
+  }
+}
+
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 bool strand_service::do_dispatch(implementation_type& impl, operation* op)
 {
   // If we are running inside the io_service, and no other handler already
@@ -145,6 +312,8 @@ void strand_service::do_post(implementation_type& impl,
   }
 }
 
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 void strand_service::do_complete(io_service_impl* owner, operation* base,
     const boost::system::error_code& ec, std::size_t /*bytes_transferred*/)
 {
@@ -21,10 +21,15 @@
 
 #include <boost/asio/detail/event.hpp>
 #include <boost/asio/detail/limits.hpp>
+#include <boost/asio/detail/monotonic_clock.hpp>
 #include <boost/asio/detail/reactor.hpp>
 #include <boost/asio/detail/task_io_service.hpp>
 #include <boost/asio/detail/task_io_service_thread_info.hpp>
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+# include <boost/asio/metrics.hpp>
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 #include <boost/asio/detail/push_options.hpp>
 
 namespace boost {
@@ -35,6 +40,13 @@ struct task_io_service::task_cleanup
 {
   ~task_cleanup()
   {
+#if defined(BOOST_ASIO_HAS_METRICS)
+    // The operations completed by the task are on the private queue.
+    task_io_service_->reactor_runs_.add(1);
+    task_io_service_->reactor_batch_sizes_.add(
+        this_thread_->private_op_queue.size());
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
     if (this_thread_->private_outstanding_work > 0)
     {
       boost::asio::detail::increment(
@@ -75,6 +87,13 @@ struct task_io_service::work_cleanup
 #if defined(BOOST_ASIO_HAS_THREADS)
     if (!this_thread_->private_op_queue.empty())
     {
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+      if (this_thread_->is_runner)
+      {
+        task_io_service_->push_local_operations(*lock_, *this_thread_);
+        return;
+      }
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
       lock_->lock();
       task_io_service_->op_queue_.push(this_thread_->private_op_queue);
     }
@@ -86,6 +105,134 @@ struct task_io_service::work_cleanup
   thread_info* this_thread_;
 };
 
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+struct task_io_service::runner_registration
+{
+  runner_registration(task_io_service* s, thread_info& this_thread)
+    : task_io_service_(s),
+      this_thread_(this_thread)
+  {
+    mutex::scoped_lock lock(task_io_service_->mutex_);
+    this_thread_.local_stopped = task_io_service_->stopped_;
+    this_thread_.is_runner = true;
+    this_thread_.prev_runner = 0;
+    this_thread_.next_runner = task_io_service_->first_runner_;
+    if (task_io_service_->first_runner_)
+      task_io_service_->first_runner_->prev_runner = &this_thread_;
+    task_io_service_->first_runner_ = &this_thread_;
+  }
+
+  ~runner_registration()
+  {
+    mutex::scoped_lock lock(task_io_service_->mutex_);
+    if (this_thread_.prev_runner)
+      this_thread_.prev_runner->next_runner = this_thread_.next_runner;
+    else
+      task_io_service_->first_runner_ = this_thread_.next_runner;
+    if (this_thread_.next_runner)
+      this_thread_.next_runner->prev_runner = this_thread_.prev_runner;
+    this_thread_.is_runner = false;
+
+    // Hand any handlers that were not run back to the shared queue.
+    mutex::scoped_lock local_lock(this_thread_.local_mutex);
+    op_queue<operation> ops;
+    ops.push(this_thread_.local_op_queue);
+    ops.push(this_thread_.private_op_queue);
+    local_lock.unlock();
+    if (!ops.empty())
+    {
+      task_io_service_->op_queue_.push(ops);
+      task_io_service_->wake_one_thread_and_unlock(lock);
+    }
+  }
+
+  task_io_service* task_io_service_;
+  thread_info& this_thread_;
+};
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+struct task_io_service::task_thread_counter
+{
+  explicit task_thread_counter(task_io_service& s)
+    : task_io_service_(s)
+  {
+    ++task_io_service_.task_thread_count_;
+  }
+
+  ~task_thread_counter()
+  {
+    --task_io_service_.task_thread_count_;
+  }
+
+  task_io_service& task_io_service_;
+};
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+struct task_io_service::metrics_registration
+{
+  metrics_registration(task_io_service* s, thread_info& this_thread)
+    : task_io_service_(s),
+      metrics_(this_thread.metrics)
+  {
+    mutex::scoped_lock lock(task_io_service_->mutex_);
+    metrics_.prev_ = 0;
+    metrics_.next_ = task_io_service_->first_thread_metrics_;
+    if (task_io_service_->first_thread_metrics_)
+      task_io_service_->first_thread_metrics_->prev_ = &metrics_;
+    task_io_service_->first_thread_metrics_ = &metrics_;
+  }
+
+  ~metrics_registration()
+  {
+    mutex::scoped_lock lock(task_io_service_->mutex_);
+    if (metrics_.prev_)
+      metrics_.prev_->next_ = metrics_.next_;
+    else
+      task_io_service_->first_thread_metrics_ = metrics_.next_;
+    if (metrics_.next_)
+      metrics_.next_->prev_ = metrics_.prev_;
+
+    // Keep the thread's counts in the io_service's totals.
+    task_io_service_->retired_handlers_executed_.add(
+        metrics_.handlers_executed.value());
+    for (std::size_t i = 0; i < metrics_histogram::buckets; ++i)
+    {
+      task_io_service_->retired_handler_latency_.add_to_bucket(
+          i, metrics_.handler_latency.value(i));
+    }
+  }
+
+  task_io_service* task_io_service_;
+  thread_metrics& metrics_;
+};
+
+struct task_io_service::handler_metrics
+{
+  explicit handler_metrics(thread_info& this_thread)
+    : metrics_(this_thread.metrics),
+      start_(0)
+  {
+    if (--metrics_.latency_countdown == 0)
+    {
+      metrics_.latency_countdown = thread_metrics::latency_sample_interval;
+      start_ = thread_metrics::now();
+    }
+  }
+
+  ~handler_metrics()
+  {
+    metrics_.handlers_executed.add(1);
+    if (start_)
+      metrics_.handler_latency.add(thread_metrics::now() - start_);
+  }
+
+  thread_metrics& metrics_;
+  uint64_t start_;
+};
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 task_io_service::task_io_service(
     boost::asio::io_service& io_service, std::size_t concurrency_hint)
   : boost::asio::detail::service_base<task_io_service>(io_service),
@@ -96,7 +243,19 @@ task_io_service::task_io_service(
     outstanding_work_(0),
     stopped_(false),
     shutdown_(false),
-    first_idle_thread_(0)
+    first_idle_thread_(0),
+    busy_poll_max_ns_(0),
+    busy_poll_ns_(0),
+    busy_poll_adaptive_(false)
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+    , idle_thread_count_(0),
+    task_thread_count_(0),
+    first_runner_(0)
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+#if defined(BOOST_ASIO_HAS_METRICS)
+    , first_thread_metrics_(0),
+    first_timer_queue_(0)
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 {
   BOOST_ASIO_HANDLER_TRACKING_INIT;
 }
@@ -145,14 +304,40 @@ std::size_t task_io_service::run(boost::system::error_code& ec)
   this_thread.wakeup_event = &wakeup_event;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  this_thread.is_runner = false;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
   thread_call_stack::context ctx(this, this_thread);
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  metrics_registration metrics_reg(this, this_thread);
+  (void)metrics_reg;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  runner_registration reg(this, this_thread);
+  (void)reg;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
   mutex::scoped_lock lock(mutex_);
 
   std::size_t n = 0;
   for (; do_run_one(lock, this_thread, ec); lock.lock())
+  {
     if (n != (std::numeric_limits<std::size_t>::max)())
       ++n;
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+    // Run a bounded number of the handlers posted by this thread, then put
+    // any that remain on the shared queue so that a handler that keeps
+    // reposting itself cannot starve the task and the other handlers.
+    for (std::size_t i = 0; i < max_local_handlers
+        && do_run_local_one(lock, this_thread, ec); ++i)
+      if (n != (std::numeric_limits<std::size_t>::max)())
+        ++n;
+    requeue_local_operations(lock, this_thread);
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  }
   return n;
 }
 
@@ -170,8 +355,21 @@ std::size_t task_io_service::run_one(boost::system::error_code& ec)
   this_thread.wakeup_event = &wakeup_event;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  this_thread.is_runner = false;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
   thread_call_stack::context ctx(this, this_thread);
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  metrics_registration metrics_reg(this, this_thread);
+  (void)metrics_reg;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  runner_registration reg(this, this_thread);
+  (void)reg;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
   mutex::scoped_lock lock(mutex_);
 
   return do_run_one(lock, this_thread, ec);
@@ -190,8 +388,16 @@ std::size_t task_io_service::poll(boost::system::error_code& ec)
   this_thread.wakeup_event = 0;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  this_thread.is_runner = false;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
   thread_call_stack::context ctx(this, this_thread);
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  metrics_registration metrics_reg(this, this_thread);
+  (void)metrics_reg;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
   mutex::scoped_lock lock(mutex_);
 
 #if defined(BOOST_ASIO_HAS_THREADS)
@@ -223,8 +429,16 @@ std::size_t task_io_service::poll_one(boost::system::error_code& ec)
   this_thread.wakeup_event = 0;
   this_thread.private_outstanding_work = 0;
   this_thread.next = 0;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  this_thread.is_runner = false;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
   thread_call_stack::context ctx(this, this_thread);
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  metrics_registration metrics_reg(this, this_thread);
+  (void)metrics_reg;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
   mutex::scoped_lock lock(mutex_);
 
 #if defined(BOOST_ASIO_HAS_THREADS)
@@ -255,6 +469,14 @@ void task_io_service::reset()
 {
   mutex::scoped_lock lock(mutex_);
   stopped_ = false;
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  for (thread_info* t = first_runner_; t; t = t->next_runner)
+  {
+    mutex::scoped_lock local_lock(t->local_mutex);
+    t->local_stopped = false;
+  }
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
 }
 
 void task_io_service::post_immediate_completion(
@@ -270,6 +492,19 @@ void task_io_service::post_immediate_completion(
       return;
     }
   }
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  else if (thread_info* this_thread = thread_call_stack::contains(this))
+  {
+    // Handlers posted from within a handler go on to the thread's own queue,
+    // from where idle threads may steal them.
+    if (this_thread->is_runner)
+    {
+      ++this_thread->private_outstanding_work;
+      this_thread->private_op_queue.push(op);
+      return;
+    }
+  }
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
 #endif // defined(BOOST_ASIO_HAS_THREADS)
 
   work_started();
@@ -318,6 +553,72 @@ void task_io_service::post_deferred_completions(
   }
 }
 
+void task_io_service::set_busy_poll(uint64_t spin_ns, bool adaptive)
+{
+  mutex::scoped_lock lock(mutex_);
+  busy_poll_max_ns_ = spin_ns;
+  busy_poll_ns_ = spin_ns;
+  busy_poll_adaptive_ = adaptive;
+}
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+void task_io_service::register_timer_queue(timer_queue_base& queue)
+{
+  mutex::scoped_lock lock(mutex_);
+  queue.next_metrics_ = first_timer_queue_;
+  first_timer_queue_ = &queue;
+}
+
+void task_io_service::unregister_timer_queue(timer_queue_base& queue)
+{
+  mutex::scoped_lock lock(mutex_);
+  for (timer_queue_base** p = &first_timer_queue_; *p; p = &(*p)->next_metrics_)
+  {
+    if (*p == &queue)
+    {
+      *p = queue.next_metrics_;
+      queue.next_metrics_ = 0;
+      return;
+    }
+  }
+}
+
+void task_io_service::get_metrics(io_service_metrics& m)
+{
+  mutex::scoped_lock lock(mutex_);
+
+  // The task operation is in the queue unless a thread is running the task.
+  m.queue_depth = op_queue_.size();
+  if (op_queue_access::next(&task_operation_) != 0
+      || op_queue_access::back(op_queue_) == &task_operation_)
+    --m.queue_depth;
+
+  for (timer_queue_base* q = first_timer_queue_; q; q = q->next_metrics_)
+    m.pending_timers += q->pending_timers();
+
+  m.handlers_executed = retired_handlers_executed_.value();
+  for (std::size_t i = 0; i < metrics_histogram::buckets; ++i)
+    m.handler_latency[i] = retired_handler_latency_.value(i);
+
+  for (thread_metrics* t = first_thread_metrics_; t; t = t->next_)
+  {
+    std::size_t n = t->handlers_executed.value();
+    m.thread_handlers_executed.push_back(n);
+    m.handlers_executed += n;
+    for (std::size_t i = 0; i < metrics_histogram::buckets; ++i)
+      m.handler_latency[i] += t->handler_latency.value(i);
+  }
+
+  lock.unlock();
+
+  m.reactor_runs = reactor_runs_.value();
+  m.reactor_interrupts = reactor_interrupts_.value();
+  m.thread_wakeups = thread_wakeups_.value();
+  for (std::size_t i = 0; i < metrics_histogram::buckets; ++i)
+    m.reactor_batch_sizes[i] = reactor_batch_sizes_.value(i);
+}
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 void task_io_service::do_dispatch(
     task_io_service::operation* op)
 {
@@ -349,7 +650,20 @@ std::size_t task_io_service::do_run_one(mutex::scoped_lock& lock,
 
       if (o == &task_operation_)
       {
-        task_interrupted_ = more_handlers;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+        // Don't block in the task while other threads have work queued. The
+        // thread is counted before it looks, so that handlers queued locally
+        // after it has looked make their owner interrupt the task.
+        task_thread_counter counted(*this);
+        if (!more_handlers && this_thread.is_runner)
+          more_handlers = steal_operations(this_thread);
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
+        // A task that is busy polling notices new handlers by itself, so it
+        // is treated as already interrupted.
+        bool spin = !more_handlers && busy_poll_max_ns_ > 0;
+        uint64_t spin_ns = busy_poll_ns_;
+        task_interrupted_ = more_handlers || spin;
 
         if (more_handlers && !one_thread_)
         {
@@ -365,7 +679,10 @@ std::size_t task_io_service::do_run_one(mutex::scoped_lock& lock,
         // Run the task. May throw an exception. Only block if the operation
         // queue is empty and we're not polling, otherwise we want to return
         // as soon as possible.
-        task_->run(!more_handlers, this_thread.private_op_queue);
+        if (spin)
+          run_task_spinning(lock, this_thread, spin_ns);
+        else
+          task_->run(!more_handlers, this_thread.private_op_queue);
       }
       else
       {
@@ -380,6 +697,11 @@ std::size_t task_io_service::do_run_one(mutex::scoped_lock& lock,
         work_cleanup on_exit = { this, &lock, &this_thread };
         (void)on_exit;
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+        handler_metrics on_complete(this_thread);
+        (void)on_complete;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
         // Complete the operation. May throw an exception. Deletes the object.
         o->complete(*this, ec, task_result);
 
@@ -388,6 +710,17 @@ std::size_t task_io_service::do_run_one(mutex::scoped_lock& lock,
     }
     else
     {
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+      // Try to take work from the other threads before going idle. As for
+      // the task, the thread is counted as idle before it looks.
+      ++idle_thread_count_;
+      if (this_thread.is_runner && steal_operations(this_thread))
+      {
+        --idle_thread_count_;
+        continue;
+      }
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
       // Nothing to run right now, so just wait for work to do.
       this_thread.next = first_idle_thread_;
       first_idle_thread_ = &this_thread;
@@ -447,22 +780,197 @@ std::size_t task_io_service::do_poll_one(mutex::scoped_lock& lock,
   work_cleanup on_exit = { this, &lock, &this_thread };
   (void)on_exit;
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  handler_metrics on_complete(this_thread);
+  (void)on_complete;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
   // Complete the operation. May throw an exception. Deletes the object.
   o->complete(*this, ec, task_result);
 
   return 1;
 }
 
+void task_io_service::run_task_spinning(mutex::scoped_lock& lock,
+    task_io_service::thread_info& this_thread, uint64_t spin_ns)
+{
+  uint64_t start = monotonic_clock::now();
+  for (;;)
+  {
+    if (spin_ns > 0)
+    {
+      // Poll the task. May throw an exception.
+      task_->run(false, this_thread.private_op_queue);
+      if (!this_thread.private_op_queue.empty())
+        return;
+    }
+
+    lock.lock();
+    if (!op_queue_.empty() || stopped_)
+    {
+      lock.unlock();
+      return;
+    }
+
+    if (monotonic_clock::now() - start >= spin_ns)
+    {
+      // Nothing arrived while spinning. Make the next spin shorter, and give
+      // up on spinning altogether once the period becomes insignificant.
+      uint64_t max_ns = busy_poll_max_ns_;
+      bool adaptive = busy_poll_adaptive_;
+      if (adaptive && spin_ns > 0)
+      {
+        busy_poll_ns_ = spin_ns / 2;
+        if (busy_poll_ns_ < max_ns / 16)
+          busy_poll_ns_ = 0;
+      }
+
+      // Let other threads interrupt the task from now on.
+      task_interrupted_ = false;
+      lock.unlock();
+
+      // Block in the task. May throw an exception.
+      uint64_t block_start = monotonic_clock::now();
+      task_->run(true, this_thread.private_op_queue);
+
+      // Spinning would have caught work that arrived this soon, so make the
+      // next spin longer.
+      if (adaptive && monotonic_clock::now() - block_start < max_ns)
+      {
+        lock.lock();
+        if (busy_poll_ns_ < busy_poll_max_ns_)
+        {
+          busy_poll_ns_ = busy_poll_ns_ > 0
+            ? busy_poll_ns_ * 2 : busy_poll_max_ns_ / 16;
+          if (busy_poll_ns_ > busy_poll_max_ns_ || busy_poll_ns_ == 0)
+            busy_poll_ns_ = busy_poll_max_ns_;
+        }
+        lock.unlock();
+      }
+      return;
+    }
+
+    lock.unlock();
+  }
+}
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+std::size_t task_io_service::do_run_local_one(mutex::scoped_lock& lock,
+    task_io_service::thread_info& this_thread,
+    const boost::system::error_code& ec)
+{
+  mutex::scoped_lock local_lock(this_thread.local_mutex);
+  if (this_thread.local_stopped || this_thread.local_op_queue.empty())
+    return 0;
+
+  operation* o = this_thread.local_op_queue.front();
+  this_thread.local_op_queue.pop();
+  local_lock.unlock();
+
+  std::size_t task_result = o->task_result_;
+
+  // Ensure the count of outstanding work is decremented on block exit.
+  work_cleanup on_exit = { this, &lock, &this_thread };
+  (void)on_exit;
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  handler_metrics on_complete(this_thread);
+  (void)on_complete;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+  // Complete the operation. May throw an exception. Deletes the object.
+  o->complete(*this, ec, task_result);
+
+  return 1;
+}
+
+bool task_io_service::steal_operations(task_io_service::thread_info& this_thread)
+{
+  bool stolen = false;
+  for (thread_info* victim = first_runner_; victim; victim = victim->next_runner)
+  {
+    if (victim == &this_thread)
+      continue;
+
+    // Take every second operation, leaving the rest for the owner.
+    mutex::scoped_lock victim_lock(victim->local_mutex);
+    op_queue<operation> kept;
+    bool take = false;
+    while (operation* o = victim->local_op_queue.front())
+    {
+      victim->local_op_queue.pop();
+      if ((take = !take))
+      {
+        op_queue_.push(o);
+        stolen = true;
+      }
+      else
+        kept.push(o);
+    }
+    victim->local_op_queue.push(kept);
+
+    if (stolen)
+      return true;
+  }
+  return false;
+}
+
+void task_io_service::push_local_operations(mutex::scoped_lock& lock,
+    task_io_service::thread_info& this_thread)
+{
+  mutex::scoped_lock local_lock(this_thread.local_mutex);
+  bool was_empty = this_thread.local_op_queue.empty();
+  this_thread.local_op_queue.push(this_thread.private_op_queue);
+  local_lock.unlock();
+
+  // A thread that finds the queue non-empty takes part of it, so another
+  // thread only needs to be told when the queue stops being empty. That
+  // thread may be idle, or blocked in the task.
+  if (was_empty && (idle_thread_count_ > 0 || task_thread_count_ > 0))
+  {
+    lock.lock();
+    wake_one_thread_and_unlock(lock);
+  }
+}
+
+void task_io_service::requeue_local_operations(mutex::scoped_lock& lock,
+    task_io_service::thread_info& this_thread)
+{
+  mutex::scoped_lock local_lock(this_thread.local_mutex);
+  op_queue<operation> ops;
+  ops.push(this_thread.local_op_queue);
+  local_lock.unlock();
+
+  if (!ops.empty())
+  {
+    lock.lock();
+    op_queue_.push(ops);
+    lock.unlock();
+  }
+}
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
 void task_io_service::stop_all_threads(
     mutex::scoped_lock& lock)
 {
   stopped_ = true;
 
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  for (thread_info* t = first_runner_; t; t = t->next_runner)
+  {
+    mutex::scoped_lock local_lock(t->local_mutex);
+    t->local_stopped = true;
+  }
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
   while (first_idle_thread_)
   {
     thread_info* idle_thread = first_idle_thread_;
     first_idle_thread_ = idle_thread->next;
     idle_thread->next = 0;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+    --idle_thread_count_;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
     idle_thread->wakeup_event->signal(lock);
   }
 
@@ -481,6 +989,12 @@ bool task_io_service::wake_one_idle_thread_and_unlock(
     thread_info* idle_thread = first_idle_thread_;
     first_idle_thread_ = idle_thread->next;
     idle_thread->next = 0;
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+    --idle_thread_count_;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+#if defined(BOOST_ASIO_HAS_METRICS)
+    thread_wakeups_.add(1);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
     idle_thread->wakeup_event->signal_and_unlock(lock);
     return true;
   }
@@ -495,6 +1009,9 @@ void task_io_service::wake_one_thread_and_unlock(
     if (!task_interrupted_ && task_)
     {
       task_interrupted_ = true;
+#if defined(BOOST_ASIO_HAS_METRICS)
+      reactor_interrupts_.add(1);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
       task_->interrupt();
     }
     lock.unlock();
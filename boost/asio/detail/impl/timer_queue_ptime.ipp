@@ -30,6 +30,12 @@ timer_queue<time_traits<boost::posix_time::ptime> >::timer_queue()
 {
 }
 
+timer_queue<time_traits<boost::posix_time::ptime> >::timer_queue(
+    long wheel_resolution)
+  : impl_(wheel_resolution)
+{
+}
+
 timer_queue<time_traits<boost::posix_time::ptime> >::~timer_queue()
 {
 }
@@ -45,6 +51,14 @@ bool timer_queue<time_traits<boost::posix_time::ptime> >::empty() const
   return impl_.empty();
 }
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+std::size_t
+timer_queue<time_traits<boost::posix_time::ptime> >::pending_timers() const
+{
+  return impl_.pending_timers();
+}
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 long timer_queue<time_traits<boost::posix_time::ptime> >::wait_duration_msec(
     long max_duration) const
 {
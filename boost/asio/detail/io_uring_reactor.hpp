@@ -0,0 +1,337 @@
+//
+// detail/io_uring_reactor.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_IO_URING_REACTOR_HPP
+#define BOOST_ASIO_DETAIL_IO_URING_REACTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_IO_URING)
+
+#include <linux/io_uring.h>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/detail/io_uring_reactor_fwd.hpp>
+#include <boost/asio/detail/limits.hpp>
+#include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/detail/object_pool.hpp>
+#include <boost/asio/detail/op_queue.hpp>
+#include <boost/asio/detail/reactor_op.hpp>
+#include <boost/asio/detail/select_interrupter.hpp>
+#include <boost/asio/detail/socket_types.hpp>
+#include <boost/asio/detail/timer_queue_base.hpp>
+#include <boost/asio/detail/timer_queue_fwd.hpp>
+#include <boost/asio/detail/timer_queue_set.hpp>
+#include <boost/asio/detail/wait_op.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// A reactor built on the Linux io_uring interface. Readiness is obtained by
+// submitting one-shot poll requests through the submission ring, so that
+// registering a descriptor costs no system call and all pending poll requests
+// are submitted in the same io_uring_enter call that waits for completions.
+class io_uring_reactor
+  : public boost::asio::detail::service_base<io_uring_reactor>
+{
+public:
+  enum op_types { read_op = 0, write_op = 1,
+    connect_op = 1, except_op = 2, max_ops = 3 };
+
+  // Per-descriptor queues.
+  class descriptor_state : operation
+  {
+    friend class io_uring_reactor;
+    friend class object_pool_access;
+
+    descriptor_state* next_;
+    descriptor_state* prev_;
+
+    mutex mutex_;
+    io_uring_reactor* reactor_;
+    int descriptor_;
+    op_queue<reactor_op> op_queue_[max_ops];
+    bool shutdown_;
+
+    // Bit mask of the operation types that have a poll request in flight.
+    unsigned polls_armed_;
+
+    // Bit mask of the operation types whose poll request could not be queued
+    // because the submission ring was full.
+    unsigned polls_pending_;
+
+    // The run() invocation that last returned this state for performing.
+    unsigned long batch_;
+
+    BOOST_ASIO_DECL descriptor_state();
+    void set_ready_events(uint32_t events) { task_result_ = events; }
+    BOOST_ASIO_DECL operation* perform_io(uint32_t events);
+    BOOST_ASIO_DECL static void do_complete(
+        io_service_impl* owner, operation* base,
+        const boost::system::error_code& ec, std::size_t bytes_transferred);
+  };
+
+  // Per-descriptor data.
+  typedef descriptor_state* per_descriptor_data;
+
+  // Constructor.
+  BOOST_ASIO_DECL io_uring_reactor(boost::asio::io_service& io_service);
+
+  // Destructor.
+  BOOST_ASIO_DECL ~io_uring_reactor();
+
+  // Destroy all user-defined handler objects owned by the service.
+  BOOST_ASIO_DECL void shutdown_service();
+
+  // Recreate internal descriptors following a fork.
+  BOOST_ASIO_DECL void fork_service(
+      boost::asio::io_service::fork_event fork_ev);
+
+  // Initialise the task.
+  BOOST_ASIO_DECL void init_task();
+
+  // Register a socket with the reactor. Returns 0 on success, system error
+  // code on failure.
+  BOOST_ASIO_DECL int register_descriptor(socket_type descriptor,
+      per_descriptor_data& descriptor_data);
+
+  // Register a descriptor with an associated single operation. Returns 0 on
+  // success, system error code on failure.
+  BOOST_ASIO_DECL int register_internal_descriptor(
+      int op_type, socket_type descriptor,
+      per_descriptor_data& descriptor_data, reactor_op* op);
+
+  // Move descriptor registration from one descriptor_data object to another.
+  BOOST_ASIO_DECL void move_descriptor(socket_type descriptor,
+      per_descriptor_data& target_descriptor_data,
+      per_descriptor_data& source_descriptor_data);
+
+  // Post a reactor operation for immediate completion.
+  void post_immediate_completion(reactor_op* op, bool is_continuation)
+  {
+    io_service_.post_immediate_completion(op, is_continuation);
+  }
+
+  // Start a new operation. The reactor operation will be performed when the
+  // given descriptor is flagged as ready, or an error has occurred.
+  BOOST_ASIO_DECL void start_op(int op_type, socket_type descriptor,
+      per_descriptor_data& descriptor_data, reactor_op* op,
+      bool is_continuation, bool allow_speculative);
+
+  // Cancel all operations associated with the given descriptor. The
+  // handlers associated with the descriptor will be invoked with the
+  // operation_aborted error.
+  BOOST_ASIO_DECL void cancel_ops(socket_type descriptor,
+      per_descriptor_data& descriptor_data);
+
+  // Cancel any operations that are running against the descriptor and remove
+  // its registration from the reactor.
+  BOOST_ASIO_DECL void deregister_descriptor(socket_type descriptor,
+      per_descriptor_data& descriptor_data, bool closing);
+
+  // Remote the descriptor's registration from the reactor.
+  BOOST_ASIO_DECL void deregister_internal_descriptor(
+      socket_type descriptor, per_descriptor_data& descriptor_data);
+
+  // Add a new timer queue to the reactor.
+  template <typename Time_Traits>
+  void add_timer_queue(timer_queue<Time_Traits>& timer_queue);
+
+  // Remove a timer queue from the reactor.
+  template <typename Time_Traits>
+  void remove_timer_queue(timer_queue<Time_Traits>& timer_queue);
+
+  // Schedule a new operation in the given timer queue to expire at the
+  // specified absolute time.
+  template <typename Time_Traits>
+  void schedule_timer(timer_queue<Time_Traits>& queue,
+      const typename Time_Traits::time_type& time,
+      typename timer_queue<Time_Traits>::per_timer_data& timer, wait_op* op);
+
+  // Cancel the timer operations associated with the given token. Returns the
+  // number of operations that have been posted or dispatched.
+  template <typename Time_Traits>
+  std::size_t cancel_timer(timer_queue<Time_Traits>& queue,
+      typename timer_queue<Time_Traits>::per_timer_data& timer,
+      std::size_t max_cancelled = (std::numeric_limits<std::size_t>::max)());
+
+  // Run io_uring once until interrupted or events are ready to be dispatched.
+  BOOST_ASIO_DECL void run(bool block, op_queue<operation>& ops);
+
+  // Interrupt the io_uring wait.
+  BOOST_ASIO_DECL void interrupt();
+
+private:
+  // The number of entries in the submission ring.
+  enum { ring_size = 4096 };
+
+  // Create the ring and map its shared memory. Throws an exception if the
+  // ring cannot be created.
+  BOOST_ASIO_DECL void do_ring_create();
+
+  // Unmap and close the ring.
+  BOOST_ASIO_DECL void do_ring_destroy();
+
+  // Obtain a zeroed submission queue entry, submitting pending entries first
+  // if the ring is full. Returns 0 if no entry is available. Must be called
+  // with mutex_ held.
+  BOOST_ASIO_DECL io_uring_sqe* get_sqe();
+
+  // Make the entry most recently returned by get_sqe visible to the kernel.
+  // Must be called with mutex_ held.
+  BOOST_ASIO_DECL void commit_sqe();
+
+  // Submit all pending entries to the kernel. Returns 0 on success, system
+  // error code on failure. Must be called with mutex_ held.
+  BOOST_ASIO_DECL int submit_sqes();
+
+  // Wrapper for the io_uring_enter system call.
+  BOOST_ASIO_DECL static int do_enter(int fd, unsigned to_submit,
+      unsigned min_complete, unsigned flags);
+
+  // Set the events to be polled for by a submission queue entry.
+  BOOST_ASIO_DECL static void set_poll_events(
+      io_uring_sqe* sqe, unsigned events);
+
+  // Submit pending entries now if a thread is blocked waiting for
+  // completions, as otherwise they would not be seen until it wakes. If the
+  // kernel refuses them, the blocked thread is interrupted so that it submits
+  // them itself. Must be called with mutex_ held.
+  BOOST_ASIO_DECL void flush_if_blocked();
+
+  // Queue a poll request for the interrupter. If the submission ring is full
+  // the interrupter is left unarmed, and run() retries once it has reaped
+  // completions. Must be called with mutex_ held.
+  BOOST_ASIO_DECL void arm_interrupter();
+
+  // Queue a poll request for the given operation type, if one is not already
+  // in flight. If the submission ring is full, run() retries once it has
+  // reaped completions. Must be called with the descriptor's mutex held.
+  BOOST_ASIO_DECL void arm_poll(descriptor_state* descriptor_data, int op_type);
+
+  // Queue removal of all poll requests in flight for a descriptor. If the
+  // submission ring is full, run() retries once it has reaped completions.
+  // Must be called with the descriptor's mutex held.
+  BOOST_ASIO_DECL void disarm_polls(descriptor_state* descriptor_data);
+
+  // Process a completion for a descriptor's poll request.
+  BOOST_ASIO_DECL void complete_poll(descriptor_state* descriptor_data,
+      int op_type, int result, op_queue<operation>& ops);
+
+  // Allocate a new descriptor state object.
+  BOOST_ASIO_DECL descriptor_state* allocate_descriptor_state();
+
+  // Free an existing descriptor state object.
+  BOOST_ASIO_DECL void free_descriptor_state(descriptor_state* s);
+
+  // Helper function to add a new timer queue.
+  BOOST_ASIO_DECL void do_add_timer_queue(timer_queue_base& queue);
+
+  // Helper function to remove a timer queue.
+  BOOST_ASIO_DECL void do_remove_timer_queue(timer_queue_base& queue);
+
+  // Called to recalculate and update the timeout.
+  BOOST_ASIO_DECL void update_timeout();
+
+  // The io_service implementation used to post completions.
+  io_service_impl& io_service_;
+
+  // Mutex to protect access to internal data, including the submission ring.
+  mutex mutex_;
+
+  // The interrupter is used to break a blocking io_uring_enter call.
+  select_interrupter interrupter_;
+
+  // The io_uring file descriptor.
+  int ring_fd_;
+
+  // The mapped submission and completion rings.
+  void* sq_ring_ptr_;
+  std::size_t sq_ring_size_;
+  void* cq_ring_ptr_;
+  std::size_t cq_ring_size_;
+  io_uring_sqe* sqes_;
+  std::size_t sqes_size_;
+
+  // Pointers into the submission ring.
+  unsigned* sq_head_;
+  unsigned* sq_tail_;
+  unsigned* sq_mask_;
+  unsigned* sq_array_;
+  unsigned sq_entries_;
+
+  // Pointers into the completion ring.
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned* cq_mask_;
+  io_uring_cqe* cqes_;
+
+  // Whether a thread is blocked, or about to block, in io_uring_enter.
+  bool blocked_;
+
+  // Whether a poll request for the interrupter has been queued and has not
+  // yet completed. A thread only blocks in io_uring_enter while it is set.
+  bool interrupter_armed_;
+
+  // Whether a descriptor that is being deregistered still has poll requests
+  // in flight for which no removal could be queued.
+  bool removals_pending_;
+
+  // Whether a descriptor has operations waiting for which no poll request
+  // could be queued.
+  bool polls_pending_;
+
+  // The timeout passed to the kernel with the last timeout request.
+  struct __kernel_timespec timeout_;
+
+  // Whether the kernel can change a pending timeout without posting a
+  // completion for the change.
+  bool update_timeout_in_place_;
+
+  // The number of times run() has reaped completions.
+  unsigned long batch_;
+
+  // The timer queues.
+  timer_queue_set timer_queues_;
+
+  // Whether the service has been shut down.
+  bool shutdown_;
+
+  // Mutex to protect access to the registered descriptors.
+  mutex registered_descriptors_mutex_;
+
+  // Keep track of all registered descriptors.
+  object_pool<descriptor_state> registered_descriptors_;
+
+  // Helper class to do post-perform_io cleanup.
+  struct perform_io_cleanup_on_block_exit;
+  friend struct perform_io_cleanup_on_block_exit;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#include <boost/asio/detail/impl/io_uring_reactor.hpp>
+#if defined(BOOST_ASIO_HEADER_ONLY)
+# include <boost/asio/detail/impl/io_uring_reactor.ipp>
+#endif // defined(BOOST_ASIO_HEADER_ONLY)
+
+#endif // defined(BOOST_ASIO_HAS_IO_URING)
+
+#endif // BOOST_ASIO_DETAIL_IO_URING_REACTOR_HPP
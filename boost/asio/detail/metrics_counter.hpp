@@ -0,0 +1,200 @@
+//
+// detail/metrics_counter.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_METRICS_COUNTER_HPP
+#define BOOST_ASIO_DETAIL_METRICS_COUNTER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+
+#include <cstddef>
+#include <boost/asio/detail/cstdint.hpp>
+#include <boost/asio/detail/monotonic_clock.hpp>
+#include <boost/asio/detail/noncopyable.hpp>
+
+#if !defined(BOOST_ASIO_HAS_THREADS)
+// Nothing to include.
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+# include <atomic>
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+# include <boost/atomic.hpp>
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// A counter that may be read at any time by a monitoring thread. All accesses
+// use relaxed ordering, so the value read is only approximately current.
+class metrics_counter
+  : private noncopyable
+{
+public:
+  metrics_counter()
+    : value_(0)
+  {
+  }
+
+  // Add to a counter that has at most one writer at a time. This avoids a
+  // locked instruction on the fast path.
+  void add(std::size_t n)
+  {
+#if !defined(BOOST_ASIO_HAS_THREADS)
+    value_ += n;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    value_.store(value_.load(std::memory_order_relaxed) + n,
+        std::memory_order_relaxed);
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    value_.store(value_.load(boost::memory_order_relaxed) + n,
+        boost::memory_order_relaxed);
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  }
+
+  // Subtract from a counter that has at most one writer at a time.
+  void subtract(std::size_t n)
+  {
+#if !defined(BOOST_ASIO_HAS_THREADS)
+    value_ -= n;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    value_.store(value_.load(std::memory_order_relaxed) - n,
+        std::memory_order_relaxed);
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    value_.store(value_.load(boost::memory_order_relaxed) - n,
+        boost::memory_order_relaxed);
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  }
+
+  // Add to a counter that may have several concurrent writers.
+  void shared_add(std::size_t n)
+  {
+#if !defined(BOOST_ASIO_HAS_THREADS)
+    value_ += n;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    value_.fetch_add(n, std::memory_order_relaxed);
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    value_.fetch_add(n, boost::memory_order_relaxed);
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  }
+
+  std::size_t value() const
+  {
+#if !defined(BOOST_ASIO_HAS_THREADS)
+    return value_;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    return value_.load(std::memory_order_relaxed);
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    return value_.load(boost::memory_order_relaxed);
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  }
+
+private:
+#if !defined(BOOST_ASIO_HAS_THREADS)
+  std::size_t value_;
+#elif defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  std::atomic<std::size_t> value_;
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+  boost::atomic<std::size_t> value_;
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+};
+
+// A histogram with power-of-two buckets. Bucket 0 counts zero values, and
+// bucket i counts values in the range [2^(i-1), 2^i). The last bucket also
+// counts everything larger.
+class metrics_histogram
+  : private noncopyable
+{
+public:
+  enum { buckets = 32 };
+
+  static std::size_t bucket(uint64_t value)
+  {
+    std::size_t b = 0;
+    while (value != 0 && b < buckets - 1)
+    {
+      value >>= 1;
+      ++b;
+    }
+    return b;
+  }
+
+  void add(uint64_t value)
+  {
+    counts_[bucket(value)].add(1);
+  }
+
+  void add_to_bucket(std::size_t b, std::size_t n)
+  {
+    counts_[b].add(n);
+  }
+
+  std::size_t value(std::size_t b) const
+  {
+    return counts_[b].value();
+  }
+
+private:
+  metrics_counter counts_[buckets];
+};
+
+// The metrics owned by a single thread that is running an io_service.
+struct thread_metrics
+  : private noncopyable
+{
+  // Reading the clock costs far more than updating a counter, so only one in
+  // every latency_sample_interval handlers is timed.
+#if defined(BOOST_ASIO_METRICS_LATENCY_SAMPLE_INTERVAL)
+  enum { latency_sample_interval = BOOST_ASIO_METRICS_LATENCY_SAMPLE_INTERVAL };
+#else // defined(BOOST_ASIO_METRICS_LATENCY_SAMPLE_INTERVAL)
+  enum { latency_sample_interval = 32 };
+#endif // defined(BOOST_ASIO_METRICS_LATENCY_SAMPLE_INTERVAL)
+
+  thread_metrics()
+    : latency_countdown(1),
+      next_(0),
+      prev_(0)
+  {
+  }
+
+  // Obtain a monotonic timestamp in nanoseconds.
+  static uint64_t now()
+  {
+    return monotonic_clock::now();
+  }
+
+  // The number of handlers executed by the thread.
+  metrics_counter handlers_executed;
+
+  // The time taken to execute the sampled handlers, in nanoseconds.
+  metrics_histogram handler_latency;
+
+  // The number of handlers to execute before the next one is timed.
+  std::size_t latency_countdown;
+
+  // Links for the io_service's list of threads.
+  thread_metrics* next_;
+  thread_metrics* prev_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+#endif // BOOST_ASIO_DETAIL_METRICS_COUNTER_HPP
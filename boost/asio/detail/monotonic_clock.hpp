@@ -0,0 +1,63 @@
+//
+// detail/monotonic_clock.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_MONOTONIC_CLOCK_HPP
+#define BOOST_ASIO_DETAIL_MONOTONIC_CLOCK_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/detail/cstdint.hpp>
+
+#if defined(BOOST_ASIO_HAS_STD_CHRONO)
+# include <chrono>
+#elif defined(BOOST_ASIO_WINDOWS)
+# include <boost/asio/detail/socket_types.hpp>
+#else // defined(BOOST_ASIO_HAS_STD_CHRONO)
+# include <time.h>
+#endif // defined(BOOST_ASIO_HAS_STD_CHRONO)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// A cheap clock for measuring short intervals inside the implementation.
+class monotonic_clock
+{
+public:
+  // Obtain a monotonic timestamp in nanoseconds.
+  static uint64_t now()
+  {
+#if defined(BOOST_ASIO_HAS_STD_CHRONO)
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count());
+#elif defined(BOOST_ASIO_WINDOWS)
+    return static_cast<uint64_t>(::GetTickCount()) * 1000000;
+#else // defined(BOOST_ASIO_HAS_STD_CHRONO)
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000
+      + static_cast<uint64_t>(ts.tv_nsec);
+#endif // defined(BOOST_ASIO_HAS_STD_CHRONO)
+  }
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_MONOTONIC_CLOCK_HPP
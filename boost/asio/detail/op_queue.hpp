@@ -15,6 +15,8 @@
 # pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
 #include <boost/asio/detail/noncopyable.hpp>
 
 #include <boost/asio/detail/push_options.hpp>
@@ -58,6 +60,14 @@ public:
   {
     return q.back_;
   }
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  template <typename Operation>
+  static std::size_t& size(op_queue<Operation>& q)
+  {
+    return q.size_;
+  }
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 template <typename Operation>
@@ -69,6 +79,9 @@ public:
   op_queue()
     : front_(0),
       back_(0)
+#if defined(BOOST_ASIO_HAS_METRICS)
+      , size_(0)
+#endif // defined(BOOST_ASIO_HAS_METRICS)
   {
   }
 
@@ -98,6 +111,9 @@ public:
       if (front_ == 0)
         back_ = 0;
       op_queue_access::next(tmp, static_cast<Operation*>(0));
+#if defined(BOOST_ASIO_HAS_METRICS)
+      --size_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
     }
   }
 
@@ -114,6 +130,9 @@ public:
     {
       front_ = back_ = h;
     }
+#if defined(BOOST_ASIO_HAS_METRICS)
+    ++size_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
   }
 
   // Push all operations from another queue on to the back of the queue. The
@@ -130,6 +149,10 @@ public:
       back_ = op_queue_access::back(q);
       op_queue_access::front(q) = 0;
       op_queue_access::back(q) = 0;
+#if defined(BOOST_ASIO_HAS_METRICS)
+      size_ += op_queue_access::size(q);
+      op_queue_access::size(q) = 0;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
     }
   }
 
@@ -139,6 +162,14 @@ public:
     return front_ == 0;
   }
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // The number of operations in the queue.
+  std::size_t size() const
+  {
+    return size_;
+  }
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 private:
   friend class op_queue_access;
 
@@ -147,6 +178,11 @@ private:
 
   // The back of the queue.
   Operation* back_;
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // The number of operations in the queue.
+  std::size_t size_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 } // namespace detail
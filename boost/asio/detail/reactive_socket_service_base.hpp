@@ -29,6 +29,7 @@
 #include <boost/asio/detail/reactive_socket_recv_op.hpp>
 #include <boost/asio/detail/reactive_socket_recvmsg_op.hpp>
 #include <boost/asio/detail/reactive_socket_send_op.hpp>
+#include <boost/asio/detail/reactive_socket_sendfile_op.hpp>
 #include <boost/asio/detail/reactor.hpp>
 #include <boost/asio/detail/reactor_op.hpp>
 #include <boost/asio/detail/socket_holder.hpp>
@@ -241,6 +242,38 @@ public:
     p.v = p.p = 0;
   }
 
+#if defined(BOOST_ASIO_HAS_SENDFILE)
+  // Send a region of a file. Returns the number of bytes sent.
+  size_t send_file(base_implementation_type& impl, int file,
+      uint64_t offset, std::size_t count, boost::system::error_code& ec)
+  {
+    return socket_ops::sync_sendfile(impl.socket_,
+        impl.state_, file, offset, count, ec);
+  }
+
+  // Start an asynchronous send of a region of a file. The file descriptor
+  // must remain open for the lifetime of the asynchronous operation.
+  template <typename Handler>
+  void async_send_file(base_implementation_type& impl, int file,
+      uint64_t offset, std::size_t count, Handler handler)
+  {
+    bool is_continuation =
+      boost_asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_socket_sendfile_op<Handler> op;
+    typename op::ptr p = { boost::asio::detail::addressof(handler),
+      boost_asio_handler_alloc_helpers::allocate(
+        sizeof(op), handler), 0 };
+    p.p = new (p.v) op(impl.socket_, file, offset, count, handler);
+
+    BOOST_ASIO_HANDLER_CREATION((p.p, "socket", &impl, "async_send_file"));
+
+    start_op(impl, reactor::write_op, p.p, is_continuation, true, count == 0);
+    p.v = p.p = 0;
+  }
+#endif // defined(BOOST_ASIO_HAS_SENDFILE)
+
   // Receive some data from the peer. Returns the number of bytes received.
   template <typename MutableBufferSequence>
   size_t receive(base_implementation_type& impl,
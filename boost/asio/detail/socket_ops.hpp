@@ -18,6 +18,7 @@
 #include <boost/asio/detail/config.hpp>
 
 #include <boost/system/error_code.hpp>
+#include <boost/asio/detail/cstdint.hpp>
 #include <boost/asio/detail/shared_ptr.hpp>
 #include <boost/asio/detail/socket_types.hpp>
 #include <boost/asio/detail/weak_ptr.hpp>
@@ -195,6 +196,25 @@ BOOST_ASIO_DECL bool non_blocking_recvmsg(socket_type s,
 
 #endif // defined(BOOST_ASIO_HAS_IOCP)
 
+#if !defined(BOOST_ASIO_HAS_IOCP)
+
+BOOST_ASIO_DECL signed_size_type recvmmsg(socket_type s, buf* bufs,
+    size_t count, int flags, socket_addr_type* const* addrs,
+    std::size_t* addrlens, std::size_t* sizes,
+    boost::system::error_code& ec);
+
+BOOST_ASIO_DECL size_t sync_recvmmsg(socket_type s, state_type state,
+    buf* bufs, size_t count, int flags, socket_addr_type* const* addrs,
+    std::size_t* addrlens, std::size_t* sizes,
+    boost::system::error_code& ec);
+
+BOOST_ASIO_DECL bool non_blocking_recvmmsg(socket_type s,
+    buf* bufs, size_t count, int flags, socket_addr_type* const* addrs,
+    std::size_t* addrlens, std::size_t* sizes,
+    boost::system::error_code& ec, size_t& messages_transferred);
+
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
 BOOST_ASIO_DECL signed_size_type send(socket_type s, const buf* bufs,
     size_t count, int flags, boost::system::error_code& ec);
 
@@ -233,6 +253,38 @@ BOOST_ASIO_DECL bool non_blocking_sendto(socket_type s,
 
 #endif // !defined(BOOST_ASIO_HAS_IOCP)
 
+#if !defined(BOOST_ASIO_HAS_IOCP)
+
+BOOST_ASIO_DECL signed_size_type sendmmsg(socket_type s, const buf* bufs,
+    size_t count, int flags, const socket_addr_type* const* addrs,
+    const std::size_t* addrlens, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL size_t sync_sendmmsg(socket_type s, state_type state,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* const* addrs, const std::size_t* addrlens,
+    boost::system::error_code& ec);
+
+BOOST_ASIO_DECL bool non_blocking_sendmmsg(socket_type s,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* const* addrs, const std::size_t* addrlens,
+    boost::system::error_code& ec, size_t& messages_transferred);
+
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
+#if defined(BOOST_ASIO_HAS_SENDFILE)
+
+BOOST_ASIO_DECL signed_size_type sendfile(socket_type s, int file,
+    uint64_t& offset, size_t count, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL size_t sync_sendfile(socket_type s, state_type state,
+    int file, uint64_t offset, size_t count, boost::system::error_code& ec);
+
+BOOST_ASIO_DECL bool non_blocking_sendfile(socket_type s,
+    int file, uint64_t& offset, size_t& remaining,
+    boost::system::error_code& ec, size_t& bytes_transferred);
+
+#endif // defined(BOOST_ASIO_HAS_SENDFILE)
+
 BOOST_ASIO_DECL socket_type socket(int af, int type, int protocol,
     boost::system::error_code& ec);
 
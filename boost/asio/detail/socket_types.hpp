@@ -60,6 +60,9 @@
 # endif
 # include <sys/socket.h>
 # include <sys/uio.h>
+# if defined(BOOST_ASIO_HAS_SENDFILE)
+#  include <sys/sendfile.h>
+# endif // defined(BOOST_ASIO_HAS_SENDFILE)
 # include <sys/un.h>
 # include <netinet/in.h>
 # if !defined(__SYMBIAN32__)
@@ -171,6 +174,8 @@ const int max_iov_len = IOV_MAX;
 const int max_iov_len = 16;
 # endif
 #endif
+// The maximum number of messages in a batched receive or send operation.
+const int max_mmsg_batch = 64;
 const int custom_socket_option_level = 0xA5100000;
 const int enable_connection_aborted_option = 1;
 const int always_fail_option = 2;
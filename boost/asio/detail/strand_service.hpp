@@ -22,6 +22,16 @@
 #include <boost/asio/detail/operation.hpp>
 #include <boost/asio/detail/scoped_ptr.hpp>
 
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+# include <boost/asio/detail/atomic_count.hpp>
+# include <boost/asio/detail/object_pool.hpp>
+# if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+#  include <atomic>
+# else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+#  include <boost/atomic.hpp>
+# endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
 #include <boost/asio/detail/push_options.hpp>
 
 namespace boost {
@@ -47,6 +57,9 @@ public:
   {
   public:
     strand_impl();
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+    ~strand_impl();
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
 
   private:
     // Only this service will have access to the internal values.
@@ -54,6 +67,33 @@ public:
     friend struct on_do_complete_exit;
     friend struct on_dispatch_exit;
 
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+    friend class object_pool_access;
+
+    // Links used by the pool of implementations.
+    strand_impl* next_;
+    strand_impl* prev_;
+
+    // The service that owns this implementation.
+    strand_service* service_;
+
+    // The number of strand objects that refer to this implementation, plus one
+    // while the strand is locked. The implementation is returned to the pool
+    // when the count reaches zero.
+    atomic_count ref_count_;
+
+    // The lock state of the strand. Zero means that the strand is not locked,
+    // and a pointer to the implementation itself means that it is locked with
+    // no waiting handlers. Any other value is the most recently added handler
+    // in a list of handlers that are waiting on the strand, linked in reverse
+    // order of arrival. Handlers are added without locking by any thread, but
+    // the list is only removed by the holder of the strand's lock.
+#if defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    std::atomic<operation*> state_;
+#else // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+    boost::atomic<operation*> state_;
+#endif // defined(BOOST_ASIO_HAS_STD_ATOMIC)
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
     // Mutex to protect access to internal data.
     boost::asio::detail::mutex mutex_;
 
@@ -66,6 +106,7 @@ public:
     // after the next time the strand is scheduled. This queue must only be
     // modified while the mutex is locked.
     op_queue<operation> waiting_queue_;
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
 
     // The handlers that are ready to be run. Logically speaking, these are the
     // handlers that hold the strand's lock. The ready queue is only modified
@@ -84,6 +125,18 @@ public:
   // Construct a new strand implementation.
   BOOST_ASIO_DECL void construct(implementation_type& impl);
 
+  // Construct a strand implementation that refers to the same strand as
+  // another.
+  void copy_construct(implementation_type& impl,
+      const implementation_type& other_impl);
+
+  // Move-construct a new strand implementation.
+  void move_construct(implementation_type& impl,
+      implementation_type& other_impl);
+
+  // Destroy a strand implementation.
+  void destroy(implementation_type& impl);
+
   // Request the io_service to invoke the given handler.
   template <typename Handler>
   void dispatch(implementation_type& impl, Handler& handler);
@@ -109,9 +162,36 @@ private:
       operation* base, const boost::system::error_code& ec,
       std::size_t bytes_transferred);
 
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+  // Acquire the strand lock on behalf of the given handler if the strand is
+  // not locked. Otherwise, add the handler to the strand's waiting list.
+  // Returns true if the lock was acquired.
+  BOOST_ASIO_DECL static bool do_lock(strand_impl* impl, operation* op);
+
+  // Move any waiting handlers to the ready queue, or release the strand lock
+  // if there are none. Returns true if the strand remains locked and must be
+  // scheduled again.
+  BOOST_ASIO_DECL static bool do_unlock(strand_impl* impl);
+
+  // Drop a reference to an implementation, returning it to the pool if no
+  // references remain.
+  BOOST_ASIO_DECL static void do_release(strand_impl* impl);
+
+  // Move a list of waiting handlers to a queue, in order of arrival.
+  BOOST_ASIO_DECL static void push_waiting(
+      op_queue<operation>& ops, operation* list);
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
   // The io_service implementation used to post completions.
   io_service_impl& io_service_;
 
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+  // Mutex to protect access to the pool of implementations.
+  boost::asio::detail::mutex mutex_;
+
+  // Pool of implementations, one for each distinct strand.
+  object_pool<strand_impl> implementations_;
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
   // Mutex to protect access to the array of implementations.
   boost::asio::detail::mutex mutex_;
 
@@ -128,6 +208,7 @@ private:
   // Extra value used when hashing to prevent recycled memory locations from
   // getting the same strand implementation.
   std::size_t salt_;
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
 };
 
 } // namespace detail
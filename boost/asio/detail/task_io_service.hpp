@@ -23,16 +23,27 @@
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/detail/atomic_count.hpp>
 #include <boost/asio/detail/call_stack.hpp>
+#include <boost/asio/detail/cstdint.hpp>
 #include <boost/asio/detail/mutex.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/reactor_fwd.hpp>
 #include <boost/asio/detail/task_io_service_fwd.hpp>
 #include <boost/asio/detail/task_io_service_operation.hpp>
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+# include <boost/asio/detail/metrics_counter.hpp>
+# include <boost/asio/detail/timer_queue_base.hpp>
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 #include <boost/asio/detail/push_options.hpp>
 
 namespace boost {
 namespace asio {
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+struct io_service_metrics;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 namespace detail {
 
 class task_io_service
@@ -117,6 +128,21 @@ public:
   // Assumes that work_started() was previously called for the operations.
   BOOST_ASIO_DECL void abandon_operations(op_queue<operation>& ops);
 
+  // Make the thread running the task poll for up to the given number of
+  // nanoseconds before blocking. A period of zero disables busy polling.
+  BOOST_ASIO_DECL void set_busy_poll(uint64_t spin_ns, bool adaptive);
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // Include the timers in the given queue in the metrics.
+  BOOST_ASIO_DECL void register_timer_queue(timer_queue_base& queue);
+
+  // Stop including the timers in the given queue in the metrics.
+  BOOST_ASIO_DECL void unregister_timer_queue(timer_queue_base& queue);
+
+  // Add the current metrics to the given snapshot.
+  BOOST_ASIO_DECL void get_metrics(io_service_metrics& m);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 private:
   // Structure containing information about an idle thread.
   typedef task_io_service_thread_info thread_info;
@@ -133,6 +159,39 @@ private:
   BOOST_ASIO_DECL std::size_t do_poll_one(mutex::scoped_lock& lock,
       thread_info& this_thread, const boost::system::error_code& ec);
 
+  // Run the task without blocking until it produces operations, a handler is
+  // posted or the spin period elapses, then block. Must be called without the
+  // mutex held, and with task_interrupted_ set so that other threads do not
+  // interrupt the task while it spins.
+  BOOST_ASIO_DECL void run_task_spinning(mutex::scoped_lock& lock,
+      thread_info& this_thread, uint64_t spin_ns);
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  // Run at most one operation from the thread's local queue. Never blocks and
+  // does not acquire the shared mutex.
+  BOOST_ASIO_DECL std::size_t do_run_local_one(mutex::scoped_lock& lock,
+      thread_info& this_thread, const boost::system::error_code& ec);
+
+  // Move operations from the local queues of other threads on to the shared
+  // queue. Must be called with the mutex held. Returns true if any operations
+  // were stolen.
+  BOOST_ASIO_DECL bool steal_operations(thread_info& this_thread);
+
+  // Move the thread's private operations on to its local queue and wake an
+  // idle thread, or interrupt the task, so that they may be stolen.
+  BOOST_ASIO_DECL void push_local_operations(mutex::scoped_lock& lock,
+      thread_info& this_thread);
+
+  // Move the operations remaining on the thread's local queue on to the
+  // shared queue. Must be called without the mutex held.
+  BOOST_ASIO_DECL void requeue_local_operations(mutex::scoped_lock& lock,
+      thread_info& this_thread);
+
+  // The maximum number of handlers run from a thread's local queue before the
+  // shared queue is serviced again.
+  enum { max_local_handlers = 64 };
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
   // Stop the task and all idle threads.
   BOOST_ASIO_DECL void stop_all_threads(mutex::scoped_lock& lock);
 
@@ -154,6 +213,27 @@ private:
   struct work_cleanup;
   friend struct work_cleanup;
 
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  // Helper class to add a thread to the list of runners for the duration of a
+  // run() or run_one() call.
+  struct runner_registration;
+  friend struct runner_registration;
+
+  // Helper class to count a thread as running the task until block exit.
+  struct task_thread_counter;
+  friend struct task_thread_counter;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // Helper class to add a thread's metrics to the list of running threads for
+  // the duration of a run(), run_one(), poll() or poll_one() call.
+  struct metrics_registration;
+  friend struct metrics_registration;
+
+  // Helper class to record the execution of a handler on block exit.
+  struct handler_metrics;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
   // Whether to optimise for single-threaded use cases.
   const bool one_thread_;
 
@@ -189,6 +269,48 @@ private:
 
   // The threads that are currently idle.
   thread_info* first_idle_thread_;
+
+  // The maximum time for which the task is polled before it blocks, in
+  // nanoseconds, and the current period if it is adapted to the traffic. Only
+  // modified while holding the mutex.
+  uint64_t busy_poll_max_ns_;
+  uint64_t busy_poll_ns_;
+  bool busy_poll_adaptive_;
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  // The number of threads that are currently idle. May be read without
+  // holding the mutex to decide whether a wakeup is worthwhile.
+  atomic_count idle_thread_count_;
+
+  // The number of threads that are running, or about to run, the task. May
+  // be read without holding the mutex to decide whether an interrupt is
+  // worthwhile.
+  atomic_count task_thread_count_;
+
+  // The threads that own a local queue that may be stolen from.
+  thread_info* first_runner_;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // The metrics of the threads that are currently running the io_service.
+  thread_metrics* first_thread_metrics_;
+
+  // The totals from threads that have returned from the io_service. Only
+  // modified while holding the mutex.
+  metrics_counter retired_handlers_executed_;
+  metrics_histogram retired_handler_latency_;
+
+  // Reactor metrics. Only one thread runs the task at a time.
+  metrics_counter reactor_runs_;
+  metrics_histogram reactor_batch_sizes_;
+
+  // Wakeup metrics. Only modified while holding the mutex.
+  metrics_counter reactor_interrupts_;
+  metrics_counter thread_wakeups_;
+
+  // The timer queues whose timers are counted by the metrics.
+  timer_queue_base* first_timer_queue_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 } // namespace detail
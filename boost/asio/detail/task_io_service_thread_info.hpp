@@ -16,6 +16,8 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <boost/asio/detail/event.hpp>
+#include <boost/asio/detail/metrics_counter.hpp>
+#include <boost/asio/detail/mutex.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/task_io_service_fwd.hpp>
 #include <boost/asio/detail/thread_info_base.hpp>
@@ -32,6 +34,23 @@ struct task_io_service_thread_info : public thread_info_base
   op_queue<task_io_service_operation> private_op_queue;
   long private_outstanding_work;
   task_io_service_thread_info* next;
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  // Handlers posted by this thread that may be stolen by idle peers.
+  mutex local_mutex;
+  op_queue<task_io_service_operation> local_op_queue;
+  bool local_stopped;
+
+  // Links for the io_service's list of threads that own a local queue.
+  bool is_runner;
+  task_io_service_thread_info* next_runner;
+  task_io_service_thread_info* prev_runner;
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // Counters owned by this thread, readable by a monitoring thread.
+  thread_metrics metrics;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 } // namespace detail
@@ -15,8 +15,8 @@
 # pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
-#include <climits>
 #include <cstddef>
+#include <boost/asio/detail/handler_memory_stats.hpp>
 #include <boost/asio/detail/noncopyable.hpp>
 
 #include <boost/asio/detail/push_options.hpp>
@@ -25,54 +25,90 @@ namespace boost {
 namespace asio {
 namespace detail {
 
+// Caches handler memory for the thread running the io_service. Requests are
+// rounded up to one of a small number of power-of-two size classes, and each
+// class keeps a bounded list of free blocks. All blocks are obtained from
+// ::operator new, so a block may be freed by a different thread from the one
+// that allocated it, or by no io_service thread at all.
 class thread_info_base
   : private noncopyable
 {
 public:
+  enum
+  {
+    // The size of the smallest class. Each subsequent class is twice the size
+    // of the one before it.
+    min_block_size = 64,
+
+    // The number of size classes. Larger requests are not cached.
+    size_classes = 6,
+    max_block_size = min_block_size << (size_classes - 1),
+
+    // The maximum number of free blocks retained in each class.
+    max_cached_blocks = 16
+  };
+
   thread_info_base()
-    : reusable_memory_(0)
   {
+    for (std::size_t i = 0; i < size_classes; ++i)
+    {
+      free_blocks_[i] = 0;
+      num_free_blocks_[i] = 0;
+    }
   }
 
   ~thread_info_base()
   {
-    if (reusable_memory_)
-      ::operator delete(reusable_memory_);
+    for (std::size_t i = 0; i < size_classes; ++i)
+    {
+      while (block* b = free_blocks_[i])
+      {
+        free_blocks_[i] = b->next_;
+        ::operator delete(b);
+      }
+    }
   }
 
   static void* allocate(thread_info_base* this_thread, std::size_t size)
   {
-    if (this_thread && this_thread->reusable_memory_)
-    {
-      void* const pointer = this_thread->reusable_memory_;
-      this_thread->reusable_memory_ = 0;
+    BOOST_ASIO_HANDLER_MEMORY_STAT(allocations);
 
-      unsigned char* const mem = static_cast<unsigned char*>(pointer);
-      if (static_cast<std::size_t>(mem[0]) >= size)
-      {
-        mem[size] = mem[0];
-        return pointer;
-      }
+    if (size > max_block_size)
+    {
+      BOOST_ASIO_HANDLER_MEMORY_STAT(oversized);
+      return ::operator new(size);
+    }
 
-      ::operator delete(pointer);
+    std::size_t c = size_class(size);
+    if (this_thread && this_thread->free_blocks_[c])
+    {
+      BOOST_ASIO_HANDLER_MEMORY_STAT(cache_hits);
+      block* b = this_thread->free_blocks_[c];
+      this_thread->free_blocks_[c] = b->next_;
+      --this_thread->num_free_blocks_[c];
+      return b;
     }
 
-    void* const pointer = ::operator new(size + 1);
-    unsigned char* const mem = static_cast<unsigned char*>(pointer);
-    mem[size] = (size <= UCHAR_MAX) ? static_cast<unsigned char>(size) : 0;
-    return pointer;
+    // Always allocate the full class size, as the block may later be cached
+    // by a thread that hands it out for any request in the same class.
+    return ::operator new(static_cast<std::size_t>(min_block_size) << c);
   }
 
   static void deallocate(thread_info_base* this_thread,
       void* pointer, std::size_t size)
   {
-    if (size <= UCHAR_MAX)
+    BOOST_ASIO_HANDLER_MEMORY_STAT(deallocations);
+
+    if (this_thread && size <= max_block_size)
     {
-      if (this_thread && this_thread->reusable_memory_ == 0)
+      std::size_t c = size_class(size);
+      if (this_thread->num_free_blocks_[c] < max_cached_blocks)
       {
-        unsigned char* const mem = static_cast<unsigned char*>(pointer);
-        mem[0] = mem[size];
-        this_thread->reusable_memory_ = pointer;
+        BOOST_ASIO_HANDLER_MEMORY_STAT(cache_returns);
+        block* b = static_cast<block*>(pointer);
+        b->next_ = this_thread->free_blocks_[c];
+        this_thread->free_blocks_[c] = b;
+        ++this_thread->num_free_blocks_[c];
         return;
       }
     }
@@ -81,7 +117,23 @@ public:
   }
 
 private:
-  void* reusable_memory_;
+  // Find the smallest class that can hold a block of the given size.
+  static std::size_t size_class(std::size_t size)
+  {
+    std::size_t c = 0;
+    while ((static_cast<std::size_t>(min_block_size) << c) < size)
+      ++c;
+    return c;
+  }
+
+  // A free block is linked through its first bytes.
+  struct block
+  {
+    block* next_;
+  };
+
+  block* free_blocks_[size_classes];
+  std::size_t num_free_blocks_[size_classes];
 };
 
 } // namespace detail
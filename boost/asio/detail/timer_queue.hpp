@@ -16,11 +16,13 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include <boost/asio/detail/config.hpp>
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 #include <boost/asio/detail/cstdint.hpp>
 #include <boost/asio/detail/date_time_fwd.hpp>
 #include <boost/asio/detail/limits.hpp>
+#include <boost/asio/detail/metrics_counter.hpp>
 #include <boost/asio/detail/op_queue.hpp>
 #include <boost/asio/detail/timer_queue_base.hpp>
 #include <boost/asio/detail/wait_op.hpp>
@@ -47,7 +49,7 @@ public:
   class per_timer_data
   {
   public:
-    per_timer_data() : next_(0), prev_(0) {}
+    per_timer_data() : next_(0), prev_(0), wheel_next_(0), wheel_prev_(0) {}
 
   private:
     friend class timer_queue;
@@ -55,26 +57,59 @@ public:
     // The operations waiting on the timer.
     op_queue<wait_op> op_queue_;
 
-    // The index of the timer in the heap.
+    // The index of the timer in the heap, or of its slot in the wheel.
     std::size_t heap_index_;
 
     // Pointers to adjacent timers in a linked list.
     per_timer_data* next_;
     per_timer_data* prev_;
+
+    // The wheel tick at which the timer expires.
+    int64_t wheel_tick_;
+
+    // Pointers to adjacent timers in the same wheel slot.
+    per_timer_data* wheel_next_;
+    per_timer_data* wheel_prev_;
   };
 
-  // Constructor.
+  // Constructor. Timers are kept in a binary heap.
   timer_queue()
     : timers_(),
-      heap_()
+      heap_(),
+      wheel_resolution_(0),
+      wheel_epoch_(),
+      wheel_current_(0),
+      wheel_hint_(0),
+      wheel_count_(0),
+      wheel_()
   {
   }
 
+  // Constructor. If wheel_resolution is non-zero, timers are kept in a
+  // hierarchical timing wheel with the given tick length in microseconds.
+  // Insertion and cancellation are then constant time, at the cost of timers
+  // firing up to one tick after their expiry time.
+  explicit timer_queue(long wheel_resolution)
+    : timers_(),
+      heap_(),
+      wheel_resolution_(wheel_resolution > 0 ? wheel_resolution : 0),
+      wheel_epoch_(Time_Traits::now()),
+      wheel_current_(0),
+      wheel_hint_((std::numeric_limits<int64_t>::max)()),
+      wheel_count_(0),
+      wheel_()
+  {
+    if (wheel_resolution_)
+      wheel_.resize(wheel_slots, 0);
+  }
+
   // Add a new timer to the queue. Returns true if this is the timer that is
   // earliest in the queue, in which case the reactor's event demultiplexing
   // function call may need to be interrupted and restarted.
   bool enqueue_timer(const time_type& time, per_timer_data& timer, wait_op* op)
   {
+    bool earliest = false;
+
     // Enqueue the timer object.
     if (timer.prev_ == 0 && &timer != timers_)
     {
@@ -83,6 +118,33 @@ public:
         // No heap entry is required for timers that never expire.
         timer.heap_index_ = (std::numeric_limits<std::size_t>::max)();
       }
+      else if (wheel_resolution_)
+      {
+        // Put the new timer into the wheel slot for its expiry tick. Only a
+        // timer that is earlier than the last reported wait duration needs
+        // to interrupt the reactor.
+        timer.wheel_tick_ = to_wheel_tick(time);
+        if (timer.wheel_tick_ <= wheel_current_)
+        {
+          // Either the timer has already expired, or the clock has gone
+          // backwards and the tick must be worked out again once the wheel
+          // has been moved back.
+          const time_type now = Time_Traits::now();
+          int64_t elapsed = wheel_elapsed(now);
+          if (wheel_behind(elapsed))
+          {
+            wheel_rebase(now, elapsed);
+            timer.wheel_tick_ = to_wheel_tick(time);
+          }
+        }
+        wheel_link(timer);
+        ++wheel_count_;
+        if (timer.wheel_tick_ < wheel_hint_)
+        {
+          wheel_hint_ = timer.wheel_tick_;
+          earliest = true;
+        }
+      }
       else
       {
         // Put the new timer at the correct position in the heap. This is done
@@ -99,12 +161,17 @@ public:
       if (timers_)
         timers_->prev_ = &timer;
       timers_ = &timer;
+#if defined(BOOST_ASIO_HAS_METRICS)
+      pending_timers_.add(1);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
     }
 
     // Enqueue the individual timer operation.
     timer.op_queue_.push(op);
 
     // Interrupt reactor only if newly added timer is first to expire.
+    if (wheel_resolution_)
+      return earliest;
     return timer.heap_index_ == 0 && timer.op_queue_.front() == op;
   }
 
@@ -114,9 +181,25 @@ public:
     return timers_ == 0;
   }
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // Get the number of timers in the queue. May be called from any thread.
+  virtual std::size_t pending_timers() const
+  {
+    return pending_timers_.value();
+  }
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
   // Get the time for the timer that is earliest in the queue.
   virtual long wait_duration_msec(long max_duration) const
   {
+    if (wheel_resolution_)
+    {
+      int64_t usec = 0;
+      if (!wheel_wait_duration(usec))
+        return max_duration;
+      return this->wheel_clamp(usec, 1000, max_duration);
+    }
+
     if (heap_.empty())
       return max_duration;
 
@@ -129,6 +212,14 @@ public:
   // Get the time for the timer that is earliest in the queue.
   virtual long wait_duration_usec(long max_duration) const
   {
+    if (wheel_resolution_)
+    {
+      int64_t usec = 0;
+      if (!wheel_wait_duration(usec))
+        return max_duration;
+      return this->wheel_clamp(usec, 1, max_duration);
+    }
+
     if (heap_.empty())
       return max_duration;
 
@@ -141,6 +232,12 @@ public:
   // Dequeue all timers not later than the current time.
   virtual void get_ready_timers(op_queue<operation>& ops)
   {
+    if (wheel_resolution_)
+    {
+      wheel_advance(ops);
+      return;
+    }
+
     if (!heap_.empty())
     {
       const time_type now = Time_Traits::now();
@@ -163,9 +260,20 @@ public:
       ops.push(timer->op_queue_);
       timer->next_ = 0;
       timer->prev_ = 0;
+      timer->wheel_next_ = 0;
+      timer->wheel_prev_ = 0;
+#if defined(BOOST_ASIO_HAS_METRICS)
+      pending_timers_.subtract(1);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
     }
 
     heap_.clear();
+
+    if (wheel_resolution_)
+    {
+      std::fill(wheel_.begin(), wheel_.end(), static_cast<per_timer_data*>(0));
+      wheel_count_ = 0;
+    }
   }
 
   // Cancel and dequeue operations for the given timer.
@@ -234,9 +342,20 @@ private:
   // Remove a timer from the heap and list of timers.
   void remove_timer(per_timer_data& timer)
   {
-    // Remove the timer from the heap.
+    // Remove the timer from the wheel.
     std::size_t index = timer.heap_index_;
-    if (!heap_.empty() && index < heap_.size())
+    if (wheel_resolution_)
+    {
+      if (index < wheel_.size())
+      {
+        wheel_unlink(timer);
+        timer.heap_index_ = (std::numeric_limits<std::size_t>::max)();
+        --wheel_count_;
+      }
+    }
+
+    // Remove the timer from the heap.
+    else if (!heap_.empty() && index < heap_.size())
     {
       if (index == heap_.size() - 1)
       {
@@ -264,6 +383,9 @@ private:
       timer.next_->prev_= timer.prev_;
     timer.next_ = 0;
     timer.prev_ = 0;
+#if defined(BOOST_ASIO_HAS_METRICS)
+    pending_timers_.subtract(1);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
   }
 
   // Determine if the specified absolute time is positive infinity.
@@ -309,6 +431,277 @@ private:
     return static_cast<long>(usec);
   }
 
+  // Helper function to convert a wheel wait duration in microseconds into
+  // the given units.
+  static long wheel_clamp(int64_t usec, int64_t units, long max_duration)
+  {
+    if (usec <= 0)
+      return 0;
+    int64_t value = usec / units;
+    if (value == 0)
+      return 1;
+    if (value > max_duration)
+      return max_duration;
+    return static_cast<long>(value);
+  }
+
+  // The number of slots in the first level of the wheel, and in each of the
+  // higher levels. Together the levels cover 2^32 ticks.
+  enum
+  {
+    wheel_bits_0 = 8,
+    wheel_bits_n = 6,
+    wheel_levels = 5,
+    wheel_size_0 = 1 << wheel_bits_0,
+    wheel_size_n = 1 << wheel_bits_n,
+    wheel_slots = wheel_size_0 + (wheel_levels - 1) * wheel_size_n
+  };
+
+  // Get the number of microseconds elapsed between the wheel's epoch and the
+  // given time.
+  int64_t wheel_elapsed(const time_type& time) const
+  {
+    return Time_Traits::to_posix_duration(
+        Time_Traits::subtract(time, wheel_epoch_)).total_microseconds();
+  }
+
+  // Convert an absolute time into the first tick not earlier than that time.
+  int64_t to_wheel_tick(const time_type& time) const
+  {
+    int64_t usec = wheel_elapsed(time);
+    if (usec <= 0)
+      return 0;
+    return (usec + wheel_resolution_ - 1) / wheel_resolution_;
+  }
+
+  // Get the slot at the given level that covers the given tick.
+  static std::size_t wheel_slot(int level, int64_t tick)
+  {
+    if (level == 0)
+      return static_cast<std::size_t>(tick & (wheel_size_0 - 1));
+    int shift = wheel_bits_0 + (level - 1) * wheel_bits_n;
+    return wheel_size_0 + (level - 1) * wheel_size_n
+      + static_cast<std::size_t>((tick >> shift) & (wheel_size_n - 1));
+  }
+
+  // Link a timer into the slot matching its distance from the current tick.
+  void wheel_link(per_timer_data& timer)
+  {
+    int64_t tick = timer.wheel_tick_;
+    int64_t delta = tick - wheel_current_;
+    std::size_t slot;
+    if (delta < 0)
+    {
+      // Already expired. Fire on the next tick to be processed.
+      slot = wheel_slot(0, wheel_current_);
+    }
+    else if (delta < wheel_size_0)
+    {
+      slot = wheel_slot(0, tick);
+    }
+    else
+    {
+      int level = 1;
+      while (level < wheel_levels - 1
+          && delta >= (static_cast<int64_t>(1)
+            << (wheel_bits_0 + level * wheel_bits_n)))
+        ++level;
+
+      // Timers beyond the range of the wheel wait in the top level and are
+      // relinked each time they are cascaded down.
+      int64_t range = static_cast<int64_t>(1)
+        << (wheel_bits_0 + level * wheel_bits_n);
+      if (delta >= range)
+        tick = wheel_current_ + range - 1;
+
+      slot = wheel_slot(level, tick);
+    }
+
+    timer.heap_index_ = slot;
+    timer.wheel_prev_ = 0;
+    timer.wheel_next_ = wheel_[slot];
+    if (wheel_[slot])
+      wheel_[slot]->wheel_prev_ = &timer;
+    wheel_[slot] = &timer;
+  }
+
+  // Unlink a timer from its wheel slot.
+  void wheel_unlink(per_timer_data& timer)
+  {
+    if (wheel_[timer.heap_index_] == &timer)
+      wheel_[timer.heap_index_] = timer.wheel_next_;
+    if (timer.wheel_prev_)
+      timer.wheel_prev_->wheel_next_ = timer.wheel_next_;
+    if (timer.wheel_next_)
+      timer.wheel_next_->wheel_prev_ = timer.wheel_prev_;
+    timer.wheel_next_ = 0;
+    timer.wheel_prev_ = 0;
+  }
+
+  // Move the timers in the higher level slots that cover the current tick
+  // down into lower levels. Called whenever the first level wraps around.
+  void wheel_cascade()
+  {
+    for (int level = 1; level < wheel_levels; ++level)
+    {
+      std::size_t slot = wheel_slot(level, wheel_current_);
+      per_timer_data* timer = wheel_[slot];
+      wheel_[slot] = 0;
+      while (timer)
+      {
+        per_timer_data* next = timer->wheel_next_;
+        wheel_link(*timer);
+        timer = next;
+      }
+
+      // Higher levels are only cascaded when this one wraps around.
+      if (slot != wheel_slot(level, 0))
+        break;
+    }
+  }
+
+  // Whether the clock, given as the number of microseconds elapsed since the
+  // wheel's epoch, has gone backwards since the wheel was last advanced.
+  bool wheel_behind(int64_t elapsed) const
+  {
+    return elapsed < 0 || elapsed < (wheel_current_ - 1) * wheel_resolution_;
+  }
+
+  // Move the wheel back to the current time after the clock has gone
+  // backwards, and relink every timer relative to the new current tick.
+  // Timers keep their expiry ticks, so they fire when the clock reaches their
+  // expiry time again, as they would in the heap.
+  void wheel_rebase(const time_type& now, int64_t elapsed)
+  {
+    // Ticks are not counted before the epoch, so if the clock is now earlier
+    // the epoch moves back too. Rounding the shift up means that no timer
+    // fires early.
+    int64_t shift = 0;
+    if (elapsed < 0)
+    {
+      shift = (wheel_resolution_ - 1 - elapsed) / wheel_resolution_;
+      wheel_epoch_ = now;
+      elapsed = 0;
+    }
+
+    wheel_current_ = elapsed / wheel_resolution_;
+    std::fill(wheel_.begin(), wheel_.end(), static_cast<per_timer_data*>(0));
+    for (per_timer_data* timer = timers_; timer; timer = timer->next_)
+    {
+      if (timer->heap_index_ < wheel_.size())
+      {
+        timer->wheel_tick_ += shift;
+        wheel_link(*timer);
+      }
+    }
+
+    // Make the next timer to be added interrupt the reactor, which may be
+    // waiting for a time computed before the clock went backwards.
+    wheel_hint_ = (std::numeric_limits<int64_t>::max)();
+  }
+
+  // Process all ticks up to and including the current time.
+  void wheel_advance(op_queue<operation>& ops)
+  {
+    const time_type now = Time_Traits::now();
+    int64_t elapsed = wheel_elapsed(now);
+    if (wheel_behind(elapsed))
+    {
+      wheel_rebase(now, elapsed);
+      elapsed = wheel_elapsed(now);
+    }
+
+    int64_t now_tick = elapsed / wheel_resolution_;
+    while (wheel_current_ <= now_tick)
+    {
+      if (wheel_count_ == 0)
+      {
+        wheel_current_ = now_tick + 1;
+        break;
+      }
+
+      if (wheel_slot(0, wheel_current_) == 0)
+        wheel_cascade();
+
+      std::size_t slot = wheel_slot(0, wheel_current_);
+      while (per_timer_data* timer = wheel_[slot])
+      {
+        if (timer->wheel_tick_ > wheel_current_)
+        {
+          // Not yet due. This can only happen for timers that were beyond
+          // the range of the wheel when they were linked.
+          wheel_unlink(*timer);
+          wheel_link(*timer);
+        }
+        else
+        {
+          ops.push(timer->op_queue_);
+          remove_timer(*timer);
+        }
+      }
+
+      ++wheel_current_;
+    }
+
+    wheel_hint_ = wheel_current_;
+  }
+
+  // Get the number of microseconds until the wheel next needs to be
+  // advanced. This is a lower bound on the time until the earliest timer
+  // expires. Returns false if there are no timers in the wheel.
+  bool wheel_wait_duration(int64_t& usec) const
+  {
+    if (wheel_count_ == 0)
+    {
+      wheel_hint_ = (std::numeric_limits<int64_t>::max)();
+      return false;
+    }
+
+    // If the clock has gone backwards, have the reactor call
+    // get_ready_timers() at once so that the wheel is moved back.
+    int64_t elapsed = wheel_elapsed(Time_Traits::now());
+    if (wheel_behind(elapsed))
+    {
+      wheel_hint_ = wheel_current_;
+      usec = 0;
+      return true;
+    }
+
+    // Find the nearest occupied slot in the first level, and the tick at
+    // which the nearest occupied slot in each higher level is cascaded.
+    int64_t next_tick = (std::numeric_limits<int64_t>::max)();
+    for (int64_t tick = wheel_current_;
+        tick < wheel_current_ + wheel_size_0; ++tick)
+    {
+      if (wheel_[wheel_slot(0, tick)])
+      {
+        next_tick = tick;
+        break;
+      }
+    }
+
+    for (int level = 1; level < wheel_levels; ++level)
+    {
+      int shift = wheel_bits_0 + (level - 1) * wheel_bits_n;
+      int64_t base = wheel_current_ >> shift;
+      for (int64_t i = 1; i <= wheel_size_n; ++i)
+      {
+        int64_t tick = (base + i) << shift;
+        if (tick >= next_tick)
+          break;
+        if (wheel_[wheel_slot(level, tick)])
+        {
+          next_tick = tick;
+          break;
+        }
+      }
+    }
+
+    wheel_hint_ = next_tick;
+    usec = next_tick * wheel_resolution_ - elapsed;
+    return true;
+  }
+
   // The head of a linked list of all active timers.
   per_timer_data* timers_;
 
@@ -323,6 +716,33 @@ private:
 
   // The heap of timers, with the earliest timer at the front.
   std::vector<heap_entry> heap_;
+
+  // The length of a wheel tick in microseconds, or 0 if the heap is used.
+  int64_t wheel_resolution_;
+
+  // The time corresponding to tick 0.
+  time_type wheel_epoch_;
+
+  // The next tick to be processed.
+  int64_t wheel_current_;
+
+  // A lower bound on the tick of the earliest timer, as last reported to the
+  // reactor.
+  mutable int64_t wheel_hint_;
+
+  // The number of timers linked into the wheel.
+  std::size_t wheel_count_;
+
+  // The wheel slots, each the head of a list of timers. The first level
+  // holds one slot per tick; each higher level slot covers a whole
+  // revolution of the level below.
+  std::vector<per_timer_data*> wheel_;
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // The number of timers in the linked list of active timers. Only modified
+  // while holding the lock that protects the queue.
+  metrics_counter pending_timers_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 } // namespace detail
@@ -31,7 +31,13 @@ class timer_queue_base
 {
 public:
   // Constructor.
-  timer_queue_base() : next_(0) {}
+  timer_queue_base()
+    : next_(0)
+#if defined(BOOST_ASIO_HAS_METRICS)
+      , next_metrics_(0)
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+  {
+  }
 
   // Destructor.
   virtual ~timer_queue_base() {}
@@ -51,11 +57,23 @@ public:
   // Dequeue all timers.
   virtual void get_all_timers(op_queue<operation>& ops) = 0;
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // Get the number of timers in the queue. May be called from any thread.
+  virtual std::size_t pending_timers() const = 0;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
 private:
   friend class timer_queue_set;
 
   // Next timer queue in the set.
   timer_queue_base* next_;
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  friend class task_io_service;
+
+  // Next timer queue in the io_service's list of queues to report on.
+  timer_queue_base* next_metrics_;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
 };
 
 } // namespace detail
@@ -0,0 +1,69 @@
+//
+// detail/timer_queue_config.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_DETAIL_TIMER_QUEUE_CONFIG_HPP
+#define BOOST_ASIO_DETAIL_TIMER_QUEUE_CONFIG_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+namespace detail {
+
+// Per-io_service settings consulted by the timer services when they create
+// their timer queues.
+class timer_queue_config
+  : public boost::asio::detail::service_base<timer_queue_config>
+{
+public:
+  // Constructor.
+  timer_queue_config(boost::asio::io_service& io_service)
+    : boost::asio::detail::service_base<timer_queue_config>(io_service),
+      wheel_resolution_(0)
+  {
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown_service()
+  {
+  }
+
+  // Get the tick length, in microseconds, of the timing wheel to be used by
+  // timer queues. A value of 0 selects the heap.
+  long wheel_resolution() const
+  {
+    return wheel_resolution_;
+  }
+
+  // Set the tick length of the timing wheel.
+  void set_wheel_resolution(long usec)
+  {
+    wheel_resolution_ = usec > 0 ? usec : 0;
+  }
+
+private:
+  // The tick length in microseconds.
+  long wheel_resolution_;
+};
+
+} // namespace detail
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_DETAIL_TIMER_QUEUE_CONFIG_HPP
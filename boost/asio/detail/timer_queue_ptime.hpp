@@ -47,6 +47,10 @@ public:
   // Constructor.
   BOOST_ASIO_DECL timer_queue();
 
+  // Constructor. Keep timers in a timing wheel if wheel_resolution is
+  // non-zero.
+  BOOST_ASIO_DECL explicit timer_queue(long wheel_resolution);
+
   // Destructor.
   BOOST_ASIO_DECL virtual ~timer_queue();
 
@@ -59,6 +63,11 @@ public:
   // Whether there are no timers in the queue.
   BOOST_ASIO_DECL virtual bool empty() const;
 
+#if defined(BOOST_ASIO_HAS_METRICS)
+  // Get the number of timers in the queue. May be called from any thread.
+  BOOST_ASIO_DECL virtual std::size_t pending_timers() const;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
   // Get the time for the timer that is earliest in the queue.
   BOOST_ASIO_DECL virtual long wait_duration_msec(long max_duration) const;
 
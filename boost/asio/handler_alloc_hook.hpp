@@ -33,7 +33,9 @@ namespace asio {
  * handlers to provide custom allocation for these temporary objects.
  *
  * The default implementation of these allocation hooks uses <tt>::operator
- * new</tt> and <tt>::operator delete</tt>.
+ * new</tt> and <tt>::operator delete</tt>. When called from a thread that is
+ * running an io_service, small blocks are rounded up to a size class and
+ * recycled through a per-thread cache rather than returned to the heap.
  *
  * @note All temporary objects associated with a handler will be deallocated
  * before the upcall to the handler is performed. This allows the same memory to
@@ -71,6 +73,38 @@ BOOST_ASIO_DECL void* asio_handler_allocate(
 BOOST_ASIO_DECL void asio_handler_deallocate(
     void* pointer, std::size_t size, ...);
 
+#if defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS) \
+  || defined(GENERATING_DOCUMENTATION)
+
+/// Counters describing the behaviour of the default allocation hooks.
+/**
+ * The counters are process-wide and are only maintained when the program is
+ * compiled with @c BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS defined.
+ */
+struct handler_memory_statistics
+{
+  /// The number of calls to the default asio_handler_allocate.
+  std::size_t allocations;
+
+  /// The number of allocations satisfied from a per-thread cache.
+  std::size_t cache_hits;
+
+  /// The number of calls to the default asio_handler_deallocate.
+  std::size_t deallocations;
+
+  /// The number of deallocations retained in a per-thread cache.
+  std::size_t cache_returns;
+
+  /// The number of allocations too large to be cached.
+  std::size_t oversized;
+};
+
+/// Obtain a snapshot of the default allocation hook counters.
+BOOST_ASIO_DECL handler_memory_statistics get_handler_memory_statistics();
+
+#endif // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+       //   || defined(GENERATING_DOCUMENTATION)
+
 } // namespace asio
 } // namespace boost
 
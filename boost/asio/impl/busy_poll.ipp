@@ -0,0 +1,49 @@
+//
+// impl/busy_poll.ipp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_IMPL_BUSY_POLL_IPP
+#define BOOST_ASIO_IMPL_BUSY_POLL_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/busy_poll.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/detail/cstdint.hpp>
+
+#if !defined(BOOST_ASIO_HAS_IOCP)
+# include <boost/asio/detail/task_io_service.hpp>
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+void set_busy_poll(io_service& ios, std::size_t spin_usec, bool adaptive)
+{
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  use_service<detail::task_io_service>(ios).set_busy_poll(
+      static_cast<uint64_t>(spin_usec) * 1000, adaptive);
+#else // !defined(BOOST_ASIO_HAS_IOCP)
+  (void)ios;
+  (void)spin_usec;
+  (void)adaptive;
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
+}
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_IMPL_BUSY_POLL_IPP
@@ -17,6 +17,7 @@
 
 #include <boost/asio/detail/config.hpp>
 #include <boost/asio/detail/call_stack.hpp>
+#include <boost/asio/detail/handler_memory_stats.hpp>
 #include <boost/asio/handler_alloc_hook.hpp>
 
 #if !defined(BOOST_ASIO_DISABLE_SMALL_BLOCK_RECYCLING)
@@ -68,6 +69,22 @@ void asio_handler_deallocate(void* pointer, std::size_t size, ...)
 #endif // !defined(BOOST_ASIO_DISABLE_SMALL_BLOCK_RECYCLING)
 }
 
+#if defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
+handler_memory_statistics get_handler_memory_statistics()
+{
+  detail::handler_memory_stats& stats = detail::handler_memory_stats::instance();
+  handler_memory_statistics result;
+  result.allocations = static_cast<std::size_t>(stats.allocations);
+  result.cache_hits = static_cast<std::size_t>(stats.cache_hits);
+  result.deallocations = static_cast<std::size_t>(stats.deallocations);
+  result.cache_returns = static_cast<std::size_t>(stats.cache_returns);
+  result.oversized = static_cast<std::size_t>(stats.oversized);
+  return result;
+}
+
+#endif // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
 } // namespace asio
 } // namespace boost
 
@@ -0,0 +1,260 @@
+//
+// impl/io_service_pool.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_IMPL_IO_SERVICE_POOL_IPP
+#define BOOST_ASIO_IMPL_IO_SERVICE_POOL_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cerrno>
+#include <stdexcept>
+#include <boost/asio/detail/thread.hpp>
+#include <boost/asio/detail/throw_error.hpp>
+#include <boost/asio/detail/throw_exception.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_service_pool.hpp>
+
+#if defined(__linux__)
+# include <sched.h>
+#endif // defined(__linux__)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+class io_service_pool::thread_function
+{
+public:
+  thread_function(io_service_pool* pool, std::size_t index,
+      int cpu, boost::system::error_code* ec)
+    : pool_(pool),
+      index_(index),
+      cpu_(cpu),
+      ec_(ec)
+  {
+  }
+
+  void operator()()
+  {
+    pool_->run_shard(index_, cpu_, *ec_);
+  }
+
+private:
+  io_service_pool* pool_;
+  std::size_t index_;
+  int cpu_;
+  boost::system::error_code* ec_;
+};
+
+// Owns the threads started by run(). If run() exits with an exception before
+// all of the threads have been joined, the pool is stopped so that the threads
+// that were started return, and they are joined before the exception leaves
+// run().
+class io_service_pool::thread_group
+{
+public:
+  explicit thread_group(io_service_pool* pool)
+    : pool_(pool)
+  {
+    threads_.reserve(pool->io_services_.size());
+  }
+
+  ~thread_group()
+  {
+    if (!threads_.empty())
+    {
+      pool_->stop();
+      join();
+      pool_->reset();
+    }
+  }
+
+  void create_thread(const thread_function& f)
+  {
+    detail::thread* t = new detail::thread(f);
+    threads_.push_back(t); // Does not throw, as the capacity is reserved.
+  }
+
+  void join()
+  {
+    while (!threads_.empty())
+    {
+      threads_.back()->join();
+      delete threads_.back();
+      threads_.pop_back();
+    }
+  }
+
+private:
+  io_service_pool* pool_;
+  std::vector<detail::thread*> threads_;
+};
+
+io_service_pool::io_service_pool(std::size_t pool_size, bool pin_threads)
+  : next_io_service_(0),
+    pin_threads_(pin_threads)
+{
+  if (pool_size == 0)
+  {
+    std::invalid_argument ex("io_service_pool size is 0");
+    boost::asio::detail::throw_exception(ex);
+  }
+
+  io_services_.reserve(pool_size);
+  work_.reserve(pool_size);
+  try
+  {
+    for (std::size_t i = 0; i < pool_size; ++i)
+    {
+      // Each shard is only ever run by one thread. The push_back calls do not
+      // throw, as the capacity is reserved.
+      io_services_.push_back(new boost::asio::io_service(1));
+      work_.push_back(new boost::asio::io_service::work(*io_services_.back()));
+    }
+  }
+  catch (...)
+  {
+    destroy();
+    throw;
+  }
+}
+
+io_service_pool::~io_service_pool()
+{
+  destroy();
+}
+
+boost::asio::io_service& io_service_pool::get_io_service()
+{
+  boost::asio::io_service& ios = *io_services_[next_io_service_];
+  if (++next_io_service_ == io_services_.size())
+    next_io_service_ = 0;
+  return ios;
+}
+
+void io_service_pool::run()
+{
+  boost::system::error_code ec;
+  run(ec);
+  boost::asio::detail::throw_error(ec, "io_service_pool");
+}
+
+void io_service_pool::run(boost::system::error_code& ec)
+{
+  std::vector<int> cpus;
+  if (pin_threads_)
+  {
+    get_allowed_cpus(cpus, ec);
+    if (ec)
+      return;
+  }
+
+  // Each thread reports its own error, so that they need no synchronisation.
+  std::vector<boost::system::error_code> errors(io_services_.size());
+
+  thread_group threads(this);
+  for (std::size_t i = 0; i < io_services_.size(); ++i)
+  {
+    int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+    threads.create_thread(thread_function(this, i, cpu, &errors[i]));
+  }
+  threads.join();
+
+  // Allow the pool to be run again.
+  reset();
+
+  ec = boost::system::error_code();
+  for (std::size_t i = 0; i < errors.size() && !ec; ++i)
+    ec = errors[i];
+}
+
+void io_service_pool::reset()
+{
+  for (std::size_t i = 0; i < io_services_.size(); ++i)
+    io_services_[i]->reset();
+}
+
+void io_service_pool::stop()
+{
+  for (std::size_t i = 0; i < io_services_.size(); ++i)
+    io_services_[i]->stop();
+}
+
+void io_service_pool::destroy()
+{
+  for (std::size_t i = 0; i < work_.size(); ++i)
+    delete work_[i];
+  work_.clear();
+  for (std::size_t i = 0; i < io_services_.size(); ++i)
+    delete io_services_[i];
+  io_services_.clear();
+}
+
+void io_service_pool::run_shard(std::size_t index, int cpu,
+    boost::system::error_code& ec)
+{
+#if defined(__linux__) && defined(CPU_SET)
+  if (cpu >= 0)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (::sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+      // A shard that cannot be pinned stops the whole pool, so that run()
+      // reports the error straight away.
+      ec = boost::system::error_code(errno,
+          boost::asio::error::get_system_category());
+      stop();
+      return;
+    }
+  }
+#else // defined(__linux__) && defined(CPU_SET)
+  (void)cpu;
+#endif // defined(__linux__) && defined(CPU_SET)
+
+  io_services_[index]->run();
+}
+
+void io_service_pool::get_allowed_cpus(
+    std::vector<int>& cpus, boost::system::error_code& ec)
+{
+  cpus.clear();
+
+#if defined(__linux__) && defined(CPU_SET)
+  // Processor ids need not be contiguous, and the process may be confined to
+  // a subset of them, e.g. by taskset or a cpuset cgroup.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    ec = boost::system::error_code(errno,
+        boost::asio::error::get_system_category());
+    return;
+  }
+
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET(cpu, &allowed))
+      cpus.push_back(cpu);
+#endif // defined(__linux__) && defined(CPU_SET)
+
+  ec = boost::system::error_code();
+}
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_IMPL_IO_SERVICE_POOL_IPP
@@ -0,0 +1,60 @@
+//
+// impl/metrics.ipp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_IMPL_METRICS_IPP
+#define BOOST_ASIO_IMPL_METRICS_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/metrics.hpp>
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+# include <boost/asio/detail/task_io_service.hpp>
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+io_service_metrics get_metrics(io_service& ios)
+{
+  io_service_metrics m;
+  m.handlers_executed = 0;
+  m.queue_depth = 0;
+  m.reactor_runs = 0;
+  m.reactor_interrupts = 0;
+  m.thread_wakeups = 0;
+  m.pending_timers = 0;
+  for (std::size_t i = 0; i < io_service_metrics::histogram_buckets; ++i)
+  {
+    m.reactor_batch_sizes[i] = 0;
+    m.handler_latency[i] = 0;
+  }
+
+#if defined(BOOST_ASIO_HAS_METRICS)
+  use_service<detail::io_service_impl>(ios).get_metrics(m);
+#else // defined(BOOST_ASIO_HAS_METRICS)
+  (void)ios;
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+  return m;
+}
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_IMPL_METRICS_IPP
@@ -0,0 +1,222 @@
+//
+// impl/splice.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_IMPL_SPLICE_HPP
+#define BOOST_ASIO_IMPL_SPLICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+#include <boost/asio/detail/descriptor_ops.hpp>
+#include <boost/asio/detail/handler_alloc_helpers.hpp>
+#include <boost/asio/detail/handler_cont_helpers.hpp>
+#include <boost/asio/detail/handler_invoke_helpers.hpp>
+#include <boost/asio/detail/handler_type_requirements.hpp>
+#include <boost/asio/detail/throw_error.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+template <typename SyncSpliceSource, typename SyncSpliceSink>
+std::size_t splice(SyncSpliceSource& source, SyncSpliceSink& sink,
+    std::size_t count, boost::system::error_code& ec)
+{
+  return detail::descriptor_ops::sync_splice(
+      source.native_handle(), sink.native_handle(), count, ec);
+}
+
+template <typename SyncSpliceSource, typename SyncSpliceSink>
+inline std::size_t splice(SyncSpliceSource& source,
+    SyncSpliceSink& sink, std::size_t count)
+{
+  boost::system::error_code ec;
+  std::size_t bytes_transferred = splice(source, sink, count, ec);
+  boost::asio::detail::throw_error(ec, "splice");
+  return bytes_transferred;
+}
+
+namespace detail
+{
+  template <typename AsyncSpliceSource,
+      typename AsyncSpliceSink, typename WriteHandler>
+  class splice_op
+  {
+  public:
+    splice_op(AsyncSpliceSource& source, AsyncSpliceSink& sink,
+        std::size_t count, WriteHandler& handler)
+      : source_(source),
+        sink_(sink),
+        remaining_(count),
+        start_(0),
+        total_transferred_(0),
+        handler_(BOOST_ASIO_MOVE_CAST(WriteHandler)(handler))
+    {
+    }
+
+#if defined(BOOST_ASIO_HAS_MOVE)
+    splice_op(const splice_op& other)
+      : source_(other.source_),
+        sink_(other.sink_),
+        remaining_(other.remaining_),
+        start_(other.start_),
+        total_transferred_(other.total_transferred_),
+        handler_(other.handler_)
+    {
+    }
+
+    splice_op(splice_op&& other)
+      : source_(other.source_),
+        sink_(other.sink_),
+        remaining_(other.remaining_),
+        start_(other.start_),
+        total_transferred_(other.total_transferred_),
+        handler_(BOOST_ASIO_MOVE_CAST(WriteHandler)(other.handler_))
+    {
+    }
+#endif // defined(BOOST_ASIO_HAS_MOVE)
+
+    void operator()(boost::system::error_code ec,
+        std::size_t /*bytes_transferred*/, int start = 0)
+    {
+      if ((start_ = start) == 1)
+      {
+        source_.native_non_blocking(true, ec);
+        if (!ec)
+          sink_.native_non_blocking(true, ec);
+      }
+
+      if (!ec && !descriptor_ops::non_blocking_splice(
+            source_.native_handle(), sink_.native_handle(),
+            remaining_, ec, total_transferred_))
+      {
+        // Wait for the source to become readable if it has no data, otherwise
+        // for the sink to become writable.
+        boost::system::error_code poll_ec;
+        if (descriptor_ops::poll_read(source_.native_handle(),
+              descriptor_ops::user_set_non_blocking, poll_ec) == 0)
+        {
+          source_.async_read_some(boost::asio::null_buffers(),
+              BOOST_ASIO_MOVE_CAST(splice_op)(*this));
+        }
+        else
+        {
+          sink_.async_write_some(boost::asio::null_buffers(),
+              BOOST_ASIO_MOVE_CAST(splice_op)(*this));
+        }
+        return;
+      }
+
+      if (start == 1)
+      {
+        // The handler must not be invoked from within the initiating function.
+        sink_.get_io_service().post(detail::bind_handler(
+              handler_, ec, total_transferred_));
+        return;
+      }
+
+      handler_(ec, static_cast<const std::size_t&>(total_transferred_));
+    }
+
+  //private:
+    AsyncSpliceSource& source_;
+    AsyncSpliceSink& sink_;
+    std::size_t remaining_;
+    int start_;
+    std::size_t total_transferred_;
+    WriteHandler handler_;
+  };
+
+  template <typename AsyncSpliceSource,
+      typename AsyncSpliceSink, typename WriteHandler>
+  inline void* asio_handler_allocate(std::size_t size,
+      splice_op<AsyncSpliceSource, AsyncSpliceSink,
+        WriteHandler>* this_handler)
+  {
+    return boost_asio_handler_alloc_helpers::allocate(
+        size, this_handler->handler_);
+  }
+
+  template <typename AsyncSpliceSource,
+      typename AsyncSpliceSink, typename WriteHandler>
+  inline void asio_handler_deallocate(void* pointer, std::size_t size,
+      splice_op<AsyncSpliceSource, AsyncSpliceSink,
+        WriteHandler>* this_handler)
+  {
+    boost_asio_handler_alloc_helpers::deallocate(
+        pointer, size, this_handler->handler_);
+  }
+
+  template <typename AsyncSpliceSource,
+      typename AsyncSpliceSink, typename WriteHandler>
+  inline bool asio_handler_is_continuation(
+      splice_op<AsyncSpliceSource, AsyncSpliceSink,
+        WriteHandler>* this_handler)
+  {
+    return this_handler->start_ == 0 ? true
+      : boost_asio_handler_cont_helpers::is_continuation(
+          this_handler->handler_);
+  }
+
+  template <typename Function, typename AsyncSpliceSource,
+      typename AsyncSpliceSink, typename WriteHandler>
+  inline void asio_handler_invoke(Function& function,
+      splice_op<AsyncSpliceSource, AsyncSpliceSink,
+        WriteHandler>* this_handler)
+  {
+    boost_asio_handler_invoke_helpers::invoke(
+        function, this_handler->handler_);
+  }
+
+  template <typename Function, typename AsyncSpliceSource,
+      typename AsyncSpliceSink, typename WriteHandler>
+  inline void asio_handler_invoke(const Function& function,
+      splice_op<AsyncSpliceSource, AsyncSpliceSink,
+        WriteHandler>* this_handler)
+  {
+    boost_asio_handler_invoke_helpers::invoke(
+        function, this_handler->handler_);
+  }
+} // namespace detail
+
+template <typename AsyncSpliceSource, typename AsyncSpliceSink,
+    typename WriteHandler>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+    void (boost::system::error_code, std::size_t))
+async_splice(AsyncSpliceSource& source, AsyncSpliceSink& sink,
+    std::size_t count, BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+{
+  // If you get an error on the following line it means that your handler does
+  // not meet the documented type requirements for a WriteHandler.
+  BOOST_ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+  detail::async_result_init<
+    WriteHandler, void (boost::system::error_code, std::size_t)> init(
+      BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+
+  detail::splice_op<AsyncSpliceSource, AsyncSpliceSink,
+    BOOST_ASIO_HANDLER_TYPE(
+      WriteHandler, void (boost::system::error_code, std::size_t))>(
+        source, sink, count, init.handler)(
+          boost::system::error_code(), 0, 1);
+
+  return init.result.get();
+}
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_IMPL_SPLICE_HPP
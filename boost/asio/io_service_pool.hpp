@@ -0,0 +1,185 @@
+//
+// io_service_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_IO_SERVICE_POOL_HPP
+#define BOOST_ASIO_IO_SERVICE_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/asio/detail/noncopyable.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+/// Provides a set of independent io_service objects, each run by its own
+/// thread.
+/**
+ * The io_service_pool class partitions an application into shards. Each shard
+ * is an io_service with its own reactor and handler queue, and is run by a
+ * single thread. I/O objects created on a shard have their handlers executed
+ * only by that shard's thread, so there is no contention between shards on
+ * descriptor registration, the reactor, or the handler queue.
+ *
+ * To keep connections local to a shard from accept through to close, use
+ * basic_sharded_acceptor to listen on one socket per shard.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe, except that stop() may be called from any
+ * thread, including from within a handler.
+ *
+ * @par Example
+ * @code
+ * boost::asio::io_service_pool pool(4);
+ * boost::asio::basic_sharded_acceptor<boost::asio::ip::tcp> acceptor(
+ *     pool, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 80));
+ * for (std::size_t i = 0; i < acceptor.size(); ++i)
+ *   start_accept(acceptor.acceptor(i));
+ * pool.run();
+ * @endcode
+ */
+class io_service_pool
+  : private noncopyable
+{
+public:
+  /// Constructor.
+  /**
+   * Construct an io_service_pool with the given number of shards.
+   *
+   * @param pool_size The number of io_service objects in the pool. Must be
+   * greater than zero.
+   *
+   * @param pin_threads If true, the thread that runs shard @c i is bound to
+   * the processor at position <tt>i % N</tt> in the affinity mask of the
+   * thread that calls run(), where @c N is the number of processors in the
+   * mask. This is only supported on Linux, and is ignored elsewhere.
+   *
+   * @throws std::invalid_argument Thrown if @c pool_size is zero.
+   */
+  BOOST_ASIO_DECL explicit io_service_pool(
+      std::size_t pool_size, bool pin_threads = false);
+
+  /// Destructor.
+  /**
+   * Destroys the io_service objects. The pool must not be running.
+   */
+  BOOST_ASIO_DECL ~io_service_pool();
+
+  /// Get the number of io_service objects in the pool.
+  std::size_t size() const
+  {
+    return io_services_.size();
+  }
+
+  /// Get the io_service at the given index.
+  boost::asio::io_service& get_io_service(std::size_t index)
+  {
+    return *io_services_[index];
+  }
+
+  /// Get the next io_service to use, in round-robin order.
+  BOOST_ASIO_DECL boost::asio::io_service& get_io_service();
+
+  /// Run all io_service objects in the pool.
+  /**
+   * Creates one thread for each io_service in the pool and blocks until all of
+   * them have been stopped. The io_service objects do not run out of work while
+   * the pool is running, so stop() must be called to make this function
+   * return.
+   *
+   * The threads do not catch exceptions: an exception thrown by a handler
+   * escapes the thread's function, which calls @c std::terminate(). Handlers
+   * run by the pool must therefore not throw.
+   *
+   * @throws boost::system::system_error Thrown if a thread cannot be created,
+   * or if a thread cannot be bound to its processor. The threads that were
+   * already started are stopped and joined first.
+   */
+  BOOST_ASIO_DECL void run();
+
+  /// Run all io_service objects in the pool.
+  /**
+   * Creates one thread for each io_service in the pool and blocks until all of
+   * them have been stopped. The io_service objects do not run out of work while
+   * the pool is running, so stop() must be called to make this function
+   * return.
+   *
+   * @param ec Set to indicate what error occurred, if any. If a thread cannot
+   * be bound to its processor, the pool is stopped and the error is reported
+   * once all of the threads have returned.
+   *
+   * @throws boost::system::system_error Thrown if a thread cannot be created.
+   * The threads that were already started are stopped and joined first.
+   */
+  BOOST_ASIO_DECL void run(boost::system::error_code& ec);
+
+  /// Stop all io_service objects in the pool.
+  /**
+   * This function does not block. The threads created by run() return as soon
+   * as they finish executing their current handlers.
+   */
+  BOOST_ASIO_DECL void stop();
+
+private:
+  // Run the io_service at the given index on the calling thread, after binding
+  // the thread to the given processor if it is not negative.
+  BOOST_ASIO_DECL void run_shard(std::size_t index, int cpu,
+      boost::system::error_code& ec);
+
+  // Get the processors in the calling thread's affinity mask. The list is left
+  // empty where pinning is not supported.
+  BOOST_ASIO_DECL static void get_allowed_cpus(
+      std::vector<int>& cpus, boost::system::error_code& ec);
+
+  // Reset all io_service objects so that the pool can be run again.
+  BOOST_ASIO_DECL void reset();
+
+  // Destroy the work objects and the io_service objects.
+  BOOST_ASIO_DECL void destroy();
+
+  // Function object used to start a thread for a shard.
+  class thread_function;
+  friend class thread_function;
+
+  // Joins the threads started by run(), including when run() throws.
+  class thread_group;
+  friend class thread_group;
+
+  // The shards in the pool.
+  std::vector<boost::asio::io_service*> io_services_;
+
+  // The work that keeps each io_service running until stop() is called.
+  std::vector<boost::asio::io_service::work*> work_;
+
+  // The next io_service to be returned by get_io_service().
+  std::size_t next_io_service_;
+
+  // Whether to bind each shard's thread to a processor.
+  bool pin_threads_;
+};
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#if defined(BOOST_ASIO_HEADER_ONLY)
+# include <boost/asio/impl/io_service_pool.ipp>
+#endif // defined(BOOST_ASIO_HEADER_ONLY)
+
+#endif // BOOST_ASIO_IO_SERVICE_POOL_HPP
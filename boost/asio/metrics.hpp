@@ -0,0 +1,100 @@
+//
+// metrics.hpp
+// ~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_METRICS_HPP
+#define BOOST_ASIO_METRICS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <cstddef>
+#include <vector>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+class io_service;
+
+/// A snapshot of the runtime metrics collected by an io_service.
+/**
+ * Metrics are collected only when the program is compiled with
+ * @c BOOST_ASIO_ENABLE_METRICS defined, and only by the reactor-based
+ * io_service implementation. Otherwise, every value is zero.
+ *
+ * The counters are updated using relaxed atomic operations and are read
+ * without stopping the threads that run the io_service, so the values in a
+ * snapshot are not guaranteed to be mutually consistent.
+ *
+ * Each histogram has @c histogram_buckets buckets. Bucket 0 counts values of
+ * zero, and bucket @c i counts values in the range [2<sup>i-1</sup>,
+ * 2<sup>i</sup>). The last bucket also counts all larger values.
+ */
+struct io_service_metrics
+{
+  /// The number of buckets in each histogram.
+  BOOST_ASIO_STATIC_CONSTANT(std::size_t, histogram_buckets = 32);
+
+  /// The number of handlers executed, including those executed by threads
+  /// that have since returned from the io_service.
+  std::size_t handlers_executed;
+
+  /// The number of handlers executed by each thread that is currently inside
+  /// a call to run(), run_one(), poll() or poll_one().
+  std::vector<std::size_t> thread_handlers_executed;
+
+  /// The number of handlers waiting in the io_service's shared queue.
+  std::size_t queue_depth;
+
+  /// The number of times the reactor was run to wait for events.
+  std::size_t reactor_runs;
+
+  /// The number of times a blocked reactor was interrupted to deliver work.
+  std::size_t reactor_interrupts;
+
+  /// The number of times an idle thread was woken to deliver work.
+  std::size_t thread_wakeups;
+
+  /// The number of timers that have at least one pending wait operation.
+  std::size_t pending_timers;
+
+  /// Histogram of the number of operations completed by each run of the
+  /// reactor.
+  std::size_t reactor_batch_sizes[histogram_buckets];
+
+  /// Histogram of the time taken to execute handlers, in nanoseconds. Only a
+  /// sample of the handlers is timed, as determined by
+  /// @c BOOST_ASIO_METRICS_LATENCY_SAMPLE_INTERVAL (default 32).
+  std::size_t handler_latency[histogram_buckets];
+};
+
+/// Obtain a snapshot of the runtime metrics of an io_service.
+/**
+ * This function may be called from any thread, including while other threads
+ * are running the io_service. It briefly acquires the io_service's internal
+ * lock to find the threads that are running it and the timer queues. The
+ * time spent holding the lock does not depend on the queue depth or the
+ * number of timers.
+ */
+BOOST_ASIO_DECL io_service_metrics get_metrics(io_service& ios);
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#if defined(BOOST_ASIO_HEADER_ONLY)
+# include <boost/asio/impl/metrics.ipp>
+#endif // defined(BOOST_ASIO_HEADER_ONLY)
+
+#endif // BOOST_ASIO_METRICS_HPP
@@ -374,6 +374,46 @@ public:
     SOL_SOCKET, SO_REUSEADDR> reuse_address;
 #endif
 
+#if defined(SO_REUSEPORT) || defined(GENERATING_DOCUMENTATION)
+  /// Socket option to allow several sockets to be bound to the same address
+  /// and port, with incoming connections or datagrams distributed between
+  /// them by the kernel.
+  /**
+   * Implements the SOL_SOCKET/SO_REUSEPORT socket option. The option must be
+   * set on every socket before it is bound.
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * boost::asio::ip::tcp::acceptor acceptor(io_service); 
+   * ...
+   * boost::asio::socket_base::reuse_port option(true);
+   * acceptor.set_option(option);
+   * @endcode
+   *
+   * @par
+   * Getting the current option value:
+   * @code
+   * boost::asio::ip::tcp::acceptor acceptor(io_service); 
+   * ...
+   * boost::asio::socket_base::reuse_port option;
+   * acceptor.get_option(option);
+   * bool is_set = option.value();
+   * @endcode
+   *
+   * @par Concepts:
+   * Socket_Option, Boolean_Socket_Option.
+   *
+   * @note Only available on platforms that define @c SO_REUSEPORT.
+   */
+#if defined(GENERATING_DOCUMENTATION)
+  typedef implementation_defined reuse_port;
+#else
+  typedef boost::asio::detail::socket_option::boolean<
+    SOL_SOCKET, SO_REUSEPORT> reuse_port;
+#endif
+#endif // defined(SO_REUSEPORT) || defined(GENERATING_DOCUMENTATION)
+
   /// Socket option to specify whether the socket lingers on close if unsent
   /// data is present.
   /**
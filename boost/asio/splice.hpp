@@ -0,0 +1,195 @@
+//
+// splice.hpp
+// ~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_SPLICE_HPP
+#define BOOST_ASIO_SPLICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_SPLICE) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/error.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+/**
+ * @defgroup splice boost::asio::splice
+ *
+ * @brief Move a certain amount of data from one descriptor to another,
+ * without copying it through user-space buffers, before returning.
+ */
+/*@{*/
+
+/// Move data from one descriptor to another before returning.
+/**
+ * This function is used to move a certain number of bytes from a source
+ * descriptor to a sink descriptor using the @c splice() system call. The call
+ * will block until one of the following conditions is true:
+ *
+ * @li @c count bytes have been moved.
+ *
+ * @li The source reached end of stream.
+ *
+ * @li An error occurred.
+ *
+ * @param source The object from which data will be read, such as a
+ * posix::stream_descriptor or an ip::tcp::socket. The type must provide a
+ * @c native_handle() member function.
+ *
+ * @param sink The object to which data will be written, such as a
+ * posix::stream_descriptor or an ip::tcp::socket. The type must provide a
+ * @c native_handle() member function.
+ *
+ * @param count The number of bytes to move.
+ *
+ * @returns The number of bytes moved.
+ *
+ * @throws boost::system::system_error Thrown on failure. An error code of
+ * boost::asio::error::eof indicates that the source reached end of stream
+ * before @c count bytes were moved.
+ *
+ * @note At least one of @c source and @c sink must refer to a pipe. This
+ * function is available on Linux only.
+ */
+template <typename SyncSpliceSource, typename SyncSpliceSink>
+std::size_t splice(SyncSpliceSource& source,
+    SyncSpliceSink& sink, std::size_t count);
+
+/// Move data from one descriptor to another before returning.
+/**
+ * This function is used to move a certain number of bytes from a source
+ * descriptor to a sink descriptor using the @c splice() system call. The call
+ * will block until one of the following conditions is true:
+ *
+ * @li @c count bytes have been moved.
+ *
+ * @li The source reached end of stream.
+ *
+ * @li An error occurred.
+ *
+ * @param source The object from which data will be read, such as a
+ * posix::stream_descriptor or an ip::tcp::socket. The type must provide a
+ * @c native_handle() member function.
+ *
+ * @param sink The object to which data will be written, such as a
+ * posix::stream_descriptor or an ip::tcp::socket. The type must provide a
+ * @c native_handle() member function.
+ *
+ * @param count The number of bytes to move.
+ *
+ * @param ec Set to indicate what error occurred, if any. An error code of
+ * boost::asio::error::eof indicates that the source reached end of stream
+ * before @c count bytes were moved.
+ *
+ * @returns The number of bytes moved.
+ *
+ * @note At least one of @c source and @c sink must refer to a pipe. This
+ * function is available on Linux only.
+ */
+template <typename SyncSpliceSource, typename SyncSpliceSink>
+std::size_t splice(SyncSpliceSource& source, SyncSpliceSink& sink,
+    std::size_t count, boost::system::error_code& ec);
+
+/*@}*/
+/**
+ * @defgroup async_splice boost::asio::async_splice
+ *
+ * @brief Start an asynchronous operation to move a certain amount of data
+ * from one descriptor to another without copying it through user-space
+ * buffers.
+ */
+/*@{*/
+
+/// Start an asynchronous operation to move data from one descriptor to
+/// another.
+/**
+ * This function is used to asynchronously move a certain number of bytes from
+ * a source descriptor to a sink descriptor using the @c splice() system call.
+ * The function call always returns immediately. The asynchronous operation
+ * will continue until one of the following conditions is true:
+ *
+ * @li @c count bytes have been moved.
+ *
+ * @li The source reached end of stream.
+ *
+ * @li An error occurred.
+ *
+ * This operation is implemented in terms of zero or more calls to the
+ * source's @c async_read_some and the sink's @c async_write_some functions
+ * with @c null_buffers, which are used to wait until the descriptor that
+ * prevented further progress becomes ready. Both objects are placed into
+ * non-blocking mode using their @c native_non_blocking functions. The program
+ * must ensure that neither object performs any other operations until this
+ * operation completes.
+ *
+ * @param source The object from which data will be read, such as a
+ * posix::stream_descriptor or an ip::tcp::socket.
+ *
+ * @param sink The object to which data will be written, such as a
+ * posix::stream_descriptor or an ip::tcp::socket.
+ *
+ * @param count The number of bytes to move.
+ *
+ * @param handler The handler to be called when the splice operation
+ * completes. Copies will be made of the handler as required. The function
+ * signature of the handler must be:
+ * @code void handler(
+ *   const boost::system::error_code& error, // Result of operation.
+ *
+ *   std::size_t bytes_transferred           // Number of bytes moved from the
+ *                                           // source to the sink. If an error
+ *                                           // occurred, this will be less
+ *                                           // than count.
+ * ); @endcode
+ * Regardless of whether the asynchronous operation completes immediately or
+ * not, the handler will not be invoked from within this function. Invocation
+ * of the handler will be performed in a manner equivalent to using
+ * boost::asio::io_service::post().
+ *
+ * @note At least one of @c source and @c sink must refer to a pipe. This
+ * function is available on Linux only.
+ *
+ * @par Example
+ * To forward the output of a child process to a client:
+ * @code
+ * boost::asio::posix::stream_descriptor pipe(io_service, pipe_fds[0]);
+ * boost::asio::async_splice(pipe, socket, 65536, handler);
+ * @endcode
+ */
+template <typename AsyncSpliceSource, typename AsyncSpliceSink,
+    typename WriteHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+    void (boost::system::error_code, std::size_t))
+async_splice(AsyncSpliceSource& source, AsyncSpliceSink& sink,
+    std::size_t count, BOOST_ASIO_MOVE_ARG(WriteHandler) handler);
+
+/*@}*/
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#include <boost/asio/impl/splice.hpp>
+
+#endif // defined(BOOST_ASIO_HAS_SPLICE)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // BOOST_ASIO_SPLICE_HPP
@@ -97,6 +97,36 @@ public:
     service_.construct(impl_);
   }
 
+  /// Copy constructor.
+  /**
+   * Constructs a strand that refers to the same underlying strand as @c other.
+   * Handlers posted through either object are not run concurrently with each
+   * other.
+   *
+   * @param other The strand to be copied.
+   */
+  strand(const strand& other)
+    : service_(other.service_)
+  {
+    service_.copy_construct(impl_, other.impl_);
+  }
+
+#if defined(BOOST_ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move constructor.
+  /**
+   * Constructs a strand that refers to the same underlying strand as @c other.
+   *
+   * @param other The strand from which the move will occur.
+   *
+   * @note Following the move, the moved-from object may only be destroyed.
+   */
+  strand(strand&& other)
+    : service_(other.service_)
+  {
+    service_.move_construct(impl_, other.impl_);
+  }
+#endif // defined(BOOST_ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
   /// Destructor.
   /**
    * Destroys a strand.
@@ -106,6 +136,7 @@ public:
    */
   ~strand()
   {
+    service_.destroy(impl_);
   }
 
   /// Get the io_service associated with the strand.
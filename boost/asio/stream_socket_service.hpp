@@ -18,6 +18,7 @@
 #include <boost/asio/detail/config.hpp>
 #include <cstddef>
 #include <boost/asio/async_result.hpp>
+#include <boost/asio/detail/cstdint.hpp>
 #include <boost/asio/detail/type_traits.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/asio/io_service.hpp>
@@ -328,6 +329,32 @@ public:
     return init.result.get();
   }
 
+#if defined(BOOST_ASIO_HAS_SENDFILE)
+  /// Send a region of a file to the peer.
+  std::size_t send_file(implementation_type& impl, int file,
+      uint64_t offset, std::size_t count, boost::system::error_code& ec)
+  {
+    return service_impl_.send_file(impl, file, offset, count, ec);
+  }
+
+  /// Start an asynchronous send of a region of a file.
+  template <typename WriteHandler>
+  BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+      void (boost::system::error_code, std::size_t))
+  async_send_file(implementation_type& impl, int file,
+      uint64_t offset, std::size_t count,
+      BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
+  {
+    detail::async_result_init<
+      WriteHandler, void (boost::system::error_code, std::size_t)> init(
+        BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+
+    service_impl_.async_send_file(impl, file, offset, count, init.handler);
+
+    return init.result.get();
+  }
+#endif // defined(BOOST_ASIO_HAS_SENDFILE)
+
   /// Receive some data from the peer.
   template <typename MutableBufferSequence>
   std::size_t receive(implementation_type& impl,
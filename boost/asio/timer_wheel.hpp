@@ -0,0 +1,57 @@
+//
+// timer_wheel.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_ASIO_TIMER_WHEEL_HPP
+#define BOOST_ASIO_TIMER_WHEEL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <boost/asio/detail/config.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/detail/timer_queue_config.hpp>
+
+#include <boost/asio/detail/push_options.hpp>
+
+namespace boost {
+namespace asio {
+
+/// Select a hierarchical timing wheel for the timers of an io_service.
+/**
+ * By default the timers belonging to an io_service are kept in a binary heap,
+ * giving logarithmic cost to start and cancel a wait. Programs that re-arm
+ * large numbers of timers, such as per-connection idle timeouts, may instead
+ * keep them in a timing wheel, where both operations take constant time.
+ * Timers in a wheel fire on tick boundaries, up to @c resolution microseconds
+ * after their expiry time.
+ *
+ * @param io_service The io_service object whose timers are to be configured.
+ *
+ * @param resolution The length of a wheel tick in microseconds. A value of 0
+ * restores the default heap.
+ *
+ * @note The setting applies to timer services created after the call. It
+ * should therefore be made before any timer objects are constructed on the
+ * io_service.
+ */
+inline void use_timer_wheel(boost::asio::io_service& io_service,
+    long resolution = 1000)
+{
+  boost::asio::use_service<detail::timer_queue_config>(
+      io_service).set_wheel_resolution(resolution);
+}
+
+} // namespace asio
+} // namespace boost
+
+#include <boost/asio/detail/pop_options.hpp>
+
+#endif // BOOST_ASIO_TIMER_WHEEL_HPP
@@ -0,0 +1,82 @@
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_DETAIL_CONTENTION_COUNTERS_HPP_INCLUDED
+#define BOOST_LOCKFREE_DETAIL_CONTENTION_COUNTERS_HPP_INCLUDED
+
+#include <cstddef>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+/* counters for the contended code paths. they are only updated after a failed compare-and-swap, so the uncontended
+ * path is not affected. */
+template <bool Enabled>
+class contention_counters
+{
+    static const int padding_size = BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(std::size_t);
+
+    char padding1[padding_size]; /* keep the counters away from the data structure */
+    atomic<std::size_t> cas_failures_;
+    char padding2[padding_size];
+    atomic<std::size_t> eliminations_;
+
+public:
+    contention_counters(void):
+        cas_failures_(0), eliminations_(0)
+    {}
+
+    void count_cas_failure(void)
+    {
+        cas_failures_.fetch_add(1, memory_order_relaxed);
+    }
+
+    void count_elimination(void)
+    {
+        eliminations_.fetch_add(1, memory_order_relaxed);
+    }
+
+    std::size_t cas_failures(void) const
+    {
+        return cas_failures_.load(memory_order_relaxed);
+    }
+
+    std::size_t eliminations(void) const
+    {
+        return eliminations_.load(memory_order_relaxed);
+    }
+};
+
+template <>
+class contention_counters<false>
+{
+public:
+    void count_cas_failure(void)
+    {}
+
+    void count_elimination(void)
+    {}
+
+    std::size_t cas_failures(void) const
+    {
+        return 0;
+    }
+
+    std::size_t eliminations(void) const
+    {
+        return 0;
+    }
+};
+
+} /* namespace detail */
+} /* namespace lockfree */
+} /* namespace boost */
+
+#endif /* BOOST_LOCKFREE_DETAIL_CONTENTION_COUNTERS_HPP_INCLUDED */
@@ -0,0 +1,137 @@
+//  elimination array from
+//  Hendler, D., Shavit, N. and Yerushalmi, L.,
+//  "a scalable lock-free stack algorithm"
+//
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_DETAIL_ELIMINATION_ARRAY_HPP_INCLUDED
+#define BOOST_LOCKFREE_DETAIL_ELIMINATION_ARRAY_HPP_INCLUDED
+
+#include <cstddef>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+/* a push that failed to update the top of the stack offers its node in a slot for a short while, a pop that failed to
+ * update the top of the stack takes an offered node from a slot. the pair is completed without touching the top of
+ * the stack, which is equivalent to a push that is immediately followed by a pop.
+ *
+ * every modification of a slot increments its tag, so a push can tell whether its offer has been taken, even if the node
+ * has been popped, reused and offered again in the meantime. */
+template <typename TaggedHandle, std::size_t Slots>
+class elimination_array
+{
+    struct slot
+    {
+        atomic<TaggedHandle> offer;
+        char padding[BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(TaggedHandle)];
+    };
+
+    /* the number of times that a push polls its slot, before it withdraws the offer */
+    static const int spin_count = 128;
+
+    /* threads choose their slots by the address of a local variable. thread stacks are usually aligned to large
+     * powers of two, so the address needs to be hashed, before it is reduced to a slot index. */
+    static std::size_t slot_index(const void * hint, std::size_t attempt)
+    {
+        boost::uint64_t h = static_cast<boost::uint64_t>(reinterpret_cast<std::size_t>(hint))
+                          + attempt * BOOST_LOCKFREE_CACHELINE_BYTES;
+        h *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(h >> 32) % Slots;
+    }
+
+    boost::array<slot, Slots> slots;
+
+public:
+    template <typename Pool>
+    void initialize(Pool & pool)
+    {
+        for (std::size_t i = 0; i != Slots; ++i)
+            slots[i].offer.store(TaggedHandle(pool.null_handle(), 0), memory_order_relaxed);
+    }
+
+    /* \returns true, if a pop has taken the node */
+    template <typename Pool, typename Node>
+    bool try_exchange_push(Pool & pool, Node * node, const void * hint, std::size_t attempt)
+    {
+        slot & s = slots[slot_index(hint, attempt)];
+
+        TaggedHandle old_offer = s.offer.load(memory_order_relaxed);
+        if (pool.get_pointer(old_offer) != 0)
+            return false; /* another push is waiting in this slot */
+
+        TaggedHandle new_offer(pool.get_handle(node), old_offer.get_next_tag());
+        if (!s.offer.compare_exchange_strong(old_offer, new_offer))
+            return false;
+
+        for (int i = 0; i != spin_count; ++i) {
+            if (s.offer.load(memory_order_relaxed) != new_offer)
+                return true;
+        }
+
+        /* withdraw the offer, this fails if a pop has taken the node in the meantime */
+        TaggedHandle withdrawn(pool.null_handle(), new_offer.get_next_tag());
+        return !s.offer.compare_exchange_strong(new_offer, withdrawn);
+    }
+
+    /* \returns true, if a node offered by a push has been taken. the node is then owned by the caller */
+    template <typename Pool, typename Node>
+    bool try_exchange_pop(Pool & pool, Node * & ret, const void * hint, std::size_t attempt)
+    {
+        std::size_t index = slot_index(hint, attempt);
+
+        for (std::size_t i = 0; i != Slots; ++i) {
+            slot & s = slots[(index + i) % Slots];
+
+            TaggedHandle offer = s.offer.load(memory_order_acquire);
+            Node * node = pool.get_pointer(offer);
+            if (!node)
+                continue;
+
+            TaggedHandle taken(pool.null_handle(), offer.get_next_tag());
+            if (s.offer.compare_exchange_strong(offer, taken)) {
+                ret = node;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+template <typename TaggedHandle>
+class elimination_array<TaggedHandle, 0>
+{
+public:
+    template <typename Pool>
+    void initialize(Pool &)
+    {}
+
+    template <typename Pool, typename Node>
+    bool try_exchange_push(Pool &, Node *, const void *, std::size_t)
+    {
+        return false;
+    }
+
+    template <typename Pool, typename Node>
+    bool try_exchange_pop(Pool &, Node * &, const void *, std::size_t)
+    {
+        return false;
+    }
+};
+
+} /* namespace detail */
+} /* namespace lockfree */
+} /* namespace boost */
+
+#endif /* BOOST_LOCKFREE_DETAIL_ELIMINATION_ARRAY_HPP_INCLUDED */
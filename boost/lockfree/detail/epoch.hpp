@@ -0,0 +1,143 @@
+//  epoch-based memory reclamation, as described by
+//  Fraser, K., "practical lock-freedom"
+//
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_DETAIL_EPOCH_HPP_INCLUDED
+#define BOOST_LOCKFREE_DETAIL_EPOCH_HPP_INCLUDED
+
+#include <cstddef>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+/* every operation that may dereference a shared node runs inside a guard, which pins the global epoch that was current
+ * when the guard was entered. the global epoch can only be advanced from e to e + 1, if no guard of epoch e - 1 is
+ * active, so guards are always pinned to the current or the previous epoch.
+ *
+ * memory that has been unlinked by a guard of epoch e can only be referenced by guards of the epochs e - 1 to e + 1. it
+ * is collected in bucket e % 3 and released when the global epoch is advanced to e + 3, when none of these guards can
+ * be active anymore. this happens right before new memory is collected in the same bucket.
+ *
+ * instead of a registry of threads, the active guards are counted per epoch. the counters are striped by the address of
+ * the guard, so threads on different stacks usually update different cache lines. */
+class epoch_manager:
+    boost::noncopyable
+{
+    static const std::size_t stripe_count = 16;
+    static const std::size_t bucket_count = 3;
+
+    struct stripe
+    {
+        atomic<std::size_t> active[bucket_count];
+        char padding[BOOST_LOCKFREE_CACHELINE_BYTES - bucket_count * sizeof(std::size_t)];
+    };
+
+    /* thread stacks are usually aligned to large powers of two, so the address needs to be hashed */
+    static std::size_t stripe_index(const void * address)
+    {
+        boost::uint64_t h = static_cast<boost::uint64_t>(reinterpret_cast<std::size_t>(address));
+        h *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(h >> 32) % stripe_count;
+    }
+
+    static const int padding_size = BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(std::size_t);
+
+    atomic<std::size_t> global_epoch_;
+    char padding1[padding_size];
+    atomic<bool> advancing_;
+    char padding2[padding_size];
+    stripe stripes_[stripe_count];
+
+public:
+    epoch_manager(void):
+        global_epoch_(0), advancing_(false)
+    {
+        for (std::size_t i = 0; i != stripe_count; ++i)
+            for (std::size_t j = 0; j != bucket_count; ++j)
+                stripes_[i].active[j].store(0, memory_order_relaxed);
+    }
+
+    class guard:
+        boost::noncopyable
+    {
+        atomic<std::size_t> * counter_;
+        std::size_t epoch_;
+
+    public:
+        explicit guard(epoch_manager & manager)
+        {
+            stripe & s = manager.stripes_[stripe_index(this)];
+
+            for (;;) {
+                epoch_ = manager.global_epoch_.load(memory_order_acquire);
+                counter_ = &s.active[epoch_ % bucket_count];
+                counter_->fetch_add(1);
+
+                /* the epoch may have been advanced before the guard has been counted */
+                if (manager.global_epoch_.load() == epoch_)
+                    return;
+                counter_->fetch_sub(1, memory_order_release);
+            }
+        }
+
+        ~guard(void)
+        {
+            counter_->fetch_sub(1, memory_order_release);
+        }
+
+        /* index of the bucket that collects memory that has been unlinked inside this guard */
+        std::size_t bucket(void) const
+        {
+            return epoch_ % bucket_count;
+        }
+    };
+
+    /* tries to advance the global epoch. before the epoch is advanced, reclaim(bucket) is called for the bucket that
+     * can be released.
+     *
+     * \returns false, if a guard of the previous epoch is still active or another thread is advancing the epoch */
+    template <typename Reclaimer>
+    bool try_advance(Reclaimer & reclaim)
+    {
+        bool expected = false;
+        if (!advancing_.compare_exchange_strong(expected, true, memory_order_acquire))
+            return false;
+
+        std::size_t epoch = global_epoch_.load(memory_order_relaxed);
+        std::size_t previous = (epoch + bucket_count - 1) % bucket_count;
+
+        bool quiescent = true;
+        for (std::size_t i = 0; i != stripe_count; ++i) {
+            if (stripes_[i].active[previous].load() != 0) {
+                quiescent = false;
+                break;
+            }
+        }
+
+        if (quiescent) {
+            reclaim((epoch + 1) % bucket_count);
+            global_epoch_.store(epoch + 1);
+        }
+
+        advancing_.store(false, memory_order_release);
+        return quiescent;
+    }
+};
+
+} /* namespace detail */
+} /* namespace lockfree */
+} /* namespace boost */
+
+#endif /* BOOST_LOCKFREE_DETAIL_EPOCH_HPP_INCLUDED */
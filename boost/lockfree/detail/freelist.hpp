@@ -19,6 +19,7 @@
 #include <boost/static_assert.hpp>
 
 #include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/epoch.hpp>
 #include <boost/lockfree/detail/parameter.hpp>
 #include <boost/lockfree/detail/tagged_ptr.hpp>
 
@@ -42,6 +43,13 @@ class freelist_stack:
 public:
     typedef tagged_ptr<T> tagged_node_handle;
 
+    /* the nodes are never returned to the allocator while the freelist is alive, so no guard is required */
+    struct reclamation_guard
+    {
+        explicit reclamation_guard(freelist_stack const &)
+        {}
+    };
+
     template <typename Allocator>
     freelist_stack (Allocator const & alloc, std::size_t n = 0):
         Alloc(alloc),
@@ -214,6 +222,42 @@ protected:
             deallocate_impl_unsafe(n);
     }
 
+    /* detaches all nodes from the freelist, they remain linked, see next_free_node */
+    T * detach_free_nodes (void)
+    {
+        tagged_node_ptr old_pool = pool_.load(memory_order_consume);
+
+        for(;;) {
+            if (!old_pool.get_ptr())
+                return NULL;
+
+            tagged_node_ptr new_pool (NULL, old_pool.get_next_tag());
+            if (pool_.compare_exchange_weak(old_pool, new_pool)) {
+                void * ptr = old_pool.get_ptr();
+                return reinterpret_cast<T*>(ptr);
+            }
+        }
+    }
+
+    static T * next_free_node (T * n)
+    {
+        void * node = n;
+        void * next = reinterpret_cast<freelist_node*>(node)->next.get_ptr();
+        return reinterpret_cast<T*>(next);
+    }
+
+    static void set_next_free_node (T * n, T * next)
+    {
+        void * node = n;
+        void * next_node = next;
+        reinterpret_cast<freelist_node*>(node)->next.set_ptr(reinterpret_cast<freelist_node*>(next_node));
+    }
+
+    void release_node (T * n)
+    {
+        Alloc::deallocate(n, 1);
+    }
+
 private:
     void deallocate_impl (T * n)
     {
@@ -245,6 +289,107 @@ private:
     atomic<tagged_node_ptr> pool_;
 };
 
+/* freelist_stack, which can return the free nodes to the allocator.
+ *
+ * nodes in the freelist may still be dereferenced by threads that have loaded a pointer to them before they have been
+ * freed, so all thread-safe operations of the data structure need to run inside a reclamation_guard. nodes that are
+ * detached from the freelist are only released to the allocator after all guards that may have seen them have been left.
+ * */
+template <typename T,
+          typename Alloc = std::allocator<T>
+         >
+class reclaiming_freelist_stack:
+    public freelist_stack<T, Alloc>
+{
+    typedef freelist_stack<T, Alloc> base_type;
+    static const std::size_t bucket_count = 3;
+
+    struct reclaim_bucket
+    {
+        reclaiming_freelist_stack & freelist;
+        std::size_t released;
+
+        explicit reclaim_bucket(reclaiming_freelist_stack & fl):
+            freelist(fl), released(0)
+        {}
+
+        void operator()(std::size_t bucket)
+        {
+            released += freelist.release_nodes(freelist.retired_[bucket].exchange(NULL));
+        }
+    };
+
+public:
+    struct reclamation_guard:
+        epoch_manager::guard
+    {
+        explicit reclamation_guard(reclaiming_freelist_stack & freelist):
+            epoch_manager::guard(freelist.epochs_)
+        {}
+    };
+
+    template <typename Allocator>
+    reclaiming_freelist_stack (Allocator const & alloc, std::size_t n = 0):
+        base_type(alloc, n)
+    {
+        for (std::size_t i = 0; i != bucket_count; ++i)
+            retired_[i].store(NULL, memory_order_relaxed);
+    }
+
+    ~reclaiming_freelist_stack(void)
+    {
+        for (std::size_t i = 0; i != bucket_count; ++i)
+            release_nodes(retired_[i].load(memory_order_relaxed));
+    }
+
+    /* detaches the free nodes and releases the nodes that have been detached before, as far as no guards prevent it.
+     *
+     * \returns number of nodes that have been returned to the allocator */
+    std::size_t shrink(void)
+    {
+        {
+            reclamation_guard guard(*this);
+
+            T * first = base_type::detach_free_nodes();
+            if (first) {
+                T * last = first;
+                while (base_type::next_free_node(last))
+                    last = base_type::next_free_node(last);
+
+                atomic<T*> & bucket = retired_[guard.bucket()];
+                T * old_first = bucket.load(memory_order_relaxed);
+                do {
+                    base_type::set_next_free_node(last, old_first);
+                } while (!bucket.compare_exchange_weak(old_first, first));
+            }
+        }
+
+        /* the nodes can be released after the epoch has been advanced three times */
+        reclaim_bucket reclaim(*this);
+        for (std::size_t i = 0; i != bucket_count; ++i)
+            if (!epochs_.try_advance(reclaim))
+                break;
+
+        return reclaim.released;
+    }
+
+private:
+    std::size_t release_nodes(T * n)
+    {
+        std::size_t released = 0;
+        while (n) {
+            T * next = base_type::next_free_node(n);
+            base_type::release_node(n);
+            n = next;
+            ++released;
+        }
+        return released;
+    }
+
+    epoch_manager epochs_;
+    atomic<T*> retired_[bucket_count];
+};
+
 class tagged_index
 {
 public:
@@ -405,6 +550,13 @@ class fixed_size_freelist:
 public:
     typedef tagged_index tagged_node_handle;
 
+    /* the nodes are stored in an array, which is never released while the freelist is alive */
+    struct reclamation_guard
+    {
+        explicit reclamation_guard(fixed_size_freelist const &)
+        {}
+    };
+
     template <typename Allocator>
     fixed_size_freelist (Allocator const & alloc, std::size_t count):
         NodeStorage(alloc, count),
@@ -600,7 +752,8 @@ template <typename T,
           typename Alloc,
           bool IsCompileTimeSized,
           bool IsFixedSize,
-          std::size_t Capacity
+          std::size_t Capacity,
+          bool IsReclaiming = false
           >
 struct select_freelist
 {
@@ -609,9 +762,14 @@ struct select_freelist
                                runtime_sized_freelist_storage<T, Alloc>
                               >::type fixed_sized_storage_type;
 
+    typedef typename mpl::if_c<IsReclaiming,
+                               reclaiming_freelist_stack<T, Alloc>,
+                               freelist_stack<T, Alloc>
+                              >::type node_based_freelist_type;
+
     typedef typename mpl::if_c<IsCompileTimeSized || IsFixedSize,
                                fixed_size_freelist<T, fixed_sized_storage_type>,
-                               freelist_stack<T, Alloc>
+                               node_based_freelist_type
                               >::type type;
 };
 
@@ -65,6 +65,45 @@ struct extract_fixed_sized
     static const bool value = type::value;
 };
 
+template <typename bound_args>
+struct extract_elimination_backoff
+{
+    static const bool has_elimination_backoff = has_arg<bound_args, tag::elimination_backoff>::value;
+
+    typedef typename mpl::if_c<has_elimination_backoff,
+                               typename has_arg<bound_args, tag::elimination_backoff>::type,
+                               mpl::size_t< 0 >
+                              >::type slots_t;
+
+    static const std::size_t slots = slots_t::value;
+};
+
+template <typename bound_args>
+struct extract_contention_statistics
+{
+    static const bool has_contention_statistics = has_arg<bound_args, tag::contention_statistics>::value;
+
+    typedef typename mpl::if_c<has_contention_statistics,
+                               typename has_arg<bound_args, tag::contention_statistics>::type,
+                               mpl::bool_<false>
+                              >::type type;
+
+    static const bool value = type::value;
+};
+
+template <typename bound_args>
+struct extract_memory_reclamation
+{
+    static const bool has_memory_reclamation = has_arg<bound_args, tag::memory_reclamation>::value;
+
+    typedef typename mpl::if_c<has_memory_reclamation,
+                               typename has_arg<bound_args, tag::memory_reclamation>::type,
+                               mpl::bool_<false>
+                              >::type type;
+
+    static const bool value = type::value;
+};
+
 
 } /* namespace detail */
 } /* namespace lockfree */
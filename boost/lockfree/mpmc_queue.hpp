@@ -0,0 +1,601 @@
+//  lock-free bounded multi-producer/multi-consumer ringbuffer
+//  the algorithm uses a sequence number per slot, as described by
+//  Dmitry Vyukov, "bounded MPMC queue"
+//
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_LOCKFREE_MPMC_QUEUE_HPP_INCLUDED
+#define BOOST_LOCKFREE_MPMC_QUEUE_HPP_INCLUDED
+
+#include <cstddef>
+#include <new>
+
+#include <boost/array.hpp>
+#include <boost/assert.hpp>
+#ifdef BOOST_NO_CXX11_DELETED_FUNCTIONS
+#include <boost/noncopyable.hpp>
+#endif
+#include <boost/static_assert.hpp>
+
+#include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/branch_hints.hpp>
+#include <boost/lockfree/detail/copy_payload.hpp>
+#include <boost/lockfree/detail/parameter.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+
+namespace boost    {
+namespace lockfree {
+namespace detail   {
+
+typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
+                              boost::parameter::optional<tag::capacity>,
+                              boost::parameter::optional<tag::fixed_sized>
+                             > mpmc_queue_signature;
+
+template <typename T>
+struct mpmc_ringbuffer_slot
+{
+    mpmc_ringbuffer_slot(void):
+        sequence(0), data()
+    {}
+
+    /* the position that this slot is waiting for: equal to the position, if
+     * the slot can be written by the push that claims the position, and one
+     * past the position, once the data can be read by the pop. */
+    atomic<std::size_t> sequence;
+    T data;
+};
+
+template <typename T>
+class mpmc_ringbuffer_base
+#ifdef BOOST_NO_CXX11_DELETED_FUNCTIONS
+        : boost::noncopyable
+#endif
+{
+#ifndef BOOST_DOXYGEN_INVOKED
+    typedef std::size_t size_t;
+    static const int padding_size = BOOST_LOCKFREE_CACHELINE_BYTES - sizeof(size_t);
+    atomic<size_t> enqueue_pos_;
+    char padding1[padding_size]; /* force enqueue_pos and dequeue_pos to different cache lines */
+    atomic<size_t> dequeue_pos_;
+    char padding2[padding_size]; /* keep the slots away from dequeue_pos */
+
+#ifndef BOOST_NO_CXX11_DELETED_FUNCTIONS
+    mpmc_ringbuffer_base(mpmc_ringbuffer_base const &) = delete;
+    mpmc_ringbuffer_base(mpmc_ringbuffer_base &&)      = delete;
+    const mpmc_ringbuffer_base& operator=( const mpmc_ringbuffer_base& ) = delete;
+#endif
+
+protected:
+    typedef mpmc_ringbuffer_slot<T> slot;
+
+    mpmc_ringbuffer_base(void):
+        enqueue_pos_(0), dequeue_pos_(0)
+    {}
+
+    static void initialize(slot * buffer, size_t max_size)
+    {
+        for (size_t i = 0; i != max_size; ++i)
+            buffer[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    /* distance between the sequence of a slot and the expected value, taking wrap-around into account */
+    static std::ptrdiff_t sequence_difference(size_t sequence, size_t expected)
+    {
+        return static_cast<std::ptrdiff_t>(sequence - expected);
+    }
+
+    bool push(T const & t, slot * buffer, size_t max_size)
+    {
+        using detail::likely;
+
+        size_t pos = enqueue_pos_.load(memory_order_relaxed);
+        slot * s;
+        for (;;) {
+            s = buffer + pos % max_size;
+            size_t sequence = s->sequence.load(memory_order_acquire);
+            std::ptrdiff_t difference = sequence_difference(sequence, pos);
+
+            if (likely(difference == 0)) {
+                /* the slot is free, try to claim the position */
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false; /* the slot still holds the element from the previous lap: ringbuffer is full */
+            else
+                pos = enqueue_pos_.load(memory_order_relaxed);
+        }
+
+        s->data = t;
+        s->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    template <typename U>
+    bool pop(U & ret, slot * buffer, size_t max_size)
+    {
+        using detail::likely;
+
+        size_t pos = dequeue_pos_.load(memory_order_relaxed);
+        slot * s;
+        for (;;) {
+            s = buffer + pos % max_size;
+            size_t sequence = s->sequence.load(memory_order_acquire);
+            std::ptrdiff_t difference = sequence_difference(sequence, pos + 1);
+
+            if (likely(difference == 0)) {
+                /* the slot holds data, try to claim the position */
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false; /* the slot has not been written: ringbuffer is empty */
+            else
+                pos = dequeue_pos_.load(memory_order_relaxed);
+        }
+
+        detail::copy_payload(s->data, ret);
+        /* hand the slot to the push of the next lap */
+        s->sequence.store(pos + max_size, memory_order_release);
+        return true;
+    }
+
+    bool unsynchronized_push(T const & t, slot * buffer, size_t max_size)
+    {
+        size_t pos = enqueue_pos_.load(memory_order_relaxed);
+        slot * s = buffer + pos % max_size;
+        if (s->sequence.load(memory_order_relaxed) != pos)
+            return false;
+
+        s->data = t;
+        s->sequence.store(pos + 1, memory_order_relaxed);
+        enqueue_pos_.store(pos + 1, memory_order_relaxed);
+        return true;
+    }
+
+    template <typename U>
+    bool unsynchronized_pop(U & ret, slot * buffer, size_t max_size)
+    {
+        size_t pos = dequeue_pos_.load(memory_order_relaxed);
+        slot * s = buffer + pos % max_size;
+        if (s->sequence.load(memory_order_relaxed) != pos + 1)
+            return false;
+
+        detail::copy_payload(s->data, ret);
+        s->sequence.store(pos + max_size, memory_order_relaxed);
+        dequeue_pos_.store(pos + 1, memory_order_relaxed);
+        return true;
+    }
+#endif
+
+public:
+    /** Check if the ringbuffer is empty
+     *
+     * \return true, if the ringbuffer is empty, false otherwise
+     * \note Due to the concurrent nature of the ringbuffer the result may be inaccurate.
+     * */
+    bool empty(void)
+    {
+        return enqueue_pos_.load(memory_order_relaxed) == dequeue_pos_.load(memory_order_relaxed);
+    }
+
+    /**
+     * \return true, if implementation is lock-free.
+     *
+     * */
+    bool is_lock_free(void) const
+    {
+        return enqueue_pos_.is_lock_free() && dequeue_pos_.is_lock_free();
+    }
+};
+
+template <typename T, std::size_t MaxSize>
+class compile_time_sized_mpmc_ringbuffer:
+    public mpmc_ringbuffer_base<T>
+{
+    typedef std::size_t size_t;
+    typedef mpmc_ringbuffer_base<T> base_type;
+    typedef typename base_type::slot slot;
+    static const size_t max_size = MaxSize;
+
+    boost::array<slot, max_size> array_;
+
+public:
+    compile_time_sized_mpmc_ringbuffer(void)
+    {
+        BOOST_STATIC_ASSERT(MaxSize > 0);
+        base_type::initialize(array_.c_array(), max_size);
+    }
+
+    bool push(T const & t)
+    {
+        return base_type::push(t, array_.c_array(), max_size);
+    }
+
+    template <typename U>
+    bool pop(U & ret)
+    {
+        return base_type::pop(ret, array_.c_array(), max_size);
+    }
+
+    bool unsynchronized_push(T const & t)
+    {
+        return base_type::unsynchronized_push(t, array_.c_array(), max_size);
+    }
+
+    template <typename U>
+    bool unsynchronized_pop(U & ret)
+    {
+        return base_type::unsynchronized_pop(ret, array_.c_array(), max_size);
+    }
+};
+
+template <typename T, typename Alloc>
+class runtime_sized_mpmc_ringbuffer:
+    public mpmc_ringbuffer_base<T>,
+    private Alloc
+{
+    typedef std::size_t size_t;
+    typedef mpmc_ringbuffer_base<T> base_type;
+    typedef typename base_type::slot slot;
+    size_t max_elements_;
+    typedef typename Alloc::pointer pointer;
+    pointer array_;
+
+    void initialize(void)
+    {
+        BOOST_ASSERT(max_elements_ > 0);
+        array_ = Alloc::allocate(max_elements_);
+        size_t i = 0;
+        try {
+            for (; i != max_elements_; ++i)
+                new (&*array_ + i) slot();
+        } catch (...) {
+            /* the constructor does not complete, so the destructor will not release the slots */
+            while (i != 0)
+                (&*array_)[--i].~slot();
+            Alloc::deallocate(array_, max_elements_);
+            array_ = pointer();
+            throw;
+        }
+        base_type::initialize(&*array_, max_elements_);
+    }
+
+public:
+    explicit runtime_sized_mpmc_ringbuffer(size_t max_elements):
+        max_elements_(max_elements)
+    {
+        initialize();
+    }
+
+    template <typename U>
+    runtime_sized_mpmc_ringbuffer(typename Alloc::template rebind<U>::other const & alloc, size_t max_elements):
+        Alloc(alloc), max_elements_(max_elements)
+    {
+        initialize();
+    }
+
+    runtime_sized_mpmc_ringbuffer(Alloc const & alloc, size_t max_elements):
+        Alloc(alloc), max_elements_(max_elements)
+    {
+        initialize();
+    }
+
+    ~runtime_sized_mpmc_ringbuffer(void)
+    {
+        for (size_t i = 0; i != max_elements_; ++i)
+            (&*array_)[i].~slot();
+        Alloc::deallocate(array_, max_elements_);
+    }
+
+    bool push(T const & t)
+    {
+        return base_type::push(t, &*array_, max_elements_);
+    }
+
+    template <typename U>
+    bool pop(U & ret)
+    {
+        return base_type::pop(ret, &*array_, max_elements_);
+    }
+
+    bool unsynchronized_push(T const & t)
+    {
+        return base_type::unsynchronized_push(t, &*array_, max_elements_);
+    }
+
+    template <typename U>
+    bool unsynchronized_pop(U & ret)
+    {
+        return base_type::unsynchronized_pop(ret, &*array_, max_elements_);
+    }
+};
+
+template <typename T, typename A0, typename A1, typename A2>
+struct make_mpmc_ringbuffer
+{
+    typedef typename mpmc_queue_signature::bind<A0, A1, A2>::type bound_args;
+
+    typedef extract_capacity<bound_args> extract_capacity_t;
+
+    static const bool runtime_sized = !extract_capacity_t::has_capacity;
+    static const size_t capacity    =  extract_capacity_t::capacity;
+
+    // the ringbuffer is always fixed-sized
+    BOOST_STATIC_ASSERT((extract_fixed_sized<bound_args, true>::value));
+
+    typedef extract_allocator<bound_args, mpmc_ringbuffer_slot<T> > extract_allocator_t;
+    typedef typename extract_allocator_t::type allocator;
+
+    typedef typename mpl::if_c<runtime_sized,
+                               runtime_sized_mpmc_ringbuffer<T, allocator>,
+                               compile_time_sized_mpmc_ringbuffer<T, capacity>
+                              >::type ringbuffer_type;
+};
+
+} /* namespace detail */
+
+
+/** The mpmc_queue class provides a bounded multi-writer/multi-reader fifo queue, pushing and popping is lock-free,
+ *  construction/destruction has to be synchronized.
+ *
+ *  Unlike \ref boost::lockfree::queue, the elements are stored in a ringbuffer of slots rather than in a linked list of nodes.
+ *  Each slot carries a sequence number that tells producers and consumers whether it may be written or read, so a push or pop
+ *  performs a single compare-and-swap on a plain index instead of several on tagged node pointers, and no freelist is needed.
+ *  This greatly reduces the contention between threads, but the capacity can never grow.
+ *
+ *  \b Policies:
+ *  - \ref boost::lockfree::capacity, optional \n
+ *    If this template argument is passed to the options, the size of the ringbuffer is set at compile-time.
+ *
+ *  - \ref boost::lockfree::allocator, defaults to \c boost::lockfree::allocator<std::allocator<void>> \n
+ *    Specifies the allocator that is used to allocate the ringbuffer, if it is sized at run-time. Using an allocator of
+ *    boost.interprocess, the queue can be placed in shared memory.
+ *
+ *  - \ref boost::lockfree::fixed_sized, optional \n
+ *    Accepted for compatibility with \ref boost::lockfree::queue. The mpmc_queue is always fixed-sized.
+ *
+ *  \b Requirements:
+ *   - T must have a default constructor
+ *   - T must be copyable
+ *
+ *  \note A popped element is copied out of its slot, but the slot keeps its copy until it is overwritten by a later push.
+ * */
+#ifndef BOOST_DOXYGEN_INVOKED
+template <typename T,
+          class A0 = boost::parameter::void_,
+          class A1 = boost::parameter::void_,
+          class A2 = boost::parameter::void_>
+#else
+template <typename T, ...Options>
+#endif
+class mpmc_queue:
+    public detail::make_mpmc_ringbuffer<T, A0, A1, A2>::ringbuffer_type
+{
+private:
+
+#ifndef BOOST_DOXYGEN_INVOKED
+    typedef typename detail::make_mpmc_ringbuffer<T, A0, A1, A2>::ringbuffer_type base_type;
+    static const bool runtime_sized = detail::make_mpmc_ringbuffer<T, A0, A1, A2>::runtime_sized;
+    typedef typename detail::make_mpmc_ringbuffer<T, A0, A1, A2>::allocator allocator_arg;
+
+    struct implementation_defined
+    {
+        typedef allocator_arg allocator;
+        typedef std::size_t size_type;
+    };
+#endif
+
+public:
+    typedef T value_type;
+    typedef typename implementation_defined::allocator allocator;
+    typedef typename implementation_defined::size_type size_type;
+
+    /** Constructs a mpmc_queue
+     *
+     *  \pre mpmc_queue must be configured to be sized at compile-time
+     */
+    // @{
+    mpmc_queue(void)
+    {
+        BOOST_ASSERT(!runtime_sized);
+    }
+
+    template <typename U>
+    explicit mpmc_queue(typename allocator::template rebind<U>::other const & alloc)
+    {
+        // just for API compatibility: we don't actually need an allocator
+        BOOST_STATIC_ASSERT(!runtime_sized);
+    }
+
+    explicit mpmc_queue(allocator const & alloc)
+    {
+        // just for API compatibility: we don't actually need an allocator
+        BOOST_ASSERT(!runtime_sized);
+    }
+    // @}
+
+    /** Constructs a mpmc_queue for element_count elements
+     *
+     *  \pre mpmc_queue must be configured to be sized at run-time
+     */
+    // @{
+    explicit mpmc_queue(size_type element_count):
+        base_type(element_count)
+    {
+        BOOST_ASSERT(runtime_sized);
+    }
+
+    template <typename U>
+    mpmc_queue(size_type element_count, typename allocator::template rebind<U>::other const & alloc):
+        base_type(alloc, element_count)
+    {
+        BOOST_STATIC_ASSERT(runtime_sized);
+    }
+
+    mpmc_queue(size_type element_count, allocator_arg const & alloc):
+        base_type(alloc, element_count)
+    {
+        BOOST_ASSERT(runtime_sized);
+    }
+    // @}
+
+    /** Pushes object t to the queue.
+     *
+     * \post object will be pushed to the queue, unless it is full.
+     * \returns true, if the push operation is successful.
+     *
+     * \note Thread-safe and non-blocking
+     * */
+    bool push(T const & t)
+    {
+        return base_type::push(t);
+    }
+
+    /** Pushes object t to the queue.
+     *
+     * \post object will be pushed to the queue, unless it is full.
+     * \returns true, if the push operation is successful.
+     *
+     * \note Thread-safe and non-blocking. Equivalent to push, provided for compatibility with boost::lockfree::queue.
+     * */
+    bool bounded_push(T const & t)
+    {
+        return base_type::push(t);
+    }
+
+    /** Pushes object t to the queue.
+     *
+     * \post object will be pushed to the queue, unless it is full.
+     * \returns true, if the push operation is successful.
+     *
+     * \note Not thread-safe, but non-blocking
+     * */
+    bool unsynchronized_push(T const & t)
+    {
+        return base_type::unsynchronized_push(t);
+    }
+
+    /** Pops object from queue.
+     *
+     * \post if pop operation is successful, object will be copied to ret.
+     * \returns true, if the pop operation is successful, false if queue was empty.
+     *
+     * \note Thread-safe and non-blocking
+     * */
+    bool pop(T & ret)
+    {
+        return pop<T>(ret);
+    }
+
+    /** Pops object from queue.
+     *
+     * \pre type U must be constructible by T and copyable, or T must be convertible to U
+     * \post if pop operation is successful, object will be copied to ret.
+     * \returns true, if the pop operation is successful, false if queue was empty.
+     *
+     * \note Thread-safe and non-blocking
+     * */
+    template <typename U>
+    bool pop(U & ret)
+    {
+        return base_type::pop(ret);
+    }
+
+    /** Pops object from queue.
+     *
+     * \post if pop operation is successful, object will be copied to ret.
+     * \returns true, if the pop operation is successful, false if queue was empty.
+     *
+     * \note Not thread-safe, but non-blocking
+     * */
+    bool unsynchronized_pop(T & ret)
+    {
+        return unsynchronized_pop<T>(ret);
+    }
+
+    /** Pops object from queue.
+     *
+     * \pre type U must be constructible by T and copyable, or T must be convertible to U
+     * \post if pop operation is successful, object will be copied to ret.
+     * \returns true, if the pop operation is successful, false if queue was empty.
+     *
+     * \note Not thread-safe, but non-blocking
+     * */
+    template <typename U>
+    bool unsynchronized_pop(U & ret)
+    {
+        return base_type::unsynchronized_pop(ret);
+    }
+
+    /** consumes one element via a functor
+     *
+     *  pops one element from the queue and applies the functor on this object
+     *
+     * \returns true, if one element was consumed
+     *
+     * \note Thread-safe and non-blocking, if functor is thread-safe and non-blocking
+     * */
+    template <typename Functor>
+    bool consume_one(Functor & f)
+    {
+        T element;
+        bool success = pop(element);
+        if (success)
+            f(element);
+
+        return success;
+    }
+
+    /// \copydoc boost::lockfree::mpmc_queue::consume_one(Functor & rhs)
+    template <typename Functor>
+    bool consume_one(Functor const & f)
+    {
+        T element;
+        bool success = pop(element);
+        if (success)
+            f(element);
+
+        return success;
+    }
+
+    /** consumes all elements via a functor
+     *
+     * sequentially pops all elements from the queue and applies the functor on each object
+     *
+     * \returns number of elements that are consumed
+     *
+     * \note Thread-safe and non-blocking, if functor is thread-safe and non-blocking
+     * */
+    template <typename Functor>
+    size_type consume_all(Functor & f)
+    {
+        size_type element_count = 0;
+        while (consume_one(f))
+            element_count += 1;
+
+        return element_count;
+    }
+
+    /// \copydoc boost::lockfree::mpmc_queue::consume_all(Functor & rhs)
+    template <typename Functor>
+    size_type consume_all(Functor const & f)
+    {
+        size_type element_count = 0;
+        while (consume_one(f))
+            element_count += 1;
+
+        return element_count;
+    }
+};
+
+} /* namespace lockfree */
+} /* namespace boost */
+
+
+#endif /* BOOST_LOCKFREE_MPMC_QUEUE_HPP_INCLUDED */
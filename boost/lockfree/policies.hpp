@@ -21,6 +21,9 @@ namespace lockfree {
 namespace tag { struct allocator ; }
 namespace tag { struct fixed_sized; }
 namespace tag { struct capacity; }
+namespace tag { struct elimination_backoff; }
+namespace tag { struct contention_statistics; }
+namespace tag { struct memory_reclamation; }
 
 #endif
 
@@ -52,6 +55,40 @@ struct allocator:
     boost::parameter::template_keyword<tag::allocator, Alloc>
 {};
 
+/** Enables an \b elimination-backoff array with the given number of slots.
+ *
+ *  If the compare-and-swap on the top of a stack fails, push offers its node in one of the slots for a short while and pop
+ *  checks the slots for an offered node. A matching push/pop pair is completed without touching the top of the stack, which
+ *  reduces the contention under symmetric load. Defaults to 0 slots, which disables elimination.
+ * */
+template <size_t Slots>
+struct elimination_backoff:
+    boost::parameter::template_keyword<tag::elimination_backoff, boost::mpl::size_t<Slots> >
+{};
+
+/** Enables \b contention statistics.
+ *
+ *  The data structure counts failed compare-and-swap operations and eliminated operations. The counters are updated only on
+ *  the contended path, but they are shared between all threads.
+ * */
+template <bool Enable>
+struct contention_statistics:
+    boost::parameter::template_keyword<tag::contention_statistics, boost::mpl::bool_<Enable> >
+{};
+
+/** Enables \b memory reclamation for node-based data structures.
+ *
+ *  By default, the nodes of the internal freelist are only returned to the allocator when the data structure is destroyed.
+ *  With this policy, unused nodes can be returned to the allocator at run-time via shrink_to_fit(). Nodes that other threads
+ *  may still access are only released once these threads have left the operation, which is tracked with epoch-based
+ *  reclamation. Every thread-safe operation pays for entering and leaving an epoch. This cannot be combined with
+ *  fixed_sized<true> or capacity<>.
+ * */
+template <bool Enable>
+struct memory_reclamation:
+    boost::parameter::template_keyword<tag::memory_reclamation, boost::mpl::bool_<Enable> >
+{};
+
 }
 }
 
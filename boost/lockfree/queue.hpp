@@ -16,6 +16,7 @@
 #include <boost/noncopyable.hpp>
 #endif
 #include <boost/static_assert.hpp>
+#include <boost/tuple/tuple.hpp>
 #include <boost/type_traits/has_trivial_assign.hpp>
 #include <boost/type_traits/has_trivial_destructor.hpp>
 
@@ -30,7 +31,8 @@ namespace lockfree {
 namespace detail   {
 
 typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
-                              boost::parameter::optional<tag::capacity>
+                              boost::parameter::optional<tag::capacity>,
+                              boost::parameter::optional<tag::memory_reclamation>
                              > queue_signature;
 
 } /* namespace detail */
@@ -55,6 +57,9 @@ typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
  *  - \ref boost::lockfree::allocator, defaults to \c boost::lockfree::allocator<std::allocator<void>> \n
  *    Specifies the allocator that is used for the internal freelist
  *
+ *  - \ref boost::lockfree::memory_reclamation, defaults to \c boost::lockfree::memory_reclamation<false> \n
+ *    Allows to return unused nodes to the allocator at run-time via shrink_to_fit(). Can only be used with node-based queues.
+ *
  *  \b Requirements:
  *   - T must have a copy constructor
  *   - T must have a trivial assignment operator
@@ -92,6 +97,9 @@ private:
     static const bool fixed_sized = detail::extract_fixed_sized<bound_args>::value;
     static const bool node_based = !(has_capacity || fixed_sized);
     static const bool compile_time_sized = has_capacity;
+    static const bool memory_reclamation = detail::extract_memory_reclamation<bound_args>::value;
+
+    BOOST_STATIC_ASSERT(!memory_reclamation || node_based);
 
     struct BOOST_LOCKFREE_CACHELINE_ALIGNMENT node
     {
@@ -119,7 +127,8 @@ private:
     };
 
     typedef typename detail::extract_allocator<bound_args, node>::type node_allocator;
-    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity>::type pool_t;
+    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity,
+                                             memory_reclamation>::type pool_t;
     typedef typename pool_t::tagged_node_handle tagged_node_handle;
     typedef typename detail::select_tagged_handle<node, node_based>::handle_type handle_type;
 
@@ -230,6 +239,20 @@ public:
         pool.template reserve<false>(n);
     }
 
+    /** Returns the unused nodes of the freelist to the allocator.
+     *
+     * \pre only valid if memory_reclamation<true> is given
+     * \returns number of nodes that have been returned to the allocator
+     *
+     * \note Thread-safe. Nodes that concurrent operations may still access are only returned by a later call, after these
+     *       operations have finished. Afterwards, bounded_push fails until new nodes are allocated by push or reserve.
+     * */
+    size_type shrink_to_fit(void)
+    {
+        BOOST_STATIC_ASSERT(memory_reclamation);
+        return pool.shrink();
+    }
+
     /** Destroys queue, free all nodes from freelist.
      * */
     ~queue(void)
@@ -281,16 +304,12 @@ public:
 
 private:
 #ifndef BOOST_DOXYGEN_INVOKED
-    template <bool Bounded>
-    bool do_push(T const & t)
+    void link_nodes_atomic(node * first_node, node * last_node)
     {
         using detail::likely;
 
-        node * n = pool.template construct<true, Bounded>(t, pool.null_handle());
-        handle_type node_handle = pool.get_handle(n);
-
-        if (n == NULL)
-            return false;
+        handle_type first_handle = pool.get_handle(first_node);
+        handle_type last_handle = pool.get_handle(last_node);
 
         for (;;) {
             tagged_node_handle tail = tail_.load(memory_order_acquire);
@@ -301,11 +320,12 @@ private:
             tagged_node_handle tail2 = tail_.load(memory_order_acquire);
             if (likely(tail == tail2)) {
                 if (next_ptr == 0) {
-                    tagged_node_handle new_tail_next(node_handle, next.get_next_tag());
+                    tagged_node_handle new_tail_next(first_handle, next.get_next_tag());
                     if ( tail_node->next.compare_exchange_weak(next, new_tail_next) ) {
-                        tagged_node_handle new_tail(node_handle, tail.get_next_tag());
+                        /* if this fails, tail_ is advanced node by node by the other threads */
+                        tagged_node_handle new_tail(last_handle, tail.get_next_tag());
                         tail_.compare_exchange_strong(tail, new_tail);
-                        return true;
+                        return;
                     }
                 }
                 else {
@@ -315,10 +335,127 @@ private:
             }
         }
     }
+
+    void link_nodes_unsafe(node * first_node, node * last_node)
+    {
+        for (;;) {
+            tagged_node_handle tail = tail_.load(memory_order_relaxed);
+            node * tail_node = pool.get_pointer(tail);
+            tagged_node_handle next = tail_node->next.load(memory_order_relaxed);
+            node * next_ptr = pool.get_pointer(next);
+
+            if (next_ptr == 0) {
+                tail_node->next.store(tagged_node_handle(pool.get_handle(first_node), next.get_next_tag()), memory_order_relaxed);
+                tail_.store(tagged_node_handle(pool.get_handle(last_node), tail.get_next_tag()), memory_order_relaxed);
+                return;
+            }
+            else
+                tail_.store(tagged_node_handle(pool.get_handle(next_ptr), tail.get_next_tag()), memory_order_relaxed);
+        }
+    }
+
+    template <bool Threadsafe, bool Bounded, typename ConstIterator>
+    tuple<node*, node*> prepare_node_list(ConstIterator begin, ConstIterator end, ConstIterator & ret)
+    {
+        ConstIterator it = begin;
+        node * first_node = pool.template construct<Threadsafe, Bounded>(*it++, pool.null_handle());
+        if (first_node == NULL) {
+            ret = begin;
+            return make_tuple<node*, node*>(NULL, NULL);
+        }
+
+        node * last_node = first_node;
+
+        try {
+            /* link nodes in fifo order, the chain is not visible to other threads before it is linked to the tail */
+            for (; it != end; ++it) {
+                node * newnode = pool.template construct<Threadsafe, Bounded>(*it, pool.null_handle());
+                if (newnode == NULL)
+                    break;
+                tagged_node_handle old_next = last_node->next.load(memory_order_relaxed);
+                last_node->next.store(tagged_node_handle(pool.get_handle(newnode), old_next.get_next_tag()),
+                                      memory_order_relaxed);
+                last_node = newnode;
+            }
+        } catch (...) {
+            for (node * current_node = first_node; current_node != NULL;) {
+                node * next = current_node == last_node ? NULL
+                                                        : pool.get_pointer(current_node->next.load(memory_order_relaxed));
+                pool.template destruct<Threadsafe>(current_node);
+                current_node = next;
+            }
+            throw;
+        }
+        ret = it;
+        return make_tuple(first_node, last_node);
+    }
+
+    template <bool Bounded>
+    bool do_push(T const & t)
+    {
+        typename pool_t::reclamation_guard guard(pool);
+
+        node * n = pool.template construct<true, Bounded>(t, pool.null_handle());
+
+        if (n == NULL)
+            return false;
+
+        link_nodes_atomic(n, n);
+        return true;
+    }
+
+    template <bool Bounded, typename ConstIterator>
+    ConstIterator do_push(ConstIterator begin, ConstIterator end)
+    {
+        if (begin == end)
+            return begin;
+
+        typename pool_t::reclamation_guard guard(pool);
+
+        node * first_node;
+        node * last_node;
+        ConstIterator ret;
+
+        tie(first_node, last_node) = prepare_node_list<true, Bounded>(begin, end, ret);
+        if (first_node)
+            link_nodes_atomic(first_node, last_node);
+
+        return ret;
+    }
 #endif
 
 public:
 
+    /** Pushes as many objects from the range [begin, end) as freelist node can be allocated.
+     *
+     * \return iterator to the first element, which has not been pushed
+     *
+     * \note Operation is applied atomically: the objects are linked to the queue with a single compare-and-swap and
+     *       become visible to consumers in order, without objects of other producers in between.
+     * \note Thread-safe. If internal memory pool is exhausted and the memory pool is not fixed-sized, a new node will be allocated
+     *                    from the OS. This may not be lock-free.
+     * \throws if memory allocator throws
+     * */
+    template <typename ConstIterator>
+    ConstIterator push(ConstIterator begin, ConstIterator end)
+    {
+        return do_push<false, ConstIterator>(begin, end);
+    }
+
+    /** Pushes as many objects from the range [begin, end) as freelist node can be allocated.
+     *
+     * \return iterator to the first element, which has not been pushed
+     *
+     * \note Operation is applied atomically
+     * \note Thread-safe and non-blocking. If internal memory pool is exhausted, the push operation will fail
+     * \throws if memory allocator throws
+     * */
+    template <typename ConstIterator>
+    ConstIterator bounded_push(ConstIterator begin, ConstIterator end)
+    {
+        return do_push<true, ConstIterator>(begin, end);
+    }
+
     /** Pushes object t to the queue.
      *
      * \post object will be pushed to the queue, if internal node can be allocated
@@ -335,19 +472,33 @@ public:
         if (n == NULL)
             return false;
 
-        for (;;) {
-            tagged_node_handle tail = tail_.load(memory_order_relaxed);
-            tagged_node_handle next = tail->next.load(memory_order_relaxed);
-            node * next_ptr = next.get_ptr();
+        link_nodes_unsafe(n, n);
+        return true;
+    }
 
-            if (next_ptr == 0) {
-                tail->next.store(tagged_node_handle(n, next.get_next_tag()), memory_order_relaxed);
-                tail_.store(tagged_node_handle(n, tail.get_next_tag()), memory_order_relaxed);
-                return true;
-            }
-            else
-                tail_.store(tagged_node_handle(next_ptr, tail.get_next_tag()), memory_order_relaxed);
-        }
+    /** Pushes as many objects from the range [begin, end) as freelist node can be allocated.
+     *
+     * \return iterator to the first element, which has not been pushed
+     *
+     * \note Not thread-safe. If internal memory pool is exhausted and the memory pool is not fixed-sized, a new node will be allocated
+     *       from the OS. This may not be lock-free.
+     * \throws if memory allocator throws
+     * */
+    template <typename ConstIterator>
+    ConstIterator unsynchronized_push(ConstIterator begin, ConstIterator end)
+    {
+        if (begin == end)
+            return begin;
+
+        node * first_node;
+        node * last_node;
+        ConstIterator ret;
+
+        tie(first_node, last_node) = prepare_node_list<false, false>(begin, end, ret);
+        if (first_node)
+            link_nodes_unsafe(first_node, last_node);
+
+        return ret;
     }
 
     /** Pops object from queue.
@@ -374,6 +525,8 @@ public:
     bool pop (U & ret)
     {
         using detail::likely;
+        typename pool_t::reclamation_guard guard(pool);
+
         for (;;) {
             tagged_node_handle head = head_.load(memory_order_acquire);
             node * head_ptr = pool.get_pointer(head);
@@ -411,6 +564,88 @@ public:
         }
     }
 
+    /** Pops up to size objects from queue.
+     *
+     * \pre type U must be constructible by T and copyable, or T must be convertible to U
+     * \post the popped objects are copied to ret[0], ret[1], ..., in fifo order
+     * \returns number of popped objects, 0 if queue was empty
+     *
+     * \note Thread-safe and non-blocking. The objects are dequeued with a single compare-and-swap of the queue head.
+     * */
+    template <typename U>
+    size_type pop (U * ret, size_type size)
+    {
+        using detail::likely;
+        if (size == 0)
+            return 0;
+
+        typename pool_t::reclamation_guard guard(pool);
+
+        for (;;) {
+            tagged_node_handle head = head_.load(memory_order_acquire);
+            node * head_ptr = pool.get_pointer(head);
+
+            tagged_node_handle tail = tail_.load(memory_order_acquire);
+            tagged_node_handle next = head_ptr->next.load(memory_order_acquire);
+            node * next_ptr = pool.get_pointer(next);
+
+            tagged_node_handle head2 = head_.load(memory_order_acquire);
+            if (!likely(head == head2))
+                continue;
+
+            if (pool.get_handle(head) == pool.get_handle(tail)) {
+                if (next_ptr == 0)
+                    return 0;
+
+                tagged_node_handle new_tail(pool.get_handle(next), tail.get_next_tag());
+                tail_.compare_exchange_strong(tail, new_tail);
+                continue;
+            }
+
+            if (next_ptr == 0)
+                /* see pop(U &) */
+                continue;
+
+            /* walk towards the tail. the head must not pass the tail, so the walk stops at the tail that has been
+             * loaded above, which may lag behind, but never moves backwards. the payloads have to be copied before
+             * the head is moved, because the nodes may be reused by other threads afterwards. */
+            size_type count = 0;
+            node * new_head_ptr = next_ptr;
+            detail::copy_payload(new_head_ptr->data, ret[count++]);
+
+            bool consistent = true;
+            while (count != size && pool.get_handle(new_head_ptr) != pool.get_handle(tail)) {
+                next = new_head_ptr->next.load(memory_order_acquire);
+                next_ptr = pool.get_pointer(next);
+
+                /* as long as the head is unchanged, the nodes between head and tail cannot be reused */
+                if (head_.load(memory_order_acquire) != head) {
+                    consistent = false;
+                    break;
+                }
+
+                if (next_ptr == 0)
+                    break;
+
+                detail::copy_payload(next_ptr->data, ret[count++]);
+                new_head_ptr = next_ptr;
+            }
+
+            if (!consistent)
+                continue;
+
+            tagged_node_handle new_head(pool.get_handle(new_head_ptr), head.get_next_tag());
+            if (head_.compare_exchange_weak(head, new_head)) {
+                for (size_type i = 0; i != count; ++i) {
+                    node * next_node = pool.get_pointer(head_ptr->next.load(memory_order_relaxed));
+                    pool.template destruct<true>(head_ptr);
+                    head_ptr = next_node;
+                }
+                return count;
+            }
+        }
+    }
+
     /** Pops object from queue.
      *
      * \post if pop operation is successful, object will be copied to ret.
@@ -466,6 +701,25 @@ public:
         }
     }
 
+    /** Pops up to size objects from queue.
+     *
+     * \pre type U must be constructible by T and copyable, or T must be convertible to U
+     * \post the popped objects are copied to ret[0], ret[1], ..., in fifo order
+     * \returns number of popped objects, 0 if queue was empty
+     *
+     * \note Not thread-safe, but non-blocking
+     *
+     * */
+    template <typename U>
+    size_type unsynchronized_pop (U * ret, size_type size)
+    {
+        size_type count = 0;
+        while (count != size && unsynchronized_pop(ret[count]))
+            count += 1;
+
+        return count;
+    }
+
     /** consumes one element via a functor
      *
      *  pops one element from the queue and applies the functor on this object
@@ -19,7 +19,9 @@
 #include <boost/type_traits/has_trivial_destructor.hpp>
 
 #include <boost/lockfree/detail/atomic.hpp>
+#include <boost/lockfree/detail/contention_counters.hpp>
 #include <boost/lockfree/detail/copy_payload.hpp>
+#include <boost/lockfree/detail/elimination_array.hpp>
 #include <boost/lockfree/detail/freelist.hpp>
 #include <boost/lockfree/detail/parameter.hpp>
 #include <boost/lockfree/detail/tagged_ptr.hpp>
@@ -29,7 +31,10 @@ namespace lockfree {
 namespace detail   {
 
 typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
-                              boost::parameter::optional<tag::capacity>
+                              boost::parameter::optional<tag::capacity>,
+                              boost::parameter::optional<tag::elimination_backoff>,
+                              boost::parameter::optional<tag::contention_statistics>,
+                              boost::parameter::optional<tag::memory_reclamation>
                              > stack_signature;
 
 }
@@ -54,6 +59,17 @@ typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
  *  - \c boost::lockfree::allocator<>, defaults to \c boost::lockfree::allocator<std::allocator<void>> <br>
  *    Specifies the allocator that is used for the internal freelist
  *
+ *  - \c boost::lockfree::elimination_backoff<>, defaults to \c boost::lockfree::elimination_backoff<0> <br>
+ *    Number of slots of the elimination array. If a push and a pop fail to update the top of the stack, they can exchange
+ *    the element through one of the slots instead of retrying. This helps under high symmetric push/pop load, but only
+ *    applies to single-element push and pop.
+ *
+ *  - \c boost::lockfree::contention_statistics<>, defaults to \c boost::lockfree::contention_statistics<false> <br>
+ *    Count failed compare-and-swap operations and eliminated push/pop pairs, see cas_failures() and eliminations().
+ *
+ *  - \c boost::lockfree::memory_reclamation<>, defaults to \c boost::lockfree::memory_reclamation<false> <br>
+ *    Allows to return unused nodes to the allocator at run-time via shrink_to_fit(). Can only be used with node-based stacks.
+ *
  *  \b Requirements:
  *  - T must have a copy constructor
  * */
@@ -61,7 +77,8 @@ typedef parameter::parameters<boost::parameter::optional<tag::allocator>,
 template <typename T,
           class A0 = boost::parameter::void_,
           class A1 = boost::parameter::void_,
-          class A2 = boost::parameter::void_>
+          class A2 = boost::parameter::void_,
+          class A3 = boost::parameter::void_>
 #else
 template <typename T, ...Options>
 #endif
@@ -75,13 +92,18 @@ private:
     BOOST_STATIC_ASSERT(boost::has_trivial_assign<T>::value);
     BOOST_STATIC_ASSERT(boost::has_trivial_destructor<T>::value);
 
-    typedef typename detail::stack_signature::bind<A0, A1, A2>::type bound_args;
+    typedef typename detail::stack_signature::bind<A0, A1, A2, A3>::type bound_args;
 
     static const bool has_capacity = detail::extract_capacity<bound_args>::has_capacity;
     static const size_t capacity = detail::extract_capacity<bound_args>::capacity;
     static const bool fixed_sized = detail::extract_fixed_sized<bound_args>::value;
     static const bool node_based = !(has_capacity || fixed_sized);
     static const bool compile_time_sized = has_capacity;
+    static const size_t elimination_slots = detail::extract_elimination_backoff<bound_args>::slots;
+    static const bool has_contention_statistics = detail::extract_contention_statistics<bound_args>::value;
+    static const bool memory_reclamation = detail::extract_memory_reclamation<bound_args>::value;
+
+    BOOST_STATIC_ASSERT(!memory_reclamation || node_based);
 
     struct node
     {
@@ -95,8 +117,10 @@ private:
     };
 
     typedef typename detail::extract_allocator<bound_args, node>::type node_allocator;
-    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity>::type pool_t;
+    typedef typename detail::select_freelist<node, node_allocator, compile_time_sized, fixed_sized, capacity,
+                                             memory_reclamation>::type pool_t;
     typedef typename pool_t::tagged_node_handle tagged_node_handle;
+    typedef detail::elimination_array<tagged_node_handle, elimination_slots> elimination_array_t;
 
     // check compile-time capacity
     BOOST_STATIC_ASSERT((mpl::if_c<has_capacity,
@@ -204,6 +228,20 @@ public:
         pool.template reserve<false>(n);
     }
 
+    /** Returns the unused nodes of the freelist to the allocator.
+     *
+     * \pre only valid if memory_reclamation<true> is given
+     * \returns number of nodes that have been returned to the allocator
+     *
+     * \note Thread-safe. Nodes that concurrent operations may still access are only returned by a later call, after these
+     *       operations have finished. Afterwards, bounded_push fails until new nodes are allocated by push or reserve.
+     * */
+    size_type shrink_to_fit(void)
+    {
+        BOOST_STATIC_ASSERT(memory_reclamation);
+        return pool.shrink();
+    }
+
     /** Destroys stack, free all nodes from freelist.
      *
      *  \note not thread-safe
@@ -221,6 +259,7 @@ private:
     void initialize(void)
     {
         tos.store(tagged_node_handle(pool.null_handle(), 0));
+        elimination.initialize(pool);
     }
 
     void link_nodes_atomic(node * new_top_node, node * end_node)
@@ -232,6 +271,27 @@ private:
 
             if (tos.compare_exchange_weak(old_tos, new_tos))
                 break;
+            counters.count_cas_failure();
+        }
+    }
+
+    void link_node_atomic(node * newnode)
+    {
+        tagged_node_handle old_tos = tos.load(detail::memory_order_relaxed);
+        for (size_t attempt = 0;; ++attempt) {
+            tagged_node_handle new_tos (pool.get_handle(newnode), old_tos.get_tag());
+            newnode->next = pool.get_handle(old_tos);
+
+            if (tos.compare_exchange_weak(old_tos, new_tos))
+                return;
+            counters.count_cas_failure();
+
+            if (elimination_slots != 0) {
+                /* the pair is counted by the pop */
+                if (elimination.try_exchange_push(pool, newnode, &old_tos, attempt))
+                    return;
+                old_tos = tos.load(detail::memory_order_relaxed);
+            }
         }
     }
 
@@ -240,7 +300,7 @@ private:
         tagged_node_handle old_tos = tos.load(detail::memory_order_relaxed);
 
         tagged_node_handle new_tos (pool.get_handle(new_top_node), old_tos.get_tag());
-        end_node->next = pool.get_pointer(old_tos);
+        end_node->next = pool.get_handle(old_tos);
 
         tos.store(new_tos, memory_order_relaxed);
     }
@@ -256,7 +316,7 @@ private:
         }
 
         node * new_top_node = end_node;
-        end_node->next = NULL;
+        end_node->next = pool.null_handle();
 
         try {
             /* link nodes */
@@ -264,12 +324,12 @@ private:
                 node * newnode = pool.template construct<Threadsafe, Bounded>(*it);
                 if (newnode == NULL)
                     break;
-                newnode->next = new_top_node;
+                newnode->next = pool.get_handle(new_top_node);
                 new_top_node = newnode;
             }
         } catch (...) {
             for (node * current_node = new_top_node; current_node != NULL;) {
-                node * next = current_node->next;
+                node * next = pool.get_pointer(current_node->next);
                 pool.template destruct<Threadsafe>(current_node);
                 current_node = next;
             }
@@ -312,17 +372,21 @@ private:
     template <bool Bounded>
     bool do_push(T const & v)
     {
+        typename pool_t::reclamation_guard guard(pool);
+
         node * newnode = pool.template construct<true, Bounded>(v);
         if (newnode == 0)
             return false;
 
-        link_nodes_atomic(newnode, newnode);
+        link_node_atomic(newnode);
         return true;
     }
 
     template <bool Bounded, typename ConstIterator>
     ConstIterator do_push(ConstIterator begin, ConstIterator end)
     {
+        typename pool_t::reclamation_guard guard(pool);
+
         node * new_top_node;
         node * end_node;
         ConstIterator ret;
@@ -435,9 +499,11 @@ public:
     bool pop(U & ret)
     {
         BOOST_STATIC_ASSERT((boost::is_convertible<T, U>::value));
+        typename pool_t::reclamation_guard guard(pool);
+
         tagged_node_handle old_tos = tos.load(detail::memory_order_consume);
 
-        for (;;) {
+        for (size_t attempt = 0;; ++attempt) {
             node * old_tos_pointer = pool.get_pointer(old_tos);
             if (!old_tos_pointer)
                 return false;
@@ -449,6 +515,15 @@ public:
                 pool.template destruct<true>(old_tos);
                 return true;
             }
+            counters.count_cas_failure();
+
+            node * eliminated_node;
+            if (elimination.try_exchange_pop(pool, eliminated_node, &old_tos, attempt)) {
+                counters.count_elimination();
+                detail::copy_payload(eliminated_node->v, ret);
+                pool.template destruct<true>(eliminated_node);
+                return true;
+            }
         }
     }
 
@@ -494,6 +569,91 @@ public:
         return true;
     }
 
+    /** Pops up to size objects from stack.
+     *
+     * \pre type T must be convertible to U
+     * \post the popped objects are copied to ret[0], ret[1], ..., in the order in which pop would have returned them
+     * \returns number of popped objects, 0 if stack was empty
+     *
+     * \note Thread-safe and non-blocking. The objects are detached from the stack with a single compare-and-swap.
+     *
+     * */
+    template <typename U>
+    size_type pop(U * ret, size_type size)
+    {
+        BOOST_STATIC_ASSERT((boost::is_convertible<T, U>::value));
+        if (size == 0)
+            return 0;
+
+        typename pool_t::reclamation_guard guard(pool);
+
+        tagged_node_handle old_tos = tos.load(detail::memory_order_consume);
+
+        for (;;) {
+            node * first_node = pool.get_pointer(old_tos);
+            if (!first_node)
+                return 0;
+
+            node * last_node = first_node;
+            size_type count = 1;
+            bool consistent = true;
+            for (; count != size; ++count) {
+                typename node::handle_t next = last_node->next;
+
+                /* the next pointer of a node is only valid as long as the node has not been popped by another
+                 * thread, because the freelist reuses the node storage. since every pop changes the tag of tos,
+                 * an unchanged tos proves that no node has been popped since old_tos has been loaded. */
+                detail::atomic_thread_fence(detail::memory_order_acquire);
+                tagged_node_handle current_tos = tos.load(detail::memory_order_relaxed);
+                if (current_tos != old_tos) {
+                    old_tos = current_tos;
+                    consistent = false;
+                    break;
+                }
+
+                node * next_node = pool.get_pointer(next);
+                if (!next_node)
+                    break;
+                last_node = next_node;
+            }
+
+            if (!consistent)
+                continue;
+
+            tagged_node_handle new_tos(last_node->next, old_tos.get_next_tag());
+
+            if (tos.compare_exchange_weak(old_tos, new_tos)) {
+                for (size_type i = 0; i != count; ++i) {
+                    node * next_node = pool.get_pointer(first_node->next);
+                    detail::copy_payload(first_node->v, ret[i]);
+                    pool.template destruct<true>(first_node);
+                    first_node = next_node;
+                }
+                return count;
+            }
+            counters.count_cas_failure();
+        }
+    }
+
+    /** Pops up to size objects from stack.
+     *
+     * \pre type T must be convertible to U
+     * \post the popped objects are copied to ret[0], ret[1], ..., in the order in which pop would have returned them
+     * \returns number of popped objects, 0 if stack was empty
+     *
+     * \note Not thread-safe, but non-blocking
+     *
+     * */
+    template <typename U>
+    size_type unsynchronized_pop(U * ret, size_type size)
+    {
+        size_type count = 0;
+        while (count != size && unsynchronized_pop(ret[count]))
+            count += 1;
+
+        return count;
+    }
+
     /** consumes one element via a functor
      *
      *  pops one element from the stack and applies the functor on this object
@@ -565,6 +725,30 @@ public:
         return pool.get_pointer(tos.load()) == NULL;
     }
 
+    /**
+     * \return number of failed compare-and-swap operations on the top of the stack.
+     *
+     * \pre only valid if contention_statistics<true> is given
+     * \note The counter is updated with relaxed atomics, so the value is only accurate, if no other thread modifies the stack.
+     * */
+    size_type cas_failures(void) const
+    {
+        BOOST_STATIC_ASSERT(has_contention_statistics);
+        return counters.cas_failures();
+    }
+
+    /**
+     * \return number of push/pop pairs that have been completed through the elimination array.
+     *
+     * \pre only valid if contention_statistics<true> is given
+     * \note The counter is updated with relaxed atomics, so the value is only accurate, if no other thread modifies the stack.
+     * */
+    size_type eliminations(void) const
+    {
+        BOOST_STATIC_ASSERT(has_contention_statistics);
+        return counters.eliminations();
+    }
+
 private:
 #ifndef BOOST_DOXYGEN_INVOKED
     detail::atomic<tagged_node_handle> tos;
@@ -573,6 +757,9 @@ private:
     char padding[padding_size];
 
     pool_t pool;
+
+    elimination_array_t elimination;
+    detail::contention_counters<has_contention_statistics> counters;
 #endif
 };
 
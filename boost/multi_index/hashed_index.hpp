@@ -438,16 +438,17 @@ public:
     const CompatibleKey& k,
     const CompatibleHash& hash,const CompatiblePred& eq)const
   {
-    std::size_t       buc=buckets.position(hash(k));
-    node_impl_pointer x=buckets.at(buc);
-    node_impl_pointer y=x->next();
-    while(y!=x){
-      if(eq(k,key(node_type::from_impl(y)->value()))){
-        return make_iterator(node_type::from_impl(y));
-      }
-      y=y->next();
-    }
-    return end();
+    return find_in_bucket(k,buckets.position(hash(k)),eq);
+  }
+
+  /* hash must be hash_function()(k), so that it can be computed once
+   * and reused for lookup in several indices.
+   */
+
+  template<typename CompatibleKey>
+  iterator find(const CompatibleKey& k,std::size_t hash)const
+  {
+    return find_in_bucket(k,buckets.position(hash),eq_);
   }
 
   template<typename CompatibleKey>
@@ -463,21 +464,13 @@ public:
     const CompatibleKey& k,
     const CompatibleHash& hash,const CompatiblePred& eq)const
   {
-    size_type         res=0;
-    std::size_t       buc=buckets.position(hash(k));
-    node_impl_pointer x=buckets.at(buc);
-    node_impl_pointer y=x->next();
-    while(y!=x){
-      if(eq(k,key(node_type::from_impl(y)->value()))){
-        do{
-          ++res;
-          y=y->next();
-        }while(y!=x&&eq(k,key(node_type::from_impl(y)->value())));
-        break;
-      }
-      y=y->next();
-    }
-    return res;
+    return count_in_bucket(k,buckets.position(hash(k)),eq);
+  }
+
+  template<typename CompatibleKey>
+  size_type count(const CompatibleKey& k,std::size_t hash)const
+  {
+    return count_in_bucket(k,buckets.position(hash),eq_);
   }
 
   template<typename CompatibleKey>
@@ -493,28 +486,14 @@ public:
     const CompatibleKey& k,
     const CompatibleHash& hash,const CompatiblePred& eq)const
   {
-    std::size_t       buc=buckets.position(hash(k));
-    node_impl_pointer x=buckets.at(buc);
-    node_impl_pointer y=x->next();
-    while(y!=x){
-      if(eq(k,key(node_type::from_impl(y)->value()))){
-        node_impl_pointer y0=y;
-        do{
-          y=y->next();
-        }while(y!=x&&eq(k,key(node_type::from_impl(y)->value())));
-        if(y==x){
-          do{
-            ++y;
-          }while(y==y->next());
-          y=y->next();
-        }
-        return std::pair<iterator,iterator>(
-          make_iterator(node_type::from_impl(y0)),
-          make_iterator(node_type::from_impl(y)));
-      }
-      y=y->next();
-    }
-    return std::pair<iterator,iterator>(end(),end());
+    return equal_range_in_bucket(k,buckets.position(hash(k)),eq);
+  }
+
+  template<typename CompatibleKey>
+  std::pair<iterator,iterator> equal_range(
+    const CompatibleKey& k,std::size_t hash)const
+  {
+    return equal_range_in_bucket(k,buckets.position(hash),eq_);
   }
 
   /* bucket interface */
@@ -1036,6 +1015,68 @@ private:
     node_impl_type::unlink_next(x);
   }
 
+  template<typename CompatibleKey,typename CompatiblePred>
+  iterator find_in_bucket(
+    const CompatibleKey& k,std::size_t buc,const CompatiblePred& eq)const
+  {
+    node_impl_pointer x=buckets.at(buc);
+    node_impl_pointer y=x->next();
+    while(y!=x){
+      if(eq(k,key(node_type::from_impl(y)->value()))){
+        return make_iterator(node_type::from_impl(y));
+      }
+      y=y->next();
+    }
+    return end();
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  size_type count_in_bucket(
+    const CompatibleKey& k,std::size_t buc,const CompatiblePred& eq)const
+  {
+    size_type         res=0;
+    node_impl_pointer x=buckets.at(buc);
+    node_impl_pointer y=x->next();
+    while(y!=x){
+      if(eq(k,key(node_type::from_impl(y)->value()))){
+        do{
+          ++res;
+          y=y->next();
+        }while(y!=x&&eq(k,key(node_type::from_impl(y)->value())));
+        break;
+      }
+      y=y->next();
+    }
+    return res;
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  std::pair<iterator,iterator> equal_range_in_bucket(
+    const CompatibleKey& k,std::size_t buc,const CompatiblePred& eq)const
+  {
+    node_impl_pointer x=buckets.at(buc);
+    node_impl_pointer y=x->next();
+    while(y!=x){
+      if(eq(k,key(node_type::from_impl(y)->value()))){
+        node_impl_pointer y0=y;
+        do{
+          y=y->next();
+        }while(y!=x&&eq(k,key(node_type::from_impl(y)->value())));
+        if(y==x){
+          do{
+            ++y;
+          }while(y==y->next());
+          y=y->next();
+        }
+        return std::pair<iterator,iterator>(
+          make_iterator(node_type::from_impl(y0)),
+          make_iterator(node_type::from_impl(y)));
+      }
+      y=y->next();
+    }
+    return std::pair<iterator,iterator>(end(),end());
+  }
+
   void calculate_max_load()
   {
     float fml=static_cast<float>(mlf*bucket_count());
@@ -26,6 +26,7 @@ class null_mutex
     null_mutex() { }
 
     static void lock() { }
+    static bool try_lock() { return true; }
     static void unlock() { }
 };
 
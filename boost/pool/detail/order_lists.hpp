@@ -0,0 +1,153 @@
+// Copyright (C) 2013 John Maddock
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org for updates, documentation, and revision history.
+
+#ifndef BOOST_POOL_ORDER_LISTS_HPP
+#define BOOST_POOL_ORDER_LISTS_HPP
+
+/*!
+  \file
+  \brief Sorts the free list and the memory block list of a pool into address order.
+  \details Pools that free chunks without keeping their free list ordered use these
+  before an operation that needs it ordered, such as pool::release_memory.
+  Both sorts are bottom-up merge sorts of the linked lists themselves, so they
+  don't allocate any memory. O(N log N) in the length of the list.
+*/
+
+#include <boost/pool/pool.hpp>
+
+#include <climits>
+#include <cstddef>
+#include <functional>
+
+namespace boost {
+
+namespace details {
+namespace pool {
+
+inline void * & order_lists_nextof(void * const ptr)
+{ //! \returns The next chunk after ptr in a free list.
+  return *(static_cast<void **>(ptr));
+}
+
+inline void * merge_free_lists(void * a, void * b)
+{ //! Merges two free lists that are in address order.
+  //! \returns The head of the merged list.
+  std::less<void *> lt;
+  void * head = 0;
+  void ** tail = &head;
+  while (a != 0 && b != 0)
+  {
+    void * & smaller = lt(b, a) ? b : a;
+    *tail = smaller;
+    tail = &order_lists_nextof(smaller);
+    smaller = order_lists_nextof(smaller);
+  }
+  *tail = (a != 0) ? a : b;
+  return head;
+}
+
+template <typename SizeType>
+PODptr<SizeType> merge_block_lists(PODptr<SizeType> a, PODptr<SizeType> b)
+{ //! Merges two memory block lists that are in address order.
+  //! \returns The head of the merged list.
+  std::less<void *> lt;
+  PODptr<SizeType> head;
+  PODptr<SizeType> tail;
+  while (a.valid() && b.valid())
+  {
+    PODptr<SizeType> & smaller = lt(b.begin(), a.begin()) ? b : a;
+    if (tail.valid())
+      tail.next(smaller);
+    else
+      head = smaller;
+    tail = smaller;
+    smaller = smaller.next();
+  }
+  PODptr<SizeType> rest = a.valid() ? a : b;
+  if (tail.valid())
+    tail.next(rest);
+  else
+    head = rest;
+  return head;
+}
+
+inline void * order_free_list(void * first)
+{ //! Sorts the free list starting at first into address order.
+  //! \returns The head of the sorted list.
+  //!
+  //! runs[i] holds a sorted list of 2^i chunks, so no memory is needed besides
+  //! the chunks themselves.
+  void * runs[sizeof(void *) * CHAR_BIT];
+  std::size_t used = 0;
+
+  void * p = first;
+  while (p != 0)
+  {
+    void * run = p;
+    p = order_lists_nextof(p);
+    order_lists_nextof(run) = 0;
+
+    std::size_t i = 0;
+    for (; i < used && runs[i] != 0; ++i)
+    {
+      run = merge_free_lists(runs[i], run);
+      runs[i] = 0;
+    }
+    if (i == used)
+      ++used;
+    runs[i] = run;
+  }
+
+  void * ret = 0;
+  for (std::size_t i = 0; i < used; ++i)
+    if (runs[i] != 0)
+      ret = merge_free_lists(runs[i], ret);
+  return ret;
+}
+
+template <typename SizeType>
+PODptr<SizeType> order_blocks(PODptr<SizeType> list)
+{ //! Sorts the list of memory blocks starting at list into address order.
+  //! \returns The head of the sorted list.
+  //!
+  //! pool::malloc adds each new block to the front of the list, so it is
+  //! usually in reverse order; this uses the same merge sort as order_free_list.
+  PODptr<SizeType> runs[sizeof(void *) * CHAR_BIT];
+  std::size_t used = 0;
+
+  PODptr<SizeType> p = list;
+  while (p.valid())
+  {
+    PODptr<SizeType> run = p;
+    p = p.next();
+    run.next(PODptr<SizeType>());
+
+    std::size_t i = 0;
+    for (; i < used && runs[i].valid(); ++i)
+    {
+      run = merge_block_lists(runs[i], run);
+      runs[i].invalidate();
+    }
+    if (i == used)
+      ++used;
+    runs[i] = run;
+  }
+
+  PODptr<SizeType> ret;
+  for (std::size_t i = 0; i < used; ++i)
+    if (runs[i].valid())
+      ret = merge_block_lists(runs[i], ret);
+  return ret;
+}
+
+} // namespace pool
+} // namespace details
+
+} // namespace boost
+
+#endif
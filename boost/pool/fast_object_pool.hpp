@@ -0,0 +1,430 @@
+// Copyright (C) 2013 John Maddock
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org for updates, documentation, and revision history.
+
+#ifndef BOOST_FAST_OBJECT_POOL_HPP
+#define BOOST_FAST_OBJECT_POOL_HPP
+/*!
+\file
+\brief  Provides a template type boost::fast_object_pool<T, UserAllocator>,
+an object pool whose destroy and free operations are O(1).
+*/
+
+#include <boost/pool/poolfwd.hpp>
+
+// boost::pool
+#include <boost/pool/pool.hpp>
+#include <boost/pool/detail/order_lists.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+// The following code will be put into Boost.Config in a later revision
+#if defined(BOOST_MSVC) || defined(__KCC)
+# define BOOST_NO_TEMPLATE_CV_REF_OVERLOADS
+#endif
+
+// The following code might be put into some Boost.Config header in a later revision
+#ifdef __BORLANDC__
+# pragma option push -w-inl
+#endif
+
+namespace boost {
+
+/*! \brief A template class
+that can be used for fast and efficient memory allocation of objects,
+with O(1) destruction of individual objects.
+It also provides automatic destruction of non-deallocated objects.
+
+\details
+
+<b>T</b> The type of object to allocate/deallocate.
+T must have a non-throwing destructor.
+
+<b>UserAllocator</b>
+Defines the allocator that the underlying Pool will use to allocate memory from the system.
+See <a href="boost_pool/pool/pooling.html#boost_pool.pool.pooling.user_allocator">User Allocators</a> for details.
+
+fast_object_pool has the same interface as \ref object_pool, but
+does not keep its free list in address order: \ref destroy and \ref free
+push the chunk onto the front of the free list in constant time,
+where object_pool has to search the free list for the right position.
+This makes it the better choice for pools holding many objects that are
+created and destroyed in an arbitrary order.
+
+Since the free list is unordered, \ref destroy_all (and so the destructor)
+and \ref release_memory cannot simply walk it alongside the memory blocks.
+Instead they build a temporary map with one bit per chunk, set for the chunks
+in the free list, which takes O(N) time and N/8 bytes of memory. If that memory
+cannot be allocated, they fall back to sorting the free list in place, which
+takes O(F log F) time, where F is the number of free chunks.
+*/
+
+template <typename T, typename UserAllocator>
+class fast_object_pool: protected pool<UserAllocator>
+{ //!
+  public:
+    typedef T element_type; //!< ElementType
+    typedef UserAllocator user_allocator; //!<
+    typedef typename pool<UserAllocator>::size_type size_type; //!<   pool<UserAllocator>::size_type
+    typedef typename pool<UserAllocator>::difference_type difference_type; //!< pool<UserAllocator>::difference_type
+
+  protected:
+    //! \return The underlying boost:: \ref pool storage used by *this.
+    pool<UserAllocator> & store()
+    {
+      return *this;
+    }
+    //! \return The underlying boost:: \ref pool storage used by *this.
+    const pool<UserAllocator> & store() const
+    {
+      return *this;
+    }
+
+    static void * & nextof(void * const ptr)
+    { //! \returns The next memory block after ptr (for the sake of code readability :)
+      return *(static_cast<void **>(ptr));
+    }
+
+    struct block_info
+    { //! A memory block, and the position of its first chunk in a free_map.
+      details::PODptr<size_type> block;
+      size_type first_chunk;
+    };
+
+    struct block_less
+    { //! Orders block_info by address.
+      bool operator()(const block_info & a, const block_info & b) const
+      {
+        return std::less<void *>()(a.block.begin(), b.block.begin());
+      }
+    };
+
+    struct free_map
+    { //! The memory blocks in address order, and a bitmap with one bit per chunk
+      //! that is set if the chunk is in the free list.
+      char * memory;
+      block_info * blocks;
+      size_type num_blocks;
+      unsigned char * free_bits;
+
+      bool is_free(const size_type n) const
+      {
+        return ((free_bits[n / CHAR_BIT] >> (n % CHAR_BIT)) & 1) != 0;
+      }
+    };
+
+    bool build_free_map(free_map & map);
+
+    void order_lists()
+    { //! Sorts the free list and the list of memory blocks into address order,
+      //! without allocating memory. O(F log F).
+      this->first = details::pool::order_free_list(this->first);
+      this->list = details::pool::order_blocks(this->list);
+    }
+
+  public:
+    explicit fast_object_pool(const size_type arg_next_size = 32, const size_type arg_max_size = 0)
+    :
+    pool<UserAllocator>(sizeof(T), arg_next_size, arg_max_size)
+    { //! Constructs a new (empty by default) fast_object_pool.
+      //! \param next_size Number of chunks to request from the system the next time that object needs to allocate system memory (default 32).
+      //! \pre next_size != 0.
+      //! \param max_size Maximum number of chunks to ever request from the system - this puts a cap on the doubling algorithm
+      //! used by the underlying pool.
+    }
+
+    ~fast_object_pool();
+
+    // Returns 0 if out-of-memory.
+    element_type * malloc BOOST_PREVENT_MACRO_SUBSTITUTION()
+    { //! Allocates memory that can hold one object of type ElementType.
+      //!
+      //! If out of memory, returns 0.
+      //!
+      //! Amortized O(1).
+      return static_cast<element_type *>(store().malloc());
+    }
+    void free BOOST_PREVENT_MACRO_SUBSTITUTION(element_type * const chunk)
+    { //! De-Allocates memory that holds a chunk of type ElementType.
+      //!
+      //!  Note that p may not be 0.\n
+      //!
+      //! Note that the destructor for p is not called. O(1).
+      store().free(chunk);
+    }
+    bool is_from(element_type * const chunk) const
+    { /*! \returns true  if chunk was allocated from *this or
+      may be returned as the result of a future allocation from *this.
+
+      Returns false if chunk was allocated from some other pool or
+      may be returned as the result of a future allocation from some other pool.
+
+      Otherwise, the return value is meaningless.
+
+      \note This function may NOT be used to reliably test random pointer values!
+    */
+      return store().is_from(chunk);
+    }
+
+    element_type * construct()
+    { //! \returns A pointer to an object of type T, allocated in memory from the underlying pool
+      //! and default constructed.  The returned objected can be freed by a call to \ref destroy.
+      //! Otherwise the returned object will be automatically destroyed when *this is destroyed.
+      element_type * const ret = (malloc)();
+      if (ret == 0)
+        return ret;
+      try { new (ret) element_type(); }
+      catch (...) { (free)(ret); throw; }
+      return ret;
+    }
+
+#if defined(BOOST_DOXYGEN)
+    template <class Arg1, ... class ArgN>
+    element_type * construct(Arg1&, ... ArgN&)
+    {
+       //! \returns A pointer to an object of type T, allocated in memory from the underlying pool
+       //! and constructed from arguments Arg1 to ArgN.  The returned objected can be freed by a call to \ref destroy.
+       //! Otherwise the returned object will be automatically destroyed when *this is destroyed.
+       //!
+       //! See \ref object_pool::construct for details.
+    }
+#else
+#ifndef BOOST_NO_TEMPLATE_CV_REF_OVERLOADS
+#   include <boost/pool/detail/pool_construct.ipp>
+#else
+#   include <boost/pool/detail/pool_construct_simple.ipp>
+#endif
+#endif
+    void destroy(element_type * const chunk)
+    { //! Destroys an object allocated with \ref construct. O(1).
+      //!
+      //! Equivalent to:
+      //!
+      //! p->~ElementType(); this->free(p);
+      //!
+      //! \pre p must have been previously allocated from *this via a call to \ref construct.
+      chunk->~T();
+      (free)(chunk);
+    }
+
+    void destroy_all();
+
+    bool release_memory();
+
+    size_type get_next_size() const
+    { //! \returns The number of chunks that will be allocated next time we run out of memory.
+      return store().get_next_size();
+    }
+    void set_next_size(const size_type x)
+    { //! Set a new number of chunks to allocate the next time we run out of memory.
+      //! \param x wanted next_size (must not be zero).
+      store().set_next_size(x);
+    }
+};
+
+template <typename T, typename UserAllocator>
+bool fast_object_pool<T, UserAllocator>::build_free_map(free_map & map)
+{ //! Fills in map, allocating its memory from the UserAllocator. O(N + F log B),
+  //! where B is the number of memory blocks.
+  //! \returns false if the memory could not be allocated.
+  const size_type partition_size = this->alloc_size();
+
+  map.num_blocks = 0;
+  size_type num_chunks = 0;
+  for (details::PODptr<size_type> iter = this->list; iter.valid(); iter = iter.next())
+  {
+    ++map.num_blocks;
+    num_chunks += iter.element_size() / partition_size;
+  }
+
+  const size_type table_size = map.num_blocks * sizeof(block_info);
+  const size_type bits_size = (num_chunks + CHAR_BIT - 1) / CHAR_BIT;
+  map.memory = 0;
+  try { map.memory = (UserAllocator::malloc)(table_size + bits_size); }
+  catch (...) { }
+  if (map.memory == 0)
+    return false;
+
+  map.blocks = static_cast<block_info *>(static_cast<void *>(map.memory));
+  map.free_bits = static_cast<unsigned char *>(
+      static_cast<void *>(map.memory + table_size));
+  std::fill(map.free_bits, map.free_bits + bits_size, 0);
+
+  block_info * b = map.blocks;
+  for (details::PODptr<size_type> iter = this->list; iter.valid(); iter = iter.next(), ++b)
+    b->block = iter;
+  std::sort(map.blocks, map.blocks + map.num_blocks, block_less());
+  size_type n = 0;
+  for (b = map.blocks; b != map.blocks + map.num_blocks; ++b)
+  {
+    b->first_chunk = n;
+    n += b->block.element_size() / partition_size;
+  }
+
+  // Find the block of each free chunk: it is the last one starting at or
+  // before the chunk.
+  block_info key;
+  for (void * p = this->first; p != 0; p = nextof(p))
+  {
+    key.block = details::PODptr<size_type>(static_cast<char *>(p), 0);
+    b = std::upper_bound(map.blocks, map.blocks + map.num_blocks, key, block_less()) - 1;
+    n = b->first_chunk + static_cast<size_type>(
+        (static_cast<char *>(p) - b->block.begin()) / partition_size);
+    map.free_bits[n / CHAR_BIT] |= static_cast<unsigned char>(1u << (n % CHAR_BIT));
+  }
+  return true;
+}
+
+template <typename T, typename UserAllocator>
+void fast_object_pool<T, UserAllocator>::destroy_all()
+{ //! Calls the destructor of every object that has not been destroyed, and
+  //! returns all memory blocks to the UserAllocator. O(N).
+  //!
+  //! Afterwards *this is empty and may be used again; all pointers
+  //! previously returned by *this are invalid.
+#ifndef BOOST_POOL_VALGRIND
+  // handle trivial case of invalid list.
+  if (!this->list.valid())
+    return;
+
+  const size_type partition_size = this->alloc_size();
+
+  free_map map;
+  if (build_free_map(map))
+  {
+    for (const block_info * b = map.blocks; b != map.blocks + map.num_blocks; ++b)
+    {
+      size_type n = b->first_chunk;
+      for (char * i = b->block.begin(); i != b->block.end(); i += partition_size, ++n)
+        if (!map.is_free(n))
+          static_cast<T *>(static_cast<void *>(i))->~T();
+    }
+    (UserAllocator::free)(map.memory);
+  }
+  else
+  {
+    // With both lists in address order the free chunks of each block are
+    // next to each other in the free list, as in an object_pool.
+    order_lists();
+
+    void * freed_iter = this->first;
+    details::PODptr<size_type> iter = this->list;
+    do
+    {
+      for (char * i = iter.begin(); i != iter.end(); i += partition_size)
+      {
+        // Skip the chunks that are free,
+        if (i == freed_iter)
+        {
+          freed_iter = nextof(freed_iter);
+          continue;
+        }
+
+        // and destroy the rest.
+        static_cast<T *>(static_cast<void *>(i))->~T();
+      }
+
+      iter = iter.next();
+    } while (iter.valid());
+  }
+#else
+   // destruct all used elements:
+   for(std::set<void*>::iterator pos = this->used_list.begin(); pos != this->used_list.end(); ++pos)
+   {
+      static_cast<T*>(*pos)->~T();
+   }
+#endif
+  // free storage.
+  store().purge_memory();
+}
+
+template <typename T, typename UserAllocator>
+bool fast_object_pool<T, UserAllocator>::release_memory()
+{ //! Frees every memory block that doesn't have any allocated chunks. O(N).
+  //!
+  //! Leaves the free list in address order, so chunks are handed out from the
+  //! remaining blocks lowest address first.
+  //! \returns true if at least one memory block was freed.
+#ifndef BOOST_POOL_VALGRIND
+  if (!this->list.valid())
+    return false;
+
+  free_map map;
+  if (!build_free_map(map))
+  {
+    order_lists();
+    return store().release_memory();
+  }
+
+  const size_type partition_size = this->alloc_size();
+  bool ret = false;
+
+  // Rebuild both lists in address order, leaving out the blocks whose chunks
+  // are all free.
+  details::PODptr<size_type> last_block;
+  void * free_head = 0;
+  void ** free_tail = &free_head;
+  this->list.invalidate();
+
+  for (const block_info * b = map.blocks; b != map.blocks + map.num_blocks; ++b)
+  {
+    const size_type end_chunk = b->first_chunk + b->block.element_size() / partition_size;
+    size_type n = b->first_chunk;
+    while (n != end_chunk && map.is_free(n))
+      ++n;
+    if (n == end_chunk)
+    {
+      (UserAllocator::free)(b->block.begin());
+      ret = true;
+      continue;
+    }
+
+    if (last_block.valid())
+      last_block.next(b->block);
+    else
+      this->list = b->block;
+    last_block = b->block;
+
+    n = b->first_chunk;
+    for (char * i = b->block.begin(); i != b->block.end(); i += partition_size, ++n)
+    {
+      if (map.is_free(n))
+      {
+        *free_tail = i;
+        free_tail = &nextof(i);
+      }
+    }
+  }
+  if (last_block.valid())
+    last_block.next(details::PODptr<size_type>());
+  *free_tail = 0;
+  this->first = free_head;
+
+  (UserAllocator::free)(map.memory);
+  this->next_size = this->start_size;
+  return ret;
+#else
+  return store().release_memory();
+#endif
+}
+
+template <typename T, typename UserAllocator>
+fast_object_pool<T, UserAllocator>::~fast_object_pool()
+{
+  destroy_all();
+}
+
+} // namespace boost
+
+// The following code might be put into some Boost.Config header in a later revision
+#ifdef __BORLANDC__
+# pragma option pop
+#endif
+
+#endif
@@ -205,6 +205,14 @@ class object_pool: protected pool<UserAllocator>
       (free)(chunk);
     }
 
+    void destroy_all();
+
+    bool release_memory()
+    { //! Frees every memory block that doesn't have any allocated chunks.
+      //! \returns true if at least one memory block was freed.
+      return store().release_memory();
+    }
+
     size_type get_next_size() const
     { //! \returns The number of chunks that will be allocated next time we run out of memory.
       return store().get_next_size();
@@ -217,15 +225,18 @@ class object_pool: protected pool<UserAllocator>
 };
 
 template <typename T, typename UserAllocator>
-object_pool<T, UserAllocator>::~object_pool()
-{
+void object_pool<T, UserAllocator>::destroy_all()
+{ //! Calls the destructor of every object that has not been destroyed, and
+  //! returns all memory blocks to the UserAllocator. O(N).
+  //!
+  //! Afterwards *this is empty and may be used again; all pointers
+  //! previously returned by *this are invalid.
 #ifndef BOOST_POOL_VALGRIND
   // handle trivial case of invalid list.
   if (!this->list.valid())
     return;
 
   details::PODptr<size_type> iter = this->list;
-  details::PODptr<size_type> next = iter;
 
   // Start 'freed_iter' at beginning of free list
   void * freed_iter = this->first;
@@ -234,9 +245,6 @@ object_pool<T, UserAllocator>::~object_pool()
 
   do
   {
-    // increment next
-    next = next.next();
-
     // delete all contained objects that aren't freed.
 
     // Iterate 'i' through all chunks in the memory block.
@@ -257,24 +265,24 @@ object_pool<T, UserAllocator>::~object_pool()
       // and continue searching chunks in the memory block.
     }
 
-    // free storage.
-    (UserAllocator::free)(iter.begin());
-
     // increment iter.
-    iter = next;
+    iter = iter.next();
   } while (iter.valid());
-
-  // Make the block list empty so that the inherited destructor doesn't try to
-  // free it again.
-  this->list.invalidate();
 #else
    // destruct all used elements:
    for(std::set<void*>::iterator pos = this->used_list.begin(); pos != this->used_list.end(); ++pos)
    {
       static_cast<T*>(*pos)->~T();
    }
-   // base class will actually free the memory...
 #endif
+  // free storage.
+  store().purge_memory();
+}
+
+template <typename T, typename UserAllocator>
+object_pool<T, UserAllocator>::~object_pool()
+{
+  destroy_all();
 }
 
 } // namespace boost
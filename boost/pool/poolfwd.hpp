@@ -46,6 +46,12 @@ class pool;
 template <typename T, typename UserAllocator = default_user_allocator_new_delete>
 class object_pool;
 
+//
+// Location: <boost/pool/fast_object_pool.hpp>
+//
+template <typename T, typename UserAllocator = default_user_allocator_new_delete>
+class fast_object_pool;
+
 //
 // Location: <boost/pool/singleton_pool.hpp>
 //
@@ -77,6 +83,27 @@ template <typename T,
     unsigned MaxSize = 0>
 class fast_pool_allocator;
 
+//
+// Location: <boost/pool/thread_cached_pool.hpp>
+//
+template <typename Tag, unsigned RequestedSize,
+    typename UserAllocator = default_user_allocator_new_delete,
+    typename Mutex = details::pool::default_mutex,
+    unsigned NextSize = 32,
+    unsigned MaxSize = 0,
+    unsigned BatchSize = 32>
+class thread_cached_pool;
+
+struct thread_cached_pool_allocator_tag;
+
+template <typename T,
+    typename UserAllocator = default_user_allocator_new_delete,
+    typename Mutex = details::pool::default_mutex,
+    unsigned NextSize = 32,
+    unsigned MaxSize = 0,
+    unsigned BatchSize = 32>
+class thread_cached_pool_allocator;
+
 } // namespace boost
 
 #endif
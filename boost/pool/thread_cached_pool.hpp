@@ -0,0 +1,591 @@
+// Copyright (C) 2013 John Maddock
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org for updates, documentation, and revision history.
+
+#ifndef BOOST_THREAD_CACHED_POOL_HPP
+#define BOOST_THREAD_CACHED_POOL_HPP
+
+/*!
+  \file
+  \brief The <tt>thread_cached_pool</tt> class is a singleton pool with a
+  per-thread cache of free chunks in front of it, and
+  <tt>thread_cached_pool_allocator</tt> is a Standard Library allocator
+  which uses it.
+
+  \details Header thread_cached_pool.hpp provides a template class
+  <tt>thread_cached_pool</tt> which, like <tt>singleton_pool</tt>, gives
+  access to a pool shared by all threads. Each thread keeps its own list of
+  free chunks, so most calls to <tt>malloc()</tt> and <tt>free()</tt>
+  don't touch the shared pool or its mutex at all. Chunks are moved between
+  the thread's list and the shared pool in batches.
+*/
+
+#include <boost/pool/poolfwd.hpp>
+
+// boost::pool
+#include <boost/pool/pool.hpp>
+// boost::simple_segregated_storage
+#include <boost/pool/simple_segregated_storage.hpp>
+// boost::details::pool::guard
+#include <boost/pool/detail/guard.hpp>
+#include <boost/pool/detail/order_lists.hpp>
+
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <limits>
+#include <new>
+
+#if defined(BOOST_HAS_THREADS) && !defined(BOOST_NO_MT) && !defined(BOOST_POOL_NO_MT)
+#include <boost/thread/tss.hpp>
+#endif
+
+namespace boost {
+
+namespace details {
+namespace pool {
+
+#if defined(BOOST_HAS_THREADS) && !defined(BOOST_NO_MT) && !defined(BOOST_POOL_NO_MT)
+
+using boost::thread_specific_ptr;
+
+#else
+
+//! Stands in for <tt>boost::thread_specific_ptr</tt> when threading is
+//! disabled: there's only one thread, so there's only one cache.
+template <typename T>
+class thread_specific_ptr
+{
+  private:
+    T * ptr;
+
+    thread_specific_ptr(const thread_specific_ptr &);
+    void operator=(const thread_specific_ptr &);
+
+  public:
+    thread_specific_ptr() : ptr(0) { }
+    ~thread_specific_ptr() { delete ptr; }
+
+    T * get() const { return ptr; }
+    void reset(T * const p = 0)
+    {
+      if (p != ptr)
+        delete ptr;
+      ptr = p;
+    }
+};
+
+#endif
+
+} // namespace pool
+} // namespace details
+
+/*!
+  Counts how often a <tt>thread_cached_pool</tt> has gone to its shared
+  pool. All of the counters are updated while the shared pool's mutex is
+  held.
+*/
+template <typename SizeType>
+struct thread_cached_pool_counters
+{
+  typedef SizeType size_type;
+
+  size_type lock_acquisitions; //!< Number of times the shared pool's mutex has been locked to allocate or free.
+  size_type contended_acquisitions; //!< Number of those times when another thread already held it.
+  size_type refills; //!< Number of batches of chunks moved from the shared pool into a thread's cache.
+  size_type flushes; //!< Number of batches of chunks moved from a thread's cache back to the shared pool.
+
+  thread_cached_pool_counters()
+  :lock_acquisitions(0), contended_acquisitions(0), refills(0), flushes(0)
+  {
+  }
+};
+
+ /*!
+ The thread_cached_pool class provides the same static interface to a shared
+ pool as singleton_pool, but keeps a cache of free chunks for each thread
+ in front of it.
+
+ <tt>malloc()</tt> takes a chunk from the calling thread's cache, and
+ <tt>free()</tt> returns one to it, without any synchronization. When the
+ cache is empty, BatchSize chunks are taken from the shared pool while
+ holding its mutex once; when it holds 2 * BatchSize chunks, BatchSize of
+ them are given back. A chunk can be freed by a different thread from the
+ one that allocated it. When a thread exits, its cache is emptied into the
+ shared pool.
+
+ Requests for more than one contiguous chunk bypass the caches, and are
+ synchronized in the same way as singleton_pool.
+
+ Template parameters are as follows:
+
+ <b>Tag</b> User-specified type to uniquely identify this pool: allows different unbounded sets of pools to exist.
+
+ <b>RequestedSize</b> The size of each chunk returned by member function <tt>malloc()</tt>.
+
+ <B>UserAllocator</b> User allocator, default = default_user_allocator_new_delete.
+
+ <b>Mutex</B> The type of mutex used to protect the shared pool. It must provide
+ <tt>lock()</tt>, <tt>unlock()</tt> and <tt>try_lock()</tt>, as all Boost.Thread mutexes
+ and <tt>boost::details::pool::null_mutex</tt> do.
+
+ <B>NextSize</b> The value of this parameter is passed to the shared pool when it is created and
+ specifies the number of chunks to allocate in the first allocation request (defaults to 32).
+
+ <b>MaxSize</B> The value of this parameter is passed to the shared pool when it is created and
+ specifies the maximum number of chunks to allocate in any single allocation request (defaults to 0).
+
+ <b>BatchSize</B> The number of chunks moved between a thread's cache and the shared pool at
+ a time (defaults to 32).
+
+  <b>Notes:</b>
+
+  There is no <tt>purge_memory()</tt>, since chunks held in the threads' caches would be
+  left dangling, and no <tt>ordered_malloc()</tt> for single chunks, since the caches aren't ordered.
+
+  \attention
+  Like that of singleton_pool, the shared pool <b>is never freed</b>,
+  and neither is the cache of any thread which doesn't exit
+  before main() returns.
+
+  */
+
+ template <typename Tag,
+    unsigned RequestedSize,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned NextSize,
+    unsigned MaxSize,
+    unsigned BatchSize >
+class thread_cached_pool
+{
+  public:
+    typedef Tag tag; //!< The Tag template parameter uniquely identifies this pool.
+    typedef Mutex mutex; //!< The type of mutex used to synchonise access to the shared pool.
+    typedef UserAllocator user_allocator; //!< The user-allocator used by the shared pool.
+    typedef typename pool<UserAllocator>::size_type size_type; //!< size_type of user allocator.
+    typedef typename pool<UserAllocator>::difference_type difference_type; //!< difference_type of user allocator.
+    typedef thread_cached_pool_counters<size_type> counters_type; //!< The type returned by <tt>counters()</tt>.
+
+    BOOST_STATIC_CONSTANT(unsigned, requested_size = RequestedSize); //!< The size of each chunk allocated by this pool.
+    BOOST_STATIC_CONSTANT(unsigned, next_size = NextSize); //!< The number of chunks to allocate on the first allocation.
+    BOOST_STATIC_CONSTANT(unsigned, batch_size = BatchSize); //!< The number of chunks moved to or from a thread's cache at a time.
+
+  private:
+    thread_cached_pool();
+
+    struct cache_type;
+
+    struct pool_type: public Mutex, public pool<UserAllocator>
+    {
+      counters_type counters;
+      details::pool::thread_specific_ptr<cache_type> cache;
+
+      pool_type() : pool<UserAllocator>(RequestedSize, NextSize, MaxSize) {}
+
+#ifndef BOOST_POOL_VALGRIND
+      bool release_memory()
+      { //! Chunks come back from the caches in any order, but pool::release_memory
+        //! needs the free list and the block list to be in address order.
+        this->first = details::pool::order_free_list(this->first);
+        this->list = details::pool::order_blocks(this->list);
+        return pool<UserAllocator>::release_memory();
+      }
+#endif
+    }; //  struct pool_type: Mutex
+
+    //! Locks the shared pool, counting the times that it was already locked.
+    class counted_guard
+    {
+      private:
+        pool_type & p;
+
+        counted_guard(const counted_guard &);
+        void operator=(const counted_guard &);
+
+      public:
+        explicit counted_guard(pool_type & np)
+        :p(np)
+        {
+          if (!p.try_lock())
+          {
+            p.lock();
+            ++p.counters.contended_acquisitions;
+          }
+          ++p.counters.lock_acquisitions;
+        }
+
+        ~counted_guard()
+        {
+          p.unlock();
+        }
+    };
+
+    //! A thread's free chunks, which are linked together in a simple_segregated_storage.
+    struct cache_type
+    {
+      simple_segregated_storage<size_type> chunks;
+      size_type count;
+
+      cache_type() : count(0) {}
+
+      ~cache_type()
+      { //! Called when the owning thread exits.
+        flush(*this, count);
+      }
+    };
+
+  public:
+    static void * malloc BOOST_PREVENT_MACRO_SUBSTITUTION()
+    { //! Returns a chunk from the calling thread's cache, refilling it from the shared pool if it is empty.
+      //! Returns 0 if out-of-memory.
+#ifndef BOOST_POOL_VALGRIND
+      cache_type & c = get_cache();
+      if (c.chunks.empty() && !refill(c))
+        return 0;
+      --c.count;
+      return (c.chunks.malloc)();
+#else
+      pool_type & p = get_pool();
+      counted_guard g(p);
+      return (p.malloc)();
+#endif
+    }
+    static void * ordered_malloc(const size_type n)
+    { //! Equivalent to SingletonPool::p.ordered_malloc(n); synchronized.
+      pool_type & p = get_pool();
+      counted_guard g(p);
+      return p.ordered_malloc(n);
+    }
+    static bool is_from(void * const ptr)
+    { //! Equivalent to SingletonPool::p.is_from(chunk); synchronized.
+      //! Chunks held in a thread's cache are still from this pool.
+      pool_type & p = get_pool();
+      details::pool::guard<Mutex> g(p);
+      return p.is_from(ptr);
+    }
+    static void free BOOST_PREVENT_MACRO_SUBSTITUTION(void * const ptr)
+    { //! Returns a chunk to the calling thread's cache, moving a batch of chunks
+      //! back to the shared pool if the cache is full.
+#ifndef BOOST_POOL_VALGRIND
+      cache_type & c = get_cache();
+      (c.chunks.free)(ptr);
+      if (++c.count >= 2 * static_cast<size_type>(BatchSize))
+        flush(c, BatchSize);
+#else
+      pool_type & p = get_pool();
+      counted_guard g(p);
+      (p.free)(ptr);
+#endif
+    }
+    static void free BOOST_PREVENT_MACRO_SUBSTITUTION(void * const ptr, const size_type n)
+    { //! Equivalent to SingletonPool::p.free(chunk, n); synchronized.
+      pool_type & p = get_pool();
+      counted_guard g(p);
+      (p.free)(ptr, n);
+    }
+    static void release_cache()
+    { //! Returns all the chunks in the calling thread's cache to the shared pool.
+      cache_type * const c = get_pool().cache.get();
+      if (c != 0)
+        flush(*c, c->count);
+    }
+    static bool release_memory()
+    { //! Frees every memory block of the shared pool that has none of its chunks in use or
+      //! in a thread's cache; synchronized. O(F log F) in the number of chunks in the shared
+      //! pool's free list, which is sorted first.
+      pool_type & p = get_pool();
+      details::pool::guard<Mutex> g(p);
+      return p.release_memory();
+    }
+    static counters_type counters()
+    { //! Returns a snapshot of the contention counters; synchronized.
+      pool_type & p = get_pool();
+      details::pool::guard<Mutex> g(p);
+      return p.counters;
+    }
+    static void reset_counters()
+    { //! Sets all the contention counters to zero; synchronized.
+      pool_type & p = get_pool();
+      details::pool::guard<Mutex> g(p);
+      p.counters = counters_type();
+    }
+
+  private:
+    static cache_type & get_cache()
+    {
+      pool_type & p = get_pool();
+      cache_type * c = p.cache.get();
+      if (c == 0)
+      {
+        c = new cache_type;
+        p.cache.reset(c);
+      }
+      return *c;
+    }
+
+    static bool refill(cache_type & c)
+    { //! Moves up to BatchSize chunks from the shared pool to c.
+      pool_type & p = get_pool();
+      counted_guard g(p);
+      for (unsigned i = 0; i < BatchSize; ++i)
+      {
+        void * const chunk = (p.malloc)();
+        if (chunk == 0)
+          break;
+        (c.chunks.free)(chunk);
+        ++c.count;
+      }
+      if (c.count == 0)
+        return false;
+      ++p.counters.refills;
+      return true;
+    }
+
+    static void flush(cache_type & c, size_type n)
+    { //! Moves n chunks from c to the shared pool.
+      if (n == 0)
+        return;
+      pool_type & p = get_pool();
+      counted_guard g(p);
+      for (size_type i = 0; i < n; ++i)
+        (p.free)((c.chunks.malloc)());
+      c.count -= n;
+      ++p.counters.flushes;
+    }
+
+   typedef boost::aligned_storage<sizeof(pool_type), boost::alignment_of<pool_type>::value> storage_type;
+   static storage_type storage;
+
+   static pool_type& get_pool()
+   {
+      static bool f = false;
+      if(!f)
+      {
+         // This code *must* be called before main() starts,
+         // and when only one thread is executing.
+         f = true;
+         new (&storage) pool_type;
+      }
+
+      // The following line does nothing else than force the instantiation
+      //  of create_object, whose constructor is
+      //  called before main() begins.
+      create_object.do_nothing();
+
+      return *static_cast<pool_type*>(static_cast<void*>(&storage));
+   }
+
+   struct object_creator
+   {
+      object_creator()
+      {  // This constructor does nothing more than ensure that get_pool()
+         //  is called before main() begins, thus creating the static
+         //  pool before multithreading race issues can come up.
+         thread_cached_pool<Tag, RequestedSize, UserAllocator, Mutex, NextSize, MaxSize, BatchSize>::get_pool();
+      }
+      inline void do_nothing() const
+      {
+      }
+   };
+   static object_creator create_object;
+}; // class thread_cached_pool
+
+template <typename Tag,
+    unsigned RequestedSize,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned NextSize,
+    unsigned MaxSize,
+    unsigned BatchSize >
+typename thread_cached_pool<Tag, RequestedSize, UserAllocator, Mutex, NextSize, MaxSize, BatchSize>::storage_type thread_cached_pool<Tag, RequestedSize, UserAllocator, Mutex, NextSize, MaxSize, BatchSize>::storage;
+
+template <typename Tag,
+    unsigned RequestedSize,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned NextSize,
+    unsigned MaxSize,
+    unsigned BatchSize >
+typename thread_cached_pool<Tag, RequestedSize, UserAllocator, Mutex, NextSize, MaxSize, BatchSize>::object_creator thread_cached_pool<Tag, RequestedSize, UserAllocator, Mutex, NextSize, MaxSize, BatchSize>::create_object;
+
+//! Simple tag type used by thread_cached_pool_allocator as a template parameter to the underlying thread_cached_pool.
+struct thread_cached_pool_allocator_tag
+{
+};
+
+ /*! \brief A C++ Standard Library conforming allocator which allocates single chunks from a thread_cached_pool.
+
+  <tt>thread_cached_pool_allocator</tt> is a replacement for <tt>fast_pool_allocator</tt>
+  for containers such as <tt>std::list</tt> which are used by several threads at once:
+  single chunks are allocated and deallocated through the calling thread's cache, so
+  threads rarely contend for the shared pool's mutex. Requests for more than one
+  chunk go to the shared pool.
+
+  The template parameters are defined as follows:
+
+  <b>T</b> Type of object to allocate/deallocate.
+
+  <b>UserAllocator</b>. Defines the method that the underlying Pool will use to allocate memory from the system.
+  See <a href="boost_pool/pool/pooling.html#boost_pool.pool.pooling.user_allocator">User Allocators</a> for details.
+
+  <b>Mutex</b> The type of mutex used to protect the shared pool.
+
+  <b>NextSize</b> The value of this parameter is passed to the underlying Pool when it is created.
+
+  <b>MaxSize</b> Limit on the maximum size used.
+
+  <b>BatchSize</b> The number of chunks moved between a thread's cache and the shared pool at a time.
+
+   \attention
+  The underlying thread_cached_pool used by the this allocator
+  constructs a pool instance that
+  <b>is never freed</b>.
+ */
+
+template <typename T,
+    typename UserAllocator,
+    typename Mutex,
+    unsigned NextSize,
+    unsigned MaxSize,
+    unsigned BatchSize >
+class thread_cached_pool_allocator
+{
+  public:
+    typedef T value_type;
+    typedef UserAllocator user_allocator;
+    typedef Mutex mutex;
+    BOOST_STATIC_CONSTANT(unsigned, next_size = NextSize);
+
+    typedef value_type * pointer;
+    typedef const value_type * const_pointer;
+    typedef value_type & reference;
+    typedef const value_type & const_reference;
+    typedef typename pool<UserAllocator>::size_type size_type;
+    typedef typename pool<UserAllocator>::difference_type difference_type;
+
+    typedef thread_cached_pool<thread_cached_pool_allocator_tag, sizeof(T),
+        UserAllocator, Mutex, NextSize, MaxSize, BatchSize> pool_type; //!< The underlying thread_cached_pool.
+
+    //! \brief Nested class rebind allows for transformation from
+    //! thread_cached_pool_allocator<T> to thread_cached_pool_allocator<U>.
+    template <typename U>
+    struct rebind
+    {
+      typedef thread_cached_pool_allocator<U, UserAllocator, Mutex, NextSize, MaxSize, BatchSize> other;
+    };
+
+  public:
+    thread_cached_pool_allocator()
+    {
+      //! Ensures construction of the underlying pool IFF an
+      //! instance of this allocator is constructed during global
+      //! initialization, as fast_pool_allocator does.
+      pool_type::is_from(0);
+    }
+
+    // Default copy constructor used.
+
+    // Default assignment operator used.
+
+    // Not explicit, mimicking std::allocator [20.4.1]
+    template <typename U>
+    thread_cached_pool_allocator(
+        const thread_cached_pool_allocator<U, UserAllocator, Mutex, NextSize, MaxSize, BatchSize> &)
+    {
+      pool_type::is_from(0);
+    }
+
+    // Default destructor used.
+
+    static pointer address(reference r)
+    {
+      return &r;
+    }
+    static const_pointer address(const_reference s)
+    { return &s; }
+    static size_type max_size()
+    { return (std::numeric_limits<size_type>::max)(); }
+    void construct(const pointer ptr, const value_type & t)
+    { new (ptr) T(t); }
+    void destroy(const pointer ptr)
+    { //! Destroy ptr using destructor.
+      ptr->~T();
+      (void) ptr; // Avoid unused variable warning.
+    }
+
+    bool operator==(const thread_cached_pool_allocator &) const
+    { return true; }
+    bool operator!=(const thread_cached_pool_allocator &) const
+    { return false; }
+
+    static pointer allocate(const size_type n)
+    {
+      const pointer ret = (n == 1) ?
+          static_cast<pointer>((pool_type::malloc)()) :
+          static_cast<pointer>(pool_type::ordered_malloc(n));
+      if (ret == 0)
+        boost::throw_exception(std::bad_alloc());
+      return ret;
+    }
+    static pointer allocate(const size_type n, const void * const)
+    { //! Allocate memory .
+      return allocate(n);
+    }
+    static pointer allocate()
+    { //! Allocate memory.
+      const pointer ret = static_cast<pointer>((pool_type::malloc)());
+      if (ret == 0)
+        boost::throw_exception(std::bad_alloc());
+      return ret;
+    }
+    static void deallocate(const pointer ptr, const size_type n)
+    { //! Deallocate memory.
+
+#ifdef BOOST_NO_PROPER_STL_DEALLOCATE
+      if (ptr == 0 || n == 0)
+        return;
+#endif
+      if (n == 1)
+        (pool_type::free)(ptr);
+      else
+        (pool_type::free)(ptr, n);
+    }
+    static void deallocate(const pointer ptr)
+    { //! deallocate/free
+      (pool_type::free)(ptr);
+    }
+};
+
+/*!  \brief Specialization of thread_cached_pool_allocator<void>.
+
+Specialization of thread_cached_pool_allocator<void> required to make the allocator standard-conforming.
+*/
+template<
+    typename UserAllocator,
+    typename Mutex,
+    unsigned NextSize,
+    unsigned MaxSize,
+    unsigned BatchSize >
+class thread_cached_pool_allocator<void, UserAllocator, Mutex, NextSize, MaxSize, BatchSize>
+{
+public:
+    typedef void*       pointer;
+    typedef const void* const_pointer;
+    typedef void        value_type;
+
+    //! \brief Nested class rebind allows for transformation from
+    //! thread_cached_pool_allocator<T> to thread_cached_pool_allocator<U>.
+    template <class U> struct rebind
+    {
+        typedef thread_cached_pool_allocator<U, UserAllocator, Mutex, NextSize, MaxSize, BatchSize> other;
+    };
+};
+
+} // namespace boost
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef BOOST_THREAD_ADAPTIVE_MUTEX_HPP
+#define BOOST_THREAD_ADAPTIVE_MUTEX_HPP
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2013. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/thread for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/lockable_traits.hpp>
+#if defined BOOST_THREAD_USES_DATETIME
+#include <boost/thread/thread_time.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/chrono/ceil.hpp>
+#endif
+#include <boost/smart_ptr/detail/yield_k.hpp>
+#include <boost/atomic.hpp>
+#include <boost/assert.hpp>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace thread_detail
+  {
+    /**
+     * The state machine shared by adaptive_mutex and adaptive_timed_mutex.
+     *
+     * The mutex is a word that is unlocked, locked or locked with possibly blocked waiters. An
+     * uncontended lock and unlock are one compare-and-swap each. A contended lock first
+     * spins with exponential backoff, watching the word without writing it, and only then blocks
+     * on an internal mutex and condition variable; unlock signals them only when the word says
+     * that somebody may be blocked.
+     */
+    class adaptive_mutex_base
+    {
+    public:
+      BOOST_THREAD_NO_COPYABLE(adaptive_mutex_base)
+
+      explicit adaptive_mutex_base(unsigned spin_limit) :
+        state_(unlocked), spin_limit_(spin_limit), contended_locks_(0), blocked_locks_(0)
+      {
+      }
+
+      /**
+       * The number of pause instructions spent spinning before blocking: 0 on a single processor,
+       * where the owner cannot make progress while we spin.
+       */
+      static unsigned default_spin_limit()
+      {
+        static const unsigned limit = thread::hardware_concurrency() > 1 ? 4000 : 0;
+        return limit;
+      }
+
+      unsigned spin_limit() const
+      {
+        return spin_limit_;
+      }
+
+      void lock()
+      {
+        if (try_lock() || spin())
+          return;
+        unique_lock<mutex> lk(mtx_);
+        while (state_.exchange(contended, memory_order_acquire) != unlocked)
+          cond_.wait(lk);
+      }
+
+      bool try_lock()
+      {
+        int expected = unlocked;
+        return state_.compare_exchange_strong(expected, locked, memory_order_acquire, memory_order_relaxed);
+      }
+
+      void unlock()
+      {
+        int expected = locked;
+        if (state_.compare_exchange_strong(expected, unlocked, memory_order_release, memory_order_relaxed))
+          return;
+        BOOST_ASSERT(expected == contended);
+        // released under mtx_, so a blocked thread cannot take the mutex, unlock it and destroy it
+        // before we are done with mtx_
+        lock_guard<mutex> lk(mtx_);
+        state_.store(unlocked, memory_order_release);
+        cond_.notify_one();
+      }
+
+      // Contention counters
+
+      /// the number of lock attempts that found the mutex owned
+      unsigned long contended_locks() const
+      {
+        return contended_locks_.load(memory_order_relaxed);
+      }
+
+      /// the number of those contended attempts that gave up spinning and blocked
+      unsigned long blocked_locks() const
+      {
+        return blocked_locks_.load(memory_order_relaxed);
+      }
+
+      void reset_contention_counters()
+      {
+        contended_locks_.store(0, memory_order_relaxed);
+        blocked_locks_.store(0, memory_order_relaxed);
+      }
+
+    protected:
+      enum { unlocked = 0, locked = 1, contended = 2 };
+
+      // a notification may have been consumed by a wait that timed out: take the mutex if it was
+      // released meanwhile, otherwise its owner still sees it contended and will notify again
+      bool acquire_after_timeout()
+      {
+        return state_.exchange(contended, memory_order_acquire) == unlocked;
+      }
+
+      // returns true if the mutex was acquired while spinning
+      bool spin()
+      {
+        contended_locks_.fetch_add(1, memory_order_relaxed);
+        const unsigned max_backoff = 64;
+        unsigned backoff = 1;
+        for (unsigned spun = 0; spun < spin_limit_; spun += backoff)
+        {
+          for (unsigned i = 0; i < backoff; ++i)
+          {
+#if defined(BOOST_SMT_PAUSE)
+            BOOST_SMT_PAUSE
+#endif
+          }
+          if (backoff < max_backoff)
+            backoff *= 2;
+          if (state_.load(memory_order_relaxed) == unlocked && try_lock())
+            return true;
+        }
+        blocked_locks_.fetch_add(1, memory_order_relaxed);
+        return false;
+      }
+
+      atomic<int> state_;
+      const unsigned spin_limit_;
+      atomic<unsigned long> contended_locks_;
+      atomic<unsigned long> blocked_locks_;
+      mutex mtx_;
+      condition_variable cond_;
+    };
+  }
+
+  /**
+   * A mutex that spins for a while before blocking, for short critical sections.
+   *
+   * Models Lockable, so it can be used with unique_lock, condition_variable_any and the lock
+   * algorithms. It is neither recursive nor fair: a spinning thread may overtake blocked ones.
+   */
+  class adaptive_mutex : public thread_detail::adaptive_mutex_base
+  {
+  public:
+    BOOST_THREAD_NO_COPYABLE(adaptive_mutex)
+
+    adaptive_mutex() :
+      adaptive_mutex_base(default_spin_limit())
+    {
+    }
+
+    explicit adaptive_mutex(unsigned spin_limit) :
+      adaptive_mutex_base(spin_limit)
+    {
+    }
+  };
+
+  /**
+   * An adaptive_mutex that models TimedLockable.
+   */
+  class adaptive_timed_mutex : public thread_detail::adaptive_mutex_base
+  {
+  public:
+    BOOST_THREAD_NO_COPYABLE(adaptive_timed_mutex)
+
+    adaptive_timed_mutex() :
+      adaptive_mutex_base(default_spin_limit())
+    {
+    }
+
+    explicit adaptive_timed_mutex(unsigned spin_limit) :
+      adaptive_mutex_base(spin_limit)
+    {
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock(system_time const& abs_time)
+    {
+      if (try_lock() || spin())
+        return true;
+      unique_lock<mutex> lk(mtx_);
+      while (state_.exchange(contended, memory_order_acquire) != unlocked)
+      {
+        if (!cond_.timed_wait(lk, abs_time))
+        {
+          return acquire_after_timeout();
+        }
+      }
+      return true;
+    }
+
+    template<typename Duration>
+    bool timed_lock(Duration const& relative_time)
+    {
+      return timed_lock(get_system_time()+relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      if (try_lock() || spin())
+        return true;
+      unique_lock<mutex> lk(mtx_);
+      while (state_.exchange(contended, memory_order_acquire) != unlocked)
+      {
+        if (cv_status::timeout == cond_.wait_until(lk, abs_time))
+        {
+          return acquire_after_timeout();
+        }
+      }
+      return true;
+    }
+#endif
+  };
+
+  namespace sync
+  {
+#ifdef BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES
+    template<>
+    struct is_basic_lockable<adaptive_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<adaptive_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_basic_lockable<adaptive_timed_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<adaptive_timed_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,182 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#ifndef BOOST_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
+#define BOOST_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/atomic.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace thread_detail
+  {
+    /**
+     * Chase-Lev work-stealing deque.
+     *
+     * The owner thread pushes and pops at the bottom, any other thread steals from the top.
+     * Only the owner may call push() and pop(); steal() may be called concurrently from any thread.
+     * The buffer grows on demand; retired buffers are kept until destruction because a concurrent
+     * thief may still be reading from them.
+     *
+     * The memory orderings follow "Correct and Efficient Work-Stealing for Weak Memory Models"
+     * (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+     *
+     * ValueType must be trivially copyable; the thread pool stores raw pointers.
+     */
+    template <typename ValueType>
+    class work_stealing_deque
+    {
+    public:
+      typedef ValueType value_type;
+      typedef std::size_t size_type;
+
+    private:
+      struct circular_array
+      {
+        size_type log_size_;
+        atomic<value_type>* buffer_;
+        circular_array* previous_;
+
+        explicit circular_array(size_type log_size) :
+          log_size_(log_size), buffer_(new atomic<value_type>[size_type(1) << log_size]), previous_(0)
+        {
+        }
+        ~circular_array()
+        {
+          delete[] buffer_;
+        }
+
+        size_type size() const
+        {
+          return size_type(1) << log_size_;
+        }
+        value_type get(std::ptrdiff_t i) const
+        {
+          return buffer_[i & (size() - 1)].load(memory_order_relaxed);
+        }
+        void put(std::ptrdiff_t i, value_type x)
+        {
+          buffer_[i & (size() - 1)].store(x, memory_order_relaxed);
+        }
+        circular_array* grow(std::ptrdiff_t bottom, std::ptrdiff_t top)
+        {
+          circular_array* a = new circular_array(log_size_ + 1);
+          for (std::ptrdiff_t i = top; i != bottom; ++i)
+            a->put(i, get(i));
+          a->previous_ = this;
+          return a;
+        }
+      };
+
+    public:
+      BOOST_THREAD_NO_COPYABLE(work_stealing_deque)
+
+      explicit work_stealing_deque(size_type log_initial_size = 8) :
+        top_(0), bottom_(0), array_(new circular_array(log_initial_size))
+      {
+      }
+
+      ~work_stealing_deque()
+      {
+        circular_array* a = array_.load(memory_order_relaxed);
+        while (a)
+        {
+          circular_array* previous = a->previous_;
+          delete a;
+          a = previous;
+        }
+      }
+
+      /**
+       * Pushes @c x at the bottom.
+       * Called only by the owner.
+       */
+      void push(value_type x)
+      {
+        std::ptrdiff_t b = bottom_.load(memory_order_relaxed);
+        std::ptrdiff_t t = top_.load(memory_order_acquire);
+        circular_array* a = array_.load(memory_order_relaxed);
+        if (b - t > static_cast<std::ptrdiff_t>(a->size()) - 1)
+        {
+          a = a->grow(b, t);
+          array_.store(a, memory_order_release);
+        }
+        a->put(b, x);
+        atomic_thread_fence(memory_order_release);
+        bottom_.store(b + 1, memory_order_relaxed);
+      }
+
+      /**
+       * Pops the most recently pushed element.
+       * Called only by the owner.
+       * @return whether an element was popped.
+       */
+      bool pop(value_type& x)
+      {
+        std::ptrdiff_t b = bottom_.load(memory_order_relaxed) - 1;
+        circular_array* a = array_.load(memory_order_relaxed);
+        bottom_.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        std::ptrdiff_t t = top_.load(memory_order_relaxed);
+        if (t > b)
+        {
+          // empty
+          bottom_.store(b + 1, memory_order_relaxed);
+          return false;
+        }
+        x = a->get(b);
+        if (t == b)
+        {
+          // last element: race against the thieves
+          bool won = top_.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+          bottom_.store(b + 1, memory_order_relaxed);
+          return won;
+        }
+        return true;
+      }
+
+      /**
+       * Steals the least recently pushed element.
+       * May be called by any thread.
+       * @return whether an element was stolen. A false result does not imply the deque is empty
+       * as the steal may have lost a race against the owner or another thief.
+       */
+      bool steal(value_type& x)
+      {
+        std::ptrdiff_t t = top_.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        std::ptrdiff_t b = bottom_.load(memory_order_acquire);
+        if (t >= b) return false;
+        circular_array* a = array_.load(memory_order_acquire);
+        x = a->get(t);
+        return top_.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+      }
+
+      /**
+       * @return whether the deque looked empty. Only a hint when called concurrently.
+       */
+      bool empty() const
+      {
+        return bottom_.load(memory_order_relaxed) <= top_.load(memory_order_relaxed);
+      }
+
+    private:
+      atomic<std::ptrdiff_t> top_;
+      // keep the owner's index away from the one written by the thieves
+      char pad_[64 - sizeof(atomic<std::ptrdiff_t>)];
+      atomic<std::ptrdiff_t> bottom_;
+      atomic<circular_array*> array_;
+    };
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -59,6 +59,15 @@
 #include <boost/utility/result_of.hpp>
 #include <boost/thread/thread_only.hpp>
 
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <iterator>
+#if ! defined BOOST_NO_CXX11_VARIADIC_TEMPLATES && ! defined BOOST_NO_CXX11_HDR_TUPLE
+#include <tuple>
+#endif
+#endif
+
 #if defined BOOST_THREAD_PROVIDES_FUTURE
 #define BOOST_THREAD_FUTURE future
 #else
@@ -1404,6 +1413,13 @@ namespace boost
         template <class F, class Rp, class Fp>
         BOOST_THREAD_FUTURE<Rp>
         make_future_deferred_continuation_shared_state(boost::unique_lock<boost::mutex> &lock, F& f, BOOST_THREAD_FWD_REF(Fp) c);
+
+        template<typename Ex, typename F, typename Rp, typename Fp>
+        struct future_executor_continuation_shared_state;
+
+        template <class Ex, class F, class Rp, class Fp>
+        BOOST_THREAD_FUTURE<Rp>
+        make_future_executor_continuation_shared_state(Ex& ex, boost::unique_lock<boost::mutex> &lock, F& f, BOOST_THREAD_FWD_REF(Fp) c);
 #endif
 #if defined BOOST_THREAD_PROVIDES_FUTURE_UNWRAP
         template<typename F, typename Rp>
@@ -1411,6 +1427,10 @@ namespace boost
         template <class F, class Rp>
         inline BOOST_THREAD_FUTURE<Rp>
         make_future_unwrap_shared_state(boost::unique_lock<boost::mutex> &lock, F& f);
+#endif
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
+        template <typename T, bool AnyReady>
+        struct future_when_shared_state;
 #endif
     }
 
@@ -1436,6 +1456,13 @@ namespace boost
         template <class F, class Rp, class Fp>
         friend BOOST_THREAD_FUTURE<Rp>
         detail::make_future_deferred_continuation_shared_state(boost::unique_lock<boost::mutex> &lock, F& f, BOOST_THREAD_FWD_REF(Fp) c);
+
+        template <typename, typename, typename, typename>
+        friend struct detail::future_executor_continuation_shared_state;
+
+        template <class Ex, class F, class Rp, class Fp>
+        friend BOOST_THREAD_FUTURE<Rp>
+        detail::make_future_executor_continuation_shared_state(Ex& ex, boost::unique_lock<boost::mutex> &lock, F& f, BOOST_THREAD_FWD_REF(Fp) c);
 #endif
 #if defined BOOST_THREAD_PROVIDES_FUTURE_UNWRAP
         template<typename F, typename Rp>
@@ -1444,6 +1471,10 @@ namespace boost
         friend BOOST_THREAD_FUTURE<Rp>
         detail::make_future_unwrap_shared_state(boost::unique_lock<boost::mutex> &lock, F& f);
 #endif
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
+        template <typename, bool>
+        friend struct detail::future_when_shared_state;
+#endif
 #if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK
         template <class> friend class packaged_task; // todo check if this works in windows
 #else
@@ -1583,6 +1614,10 @@ namespace boost
         template<typename F>
         inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE&)>::type>
         then(launch policy, BOOST_THREAD_FWD_REF(F) func);
+        // Ex is an executor providing execute(Closure), e.g. thread_pool.
+        template<typename Ex, typename F>
+        inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE&)>::type>
+        then(Ex& ex, BOOST_THREAD_FWD_REF(F) func);
 
         template <typename R2>
         inline typename disable_if< is_void<R2>, BOOST_THREAD_FUTURE<R> >::type
@@ -3859,6 +3894,131 @@ namespace boost
       }
     };
 
+    //////////////////////////
+    /// future_executor_continuation_shared_state
+    //////////////////////////
+    template<typename Ex, typename F, typename Rp, typename Fp>
+    struct future_executor_continuation_shared_state: shared_state<Rp>
+    {
+      Ex* ex;
+      F parent;
+      Fp continuation;
+
+      // keeps the shared state alive while the closure is queued on the executor
+      struct run_it
+      {
+        shared_ptr<future_executor_continuation_shared_state> that;
+        explicit run_it(shared_ptr<future_executor_continuation_shared_state> const& t) : that(t) {}
+        void operator()()
+        {
+          that->run();
+        }
+      };
+
+    public:
+      future_executor_continuation_shared_state(
+          Ex& e, F& f, BOOST_THREAD_FWD_REF(Fp) c
+          ) :
+          ex(&e),
+          parent(f.future_),
+          continuation(boost::move(c))
+      {
+        this->set_async();
+      }
+
+      virtual void launch_continuation(boost::unique_lock<boost::mutex>& lk)
+      {
+        lk.unlock();
+        try
+        {
+          ex->execute(run_it(static_pointer_cast<future_executor_continuation_shared_state>(this->shared_from_this())));
+        }
+        catch (...)
+        {
+          this->mark_exceptional_finish();
+        }
+      }
+
+      void run()
+      {
+        try
+        {
+          this->mark_finished_with_result(continuation(parent));
+        }
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+        catch(thread_interrupted& )
+        {
+          this->mark_interrupted_finish();
+        }
+#endif
+        catch(...)
+        {
+          this->mark_exceptional_finish();
+        }
+      }
+    };
+
+    template<typename Ex, typename F, typename Fp>
+    struct future_executor_continuation_shared_state<Ex, F, void, Fp>: shared_state<void>
+    {
+      Ex* ex;
+      F parent;
+      Fp continuation;
+
+      struct run_it
+      {
+        shared_ptr<future_executor_continuation_shared_state> that;
+        explicit run_it(shared_ptr<future_executor_continuation_shared_state> const& t) : that(t) {}
+        void operator()()
+        {
+          that->run();
+        }
+      };
+
+    public:
+      future_executor_continuation_shared_state(
+          Ex& e, F& f, BOOST_THREAD_FWD_REF(Fp) c
+          ) :
+          ex(&e),
+          parent(f.future_),
+          continuation(boost::move(c))
+      {
+        this->set_async();
+      }
+
+      virtual void launch_continuation(boost::unique_lock<boost::mutex>& lk)
+      {
+        lk.unlock();
+        try
+        {
+          ex->execute(run_it(static_pointer_cast<future_executor_continuation_shared_state>(this->shared_from_this())));
+        }
+        catch (...)
+        {
+          this->mark_exceptional_finish();
+        }
+      }
+
+      void run()
+      {
+        try
+        {
+          continuation(parent);
+          this->mark_finished_with_result();
+        }
+#if defined BOOST_THREAD_PROVIDES_INTERRUPTIONS
+        catch(thread_interrupted& )
+        {
+          this->mark_interrupted_finish();
+        }
+#endif
+        catch(...)
+        {
+          this->mark_exceptional_finish();
+        }
+      }
+    };
+
     ////////////////////////////////
     // make_future_deferred_continuation_shared_state
     ////////////////////////////////
@@ -3891,6 +4051,22 @@ namespace boost
       return BOOST_THREAD_FUTURE<Rp>(h);
     }
 
+    ////////////////////////////////
+    // make_future_executor_continuation_shared_state
+    ////////////////////////////////
+    template<typename Ex, typename F, typename Rp, typename Fp>
+    BOOST_THREAD_FUTURE<Rp>
+    make_future_executor_continuation_shared_state(
+        Ex& ex, boost::unique_lock<boost::mutex> &lock, F& f, BOOST_THREAD_FWD_REF(Fp) c
+        )
+    {
+      shared_ptr<future_executor_continuation_shared_state<Ex, F, Rp, Fp> >
+          h(new future_executor_continuation_shared_state<Ex, F, Rp, Fp>(ex, f, boost::forward<Fp>(c)));
+      f.future_->set_continuation_ptr(h, lock);
+
+      return BOOST_THREAD_FUTURE<Rp>(h);
+    }
+
   }
 
   ////////////////////////////////
@@ -3956,6 +4132,26 @@ namespace boost
   }
 
 
+  ////////////////////////////////
+  // template<typename Ex, typename F>
+  // auto future<R>::then(Ex& ex, F&& func) -> BOOST_THREAD_FUTURE<decltype(func(*this))>;
+  ////////////////////////////////
+
+  template <typename R>
+  template <typename Ex, typename F>
+  inline BOOST_THREAD_FUTURE<typename boost::result_of<F(BOOST_THREAD_FUTURE<R>&)>::type>
+  BOOST_THREAD_FUTURE<R>::then(Ex& ex, BOOST_THREAD_FWD_REF(F) func)
+  {
+
+    typedef typename boost::result_of<F(BOOST_THREAD_FUTURE<R>&)>::type future_type;
+    BOOST_THREAD_ASSERT_PRECONDITION(this->future_!=0, future_uninitialized());
+
+    boost::unique_lock<boost::mutex> lock(this->future_->mutex);
+    return BOOST_THREAD_MAKE_RV_REF((boost::detail::make_future_executor_continuation_shared_state<Ex, BOOST_THREAD_FUTURE<R>, future_type, F>(
+                ex, lock, *this, boost::forward<F>(func)
+            )));
+  }
+
 //#if 0 && defined(BOOST_THREAD_RVALUE_REFERENCES_DONT_MATCH_FUNTION_PTR)
 //  template <typename R>
 //  template<typename RF>
@@ -4181,6 +4377,236 @@ namespace boost
     return boost::detail::make_future_unwrap_shared_state<BOOST_THREAD_FUTURE<BOOST_THREAD_FUTURE<R2> >, R2>(lock, *this);
   }
 #endif
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
+  namespace detail
+  {
+    template <typename T>
+    struct is_future_type
+    {
+      BOOST_STATIC_CONSTANT(bool, value = false);
+    };
+    template <typename T>
+    struct is_future_type<BOOST_THREAD_FUTURE<T> >
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+
+    //////////////////////////
+    /// future_when_shared_state
+    //////////////////////////
+    // The state returned by when_all/when_any. It owns the input futures and is registered as the
+    // continuation of each of their shared states, so no thread waits on them: the input that
+    // makes the condition true marks this state ready from its own completion.
+    // The futures are returned from the state itself, so there is no allocation besides the state.
+    template <typename T, bool AnyReady>
+    struct future_when_shared_state: shared_state<T>
+    {
+      typedef typename shared_state<T>::move_dest_type move_dest_type;
+      typedef typename shared_state<T>::shared_future_get_result_type shared_future_get_result_type;
+
+      T futures;
+      // the number of events before ready, protected by this->mutex. It includes the end of
+      // attach(), so that futures is not moved out while attach() still reads it.
+      std::size_t pending;
+      bool fired;
+
+      explicit future_when_shared_state(BOOST_THREAD_RV_REF(T) f) :
+        futures(boost::move(f)), pending(0), fired(false)
+      {
+        this->set_async();
+      }
+
+      template <typename InputIterator>
+      future_when_shared_state(InputIterator first, InputIterator last) :
+        pending(0), fired(false)
+      {
+        for (; first != last; ++first)
+          futures.push_back(boost::move(*first));
+        this->set_async();
+      }
+
+      BOOST_THREAD_FUTURE<T> attach(std::size_t count)
+      {
+        pending = (AnyReady && count != 0) ? 2 : count + 1;
+        attach_futures(*this, futures);
+        {
+          boost::unique_lock<boost::mutex> lk(this->mutex);
+          count_down(lk);
+        }
+        return BOOST_THREAD_FUTURE<T>(static_pointer_cast<shared_state<T> >(this->shared_from_this()));
+      }
+
+      template <typename F>
+      void attach_to(F& f)
+      {
+        BOOST_THREAD_ASSERT_PRECONDITION(f.future_!=0, future_uninitialized());
+        // a deferred future is only run by a waiter
+        if (int(f.launch_policy()) & int(launch::deferred))
+          f.wait();
+        boost::unique_lock<boost::mutex> lk(f.future_->mutex);
+        f.future_->set_continuation_ptr(this->shared_from_this(), lk);
+      }
+
+      virtual void launch_continuation(boost::unique_lock<boost::mutex>& parent_lock)
+      {
+        parent_lock.unlock();
+        boost::unique_lock<boost::mutex> lk(this->mutex);
+        if (AnyReady)
+        {
+          if (fired) return;
+          fired = true;
+        }
+        count_down(lk);
+      }
+
+      void count_down(boost::unique_lock<boost::mutex>& lk)
+      {
+        if (--pending == 0)
+          this->mark_finished_internal(lk);
+      }
+
+      virtual move_dest_type get()
+      {
+        this->wait();
+        return boost::move(futures);
+      }
+
+      virtual shared_future_get_result_type get_sh()
+      {
+        this->wait();
+        return futures;
+      }
+    };
+
+    template <typename S, typename F>
+    void attach_futures(S& s, std::vector<F>& futures)
+    {
+      for (typename std::vector<F>::iterator it = futures.begin(), end = futures.end(); it != end; ++it)
+        s.attach_to(*it);
+    }
+
+    template <typename InputIterator, bool AnyReady>
+    BOOST_THREAD_FUTURE<std::vector<typename std::iterator_traits<InputIterator>::value_type> >
+    make_future_when_shared_state(InputIterator first, InputIterator last)
+    {
+      typedef std::vector<typename std::iterator_traits<InputIterator>::value_type> container_type;
+      shared_ptr<future_when_shared_state<container_type, AnyReady> >
+          h(boost::make_shared<future_when_shared_state<container_type, AnyReady> >(first, last));
+      return h->attach(h->futures.size());
+    }
+
+#if ! defined BOOST_NO_CXX11_VARIADIC_TEMPLATES && ! defined BOOST_NO_CXX11_HDR_TUPLE
+    template <std::size_t I, std::size_t N>
+    struct attach_tuple_futures
+    {
+      template <typename S, typename Tuple>
+      static void apply(S& s, Tuple& futures)
+      {
+        s.attach_to(std::get<I>(futures));
+        attach_tuple_futures<I+1, N>::apply(s, futures);
+      }
+    };
+    template <std::size_t N>
+    struct attach_tuple_futures<N, N>
+    {
+      template <typename S, typename Tuple>
+      static void apply(S&, Tuple&)
+      {
+      }
+    };
+
+    template <typename S, typename... F>
+    void attach_futures(S& s, std::tuple<F...>& futures)
+    {
+      attach_tuple_futures<0, sizeof...(F)>::apply(s, futures);
+    }
+
+    template <bool AnyReady, typename... F>
+    BOOST_THREAD_FUTURE<std::tuple<typename decay<F>::type...> >
+    make_future_when_shared_state(BOOST_THREAD_FWD_REF(F)... futures)
+    {
+      typedef std::tuple<typename decay<F>::type...> container_type;
+      shared_ptr<future_when_shared_state<container_type, AnyReady> >
+          h(boost::make_shared<future_when_shared_state<container_type, AnyReady> >(
+              container_type(boost::forward<F>(futures)...)));
+      return h->attach(sizeof...(F));
+    }
+#endif
+  }
+
+  ////////////////////////////////
+  // template <class InputIterator>
+  // future<vector<typename iterator_traits<InputIterator>::value_type>> when_all(InputIterator first, InputIterator last);
+  // template <class InputIterator>
+  // future<vector<typename iterator_traits<InputIterator>::value_type>> when_any(InputIterator first, InputIterator last);
+  ////////////////////////////////
+
+  /**
+   * Returns a future that becomes ready when all the futures in [first, last) are ready. Its value
+   * is the vector of the futures moved from the range, each ready with its value or exception.
+   *
+   * The range must contain valid futures (not shared_futures). Deferred futures are run here.
+   */
+  template <typename InputIterator>
+  typename disable_if<detail::is_future_type<InputIterator>,
+    BOOST_THREAD_FUTURE<std::vector<typename std::iterator_traits<InputIterator>::value_type> >
+  >::type
+  when_all(InputIterator first, InputIterator last)
+  {
+    return detail::make_future_when_shared_state<InputIterator, false>(first, last);
+  }
+
+  /**
+   * Returns a future that becomes ready when one of the futures in [first, last) is ready, or at
+   * once if the range is empty. Its value is the vector of the futures moved from the range.
+   */
+  template <typename InputIterator>
+  typename disable_if<detail::is_future_type<InputIterator>,
+    BOOST_THREAD_FUTURE<std::vector<typename std::iterator_traits<InputIterator>::value_type> >
+  >::type
+  when_any(InputIterator first, InputIterator last)
+  {
+    return detail::make_future_when_shared_state<InputIterator, true>(first, last);
+  }
+
+#if ! defined BOOST_NO_CXX11_VARIADIC_TEMPLATES && ! defined BOOST_NO_CXX11_HDR_TUPLE
+  ////////////////////////////////
+  // template <typename... T>
+  // future<tuple<decay_t<T>...>> when_all(T&&... futures);
+  // template <typename... T>
+  // future<tuple<decay_t<T>...>> when_any(T&&... futures);
+  ////////////////////////////////
+
+  inline BOOST_THREAD_FUTURE<std::tuple<> > when_all()
+  {
+    return detail::make_future_when_shared_state<false>();
+  }
+
+  template <typename F, typename... Fs>
+  typename enable_if<detail::is_future_type<typename decay<F>::type>,
+    BOOST_THREAD_FUTURE<std::tuple<typename decay<F>::type, typename decay<Fs>::type...> >
+  >::type
+  when_all(BOOST_THREAD_FWD_REF(F) f, BOOST_THREAD_FWD_REF(Fs)... fs)
+  {
+    return detail::make_future_when_shared_state<false>(boost::forward<F>(f), boost::forward<Fs>(fs)...);
+  }
+
+  inline BOOST_THREAD_FUTURE<std::tuple<> > when_any()
+  {
+    return detail::make_future_when_shared_state<true>();
+  }
+
+  template <typename F, typename... Fs>
+  typename enable_if<detail::is_future_type<typename decay<F>::type>,
+    BOOST_THREAD_FUTURE<std::tuple<typename decay<F>::type, typename decay<Fs>::type...> >
+  >::type
+  when_any(BOOST_THREAD_FWD_REF(F) f, BOOST_THREAD_FWD_REF(Fs)... fs)
+  {
+    return detail::make_future_when_shared_state<true>(boost::forward<F>(f), boost::forward<Fs>(fs)...);
+  }
+#endif
+#endif
 }
 
 #endif // BOOST_NO_EXCEPTION
@@ -0,0 +1,291 @@
+#ifndef BOOST_THREAD_NUMA_HPP
+#define BOOST_THREAD_NUMA_HPP
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2013. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/thread for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/detail/thread_group.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+
+  /**
+   * A NUMA node: the processors sharing a memory controller.
+   */
+  struct numa_node
+  {
+    /// the node number, as used by allocate_on_node
+    unsigned id;
+    /// the online processors of the node that the process may run on, in increasing order
+    std::vector<unsigned> cpus;
+    /// the number of physical cores among cpus, hyper-threads counting once
+    unsigned cores;
+
+    numa_node() : id(0), cores(0) {}
+  };
+
+  namespace thread_detail
+  {
+    // parses the sysfs cpu list format, e.g. "0-3,8,10-11"
+    inline std::vector<unsigned> parse_cpu_list(std::string const& list)
+    {
+      std::vector<unsigned> cpus;
+      std::istringstream in(list);
+      std::string range;
+      while (std::getline(in, range, ','))
+      {
+        if (range.find_first_of("0123456789") == std::string::npos) continue;
+        std::string::size_type dash = range.find('-');
+        unsigned first = unsigned(std::strtoul(range.c_str(), 0, 10));
+        unsigned last = dash == std::string::npos ? first : unsigned(std::strtoul(range.c_str() + dash + 1, 0, 10));
+        for (unsigned cpu = first; cpu <= last; ++cpu)
+          cpus.push_back(cpu);
+      }
+      return cpus;
+    }
+
+    inline bool read_first_line(std::string const& path, std::string& line)
+    {
+      std::ifstream in(path.c_str());
+      return std::getline(in, line) ? true : false;
+    }
+
+    inline std::string cpu_path(unsigned cpu, const char* file)
+    {
+      std::ostringstream path;
+      path << "/sys/devices/system/cpu/cpu" << cpu << "/topology/" << file;
+      return path.str();
+    }
+
+    inline unsigned count_cores(std::vector<unsigned> const& cpus)
+    {
+      std::set<std::pair<std::string, std::string> > cores;
+      for (std::size_t i = 0; i < cpus.size(); ++i)
+      {
+        std::pair<std::string, std::string> core;
+        if (!read_first_line(cpu_path(cpus[i], "physical_package_id"), core.first)
+            || !read_first_line(cpu_path(cpus[i], "core_id"), core.second))
+          return unsigned(cpus.size());
+        cores.insert(core);
+      }
+      return unsigned(cores.size());
+    }
+
+    // removes the processors outside the calling thread's affinity mask, e.g. when the
+    // process is started by taskset or confined by a cpuset cgroup
+    inline void keep_allowed_cpus(std::vector<unsigned>& cpus)
+    {
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+      cpu_set_t allowed;
+      CPU_ZERO(&allowed);
+      if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return;
+      std::vector<unsigned> kept;
+      for (std::size_t i = 0; i < cpus.size(); ++i)
+        if (cpus[i] < CPU_SETSIZE && CPU_ISSET(cpus[i], &allowed))
+          kept.push_back(cpus[i]);
+      cpus.swap(kept);
+#else
+      (void)cpus;
+#endif
+    }
+
+    inline bool node_id_less(numa_node const& lhs, numa_node const& rhs)
+    {
+      return lhs.id < rhs.id;
+    }
+
+    inline std::vector<numa_node> discover_numa_nodes()
+    {
+      std::vector<numa_node> nodes;
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+      if (DIR* dir = opendir("/sys/devices/system/node"))
+      {
+        while (dirent* entry = readdir(dir))
+        {
+          std::string name(entry->d_name);
+          if (name.size() <= 4 || name.compare(0, 4, "node") != 0
+              || name.find_first_not_of("0123456789", 4) != std::string::npos)
+            continue;
+          std::string list;
+          if (!read_first_line("/sys/devices/system/node/" + name + "/cpulist", list))
+            continue;
+          numa_node node;
+          node.id = unsigned(std::strtoul(name.c_str() + 4, 0, 10));
+          node.cpus = parse_cpu_list(list);
+          keep_allowed_cpus(node.cpus);
+          // memory-only nodes, and nodes the process may not run on, have no processor to run
+          // a thread group on
+          if (node.cpus.empty())
+            continue;
+          node.cores = count_cores(node.cpus);
+          nodes.push_back(node);
+        }
+        closedir(dir);
+      }
+#endif
+      if (nodes.empty())
+      {
+        // not a NUMA system, or no sysfs: a single node with every processor
+        numa_node node;
+        std::string list;
+        if (read_first_line("/sys/devices/system/cpu/online", list))
+        {
+          node.cpus = parse_cpu_list(list);
+          keep_allowed_cpus(node.cpus);
+        }
+        if (node.cpus.empty())
+          for (unsigned cpu = 0, n = (std::max)(thread::hardware_concurrency(), 1u); cpu < n; ++cpu)
+            node.cpus.push_back(cpu);
+        node.cores = count_cores(node.cpus);
+        nodes.push_back(node);
+      }
+      std::sort(nodes.begin(), nodes.end(), node_id_less);
+      return nodes;
+    }
+  }
+
+  /**
+   * The NUMA nodes of the machine that have processors the process may run on, ordered by id.
+   * Never empty: a machine without NUMA information is reported as one node holding all the
+   * processors. The topology is read from sysfs once, and restricted to the affinity mask of
+   * the thread making the first call.
+   */
+  inline std::vector<numa_node> const& numa_nodes()
+  {
+    static const std::vector<numa_node> nodes = thread_detail::discover_numa_nodes();
+    return nodes;
+  }
+
+  namespace this_thread
+  {
+    /**
+     * Restricts the calling thread to the given processors.
+     * Returns false if affinity is not supported or the set contains no usable processor.
+     */
+    inline bool set_affinity(std::vector<unsigned> const& cpus)
+    {
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (std::size_t i = 0; i < cpus.size(); ++i)
+        if (cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+      return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+      return false;
+#endif
+    }
+
+    /**
+     * Restricts the calling thread to the processors of node.
+     */
+    inline bool set_affinity(numa_node const& node)
+    {
+      return set_affinity(node.cpus);
+    }
+  }
+
+  /**
+   * Creates a thread running f on the processors of node and adds it to group.
+   */
+  template <typename F>
+  thread* create_thread_on_node(thread_group& group, numa_node const& node, F f)
+  {
+    thread::attributes attrs;
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+    attrs.set_affinity(node.cpus);
+#endif
+    thread::attributes const& const_attrs = attrs;
+    std::auto_ptr<thread> new_thread(new thread(const_attrs, f));
+    group.add_thread(new_thread.get());
+    return new_thread.release();
+  }
+
+  /**
+   * Creates threads_per_node threads running f, pinned to each node of numa_nodes() in turn.
+   * Passing 0 creates one thread per processor of each node.
+   */
+  template <typename F>
+  void create_threads_on_nodes(thread_group& group, F f, unsigned threads_per_node = 0)
+  {
+    std::vector<numa_node> const& nodes = numa_nodes();
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      unsigned n = threads_per_node ? threads_per_node : unsigned(nodes[i].cpus.size());
+      for (unsigned j = 0; j < n; ++j)
+        create_thread_on_node(group, nodes[i], f);
+    }
+  }
+
+  /**
+   * Allocates page aligned memory whose pages are placed on node if the system can, falling back
+   * to other nodes when node runs out of memory. Without NUMA support this is a plain allocation.
+   * Throws std::bad_alloc on failure. The memory must be released with deallocate_on_node.
+   */
+  inline void* allocate_on_node(std::size_t bytes, unsigned node)
+  {
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+    void* p = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      boost::throw_exception(std::bad_alloc());
+#if defined SYS_mbind
+    // mbind(2) with MPOL_PREFERRED; the pages are placed when first touched
+    const int mpol_preferred = 1;
+    const std::size_t bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] = 1UL << (node % bits);
+    syscall(SYS_mbind, p, bytes, mpol_preferred, &mask[0], mask.size() * bits + 1, 0);
+#else
+    (void)node;
+#endif
+    return p;
+#else
+    (void)node;
+    return ::operator new(bytes);
+#endif
+  }
+
+  inline void deallocate_on_node(void* p, std::size_t bytes)
+  {
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+    if (p) munmap(p, bytes);
+#else
+    (void)bytes;
+    ::operator delete(p);
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -31,6 +31,10 @@
 
 #include <pthread.h>
 #include <unistd.h>
+#if defined(__linux__) && defined(_GNU_SOURCE) && !defined(__ANDROID__)
+#include <sched.h>
+#define BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+#endif
 
 #include <boost/config/abi_prefix.hpp>
 
@@ -64,6 +68,28 @@ namespace boost
             BOOST_VERIFY(!res && "pthread_attr_getstacksize failed");
             return size;
         }
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+        // cpu affinity: the thread is only scheduled on the given processors
+        void set_affinity(std::vector<unsigned> const& cpus) BOOST_NOEXCEPT {
+          cpu_set_t set;
+          CPU_ZERO(&set);
+          for (std::size_t i = 0; i < cpus.size(); ++i)
+            if (cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+          int res = pthread_attr_setaffinity_np(&val_, sizeof(set), &set);
+          BOOST_VERIFY(!res && "pthread_attr_setaffinity_np failed");
+        }
+
+        std::vector<unsigned> get_affinity() const {
+          cpu_set_t set;
+          CPU_ZERO(&set);
+          int res = pthread_attr_getaffinity_np(&val_, sizeof(set), &set);
+          BOOST_VERIFY(!res && "pthread_attr_getaffinity_np failed");
+          std::vector<unsigned> cpus;
+          for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+          return cpus;
+        }
+#endif
 #define BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_NATIVE_HANDLE
 
         typedef pthread_attr_t native_handle_type;
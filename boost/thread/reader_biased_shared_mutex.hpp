@@ -0,0 +1,353 @@
+#ifndef BOOST_THREAD_READER_BIASED_SHARED_MUTEX_HPP
+#define BOOST_THREAD_READER_BIASED_SHARED_MUTEX_HPP
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2013. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/thread for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/lockable_traits.hpp>
+#if defined BOOST_THREAD_USES_DATETIME
+#include <boost/thread/thread_time.hpp>
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/chrono/ceil.hpp>
+#endif
+#include <boost/atomic.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+
+  /**
+   * A shared mutex optimized for read-mostly workloads.
+   *
+   * Each reader registers in one of reader_slots counters, chosen from its thread id and padded
+   * to its own cache line, so readers running on different cores do not write the same memory
+   * and shared ownership is taken and released with a single atomic operation.
+   * Acquiring exclusive ownership announces the writer and then waits until every counter drains,
+   * which makes lock() more expensive than the one of shared_mutex. While a writer is waiting or
+   * owns the mutex new readers block, so writers are not starved.
+   *
+   * Models SharedLockable. Upgrade ownership is not provided.
+   */
+  class reader_biased_shared_mutex
+  {
+  public:
+    BOOST_STATIC_CONSTANT(std::size_t, reader_slots = 64);
+
+    BOOST_THREAD_NO_COPYABLE(reader_biased_shared_mutex)
+
+    reader_biased_shared_mutex() :
+      writer_(false), waiting_readers_(0), waiting_writers_(0), draining_(false)
+    {
+      for (std::size_t i = 0; i < reader_slots; ++i)
+        slots_[i].readers_.store(0, memory_order_relaxed);
+    }
+
+    // Shared ownership
+
+    void lock_shared()
+    {
+      reader_slot& slot = current_slot();
+      while (!try_lock_shared(slot))
+      {
+        unique_lock<mutex> lk(mtx_);
+        ++waiting_readers_;
+        while (writer_.load(memory_order_relaxed))
+          readers_cond_.wait(lk);
+        --waiting_readers_;
+      }
+    }
+
+    bool try_lock_shared()
+    {
+      return try_lock_shared(current_slot());
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock_shared(system_time const& timeout)
+    {
+      reader_slot& slot = current_slot();
+      while (!try_lock_shared(slot))
+      {
+        unique_lock<mutex> lk(mtx_);
+        ++waiting_readers_;
+        while (writer_.load(memory_order_relaxed))
+        {
+          if (!readers_cond_.timed_wait(lk, timeout))
+          {
+            --waiting_readers_;
+            return false;
+          }
+        }
+        --waiting_readers_;
+      }
+      return true;
+    }
+
+    template<typename TimeDuration>
+    bool timed_lock_shared(TimeDuration const & relative_time)
+    {
+      return timed_lock_shared(get_system_time()+relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_shared_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_shared_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_shared_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      reader_slot& slot = current_slot();
+      while (!try_lock_shared(slot))
+      {
+        unique_lock<mutex> lk(mtx_);
+        ++waiting_readers_;
+        while (writer_.load(memory_order_relaxed))
+        {
+          if (cv_status::timeout == readers_cond_.wait_until(lk, abs_time))
+          {
+            --waiting_readers_;
+            return false;
+          }
+        }
+        --waiting_readers_;
+      }
+      return true;
+    }
+#endif
+
+    void unlock_shared()
+    {
+      release_slot(current_slot());
+    }
+
+    // Exclusive ownership
+
+    void lock()
+    {
+      unique_lock<mutex> lk(mtx_);
+      ++waiting_writers_;
+      while (writer_.load(memory_order_relaxed))
+        writers_cond_.wait(lk);
+      --waiting_writers_;
+      announce_writer();
+      while (!drained())
+      {
+        draining_ = true;
+        drain_cond_.wait(lk);
+      }
+      draining_ = false;
+    }
+
+    bool try_lock()
+    {
+      unique_lock<mutex> lk(mtx_);
+      if (writer_.load(memory_order_relaxed))
+        return false;
+      announce_writer();
+      if (drained())
+        return true;
+      withdraw_writer(lk);
+      return false;
+    }
+
+#if defined BOOST_THREAD_USES_DATETIME
+    bool timed_lock(system_time const& timeout)
+    {
+      unique_lock<mutex> lk(mtx_);
+      ++waiting_writers_;
+      while (writer_.load(memory_order_relaxed))
+      {
+        if (!writers_cond_.timed_wait(lk, timeout))
+        {
+          // withdraw_writer may have woken this writer instead of one that waits without a
+          // timeout: if the mutex is free take it, so that giving it back passes the wakeup on
+          if (!writer_.load(memory_order_relaxed))
+            break;
+          --waiting_writers_;
+          return false;
+        }
+      }
+      --waiting_writers_;
+      announce_writer();
+      while (!drained())
+      {
+        draining_ = true;
+        if (!drain_cond_.timed_wait(lk, timeout) && !drained())
+        {
+          draining_ = false;
+          withdraw_writer(lk);
+          return false;
+        }
+      }
+      draining_ = false;
+      return true;
+    }
+
+    template<typename TimeDuration>
+    bool timed_lock(TimeDuration const & relative_time)
+    {
+      return timed_lock(get_system_time()+relative_time);
+    }
+#endif
+#ifdef BOOST_THREAD_USES_CHRONO
+    template <class Rep, class Period>
+    bool try_lock_for(const chrono::duration<Rep, Period>& rel_time)
+    {
+      return try_lock_until(chrono::steady_clock::now() + rel_time);
+    }
+    template <class Clock, class Duration>
+    bool try_lock_until(const chrono::time_point<Clock, Duration>& abs_time)
+    {
+      unique_lock<mutex> lk(mtx_);
+      ++waiting_writers_;
+      while (writer_.load(memory_order_relaxed))
+      {
+        if (cv_status::timeout == writers_cond_.wait_until(lk, abs_time))
+        {
+          // withdraw_writer may have woken this writer instead of one that waits without a
+          // timeout: if the mutex is free take it, so that giving it back passes the wakeup on
+          if (!writer_.load(memory_order_relaxed))
+            break;
+          --waiting_writers_;
+          return false;
+        }
+      }
+      --waiting_writers_;
+      announce_writer();
+      while (!drained())
+      {
+        draining_ = true;
+        if (cv_status::timeout == drain_cond_.wait_until(lk, abs_time) && !drained())
+        {
+          draining_ = false;
+          withdraw_writer(lk);
+          return false;
+        }
+      }
+      draining_ = false;
+      return true;
+    }
+#endif
+
+    void unlock()
+    {
+      unique_lock<mutex> lk(mtx_);
+      BOOST_ASSERT(writer_.load(memory_order_relaxed));
+      withdraw_writer(lk);
+    }
+
+  private:
+    // a reader counter alone in its cache line
+    struct reader_slot
+    {
+      atomic<int> readers_;
+      char pad_[64 - sizeof(atomic<int>)];
+    };
+
+    reader_slot& current_slot()
+    {
+      // pthread ids are addresses of thread control blocks: keep the well mixed high bits
+      boost::uint64_t h = static_cast<boost::uint64_t>(hash_value(this_thread::get_id()));
+      h *= 0x9E3779B97F4A7C15ULL;
+      return slots_[static_cast<std::size_t>(h >> 58) % reader_slots];
+    }
+
+    // The reader increments its counter and then checks the writer flag, while a writer sets the
+    // flag and then reads the counters. Both sides use sequentially consistent operations, so at
+    // least one of them sees the other.
+    bool try_lock_shared(reader_slot& slot)
+    {
+      slot.readers_.fetch_add(1, memory_order_seq_cst);
+      if (!writer_.load(memory_order_seq_cst))
+        return true;
+      release_slot(slot);
+      return false;
+    }
+
+    void release_slot(reader_slot& slot)
+    {
+      slot.readers_.fetch_sub(1, memory_order_seq_cst);
+      if (writer_.load(memory_order_seq_cst))
+      {
+        // a writer may be waiting for this counter to drain
+        lock_guard<mutex> lk(mtx_);
+        if (draining_)
+          drain_cond_.notify_one();
+      }
+    }
+
+    void announce_writer()
+    {
+      writer_.store(true, memory_order_seq_cst);
+    }
+
+    bool drained() const
+    {
+      for (std::size_t i = 0; i < reader_slots; ++i)
+        if (slots_[i].readers_.load(memory_order_seq_cst) != 0)
+          return false;
+      return true;
+    }
+
+    void withdraw_writer(unique_lock<mutex>& lk)
+    {
+      writer_.store(false, memory_order_seq_cst);
+      bool readers = waiting_readers_ != 0;
+      bool writers = waiting_writers_ != 0;
+      lk.unlock();
+      if (readers)
+        readers_cond_.notify_all();
+      if (writers)
+        writers_cond_.notify_one();
+    }
+
+    reader_slot slots_[reader_slots];
+    atomic<bool> writer_;
+    mutex mtx_;
+    // the members below are protected by mtx_
+    std::size_t waiting_readers_;
+    std::size_t waiting_writers_;
+    bool draining_;
+    condition_variable readers_cond_;
+    condition_variable writers_cond_;
+    condition_variable drain_cond_;
+  };
+
+  namespace sync
+  {
+#ifdef BOOST_THREAD_NO_AUTO_DETECT_MUTEX_TYPES
+    template<>
+    struct is_basic_lockable<reader_biased_shared_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+    template<>
+    struct is_lockable<reader_biased_shared_mutex>
+    {
+      BOOST_STATIC_CONSTANT(bool, value = true);
+    };
+#endif
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,600 @@
+#ifndef BOOST_THREAD_SYNC_LOCKFREE_BOUNDED_QUEUE_HPP
+#define BOOST_THREAD_SYNC_LOCKFREE_BOUNDED_QUEUE_HPP
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Vicente J. Botet Escriba 2013. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/thread for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/sync_bounded_queue.hpp>
+#include <boost/atomic.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <new>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+
+  /**
+   * A bounded multi-producer/multi-consumer queue with the interface of sync_bounded_queue.
+   *
+   * The elements live in a ring of sequenced cells (D. Vyukov's bounded MPMC queue), so pushing and
+   * pulling only take a compare-and-swap on the shared position. The mutex and the condition
+   * variables are used only when a thread has to block: a push notifies only if some puller is
+   * waiting on an empty queue, and a pull notifies only if some pusher is waiting on a full one.
+   *
+   * The capacity is rounded up to a power of two.
+   * Moving a value_type must not throw.
+   */
+  template <typename ValueType>
+  class sync_lockfree_bounded_queue
+  {
+  public:
+    typedef ValueType value_type;
+    typedef std::size_t size_type;
+
+    // Constructors/Assignment/Destructors
+    BOOST_THREAD_NO_COPYABLE(sync_lockfree_bounded_queue)
+    explicit sync_lockfree_bounded_queue(size_type max_elems);
+    ~sync_lockfree_bounded_queue();
+
+    // Observers
+    // empty(), full() and size() are only hints while other threads push or pull.
+    bool empty() const;
+    bool full() const;
+    size_type capacity() const;
+    size_type size() const;
+    bool closed() const;
+
+    // Modifiers
+    void close();
+
+    void push(const value_type& x);
+    void push(BOOST_THREAD_RV_REF(value_type) x);
+    bool try_push(const value_type& x);
+    bool try_push(BOOST_THREAD_RV_REF(value_type) x);
+    // never blocks, same as try_push
+    bool try_push(no_block_tag, const value_type& x);
+    bool try_push(no_block_tag, BOOST_THREAD_RV_REF(value_type) x);
+
+    // Observers/Modifiers
+    void pull(value_type&);
+    void pull(ValueType& elem, bool & closed);
+    // enable_if is_nothrow_copy_movable<value_type>
+    value_type pull();
+    shared_ptr<ValueType> ptr_pull();
+    bool try_pull(value_type&);
+    // never blocks, same as try_pull
+    bool try_pull(no_block_tag,value_type&);
+    shared_ptr<ValueType> try_pull();
+
+    /**
+     * Waits until the queue is not empty and moves up to @c max_elems elements to @c elems.
+     * The elements are claimed at once.
+     * @return the number of elements pulled.
+     * @throws sync_queue_is_closed if the queue is closed and empty.
+     */
+    size_type pull(value_type* elems, size_type max_elems);
+    /**
+     * Moves up to @c max_elems elements to @c elems without waiting.
+     * @return the number of elements pulled.
+     * @throws sync_queue_is_closed if the queue is closed and empty.
+     */
+    size_type try_pull(value_type* elems, size_type max_elems);
+
+  private:
+    typedef typename aligned_storage<sizeof(value_type), alignment_of<value_type>::value>::type storage_type;
+
+    struct cell
+    {
+      atomic<size_type> sequence_;
+      storage_type storage_;
+
+      value_type* value()
+      {
+        return static_cast<value_type*>(static_cast<void*>(&storage_));
+      }
+    };
+
+    // pads the positions, each written by one side, to their own cache line
+    struct padded_position
+    {
+      atomic<size_type> value_;
+      char pad_[64 - sizeof(atomic<size_type>)];
+    };
+
+    cell* cells_;
+    const size_type mask_;
+    padded_position push_pos_;
+    padded_position pull_pos_;
+    atomic<bool> closed_;
+
+    // the slow path
+    atomic<size_type> waiting_full_;
+    atomic<size_type> waiting_empty_;
+    mutable mutex mtx_;
+    condition_variable not_empty_;
+    condition_variable not_full_;
+
+    static size_type round_up(size_type n) BOOST_NOEXCEPT
+    {
+      size_type r = 1;
+      while (r < n) r <<= 1;
+      return r;
+    }
+
+    void throw_if_closed()
+    {
+      if (closed_.load(memory_order_acquire))
+      {
+        BOOST_THROW_EXCEPTION( sync_queue_is_closed() );
+      }
+    }
+    // unlike empty(), size() also counts the elements whose push is still in progress
+    void throw_if_closed_and_drained()
+    {
+      if (closed_.load(memory_order_acquire) && size() == 0)
+      {
+        BOOST_THROW_EXCEPTION( sync_queue_is_closed() );
+      }
+    }
+
+    cell* claim_push_cell();
+    cell* claim_pull_cell();
+    size_type claim_pull_cells(size_type max_elems, size_type& pos);
+
+    template <typename Arg>
+    bool try_push_impl(BOOST_THREAD_FWD_REF(Arg) x);
+    template <typename Arg>
+    void push_impl(BOOST_THREAD_FWD_REF(Arg) x);
+    bool try_pull_impl(value_type& x);
+
+    void release_pushed(cell* c, size_type seq)
+    {
+      c->sequence_.store(seq, memory_order_release);
+      notify_if_needed(waiting_empty_, not_empty_);
+    }
+    void release_pulled(cell* c, size_type seq)
+    {
+      c->value()->~value_type();
+      c->sequence_.store(seq, memory_order_release);
+    }
+
+    void notify_if_needed(atomic<size_type>& waiting, condition_variable& cv, bool all = false)
+    {
+      // pairs with the fence in wait_until
+      atomic_thread_fence(memory_order_seq_cst);
+      if (waiting.load(memory_order_relaxed) > 0)
+      {
+        lock_guard<mutex> lk(mtx_);
+        size_type n = waiting.load(memory_order_relaxed);
+        if (n == 0) return;
+        // each waiter is notified once, as in sync_bounded_queue
+        if (all)
+        {
+          waiting.store(0, memory_order_relaxed);
+          cv.notify_all();
+        }
+        else
+        {
+          waiting.store(n - 1, memory_order_relaxed);
+          cv.notify_one();
+        }
+      }
+    }
+
+    /**
+     * Blocks until @c ready() or the queue is closed, or until notified.
+     * The waiter announces itself then checks again, so that a notifier either sees the waiter or
+     * the waiter sees what was notified. The notifier withdraws the announcement.
+     */
+    template <typename Pred>
+    void wait_until(atomic<size_type>& waiting, condition_variable& cv, Pred ready)
+    {
+      unique_lock<mutex> lk(mtx_);
+      waiting.store(waiting.load(memory_order_relaxed) + 1, memory_order_relaxed);
+      atomic_thread_fence(memory_order_seq_cst);
+      if (ready() || closed_.load(memory_order_acquire))
+      {
+        waiting.store(waiting.load(memory_order_relaxed) - 1, memory_order_relaxed);
+        return;
+      }
+      cv.wait(lk);
+    }
+
+    struct can_push
+    {
+      sync_lockfree_bounded_queue const* q;
+      bool operator()() const { return !q->full(); }
+    };
+    struct can_pull
+    {
+      sync_lockfree_bounded_queue const* q;
+      bool operator()() const { return !q->empty(); }
+    };
+  };
+
+  template <typename ValueType>
+  sync_lockfree_bounded_queue<ValueType>::sync_lockfree_bounded_queue(size_type max_elems) :
+    cells_(0), mask_(round_up(max_elems) - 1), closed_(false), waiting_full_(0), waiting_empty_(0)
+  {
+    BOOST_ASSERT_MSG(max_elems >= 1, "number of elements must be > 1");
+    cells_ = new cell[mask_ + 1];
+    for (size_type i = 0; i <= mask_; ++i)
+      cells_[i].sequence_.store(i, memory_order_relaxed);
+    push_pos_.value_.store(0, memory_order_relaxed);
+    pull_pos_.value_.store(0, memory_order_relaxed);
+  }
+
+  template <typename ValueType>
+  sync_lockfree_bounded_queue<ValueType>::~sync_lockfree_bounded_queue()
+  {
+    for (size_type pos = pull_pos_.value_.load(memory_order_relaxed); pos != push_pos_.value_.load(memory_order_relaxed); ++pos)
+      cells_[pos & mask_].value()->~value_type();
+    delete[] cells_;
+  }
+
+  template <typename ValueType>
+  void sync_lockfree_bounded_queue<ValueType>::close()
+  {
+    closed_.store(true, memory_order_release);
+    lock_guard<mutex> lk(mtx_);
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::closed() const
+  {
+    return closed_.load(memory_order_acquire);
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::empty() const
+  {
+    size_type pos = pull_pos_.value_.load(memory_order_acquire);
+    return cells_[pos & mask_].sequence_.load(memory_order_acquire) != pos + 1;
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::full() const
+  {
+    size_type pos = push_pos_.value_.load(memory_order_acquire);
+    return cells_[pos & mask_].sequence_.load(memory_order_acquire) != pos;
+  }
+
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::size_type sync_lockfree_bounded_queue<ValueType>::capacity() const
+  {
+    return mask_ + 1;
+  }
+
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::size_type sync_lockfree_bounded_queue<ValueType>::size() const
+  {
+    size_type out = pull_pos_.value_.load(memory_order_acquire);
+    size_type in = push_pos_.value_.load(memory_order_acquire);
+    return in > out ? in - out : 0;
+  }
+
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::cell* sync_lockfree_bounded_queue<ValueType>::claim_push_cell()
+  {
+    size_type pos = push_pos_.value_.load(memory_order_relaxed);
+    for (;;)
+    {
+      cell* c = &cells_[pos & mask_];
+      size_type seq = c->sequence_.load(memory_order_acquire);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (dif == 0)
+      {
+        if (push_pos_.value_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+          return c;
+      }
+      else if (dif < 0)
+      {
+        return 0; // full
+      }
+      else
+      {
+        pos = push_pos_.value_.load(memory_order_relaxed);
+      }
+    }
+  }
+
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::cell* sync_lockfree_bounded_queue<ValueType>::claim_pull_cell()
+  {
+    size_type pos;
+    return claim_pull_cells(1, pos) ? &cells_[pos & mask_] : 0;
+  }
+
+  /**
+   * Claims up to @c max_elems consecutive ready cells with a single compare-and-swap.
+   * @return the number of cells claimed, the first one being at @c pos.
+   */
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::size_type
+  sync_lockfree_bounded_queue<ValueType>::claim_pull_cells(size_type max_elems, size_type& pos)
+  {
+    pos = pull_pos_.value_.load(memory_order_relaxed);
+    for (;;)
+    {
+      size_type n = 0;
+      while (n < max_elems && n <= mask_)
+      {
+        size_type seq = cells_[(pos + n) & mask_].sequence_.load(memory_order_acquire);
+        if (seq != pos + n + 1) break;
+        ++n;
+      }
+      if (n == 0)
+      {
+        size_type seq = cells_[pos & mask_].sequence_.load(memory_order_acquire);
+        std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (dif < 0)
+          return 0; // empty
+        pos = pull_pos_.value_.load(memory_order_relaxed);
+        continue;
+      }
+      if (pull_pos_.value_.compare_exchange_weak(pos, pos + n, memory_order_relaxed))
+        return n;
+    }
+  }
+
+  template <typename ValueType>
+  template <typename Arg>
+  bool sync_lockfree_bounded_queue<ValueType>::try_push_impl(BOOST_THREAD_FWD_REF(Arg) x)
+  {
+    throw_if_closed();
+    cell* c = claim_push_cell();
+    if (!c) return false;
+    size_type pos = c->sequence_.load(memory_order_relaxed);
+    new (c->value()) value_type(boost::forward<Arg>(x));
+    release_pushed(c, pos + 1);
+    return true;
+  }
+
+  template <typename ValueType>
+  template <typename Arg>
+  void sync_lockfree_bounded_queue<ValueType>::push_impl(BOOST_THREAD_FWD_REF(Arg) x)
+  {
+    for (;;)
+    {
+      throw_if_closed();
+      cell* c = claim_push_cell();
+      if (c)
+      {
+        size_type pos = c->sequence_.load(memory_order_relaxed);
+        new (c->value()) value_type(boost::forward<Arg>(x));
+        release_pushed(c, pos + 1);
+        return;
+      }
+      can_push pred = { this };
+      wait_until(waiting_full_, not_full_, pred);
+    }
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_pull_impl(ValueType& elem)
+  {
+    cell* c = claim_pull_cell();
+    if (!c) return false;
+    size_type seq = c->sequence_.load(memory_order_relaxed);
+    elem = boost::move(*c->value());
+    release_pulled(c, seq + mask_);
+    notify_if_needed(waiting_full_, not_full_);
+    return true;
+  }
+
+  template <typename ValueType>
+  void sync_lockfree_bounded_queue<ValueType>::push(const ValueType& elem)
+  {
+    // copy first: once a cell is claimed, constructing the element must not throw
+    value_type tmp(elem);
+    push_impl(boost::move(tmp));
+  }
+
+  template <typename ValueType>
+  void sync_lockfree_bounded_queue<ValueType>::push(BOOST_THREAD_RV_REF(ValueType) elem)
+  {
+    push_impl(boost::move(elem));
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_push(const ValueType& elem)
+  {
+    throw_if_closed();
+    if (full()) return false;
+    value_type tmp(elem);
+    return try_push_impl(boost::move(tmp));
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_push(BOOST_THREAD_RV_REF(ValueType) elem)
+  {
+    return try_push_impl(boost::move(elem));
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_push(no_block_tag, const ValueType& elem)
+  {
+    return try_push(elem);
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_push(no_block_tag, BOOST_THREAD_RV_REF(ValueType) elem)
+  {
+    return try_push(boost::move(elem));
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_pull(ValueType& elem)
+  {
+    if (try_pull_impl(elem)) return true;
+    throw_if_closed_and_drained();
+    return false;
+  }
+
+  template <typename ValueType>
+  bool sync_lockfree_bounded_queue<ValueType>::try_pull(no_block_tag, ValueType& elem)
+  {
+    return try_pull(elem);
+  }
+
+  template <typename ValueType>
+  boost::shared_ptr<ValueType> sync_lockfree_bounded_queue<ValueType>::try_pull()
+  {
+    cell* c = claim_pull_cell();
+    if (!c)
+    {
+      throw_if_closed_and_drained();
+      return shared_ptr<ValueType>();
+    }
+    size_type seq = c->sequence_.load(memory_order_relaxed);
+    shared_ptr<value_type> res;
+    try
+    {
+      res = make_shared<value_type>(boost::move(*c->value()));
+    }
+    catch (...)
+    {
+      release_pulled(c, seq + mask_);
+      notify_if_needed(waiting_full_, not_full_);
+      throw;
+    }
+    release_pulled(c, seq + mask_);
+    notify_if_needed(waiting_full_, not_full_);
+    return res;
+  }
+
+  template <typename ValueType>
+  void sync_lockfree_bounded_queue<ValueType>::pull(ValueType& elem)
+  {
+    for (;;)
+    {
+      if (try_pull_impl(elem)) return;
+      // drain what was pushed before the queue was closed
+      throw_if_closed_and_drained();
+      can_pull pred = { this };
+      wait_until(waiting_empty_, not_empty_, pred);
+    }
+  }
+
+  template <typename ValueType>
+  void sync_lockfree_bounded_queue<ValueType>::pull(ValueType& elem, bool & closed)
+  {
+    for (;;)
+    {
+      if (try_pull_impl(elem)) return;
+      if (this->closed() && size() == 0) {closed=true; return;}
+      can_pull pred = { this };
+      wait_until(waiting_empty_, not_empty_, pred);
+    }
+  }
+
+  // enable if ValueType is nothrow movable
+  template <typename ValueType>
+  ValueType sync_lockfree_bounded_queue<ValueType>::pull()
+  {
+    value_type elem;
+    pull(elem);
+    return boost::move(elem);
+  }
+
+  template <typename ValueType>
+  boost::shared_ptr<ValueType> sync_lockfree_bounded_queue<ValueType>::ptr_pull()
+  {
+    value_type elem;
+    pull(elem);
+    return make_shared<value_type>(boost::move(elem));
+  }
+
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::size_type
+  sync_lockfree_bounded_queue<ValueType>::try_pull(ValueType* elems, size_type max_elems)
+  {
+    if (max_elems == 0) return 0;
+    size_type pos;
+    size_type n = claim_pull_cells(max_elems, pos);
+    if (n == 0)
+    {
+      throw_if_closed_and_drained();
+      return 0;
+    }
+    for (size_type i = 0; i < n; ++i)
+    {
+      cell* c = &cells_[(pos + i) & mask_];
+      elems[i] = boost::move(*c->value());
+      release_pulled(c, pos + i + mask_ + 1);
+    }
+    notify_if_needed(waiting_full_, not_full_, n > 1);
+    return n;
+  }
+
+  template <typename ValueType>
+  typename sync_lockfree_bounded_queue<ValueType>::size_type
+  sync_lockfree_bounded_queue<ValueType>::pull(ValueType* elems, size_type max_elems)
+  {
+    if (max_elems == 0) return 0;
+    for (;;)
+    {
+      size_type pos;
+      size_type n = claim_pull_cells(max_elems, pos);
+      if (n)
+      {
+        for (size_type i = 0; i < n; ++i)
+        {
+          cell* c = &cells_[(pos + i) & mask_];
+          elems[i] = boost::move(*c->value());
+          release_pulled(c, pos + i + mask_ + 1);
+        }
+        notify_if_needed(waiting_full_, not_full_, n > 1);
+        return n;
+      }
+      throw_if_closed_and_drained();
+      can_pull pred = { this };
+      wait_until(waiting_empty_, not_empty_, pred);
+    }
+  }
+
+  template <typename ValueType>
+  sync_lockfree_bounded_queue<ValueType>& operator<<(sync_lockfree_bounded_queue<ValueType>& sbq, BOOST_THREAD_RV_REF(ValueType) elem)
+  {
+    sbq.push(boost::forward<ValueType>(elem));
+    return sbq;
+  }
+
+  template <typename ValueType>
+  sync_lockfree_bounded_queue<ValueType>& operator<<(sync_lockfree_bounded_queue<ValueType>& sbq, ValueType const&elem)
+  {
+    sbq.push(elem);
+    return sbq;
+  }
+
+  template <typename ValueType>
+  sync_lockfree_bounded_queue<ValueType>& operator>>(sync_lockfree_bounded_queue<ValueType>& sbq, ValueType &elem)
+  {
+    sbq.pull(elem);
+    return sbq;
+  }
+
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
@@ -0,0 +1,376 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#ifndef BOOST_THREAD_THREAD_POOL_HPP
+#define BOOST_THREAD_THREAD_POOL_HPP
+
+#include <boost/thread/detail/config.hpp>
+#include <boost/thread/detail/delete.hpp>
+#include <boost/thread/detail/move.hpp>
+#include <boost/thread/detail/work_stealing_deque.hpp>
+#include <boost/thread/thread_only.hpp>
+#include <boost/thread/detail/thread_group.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/thread/sync_bounded_queue.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/decay.hpp>
+#include <boost/utility/result_of.hpp>
+#include <deque>
+#include <exception>
+
+#include <boost/config/abi_prefix.hpp>
+
+namespace boost
+{
+  namespace thread_detail
+  {
+    struct pool_work
+    {
+      virtual ~pool_work() {}
+      virtual void run() = 0;
+    };
+
+    template <typename Closure>
+    struct pool_work_impl : pool_work
+    {
+      Closure closure_;
+
+      template <typename C>
+      explicit pool_work_impl(BOOST_THREAD_FWD_REF(C) c) :
+        closure_(boost::forward<C>(c))
+      {
+      }
+      void run()
+      {
+        closure_();
+      }
+    };
+  }
+
+  /**
+   * A fixed size pool of worker threads executing closures.
+   *
+   * Each worker owns a work-stealing deque. Closures submitted from a worker are pushed on its own
+   * deque and popped LIFO, so fork/join computations stay cache local; idle workers steal FIFO from
+   * the others. Closures submitted from outside the pool go through a shared injection queue.
+   *
+   * Closing the pool only rejects submissions from outside the pool: closures already queued, and
+   * any closure they submit, are run before the workers exit.
+   */
+  class thread_pool
+  {
+  public:
+    typedef std::size_t size_type;
+
+    BOOST_THREAD_NO_COPYABLE(thread_pool)
+
+    /**
+     * Creates @c thread_count worker threads.
+     * If @c thread_count is 0 one worker is created.
+     */
+    explicit thread_pool(unsigned thread_count = thread::hardware_concurrency());
+
+    /**
+     * Closes the pool, waits until all the queued closures have been run and joins the workers.
+     * @pre Not called from one of the pool's workers.
+     */
+    ~thread_pool();
+
+    /// @return the number of worker threads.
+    size_type size() const BOOST_NOEXCEPT
+    {
+      return size_;
+    }
+
+    /// Rejects further submissions from outside the pool.
+    void close();
+    /// @return whether the pool is closed.
+    bool closed();
+
+    /**
+     * Closes the pool and waits until the workers are done.
+     * @pre Not called from one of the pool's workers.
+     */
+    void join();
+
+    /**
+     * Schedules @c closure to be run by one of the workers.
+     * An exception escaping the closure calls std::terminate.
+     * @throws sync_queue_is_closed if the pool is closed and the caller is not one of its workers.
+     */
+    template <typename Closure>
+    void execute(BOOST_THREAD_FWD_REF(Closure) closure)
+    {
+      thread_detail::pool_work* w =
+        new thread_detail::pool_work_impl<typename decay<Closure>::type>(boost::forward<Closure>(closure));
+      worker_data* self = current_.get();
+      if (self)
+      {
+        self->tasks_.push(w);
+      }
+      else
+      {
+        lock_guard<mutex> lk(injected_mtx_);
+        if (closed_)
+        {
+          delete w;
+          throw_exception(sync_queue_is_closed());
+        }
+        injected_.push_back(w);
+      }
+      pending_.fetch_add(1, memory_order_seq_cst);
+      notify_idle_if_needed();
+    }
+
+    /**
+     * Schedules @c f to be run by one of the workers.
+     * @return a future holding the result of @c f or the exception it threw.
+     * @throws sync_queue_is_closed if the pool is closed and the caller is not one of its workers.
+     */
+    template <typename F>
+    BOOST_THREAD_FUTURE<typename boost::result_of<typename decay<F>::type()>::type>
+    submit(BOOST_THREAD_FWD_REF(F) f)
+    {
+      typedef typename boost::result_of<typename decay<F>::type()>::type result_type;
+#if defined BOOST_THREAD_PROVIDES_SIGNATURE_PACKAGED_TASK
+      typedef packaged_task<result_type()> packaged_task_type;
+#else
+      typedef packaged_task<result_type> packaged_task_type;
+#endif
+      packaged_task_type task(boost::forward<F>(f));
+      BOOST_THREAD_FUTURE<result_type> ret = task.get_future();
+      execute(boost::move(task));
+      return BOOST_THREAD_MAKE_RV_REF(ret);
+    }
+
+    /**
+     * Runs one queued closure in the calling thread, if any is available.
+     * A worker looks first at its own deque; any other thread only steals.
+     * @return whether a closure was run.
+     */
+    bool try_executing_one();
+
+    /**
+     * Runs queued closures in the calling thread until @c pred returns true.
+     * Use it instead of blocking on a future from within a worker, so that the worker keeps
+     * helping rather than deadlocking the pool, e.g.
+     * @code
+     * pool.reschedule_until(bind(&future<int>::is_ready, &f));
+     * @endcode
+     */
+    template <typename Pred>
+    void reschedule_until(Pred const& pred)
+    {
+      while (!pred())
+      {
+        if (!try_executing_one())
+          this_thread::yield();
+      }
+    }
+
+  private:
+    struct worker_data
+    {
+      thread_detail::work_stealing_deque<thread_detail::pool_work*> tasks_;
+      unsigned index_;
+      unsigned seed_;
+    };
+
+    static void no_cleanup(worker_data*) {}
+
+    void worker_loop(unsigned index);
+    bool find_work(worker_data* self, thread_detail::pool_work*& w);
+    bool try_pull_injected(thread_detail::pool_work*& w);
+    bool try_steal(unsigned start, thread_detail::pool_work*& w);
+    void run(thread_detail::pool_work* w);
+    void notify_idle_if_needed();
+
+    const size_type size_;
+    scoped_array<worker_data> workers_;
+    thread_specific_ptr<worker_data> current_;
+    thread_group threads_;
+
+    // queued but not yet started closures
+    atomic<size_type> pending_;
+    atomic<size_type> idle_;
+
+    mutex injected_mtx_;
+    std::deque<thread_detail::pool_work*> injected_;
+    bool closed_;
+
+    mutex idle_mtx_;
+    condition_variable not_empty_;
+  };
+
+  inline thread_pool::thread_pool(unsigned thread_count) :
+    size_(thread_count ? thread_count : 1),
+    workers_(new worker_data[thread_count ? thread_count : 1]),
+    current_(&thread_pool::no_cleanup),
+    pending_(0),
+    idle_(0),
+    closed_(false)
+  {
+    for (unsigned i = 0; i < size_; ++i)
+    {
+      workers_[i].index_ = i;
+      workers_[i].seed_ = 2654435761u * (i + 1);
+    }
+    try
+    {
+      for (unsigned i = 0; i < size_; ++i)
+        threads_.create_thread(bind(&thread_pool::worker_loop, this, i));
+    }
+    catch (...)
+    {
+      join();
+      throw;
+    }
+  }
+
+  inline thread_pool::~thread_pool()
+  {
+    join();
+  }
+
+  inline void thread_pool::close()
+  {
+    {
+      lock_guard<mutex> lk(injected_mtx_);
+      closed_ = true;
+    }
+    lock_guard<mutex> lk(idle_mtx_);
+    not_empty_.notify_all();
+  }
+
+  inline bool thread_pool::closed()
+  {
+    lock_guard<mutex> lk(injected_mtx_);
+    return closed_;
+  }
+
+  inline void thread_pool::join()
+  {
+    close();
+    threads_.join_all();
+  }
+
+  inline bool thread_pool::try_executing_one()
+  {
+    thread_detail::pool_work* w;
+    worker_data* self = current_.get();
+    if (self ? find_work(self, w) : (try_pull_injected(w) || try_steal(0, w)))
+    {
+      run(w);
+      return true;
+    }
+    return false;
+  }
+
+  inline void thread_pool::run(thread_detail::pool_work* w)
+  {
+    pending_.fetch_sub(1, memory_order_relaxed);
+    try
+    {
+      w->run();
+    }
+    catch (...)
+    {
+      std::terminate();
+    }
+    delete w;
+  }
+
+  inline bool thread_pool::try_pull_injected(thread_detail::pool_work*& w)
+  {
+    lock_guard<mutex> lk(injected_mtx_);
+    if (injected_.empty()) return false;
+    w = injected_.front();
+    injected_.pop_front();
+    return true;
+  }
+
+  inline bool thread_pool::try_steal(unsigned start, thread_detail::pool_work*& w)
+  {
+    for (size_type i = 0; i < size_; ++i)
+    {
+      worker_data& victim = workers_[(start + i) % size_];
+      if (victim.tasks_.steal(w)) return true;
+    }
+    return false;
+  }
+
+  inline bool thread_pool::find_work(worker_data* self, thread_detail::pool_work*& w)
+  {
+    if (self->tasks_.pop(w)) return true;
+    if (try_pull_injected(w)) return true;
+    // xorshift, so that the thieves do not all start with the same victim
+    self->seed_ ^= self->seed_ << 13;
+    self->seed_ ^= self->seed_ >> 17;
+    self->seed_ ^= self->seed_ << 5;
+    return try_steal(self->seed_ % size_, w);
+  }
+
+  inline void thread_pool::notify_idle_if_needed()
+  {
+    // pairs with the increment of idle_ followed by the load of pending_ in worker_loop
+    if (idle_.load(memory_order_seq_cst) > 0)
+    {
+      lock_guard<mutex> lk(idle_mtx_);
+      not_empty_.notify_one();
+    }
+  }
+
+  inline void thread_pool::worker_loop(unsigned index)
+  {
+    worker_data* self = &workers_[index];
+    current_.reset(self);
+    thread_detail::pool_work* w;
+    for (;;)
+    {
+      if (find_work(self, w))
+      {
+        run(w);
+        continue;
+      }
+      unique_lock<mutex> lk(idle_mtx_);
+      idle_.fetch_add(1, memory_order_seq_cst);
+      bool stop = false;
+      while (pending_.load(memory_order_seq_cst) == 0)
+      {
+        {
+          lock_guard<mutex> lk2(injected_mtx_);
+          stop = closed_;
+        }
+        if (stop) break;
+        not_empty_.wait(lk);
+      }
+      idle_.fetch_sub(1, memory_order_relaxed);
+      if (stop) break;
+    }
+    current_.release();
+  }
+
+  /**
+   * Schedules @c f on @c ex.
+   * @return a future holding the result of @c f or the exception it threw.
+   */
+  template <class F>
+  BOOST_THREAD_FUTURE<typename boost::result_of<typename decay<F>::type()>::type>
+  async(thread_pool& ex, BOOST_THREAD_FWD_REF(F) f)
+  {
+    return BOOST_THREAD_MAKE_RV_REF(ex.submit(boost::forward<F>(f)));
+  }
+}
+
+#include <boost/config/abi_suffix.hpp>
+
+#endif
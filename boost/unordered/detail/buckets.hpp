@@ -595,6 +595,10 @@ namespace boost { namespace unordered { namespace detail {
             return hf(x);
         }
 
+        static inline SizeT apply_hash_value(SizeT hash) {
+            return hash;
+        }
+
         static inline SizeT to_bucket(SizeT bucket_count, SizeT hash) {
             return hash % bucket_count;
         }
@@ -609,19 +613,15 @@ namespace boost { namespace unordered { namespace detail {
     };
 
     template <typename SizeT>
-    struct mix64_policy
+    struct mix_policy
     {
         template <typename Hash, typename T>
         static inline SizeT apply_hash(Hash const& hf, T const& x) {
-            SizeT key = hf(x);
-            key = (~key) + (key << 21); // key = (key << 21) - key - 1;
-            key = key ^ (key >> 24);
-            key = (key + (key << 3)) + (key << 8); // key * 265
-            key = key ^ (key >> 14);
-            key = (key + (key << 2)) + (key << 4); // key * 21
-            key = key ^ (key >> 28);
-            key = key + (key << 31);
-            return key;
+            return apply_hash_value(hf(x));
+        }
+
+        static inline SizeT apply_hash_value(SizeT hash) {
+            return boost::unordered::detail::mix_hash(hash);
         }
 
         static inline SizeT to_bucket(SizeT bucket_count, SizeT hash) {
@@ -631,41 +631,56 @@ namespace boost { namespace unordered { namespace detail {
         static inline SizeT new_bucket_count(SizeT min) {
             if (min <= 4) return 4;
             --min;
-            min |= min >> 1;
-            min |= min >> 2;
-            min |= min >> 4;
-            min |= min >> 8;
-            min |= min >> 16;
-            min |= min >> 32;
+            for (std::size_t shift = 1; shift < sizeof(SizeT) * CHAR_BIT;
+                    shift *= 2)
+                min |= min >> shift;
             return min + 1;
         }
 
         static inline SizeT prev_bucket_count(SizeT max) {
-            max |= max >> 1;
-            max |= max >> 2;
-            max |= max >> 4;
-            max |= max >> 8;
-            max |= max >> 16;
-            max |= max >> 32;
+            for (std::size_t shift = 1; shift < sizeof(SizeT) * CHAR_BIT;
+                    shift *= 2)
+                max |= max >> shift;
             return (max >> 1) + 1;
         }
     };
 
+    // Maps the tags from boost::unordered::bucket_policy to the policies.
+
     template <int digits, int radix>
-    struct pick_policy_impl {
+    struct pick_default_policy {
         typedef prime_policy<std::size_t> type;
     };
 
     template <>
-    struct pick_policy_impl<64, 2> {
-        typedef mix64_policy<std::size_t> type;
+    struct pick_default_policy<64, 2> {
+        typedef mix_policy<std::size_t> type;
     };
 
-    struct pick_policy :
-        pick_policy_impl<
+    template <typename Tag>
+    struct pick_policy_impl;
+
+    template <>
+    struct pick_policy_impl<boost::unordered::default_bucket_policy> :
+        pick_default_policy<
             std::numeric_limits<std::size_t>::digits,
             std::numeric_limits<std::size_t>::radix> {};
 
+    template <>
+    struct pick_policy_impl<boost::unordered::prime_bucket_policy> {
+        typedef prime_policy<std::size_t> type;
+    };
+
+    template <>
+    struct pick_policy_impl<boost::unordered::power_of_two_bucket_policy> {
+        typedef mix_policy<std::size_t> type;
+    };
+
+    template <typename Hash>
+    struct pick_policy :
+        pick_policy_impl<
+            typename boost::unordered::bucket_policy<Hash>::type> {};
+
     ////////////////////////////////////////////////////////////////////////////
     // Functions
 
@@ -145,7 +145,8 @@ namespace boost { namespace unordered { namespace detail {
         typedef boost::unordered::detail::grouped_table_impl<types> table;
         typedef boost::unordered::detail::set_extractor<value_type> extractor;
 
-        typedef boost::unordered::detail::pick_policy::type policy;
+        typedef typename boost::unordered::detail::pick_policy<H>::type
+            policy;
     };
 
     template <typename A, typename K, typename M, typename H, typename P>
@@ -170,7 +171,8 @@ namespace boost { namespace unordered { namespace detail {
         typedef boost::unordered::detail::map_extractor<key_type, value_type>
             extractor;
 
-        typedef boost::unordered::detail::pick_policy::type policy;
+        typedef typename boost::unordered::detail::pick_policy<H>::type
+            policy;
     };
 
     template <typename Types>
@@ -262,7 +264,13 @@ namespace boost { namespace unordered { namespace detail {
 
         std::size_t count(key_type const& k) const
         {
-            iterator n = this->find_node(k);
+            return count(this->hash(k), k);
+        }
+
+        template <typename Key>
+        std::size_t count(std::size_t key_hash, Key const& k) const
+        {
+            iterator n = this->find_node(key_hash, k);
             if (!n.node_) return 0;
 
             std::size_t x = 0;
@@ -278,7 +286,14 @@ namespace boost { namespace unordered { namespace detail {
         std::pair<iterator, iterator>
             equal_range(key_type const& k) const
         {
-            iterator n = this->find_node(k);
+            return equal_range(this->hash(k), k);
+        }
+
+        template <typename Key>
+        std::pair<iterator, iterator>
+            equal_range(std::size_t key_hash, Key const& k) const
+        {
+            iterator n = this->find_node(key_hash, k);
             return std::make_pair(
                 n, n.node_ ? iterator(n.node_->group_prev_->next_) : n);
         }
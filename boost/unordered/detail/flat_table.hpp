@@ -0,0 +1,1087 @@
+// Copyright (C) 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_FLAT_TABLE_HPP_INCLUDED
+#define BOOST_UNORDERED_DETAIL_FLAT_TABLE_HPP_INCLUDED
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+#include <boost/unordered/detail/extract_key.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/swap.hpp>
+#include <boost/assert.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <cstring>
+
+// Group probing uses SSE2 when the target has it. Define
+// BOOST_UNORDERED_FLAT_SSE2 to 0 to force the portable implementation.
+
+#if !defined(BOOST_UNORDERED_FLAT_SSE2)
+#  if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define BOOST_UNORDERED_FLAT_SSE2 1
+#  else
+#    define BOOST_UNORDERED_FLAT_SSE2 0
+#  endif
+#endif
+
+#if BOOST_UNORDERED_FLAT_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(BOOST_MSVC)
+#include <intrin.h>
+#endif
+
+namespace boost { namespace unordered { namespace detail {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // flat_group
+    //
+    // The open addressing table keeps one control byte per slot. A full slot
+    // stores the low 7 bits of its element's hash, the other states have the
+    // high bit set. Slots are probed 16 at a time: a group's control bytes
+    // are compared with the hash fragment in one go, so most lookups only
+    // compare the key of the element they find.
+
+    struct flat_group
+    {
+        BOOST_STATIC_CONSTANT(std::size_t, width = 16);
+        BOOST_STATIC_CONSTANT(unsigned char, empty = 0x80);
+        BOOST_STATIC_CONSTANT(unsigned char, deleted = 0xFE);
+        // Marks the end of the control bytes, for iteration.
+        BOOST_STATIC_CONSTANT(unsigned char, sentinel = 0xFF);
+
+        static bool is_full(unsigned char c) { return !(c & 0x80); }
+
+#if BOOST_UNORDERED_FLAT_SSE2
+
+        static __m128i load(unsigned char const* ctrl)
+        {
+            return _mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl));
+        }
+
+        // Bit i is set when ctrl[i] == c.
+        static unsigned match(unsigned char const* ctrl, unsigned char c)
+        {
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                load(ctrl), _mm_set1_epi8(static_cast<char>(c)))));
+        }
+
+        // Bit i is set when ctrl[i] is empty or deleted.
+        static unsigned match_available(unsigned char const* ctrl)
+        {
+            return static_cast<unsigned>(_mm_movemask_epi8(load(ctrl)));
+        }
+
+#else
+
+        static unsigned match(unsigned char const* ctrl, unsigned char c)
+        {
+            unsigned mask = 0;
+            for (unsigned i = 0; i < width; ++i)
+                if (ctrl[i] == c) mask |= 1u << i;
+            return mask;
+        }
+
+        static unsigned match_available(unsigned char const* ctrl)
+        {
+            unsigned mask = 0;
+            for (unsigned i = 0; i < width; ++i)
+                if (ctrl[i] & 0x80) mask |= 1u << i;
+            return mask;
+        }
+
+#endif
+
+        static unsigned match_empty(unsigned char const* ctrl)
+        {
+            return match(ctrl, empty);
+        }
+
+        static unsigned first_bit(unsigned mask)
+        {
+            BOOST_ASSERT(mask);
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#elif defined(BOOST_MSVC)
+            unsigned long r;
+            _BitScanForward(&r, mask);
+            return static_cast<unsigned>(r);
+#else
+            unsigned r = 0;
+            while (!(mask & 1u)) { mask >>= 1; ++r; }
+            return r;
+#endif
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // flat_iterator
+    //
+    // Walks the control bytes alongside the slots, skipping anything that
+    // isn't full. The sentinel after the last group stops it.
+
+    template <typename Value>
+    struct flat_iterator
+        : public boost::iterator<
+            std::forward_iterator_tag,
+            Value,
+            std::ptrdiff_t,
+            Value*,
+            Value&>
+    {
+        unsigned char const* ctrl_;
+        Value* slot_;
+
+        flat_iterator() BOOST_NOEXCEPT : ctrl_(), slot_() {}
+
+        flat_iterator(unsigned char const* ctrl, Value* slot) BOOST_NOEXCEPT
+            : ctrl_(ctrl), slot_(slot) {}
+
+        // Conversion from iterator to const_iterator.
+        template <typename Value2>
+        flat_iterator(flat_iterator<Value2> const& x,
+                typename boost::enable_if_c<
+                    boost::is_convertible<Value2*, Value*>::value,
+                    void*>::type = 0) BOOST_NOEXCEPT
+            : ctrl_(x.ctrl_), slot_(x.slot_) {}
+
+        Value& operator*() const {
+            return *slot_;
+        }
+
+        Value* operator->() const {
+            return slot_;
+        }
+
+        flat_iterator& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skip_free();
+            return *this;
+        }
+
+        flat_iterator operator++(int) {
+            flat_iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        void skip_free() {
+            while (*ctrl_ == flat_group::empty ||
+                    *ctrl_ == flat_group::deleted) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        friend bool operator==(flat_iterator const& x, flat_iterator const& y)
+            BOOST_NOEXCEPT
+        {
+            return x.ctrl_ == y.ctrl_;
+        }
+
+        friend bool operator!=(flat_iterator const& x, flat_iterator const& y)
+            BOOST_NOEXCEPT
+        {
+            return x.ctrl_ != y.ctrl_;
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // flat_storage
+    //
+    // The control bytes and slots of a table. Destroys the values in full
+    // slots and frees the arrays unless released, so a table under
+    // construction is cleaned up if an exception is thrown.
+
+    template <typename ValueAllocator>
+    struct flat_storage
+    {
+        typedef boost::unordered::detail::allocator_traits<ValueAllocator>
+            value_allocator_traits;
+        typedef typename value_allocator_traits::value_type value_type;
+        typedef typename boost::unordered::detail::rebind_wrap<
+            ValueAllocator, unsigned char>::type ctrl_allocator;
+        typedef boost::unordered::detail::allocator_traits<ctrl_allocator>
+            ctrl_allocator_traits;
+
+        ValueAllocator& alloc_;
+        unsigned char* ctrl_;
+        value_type* slots_;
+        std::size_t groups_;
+
+        explicit flat_storage(ValueAllocator& a)
+            : alloc_(a), ctrl_(), slots_(), groups_(0) {}
+
+        // Allocates 'groups' groups of empty slots.
+        void create(std::size_t groups)
+        {
+            BOOST_ASSERT(!ctrl_ && groups);
+            std::size_t capacity = groups * flat_group::width;
+            slots_ = value_allocator_traits::allocate(alloc_, capacity);
+            ctrl_allocator ctrl_alloc(alloc_);
+            BOOST_TRY {
+                ctrl_ = ctrl_allocator_traits::allocate(ctrl_alloc,
+                    capacity + 1);
+            }
+            BOOST_CATCH(...) {
+                value_allocator_traits::deallocate(alloc_, slots_, capacity);
+                slots_ = 0;
+                BOOST_RETHROW;
+            }
+            BOOST_CATCH_END
+            groups_ = groups;
+            std::memset(ctrl_, flat_group::empty, capacity);
+            ctrl_[capacity] = flat_group::sentinel;
+        }
+
+        void release()
+        {
+            ctrl_ = 0;
+            slots_ = 0;
+            groups_ = 0;
+        }
+
+        ~flat_storage()
+        {
+            if (!ctrl_) return;
+            std::size_t capacity = groups_ * flat_group::width;
+            for (std::size_t i = 0; i < capacity; ++i) {
+                if (flat_group::is_full(ctrl_[i])) {
+                    boost::unordered::detail::destroy_value_impl(alloc_,
+                        slots_ + i);
+                }
+            }
+            ctrl_allocator ctrl_alloc(alloc_);
+            ctrl_allocator_traits::deallocate(ctrl_alloc, ctrl_,
+                capacity + 1);
+            value_allocator_traits::deallocate(alloc_, slots_, capacity);
+        }
+
+    private:
+        flat_storage(flat_storage const&);
+        flat_storage& operator=(flat_storage const&);
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // flat_table
+    //
+    // An open addressing hash table storing values inline, used by
+    // unordered_flat_map and unordered_flat_set.
+    //
+    // The hash picks a starting group and the 7 bit fragment kept in the
+    // control bytes. Groups are probed in triangular steps, which visits
+    // every group since the group count is a power of two. A probe stops
+    // at the first group with an empty slot, so erasing only leaves a
+    // 'deleted' marker when the slot's group has no empty slot; otherwise
+    // no probe can have passed through the group and the slot is simply
+    // emptied.
+    //
+    // 'growth_left_' counts the empty slots that can still be filled before
+    // the load limit is reached. Deleted slots don't count as free, so a
+    // table with lots of them is rehashed at the same size rather than
+    // grown.
+
+    template <typename Types>
+    struct flat_table
+    {
+        typedef typename Types::value_type value_type;
+        typedef typename Types::key_type key_type;
+        typedef typename Types::hasher hasher;
+        typedef typename Types::key_equal key_equal;
+        typedef typename Types::value_allocator value_allocator;
+        typedef typename Types::extractor extractor;
+
+        typedef boost::unordered::detail::allocator_traits<value_allocator>
+            value_allocator_traits;
+        typedef boost::unordered::detail::flat_storage<value_allocator>
+            storage;
+
+        typedef boost::unordered::detail::flat_iterator<
+            typename Types::iterator_value> iterator;
+        typedef boost::unordered::detail::flat_iterator<value_type const>
+            c_iterator;
+
+        typedef std::pair<iterator, bool> emplace_return;
+
+        // The table is never filled beyond 7/8 of its slots, whatever the
+        // max load factor is set to.
+        static float maximum_load_factor() { return 0.875f; }
+
+        hasher hash_;
+        key_equal eq_;
+        value_allocator alloc_;
+        unsigned char* ctrl_;
+        value_type* slots_;
+        std::size_t groups_;
+        std::size_t size_;
+        std::size_t growth_left_;
+        float mlf_;
+
+        ////////////////////////////////////////////////////////////////////////
+        // Constructors
+
+        flat_table(std::size_t num_buckets,
+                hasher const& hf,
+                key_equal const& eq,
+                value_allocator const& a) :
+            hash_(hf),
+            eq_(eq),
+            alloc_(a),
+            ctrl_(empty_ctrl()),
+            slots_(),
+            groups_(0),
+            size_(0),
+            growth_left_(0),
+            mlf_(maximum_load_factor())
+        {
+            if (num_buckets) this->rehash(num_buckets);
+        }
+
+        flat_table(flat_table const& x, value_allocator const& a) :
+            hash_(x.hash_),
+            eq_(x.eq_),
+            alloc_(a),
+            ctrl_(empty_ctrl()),
+            slots_(),
+            groups_(0),
+            size_(0),
+            growth_left_(0),
+            mlf_(x.mlf_)
+        {
+            this->copy_from(x, false);
+        }
+
+        flat_table(flat_table& x, boost::unordered::detail::move_tag) :
+            hash_(x.hash_),
+            eq_(x.eq_),
+            alloc_(x.alloc_),
+            ctrl_(x.ctrl_),
+            slots_(x.slots_),
+            groups_(x.groups_),
+            size_(x.size_),
+            growth_left_(x.growth_left_),
+            mlf_(x.mlf_)
+        {
+            x.reset();
+        }
+
+        flat_table(flat_table& x, value_allocator const& a,
+                boost::unordered::detail::move_tag) :
+            hash_(x.hash_),
+            eq_(x.eq_),
+            alloc_(a),
+            ctrl_(empty_ctrl()),
+            slots_(),
+            groups_(0),
+            size_(0),
+            growth_left_(0),
+            mlf_(x.mlf_)
+        {
+            if (alloc_ == x.alloc_) {
+                this->swap_contents(x);
+            }
+            else {
+                this->copy_from(x, true);
+            }
+        }
+
+        ~flat_table()
+        {
+            this->delete_storage();
+        }
+
+        flat_table& operator=(flat_table const& x)
+        {
+            if (this != &x) {
+                this->assign(x,
+                    boost::unordered::detail::integral_constant<bool,
+                        value_allocator_traits::
+                        propagate_on_container_copy_assignment::value>());
+            }
+            return *this;
+        }
+
+        void assign(flat_table const& x, false_type)
+        {
+            flat_table tmp(x, alloc_);
+            this->swap_contents(tmp);
+        }
+
+        void assign(flat_table const& x, true_type)
+        {
+            flat_table tmp(x, x.alloc_);
+            this->delete_storage();
+            alloc_ = x.alloc_;
+            this->swap_contents(tmp);
+        }
+
+        void move_assign(flat_table& x)
+        {
+            if (this != &x) {
+                this->move_assign(x,
+                    boost::unordered::detail::integral_constant<bool,
+                        value_allocator_traits::
+                        propagate_on_container_move_assignment::value>());
+            }
+        }
+
+        void move_assign(flat_table& x, true_type)
+        {
+            flat_table tmp(x, boost::unordered::detail::move_tag());
+            this->delete_storage();
+            alloc_ = boost::move(tmp.alloc_);
+            this->swap_contents(tmp);
+        }
+
+        void move_assign(flat_table& x, false_type)
+        {
+            // Steals x's storage if the allocators are equal, otherwise
+            // moves the elements one at a time.
+            flat_table tmp(x, alloc_, boost::unordered::detail::move_tag());
+            this->swap_contents(tmp);
+        }
+
+        void swap_allocators(flat_table& x, false_type)
+        {
+            // According to 23.2.1.8, if propagate_on_container_swap is
+            // false the behaviour is undefined unless the allocators
+            // are equal.
+            BOOST_ASSERT(alloc_ == x.alloc_);
+        }
+
+        void swap_allocators(flat_table& x, true_type)
+        {
+            boost::swap(alloc_, x.alloc_);
+        }
+
+        // Only swaps the allocators if propagate_on_container_swap
+        void swap(flat_table& x)
+        {
+            this->swap_allocators(x,
+                boost::unordered::detail::integral_constant<bool,
+                    value_allocator_traits::
+                    propagate_on_container_swap::value>());
+            this->swap_contents(x);
+        }
+
+        void swap_contents(flat_table& x)
+        {
+            boost::swap(hash_, x.hash_);
+            boost::swap(eq_, x.eq_);
+            std::swap(ctrl_, x.ctrl_);
+            std::swap(slots_, x.slots_);
+            std::swap(groups_, x.groups_);
+            std::swap(size_, x.size_);
+            std::swap(growth_left_, x.growth_left_);
+            std::swap(mlf_, x.mlf_);
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Storage
+
+        static unsigned char* empty_ctrl()
+        {
+            // Never written to: a table without slots has no full slot to
+            // find, and allocates before inserting.
+            static unsigned char sentinel = flat_group::sentinel;
+            return &sentinel;
+        }
+
+        std::size_t capacity() const
+        {
+            return groups_ * flat_group::width;
+        }
+
+        void reset()
+        {
+            ctrl_ = empty_ctrl();
+            slots_ = 0;
+            groups_ = 0;
+            size_ = 0;
+            growth_left_ = 0;
+        }
+
+        void delete_storage()
+        {
+            if (!groups_) return;
+            storage s(alloc_);
+            s.ctrl_ = ctrl_;
+            s.slots_ = slots_;
+            s.groups_ = groups_;
+            this->reset();
+        }
+
+        void adopt(storage& s, std::size_t size)
+        {
+            this->delete_storage();
+            ctrl_ = s.ctrl_;
+            slots_ = s.slots_;
+            groups_ = s.groups_;
+            size_ = size;
+            growth_left_ = this->max_load_for(groups_) - size_;
+            s.release();
+        }
+
+        // Copies or moves x's values into the same slots of new storage,
+        // keeping any deleted markers so that probe sequences still work.
+        void copy_from(flat_table const& x, bool move)
+        {
+            if (!x.size_) return;
+            storage s(alloc_);
+            s.create(x.groups_);
+            std::size_t capacity = x.capacity();
+            for (std::size_t i = 0; i < capacity; ++i) {
+                unsigned char c = x.ctrl_[i];
+                if (flat_group::is_full(c)) {
+                    if (move)
+                        this->construct_value(s.slots_ + i,
+                            boost::move(const_cast<value_type&>(x.slots_[i])));
+                    else
+                        this->construct_value(s.slots_ + i, x.slots_[i]);
+                }
+                s.ctrl_[i] = c;
+            }
+            ctrl_ = s.ctrl_;
+            slots_ = s.slots_;
+            groups_ = s.groups_;
+            size_ = x.size_;
+            growth_left_ = x.growth_left_;
+            s.release();
+        }
+
+        template <typename A0>
+        void construct_value(value_type* address, BOOST_FWD_REF(A0) a0)
+        {
+            boost::unordered::detail::construct_value_impl(alloc_, address,
+                BOOST_UNORDERED_EMPLACE_ARGS1(boost::forward<A0>(a0)));
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Load methods
+
+        std::size_t max_load_for(std::size_t groups) const
+        {
+            using namespace std;
+
+            std::size_t capacity = groups * flat_group::width;
+            return (std::min)(
+                capacity - capacity / 8,
+                boost::unordered::detail::double_to_size(floor(
+                    static_cast<double>(mlf_) *
+                    static_cast<double>(capacity))));
+        }
+
+        std::size_t min_groups_for_size(std::size_t size) const
+        {
+            std::size_t groups = 1;
+            while (this->max_load_for(groups) < size) groups *= 2;
+            return groups;
+        }
+
+        std::size_t max_size() const
+        {
+            return (value_allocator_traits::max_size(alloc_) /
+                flat_group::width) * 7;
+        }
+
+        float load_factor() const
+        {
+            return groups_ ? static_cast<float>(size_) /
+                static_cast<float>(this->capacity()) : 0;
+        }
+
+        void max_load_factor(float z)
+        {
+            BOOST_ASSERT(z > 0);
+            mlf_ = (std::min)((std::max)(z, minimum_max_load_factor),
+                maximum_load_factor());
+            if (groups_) {
+                this->rehash_impl((std::max)(groups_,
+                    this->min_groups_for_size(size_)));
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Rehashing
+
+        void rehash(std::size_t num_buckets)
+        {
+            std::size_t groups = 1;
+            while (groups * flat_group::width < num_buckets) groups *= 2;
+            groups = (std::max)(groups, this->min_groups_for_size(size_));
+
+            if (!size_ && !num_buckets) {
+                this->delete_storage();
+            }
+            else if (groups != groups_) {
+                this->rehash_impl(groups);
+            }
+        }
+
+        void reserve(std::size_t size)
+        {
+            std::size_t groups = this->min_groups_for_size(size);
+            if (groups > groups_ ||
+                    (size > size_ && growth_left_ < size - size_)) {
+                this->rehash_impl((std::max)(groups, groups_));
+            }
+        }
+
+        // Called when an insert would take the table over its load limit.
+        // Mostly full of live values: double, otherwise clear out the
+        // deleted slots, which leaves at least a quarter of the load limit
+        // free so that rehashing stays amortised constant time.
+        void reserve_for_insert()
+        {
+            std::size_t groups = groups_ ? groups_ : 1;
+            if (size_ + 1 > this->max_load_for(groups) / 4 * 3) groups *= 2;
+            this->rehash_impl((std::max)(groups,
+                this->min_groups_for_size(size_ + 1)));
+        }
+
+        void rehash_impl(std::size_t groups)
+        {
+            storage s(alloc_);
+            s.create(groups);
+
+            std::size_t capacity = this->capacity();
+            for (std::size_t i = 0; i < capacity; ++i) {
+                if (flat_group::is_full(ctrl_[i])) {
+                    std::size_t key_hash =
+                        this->hash(extractor::extract(slots_[i]));
+                    std::size_t pos = find_available(s.ctrl_, groups,
+                        key_hash);
+                    this->construct_value(s.slots_ + pos,
+                        boost::move(slots_[i]));
+                    s.ctrl_[pos] = fragment(key_hash);
+                }
+            }
+
+            this->adopt(s, size_);
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Hashing and probing
+
+        hasher const& hash_function() const
+        {
+            return hash_;
+        }
+
+        std::size_t hash(key_type const& k) const
+        {
+            return this->hash_from_value(hash_(k));
+        }
+
+        std::size_t hash_from_value(std::size_t hash_value) const
+        {
+            return boost::unordered::detail::mix_hash(hash_value);
+        }
+
+        static unsigned char fragment(std::size_t key_hash)
+        {
+            return static_cast<unsigned char>(key_hash & 0x7F);
+        }
+
+        static std::size_t first_group(std::size_t key_hash,
+                std::size_t groups)
+        {
+            return (key_hash >> 7) & (groups - 1);
+        }
+
+        // Returns the slot holding a value equal to k, or capacity().
+        template <class Key, class Pred>
+        std::size_t find_pos(std::size_t key_hash, Key const& k,
+                Pred const& eq) const
+        {
+            if (!size_) return this->capacity();
+
+            std::size_t mask = groups_ - 1;
+            std::size_t group = first_group(key_hash, groups_);
+            unsigned char h = fragment(key_hash);
+
+            for (std::size_t step = 1;; ++step) {
+                unsigned char const* ctrl = ctrl_ + group * flat_group::width;
+                for (unsigned m = flat_group::match(ctrl, h); m; m &= m - 1) {
+                    std::size_t pos = group * flat_group::width +
+                        flat_group::first_bit(m);
+                    if (eq(k, extractor::extract(slots_[pos]))) return pos;
+                }
+                if (flat_group::match_empty(ctrl)) return this->capacity();
+                group = (group + step) & mask;
+            }
+        }
+
+        // Returns the first empty or deleted slot on key_hash's probe
+        // sequence. There's always one, since the load is limited.
+        static std::size_t find_available(unsigned char const* ctrl,
+                std::size_t groups, std::size_t key_hash)
+        {
+            std::size_t mask = groups - 1;
+            std::size_t group = first_group(key_hash, groups);
+
+            for (std::size_t step = 1;; ++step) {
+                unsigned m = flat_group::match_available(
+                    ctrl + group * flat_group::width);
+                if (m) {
+                    return group * flat_group::width +
+                        flat_group::first_bit(m);
+                }
+                group = (group + step) & mask;
+            }
+        }
+
+        // Finds the slot for a new value, growing the table if an empty
+        // slot would take it past the load limit.
+        std::size_t prepare_insert(std::size_t key_hash)
+        {
+            if (groups_) {
+                std::size_t pos = find_available(ctrl_, groups_, key_hash);
+                if (growth_left_ || ctrl_[pos] == flat_group::deleted)
+                    return pos;
+            }
+            this->reserve_for_insert();
+            return find_available(ctrl_, groups_, key_hash);
+        }
+
+        // Marks the slot full once its value has been constructed.
+        iterator commit_insert(std::size_t pos, std::size_t key_hash)
+        {
+            if (ctrl_[pos] == flat_group::empty) --growth_left_;
+            ctrl_[pos] = fragment(key_hash);
+            ++size_;
+            return this->iterator_at(pos);
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Iterators
+
+        iterator iterator_at(std::size_t pos) const
+        {
+            return iterator(ctrl_ + pos, slots_ + pos);
+        }
+
+        iterator begin() const
+        {
+            if (!size_) return this->end();
+            iterator it(ctrl_, slots_);
+            it.skip_free();
+            return it;
+        }
+
+        iterator end() const
+        {
+            return this->iterator_at(this->capacity());
+        }
+
+        std::size_t position(c_iterator it) const
+        {
+            return static_cast<std::size_t>(it.ctrl_ - ctrl_);
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Lookup
+
+        iterator find(key_type const& k) const
+        {
+            return this->find(this->hash(k), k);
+        }
+
+        template <class Key>
+        iterator find(std::size_t key_hash, Key const& k) const
+        {
+            return this->iterator_at(this->find_pos(key_hash, k, eq_));
+        }
+
+        template <class Key, class Hash, class Pred>
+        iterator generic_find(Key const& k, Hash const& hf, Pred const& eq)
+            const
+        {
+            return this->iterator_at(this->find_pos(
+                boost::unordered::detail::mix_hash(hf(k)), k, eq));
+        }
+
+        std::size_t count(key_type const& k) const
+        {
+            return this->count(this->hash(k), k);
+        }
+
+        template <class Key>
+        std::size_t count(std::size_t key_hash, Key const& k) const
+        {
+            return this->find_pos(key_hash, k, eq_) != this->capacity()
+                ? 1 : 0;
+        }
+
+        std::pair<iterator, iterator> equal_range(key_type const& k) const
+        {
+            return this->equal_range(this->hash(k), k);
+        }
+
+        template <class Key>
+        std::pair<iterator, iterator> equal_range(std::size_t key_hash,
+                Key const& k) const
+        {
+            std::size_t pos = this->find_pos(key_hash, k, eq_);
+            iterator first = this->iterator_at(pos);
+            iterator last = first;
+            if (pos != this->capacity()) ++last;
+            return std::make_pair(first, last);
+        }
+
+        bool equals(flat_table const& other) const
+        {
+            if (size_ != other.size_) return false;
+
+            for (iterator it = this->begin(), e = this->end(); it != e; ++it)
+            {
+                iterator it2 = other.find(extractor::extract(*it));
+                if (it2 == other.end() || !(*it == *it2)) return false;
+            }
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Insert
+
+        value_type& operator[](key_type const& k)
+        {
+            std::size_t key_hash = this->hash(k);
+            std::size_t pos = this->find_pos(key_hash, k, eq_);
+
+            if (pos != this->capacity()) return slots_[pos];
+
+            pos = this->prepare_insert(key_hash);
+            boost::unordered::detail::construct_value_impl(
+                alloc_, slots_ + pos, BOOST_UNORDERED_EMPLACE_ARGS3(
+                    boost::unordered::piecewise_construct,
+                    boost::make_tuple(k),
+                    boost::make_tuple()));
+            this->commit_insert(pos, key_hash);
+            return slots_[pos];
+        }
+
+#if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#   if defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+        emplace_return emplace(boost::unordered::detail::emplace_args1<
+                boost::unordered::detail::please_ignore_this_overload> const&)
+        {
+            BOOST_ASSERT(false);
+            return emplace_return(this->begin(), false);
+        }
+#   else
+        emplace_return emplace(
+                boost::unordered::detail::please_ignore_this_overload const&)
+        {
+            BOOST_ASSERT(false);
+            return emplace_return(this->begin(), false);
+        }
+#   endif
+#endif
+
+        template <BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        emplace_return emplace(BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+            return emplace_impl(
+                extractor::extract(BOOST_UNORDERED_EMPLACE_FORWARD),
+                BOOST_UNORDERED_EMPLACE_FORWARD);
+#else
+            return emplace_impl(
+                extractor::extract(args.a0, args.a1),
+                BOOST_UNORDERED_EMPLACE_FORWARD);
+#endif
+        }
+
+#if defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+        template <typename A0>
+        emplace_return emplace(
+                boost::unordered::detail::emplace_args1<A0> const& args)
+        {
+            return emplace_impl(extractor::extract(args.a0), args);
+        }
+#endif
+
+        template <BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        emplace_return emplace_impl(key_type const& k,
+            BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+            std::size_t key_hash = this->hash(k);
+            std::size_t pos = this->find_pos(key_hash, k, eq_);
+
+            if (pos != this->capacity())
+                return emplace_return(this->iterator_at(pos), false);
+
+            // The value is constructed straight into its slot, which is
+            // only marked full afterwards, so nothing changes if the
+            // constructor throws (apart from a possible rehash).
+            pos = this->prepare_insert(key_hash);
+            boost::unordered::detail::construct_value_impl(
+                alloc_, slots_ + pos, BOOST_UNORDERED_EMPLACE_FORWARD);
+            return emplace_return(this->commit_insert(pos, key_hash), true);
+        }
+
+        template <BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        emplace_return emplace_impl(no_key, BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+            // Don't have a key, so construct the value first in order
+            // to be able to lookup the position.
+            value_holder v(alloc_);
+            boost::unordered::detail::construct_value_impl(
+                alloc_, v.address(), BOOST_UNORDERED_EMPLACE_FORWARD);
+            v.constructed_ = true;
+
+            key_type const& k = extractor::extract(*v.address());
+            std::size_t key_hash = this->hash(k);
+            std::size_t pos = this->find_pos(key_hash, k, eq_);
+
+            if (pos != this->capacity())
+                return emplace_return(this->iterator_at(pos), false);
+
+            pos = this->prepare_insert(key_hash);
+            this->construct_value(slots_ + pos, boost::move(*v.address()));
+            return emplace_return(this->commit_insert(pos, key_hash), true);
+        }
+
+        template <class InputIt>
+        void insert_range(InputIt i, InputIt j)
+        {
+            for (; i != j; ++i) this->emplace(
+                BOOST_UNORDERED_EMPLACE_ARGS1(*i));
+        }
+
+        // Storage for a value that's constructed before its slot is known.
+        struct value_holder
+        {
+            value_allocator& alloc_;
+            typename boost::aligned_storage<
+                sizeof(value_type),
+                boost::alignment_of<value_type>::value>::type data_;
+            bool constructed_;
+
+            explicit value_holder(value_allocator& a)
+                : alloc_(a), constructed_(false) {}
+
+            value_type* address()
+            {
+                return static_cast<value_type*>(
+                    static_cast<void*>(data_.address()));
+            }
+
+            ~value_holder()
+            {
+                if (constructed_) {
+                    boost::unordered::detail::destroy_value_impl(alloc_,
+                        this->address());
+                }
+            }
+
+        private:
+            value_holder(value_holder const&);
+            value_holder& operator=(value_holder const&);
+        };
+
+        ////////////////////////////////////////////////////////////////////////
+        // Erase
+
+        void erase_pos(std::size_t pos)
+        {
+            BOOST_ASSERT(flat_group::is_full(ctrl_[pos]));
+            boost::unordered::detail::destroy_value_impl(alloc_, slots_ + pos);
+            --size_;
+
+            if (flat_group::match_empty(
+                    ctrl_ + (pos & ~(flat_group::width - 1)))) {
+                ctrl_[pos] = flat_group::empty;
+                ++growth_left_;
+            }
+            else {
+                ctrl_[pos] = flat_group::deleted;
+            }
+        }
+
+        iterator erase(c_iterator r)
+        {
+            BOOST_ASSERT(r != c_iterator(this->end()));
+            std::size_t pos = this->position(r);
+            iterator next = this->iterator_at(pos);
+            ++next;
+            this->erase_pos(pos);
+            return next;
+        }
+
+        iterator erase_range(c_iterator r1, c_iterator r2)
+        {
+            for (; r1 != r2; ++r1) this->erase_pos(this->position(r1));
+            return this->iterator_at(this->position(r2));
+        }
+
+        std::size_t erase_key(key_type const& k)
+        {
+            std::size_t pos = this->find_pos(this->hash(k), k, eq_);
+            if (pos == this->capacity()) return 0;
+            this->erase_pos(pos);
+            return 1;
+        }
+
+        void clear()
+        {
+            if (!size_) return;
+
+            std::size_t capacity = this->capacity();
+            for (std::size_t i = 0; i < capacity; ++i) {
+                if (flat_group::is_full(ctrl_[i])) {
+                    boost::unordered::detail::destroy_value_impl(alloc_,
+                        slots_ + i);
+                }
+            }
+            std::memset(ctrl_, flat_group::empty, capacity);
+            size_ = 0;
+            growth_left_ = this->max_load_for(groups_);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types for the flat containers
+
+    template <typename A, typename T, typename H, typename P>
+    struct flat_set
+    {
+        typedef T value_type;
+        typedef T const iterator_value;
+        typedef H hasher;
+        typedef P key_equal;
+        typedef T key_type;
+
+        typedef typename boost::unordered::detail::rebind_wrap<
+            A, value_type>::type value_allocator;
+        typedef boost::unordered::detail::flat_table<flat_set> table;
+        typedef boost::unordered::detail::set_extractor<value_type> extractor;
+    };
+
+    template <typename A, typename K, typename M, typename H, typename P>
+    struct flat_map
+    {
+        typedef std::pair<K const, M> value_type;
+        typedef value_type iterator_value;
+        typedef H hasher;
+        typedef P key_equal;
+        typedef K key_type;
+
+        typedef typename boost::unordered::detail::rebind_wrap<
+            A, value_type>::type value_allocator;
+        typedef boost::unordered::detail::flat_table<flat_map> table;
+        typedef boost::unordered::detail::map_extractor<key_type, value_type>
+            extractor;
+    };
+}}}
+
+#endif
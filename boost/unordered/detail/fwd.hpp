@@ -17,6 +17,34 @@ namespace unordered
 {
     struct piecewise_construct_t {};
     const piecewise_construct_t piecewise_construct = piecewise_construct_t();
+
+    // Bucket policies
+    //
+    // prime_bucket_policy uses a prime number of buckets and places values
+    // by the hash value modulo the bucket count. power_of_two_bucket_policy
+    // uses a power of two, and places values by the low bits of the hash
+    // value after mixing it, which avoids an integer division per lookup.
+    // default_bucket_policy is power_of_two_bucket_policy when std::size_t
+    // is 64 bit and prime_bucket_policy otherwise.
+    //
+    // The policy is chosen for a hash function by specializing
+    // bucket_policy, e.g.
+    //
+    //     namespace boost { namespace unordered {
+    //         template <> struct bucket_policy<my_hash> {
+    //             typedef power_of_two_bucket_policy type;
+    //         };
+    //     }}
+
+    struct default_bucket_policy {};
+    struct prime_bucket_policy {};
+    struct power_of_two_bucket_policy {};
+
+    template <class Hash>
+    struct bucket_policy
+    {
+        typedef default_bucket_policy type;
+    };
 }
 }
 
@@ -756,6 +756,14 @@ namespace boost { namespace unordered { namespace detail {
             return policy::apply_hash(this->hash_function(), k);
         }
 
+        // Used when the caller has already called the hash function, the
+        // value still needs to be processed by the policy.
+
+        std::size_t hash_from_value(std::size_t hash_value) const
+        {
+            return policy::apply_hash_value(hash_value);
+        }
+
         // Find Node
 
         template <typename Key, typename Hash, typename Pred>
@@ -768,9 +776,10 @@ namespace boost { namespace unordered { namespace detail {
                 find_node_impl(policy::apply_hash(hf, k), k, eq);
         }
 
+        template <typename Key>
         iterator find_node(
                 std::size_t key_hash,
-                key_type const& k) const
+                Key const& k) const
         {
             return static_cast<table_impl const*>(this)->
                 find_node_impl(key_hash, k, this->key_eq());
@@ -138,7 +138,8 @@ namespace boost { namespace unordered { namespace detail {
         typedef boost::unordered::detail::table_impl<types> table;
         typedef boost::unordered::detail::set_extractor<value_type> extractor;
 
-        typedef boost::unordered::detail::pick_policy::type policy;
+        typedef typename boost::unordered::detail::pick_policy<H>::type
+            policy;
     };
 
     template <typename A, typename K, typename M, typename H, typename P>
@@ -163,7 +164,8 @@ namespace boost { namespace unordered { namespace detail {
         typedef boost::unordered::detail::map_extractor<key_type, value_type>
             extractor;
 
-        typedef boost::unordered::detail::pick_policy::type policy;
+        typedef typename boost::unordered::detail::pick_policy<H>::type
+            policy;
     };
 
     template <typename Types>
@@ -260,6 +262,12 @@ namespace boost { namespace unordered { namespace detail {
             return this->find_node(k).node_ ? 1 : 0;
         }
 
+        template <typename Key>
+        std::size_t count(std::size_t key_hash, Key const& k) const
+        {
+            return this->find_node(key_hash, k).node_ ? 1 : 0;
+        }
+
         value_type& at(key_type const& k) const
         {
             if (this->size_) {
@@ -274,7 +282,14 @@ namespace boost { namespace unordered { namespace detail {
         std::pair<iterator, iterator>
             equal_range(key_type const& k) const
         {
-            iterator n = this->find_node(k);
+            return equal_range(this->hash(k), k);
+        }
+
+        template <typename Key>
+        std::pair<iterator, iterator>
+            equal_range(std::size_t key_hash, Key const& k) const
+        {
+            iterator n = this->find_node(key_hash, k);
             iterator n2 = n;
             if (n2.node_) ++n2;
             return std::make_pair(n, n2);
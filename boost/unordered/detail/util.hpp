@@ -20,6 +20,8 @@
 #include <boost/preprocessor/seq/size.hpp>
 #include <boost/preprocessor/seq/enum.hpp>
 #include <boost/swap.hpp>
+#include <boost/cstdint.hpp>
+#include <climits>
 
 namespace boost { namespace unordered { namespace detail {
 
@@ -52,6 +54,84 @@ namespace boost { namespace unordered { namespace detail {
             ReturnType>
     {};
 
+    ////////////////////////////////////////////////////////////////////////////
+    // transparent lookup SFINAE
+    //
+    // Lookup with a key of another type is only enabled when both the hash
+    // function and the predicate have a nested 'is_transparent' type, i.e.
+    // when they promise to give the same results for equivalent keys of
+    // different types.
+
+    template <typename T> struct transparent_check { typedef char type; };
+
+    template <typename T>
+    struct is_transparent
+    {
+        typedef char (&yes_type)[1];
+        typedef char (&no_type)[2];
+
+        template <typename U>
+        static yes_type test(U*, typename
+            boost::unordered::detail::transparent_check<
+                typename U::is_transparent>::type = 0);
+        template <typename U>
+        static no_type test(...);
+
+        enum { value = sizeof(test<T>(0)) == sizeof(yes_type) };
+    };
+
+    // 'Key' isn't used, it just makes the condition depend on the lookup
+    // function's template parameter so that it's a substitution failure.
+
+    template <typename H, typename P, typename Key, typename ReturnType>
+    struct enable_if_transparent :
+        boost::enable_if_c<
+            boost::unordered::detail::is_transparent<H>::value &&
+            boost::unordered::detail::is_transparent<P>::value,
+            ReturnType>
+    {};
+
+    ////////////////////////////////////////////////////////////////////////////
+    // mix_hash
+    //
+    // Used when the bucket position is taken from the low bits of the hash
+    // value. boost::hash is the identity for integers, so the value is
+    // mixed first (this is the MurmurHash3 finalizer).
+
+    template <std::size_t SizeTBits>
+    struct mix_hash_impl
+    {
+        static std::size_t apply(std::size_t h)
+        {
+            h ^= h >> 16;
+            h *= 0x85ebca6bu;
+            h ^= h >> 13;
+            h *= 0xc2b2ae35u;
+            h ^= h >> 16;
+            return h;
+        }
+    };
+
+    template <>
+    struct mix_hash_impl<64>
+    {
+        static std::size_t apply(std::size_t h)
+        {
+            boost::uint64_t x = h;
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return static_cast<std::size_t>(x);
+        }
+    };
+
+    inline std::size_t mix_hash(std::size_t h)
+    {
+        return mix_hash_impl<sizeof(std::size_t) * CHAR_BIT>::apply(h);
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     // primes
 
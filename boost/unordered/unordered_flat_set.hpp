@@ -0,0 +1,669 @@
+// Copyright (C) 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/libs/unordered for documentation
+
+#ifndef BOOST_UNORDERED_UNORDERED_FLAT_SET_HPP_INCLUDED
+#define BOOST_UNORDERED_UNORDERED_FLAT_SET_HPP_INCLUDED
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+# pragma once
+#endif
+
+#include <boost/unordered/detail/flat_table.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/move/move.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+namespace boost
+{
+namespace unordered
+{
+    template <class T,
+        class H = boost::hash<T>,
+        class P = std::equal_to<T>,
+        class A = std::allocator<T> >
+    class unordered_flat_set;
+
+    template <class T, class H, class P, class A>
+    inline bool operator==(unordered_flat_set<T, H, P, A> const&,
+        unordered_flat_set<T, H, P, A> const&);
+    template <class T, class H, class P, class A>
+    inline bool operator!=(unordered_flat_set<T, H, P, A> const&,
+        unordered_flat_set<T, H, P, A> const&);
+
+    // unordered_flat_set
+    //
+    // The set counterpart of unordered_flat_set, with the same iterator
+    // invalidation rules.
+
+    template <class T, class H, class P, class A>
+    class unordered_flat_set
+    {
+#if defined(BOOST_UNORDERED_USE_MOVE)
+        BOOST_COPYABLE_AND_MOVABLE(unordered_flat_set)
+#endif
+
+    public:
+
+        typedef T key_type;
+        typedef T value_type;
+        typedef H hasher;
+        typedef P key_equal;
+        typedef A allocator_type;
+
+    private:
+
+        typedef boost::unordered::detail::flat_set<A, T, H, P> types;
+        typedef typename types::table table;
+        typedef boost::unordered::detail::allocator_traits<
+            typename types::value_allocator> allocator_traits;
+
+    public:
+
+        typedef typename allocator_traits::pointer pointer;
+        typedef typename allocator_traits::const_pointer const_pointer;
+
+        typedef value_type& reference;
+        typedef value_type const& const_reference;
+
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef typename table::c_iterator const_iterator;
+        typedef typename table::iterator iterator;
+
+    private:
+
+        table table_;
+
+    public:
+
+        // constructors
+
+        explicit unordered_flat_set(
+                size_type n = 0,
+                const hasher& hf = hasher(),
+                const key_equal& eql = key_equal(),
+                const allocator_type& a = allocator_type())
+          : table_(n, hf, eql, a)
+        {
+        }
+
+        explicit unordered_flat_set(allocator_type const& a)
+          : table_(0, hasher(), key_equal(), a)
+        {
+        }
+
+        template <class InputIt>
+        unordered_flat_set(InputIt f, InputIt l,
+                size_type n = 0,
+                const hasher& hf = hasher(),
+                const key_equal& eql = key_equal(),
+                const allocator_type& a = allocator_type())
+          : table_(n, hf, eql, a)
+        {
+            table_.insert_range(f, l);
+        }
+
+        // copy/move constructors
+
+        unordered_flat_set(unordered_flat_set const& other)
+          : table_(other.table_, allocator_traits::
+                select_on_container_copy_construction(other.table_.alloc_))
+        {
+        }
+
+        unordered_flat_set(unordered_flat_set const& other,
+                allocator_type const& a)
+          : table_(other.table_, a)
+        {
+        }
+
+#if defined(BOOST_UNORDERED_USE_MOVE)
+        unordered_flat_set(BOOST_RV_REF(unordered_flat_set) other)
+          : table_(other.table_, boost::unordered::detail::move_tag())
+        {
+        }
+#elif !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        unordered_flat_set(unordered_flat_set&& other)
+          : table_(other.table_, boost::unordered::detail::move_tag())
+        {
+        }
+#endif
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        unordered_flat_set(unordered_flat_set&& other,
+                allocator_type const& a)
+          : table_(other.table_, a, boost::unordered::detail::move_tag())
+        {
+        }
+#endif
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+        unordered_flat_set(
+                std::initializer_list<value_type> list,
+                size_type n = 0,
+                const hasher& hf = hasher(),
+                const key_equal& eql = key_equal(),
+                const allocator_type& a = allocator_type())
+          : table_(n, hf, eql, a)
+        {
+            table_.insert_range(list.begin(), list.end());
+        }
+#endif
+
+        // Assign
+
+#if defined(BOOST_UNORDERED_USE_MOVE)
+        unordered_flat_set& operator=(
+                BOOST_COPY_ASSIGN_REF(unordered_flat_set) x)
+        {
+            table_ = x.table_;
+            return *this;
+        }
+
+        unordered_flat_set& operator=(BOOST_RV_REF(unordered_flat_set) x)
+        {
+            table_.move_assign(x.table_);
+            return *this;
+        }
+#else
+        unordered_flat_set& operator=(unordered_flat_set const& x)
+        {
+            table_ = x.table_;
+            return *this;
+        }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        unordered_flat_set& operator=(unordered_flat_set&& x)
+        {
+            table_.move_assign(x.table_);
+            return *this;
+        }
+#endif
+#endif
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+        unordered_flat_set& operator=(std::initializer_list<value_type> list)
+        {
+            table_.clear();
+            table_.insert_range(list.begin(), list.end());
+            return *this;
+        }
+#endif
+
+        allocator_type get_allocator() const BOOST_NOEXCEPT
+        {
+            return table_.alloc_;
+        }
+
+        // size and capacity
+
+        bool empty() const BOOST_NOEXCEPT
+        {
+            return table_.size_ == 0;
+        }
+
+        size_type size() const BOOST_NOEXCEPT
+        {
+            return table_.size_;
+        }
+
+        size_type max_size() const BOOST_NOEXCEPT
+        {
+            return table_.max_size();
+        }
+
+        // iterators
+
+        iterator begin() BOOST_NOEXCEPT
+        {
+            return table_.begin();
+        }
+
+        const_iterator begin() const BOOST_NOEXCEPT
+        {
+            return table_.begin();
+        }
+
+        iterator end() BOOST_NOEXCEPT
+        {
+            return table_.end();
+        }
+
+        const_iterator end() const BOOST_NOEXCEPT
+        {
+            return table_.end();
+        }
+
+        const_iterator cbegin() const BOOST_NOEXCEPT
+        {
+            return table_.begin();
+        }
+
+        const_iterator cend() const BOOST_NOEXCEPT
+        {
+            return table_.end();
+        }
+
+        // emplace
+
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+        template <class... Args>
+        std::pair<iterator, bool> emplace(BOOST_FWD_REF(Args)... args)
+        {
+            return table_.emplace(boost::forward<Args>(args)...);
+        }
+
+        template <class... Args>
+        iterator emplace_hint(const_iterator, BOOST_FWD_REF(Args)... args)
+        {
+            return table_.emplace(boost::forward<Args>(args)...).first;
+        }
+#else
+
+        template <typename A0>
+        std::pair<iterator, bool> emplace(BOOST_FWD_REF(A0) a0)
+        {
+            return table_.emplace(
+                boost::unordered::detail::create_emplace_args(
+                    boost::forward<A0>(a0))
+            );
+        }
+
+        template <typename A0>
+        iterator emplace_hint(const_iterator, BOOST_FWD_REF(A0) a0)
+        {
+            return table_.emplace(
+                boost::unordered::detail::create_emplace_args(
+                    boost::forward<A0>(a0))
+            ).first;
+        }
+
+        template <typename A0, typename A1>
+        std::pair<iterator, bool> emplace(
+            BOOST_FWD_REF(A0) a0,
+            BOOST_FWD_REF(A1) a1)
+        {
+            return table_.emplace(
+                boost::unordered::detail::create_emplace_args(
+                    boost::forward<A0>(a0),
+                    boost::forward<A1>(a1))
+            );
+        }
+
+        template <typename A0, typename A1>
+        iterator emplace_hint(const_iterator,
+            BOOST_FWD_REF(A0) a0,
+            BOOST_FWD_REF(A1) a1)
+        {
+            return table_.emplace(
+                boost::unordered::detail::create_emplace_args(
+                    boost::forward<A0>(a0),
+                    boost::forward<A1>(a1))
+            ).first;
+        }
+
+#define BOOST_UNORDERED_EMPLACE(z, n, _)                                    \
+            template <                                                      \
+                BOOST_PP_ENUM_PARAMS_Z(z, n, typename A)                    \
+            >                                                               \
+            std::pair<iterator, bool> emplace(                              \
+                    BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_FWD_PARAM, a)      \
+            )                                                               \
+            {                                                               \
+                return table_.emplace(                                      \
+                    boost::unordered::detail::create_emplace_args(          \
+                        BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_CALL_FORWARD,  \
+                            a)                                              \
+                ));                                                         \
+            }                                                               \
+                                                                            \
+            template <                                                      \
+                BOOST_PP_ENUM_PARAMS_Z(z, n, typename A)                    \
+            >                                                               \
+            iterator emplace_hint(                                          \
+                    const_iterator,                                         \
+                    BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_FWD_PARAM, a)      \
+            )                                                               \
+            {                                                               \
+                return table_.emplace(                                      \
+                    boost::unordered::detail::create_emplace_args(          \
+                        BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_CALL_FORWARD,  \
+                            a)                                              \
+                )).first;                                                   \
+            }
+
+        BOOST_PP_REPEAT_FROM_TO(3, BOOST_UNORDERED_EMPLACE_LIMIT,
+            BOOST_UNORDERED_EMPLACE, _)
+
+#undef BOOST_UNORDERED_EMPLACE
+
+#endif
+
+        std::pair<iterator, bool> insert(value_type const& x)
+        {
+            return this->emplace(x);
+        }
+
+        std::pair<iterator, bool> insert(BOOST_RV_REF(value_type) x)
+        {
+            return this->emplace(boost::move(x));
+        }
+
+        iterator insert(const_iterator hint, value_type const& x)
+        {
+            return this->emplace_hint(hint, x);
+        }
+
+        iterator insert(const_iterator hint, BOOST_RV_REF(value_type) x)
+        {
+            return this->emplace_hint(hint, boost::move(x));
+        }
+
+        template <class InputIt> void insert(InputIt first, InputIt last)
+        {
+            table_.insert_range(first, last);
+        }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+        void insert(std::initializer_list<value_type> list)
+        {
+            table_.insert_range(list.begin(), list.end());
+        }
+#endif
+
+        iterator erase(const_iterator position)
+        {
+            return table_.erase(position);
+        }
+
+        size_type erase(const key_type& k)
+        {
+            return table_.erase_key(k);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            return table_.erase_range(first, last);
+        }
+
+        void clear()
+        {
+            table_.clear();
+        }
+
+        void swap(unordered_flat_set& other)
+        {
+            table_.swap(other.table_);
+        }
+
+        // observers
+
+        hasher hash_function() const
+        {
+            return table_.hash_;
+        }
+
+        key_equal key_eq() const
+        {
+            return table_.eq_;
+        }
+
+        // lookup
+
+        iterator find(const key_type& k)
+        {
+            return table_.find(k);
+        }
+
+        const_iterator find(const key_type& k) const
+        {
+            return table_.find(k);
+        }
+
+        template <class CompatibleKey, class CompatibleHash,
+            class CompatiblePredicate>
+        iterator find(
+                CompatibleKey const& k,
+                CompatibleHash const& hash,
+                CompatiblePredicate const& eq)
+        {
+            return table_.generic_find(k, hash, eq);
+        }
+
+        template <class CompatibleKey, class CompatibleHash,
+            class CompatiblePredicate>
+        const_iterator find(
+                CompatibleKey const& k,
+                CompatibleHash const& hash,
+                CompatiblePredicate const& eq) const
+        {
+            return table_.generic_find(k, hash, eq);
+        }
+
+        size_type count(const key_type& k) const
+        {
+            return table_.count(k);
+        }
+
+        std::pair<iterator, iterator>
+        equal_range(const key_type& k)
+        {
+            return table_.equal_range(k);
+        }
+
+        std::pair<const_iterator, const_iterator>
+        equal_range(const key_type& k) const
+        {
+            std::pair<iterator, iterator> r = table_.equal_range(k);
+            return std::pair<const_iterator, const_iterator>(
+                r.first, r.second);
+        }
+
+        // lookup with a precomputed hash
+        //
+        // 'hash' must be the value returned by hash_function() for the key,
+        // so that it can be calculated once and used with several
+        // containers.
+
+        iterator find(const key_type& k, std::size_t hash)
+        {
+            return table_.find(table_.hash_from_value(hash), k);
+        }
+
+        const_iterator find(const key_type& k, std::size_t hash) const
+        {
+            return table_.find(table_.hash_from_value(hash), k);
+        }
+
+        size_type count(const key_type& k, std::size_t hash) const
+        {
+            return table_.count(table_.hash_from_value(hash), k);
+        }
+
+        std::pair<iterator, iterator>
+        equal_range(const key_type& k, std::size_t hash)
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
+        std::pair<const_iterator, const_iterator>
+        equal_range(const key_type& k, std::size_t hash) const
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
+        // transparent lookup
+        //
+        // Only available when both hasher and key_equal have a nested
+        // 'is_transparent' type, the key is passed on to them without
+        // being converted to key_type.
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, iterator>::type
+        find(Key const& k)
+        {
+            return table_.find(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, const_iterator>::type
+        find(Key const& k) const
+        {
+            return table_.find(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, size_type>::type
+        count(Key const& k) const
+        {
+            return table_.count(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<iterator, iterator> >::type
+        equal_range(Key const& k)
+        {
+            return table_.equal_range(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<const_iterator, const_iterator> >::type
+        equal_range(Key const& k) const
+        {
+            return table_.equal_range(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, iterator>::type
+        find(Key const& k, std::size_t hash)
+        {
+            return table_.find(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, const_iterator>::type
+        find(Key const& k, std::size_t hash) const
+        {
+            return table_.find(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, size_type>::type
+        count(Key const& k, std::size_t hash) const
+        {
+            return table_.count(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<iterator, iterator> >::type
+        equal_range(Key const& k, std::size_t hash)
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<const_iterator, const_iterator> >::type
+        equal_range(Key const& k, std::size_t hash) const
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
+        // bucket interface
+
+        size_type bucket_count() const BOOST_NOEXCEPT
+        {
+            return table_.capacity();
+        }
+
+        size_type max_bucket_count() const BOOST_NOEXCEPT
+        {
+            return table_.max_size();
+        }
+
+        // hash policy
+
+        float max_load_factor() const BOOST_NOEXCEPT
+        {
+            return table_.mlf_;
+        }
+
+        float load_factor() const BOOST_NOEXCEPT
+        {
+            return table_.load_factor();
+        }
+
+        void max_load_factor(float m)
+        {
+            table_.max_load_factor(m);
+        }
+
+        void rehash(size_type n)
+        {
+            table_.rehash(n);
+        }
+
+        void reserve(size_type n)
+        {
+            table_.reserve(n);
+        }
+
+#if !BOOST_WORKAROUND(__BORLANDC__, < 0x0582)
+        friend bool operator==<T,H,P,A>(
+                unordered_flat_set const&, unordered_flat_set const&);
+        friend bool operator!=<T,H,P,A>(
+                unordered_flat_set const&, unordered_flat_set const&);
+#endif
+    }; // class template unordered_flat_set
+
+    template <class T, class H, class P, class A>
+    inline bool operator==(
+            unordered_flat_set<T,H,P,A> const& m1,
+            unordered_flat_set<T,H,P,A> const& m2)
+    {
+        return m1.table_.equals(m2.table_);
+    }
+
+    template <class T, class H, class P, class A>
+    inline bool operator!=(
+            unordered_flat_set<T,H,P,A> const& m1,
+            unordered_flat_set<T,H,P,A> const& m2)
+    {
+        return !m1.table_.equals(m2.table_);
+    }
+
+    template <class T, class H, class P, class A>
+    inline void swap(
+            unordered_flat_set<T,H,P,A> &m1,
+            unordered_flat_set<T,H,P,A> &m2)
+    {
+        m1.swap(m2);
+    }
+
+} // namespace unordered
+
+    using boost::unordered::unordered_flat_set;
+} // namespace boost
+
+#endif // BOOST_UNORDERED_UNORDERED_FLAT_SET_HPP_INCLUDED
@@ -434,6 +434,85 @@ namespace unordered
         std::pair<const_iterator, const_iterator>
         equal_range(const key_type&) const;
 
+        // lookup with a precomputed hash
+        //
+        // 'hash' must be the value returned by hash_function() for the key,
+        // so that it can be calculated once and used with several
+        // containers.
+
+        const_iterator find(const key_type& k, std::size_t hash) const
+        {
+            return table_.find_node(table_.hash_from_value(hash), k);
+        }
+
+        size_type count(const key_type& k, std::size_t hash) const
+        {
+            return table_.count(table_.hash_from_value(hash), k);
+        }
+
+        std::pair<const_iterator, const_iterator>
+        equal_range(const key_type& k, std::size_t hash) const
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
+        // transparent lookup
+        //
+        // Only available when both hasher and key_equal have a nested
+        // 'is_transparent' type, the key is passed on to them without
+        // being converted to key_type.
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, const_iterator>::type
+        find(Key const& k) const
+        {
+            return table_.find_node(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, size_type>::type
+        count(Key const& k) const
+        {
+            return table_.count(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<const_iterator, const_iterator> >::type
+        equal_range(Key const& k) const
+        {
+            return table_.equal_range(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, const_iterator>::type
+        find(Key const& k, std::size_t hash) const
+        {
+            return table_.find_node(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, size_type>::type
+        count(Key const& k, std::size_t hash) const
+        {
+            return table_.count(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<const_iterator, const_iterator> >::type
+        equal_range(Key const& k, std::size_t hash) const
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
         // bucket interface
 
         size_type bucket_count() const BOOST_NOEXCEPT
@@ -904,6 +983,85 @@ namespace unordered
         std::pair<const_iterator, const_iterator>
         equal_range(const key_type&) const;
 
+        // lookup with a precomputed hash
+        //
+        // 'hash' must be the value returned by hash_function() for the key,
+        // so that it can be calculated once and used with several
+        // containers.
+
+        const_iterator find(const key_type& k, std::size_t hash) const
+        {
+            return table_.find_node(table_.hash_from_value(hash), k);
+        }
+
+        size_type count(const key_type& k, std::size_t hash) const
+        {
+            return table_.count(table_.hash_from_value(hash), k);
+        }
+
+        std::pair<const_iterator, const_iterator>
+        equal_range(const key_type& k, std::size_t hash) const
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
+        // transparent lookup
+        //
+        // Only available when both hasher and key_equal have a nested
+        // 'is_transparent' type, the key is passed on to them without
+        // being converted to key_type.
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, const_iterator>::type
+        find(Key const& k) const
+        {
+            return table_.find_node(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, size_type>::type
+        count(Key const& k) const
+        {
+            return table_.count(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<const_iterator, const_iterator> >::type
+        equal_range(Key const& k) const
+        {
+            return table_.equal_range(
+                table_.hash_from_value(table_.hash_function()(k)), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, const_iterator>::type
+        find(Key const& k, std::size_t hash) const
+        {
+            return table_.find_node(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, size_type>::type
+        count(Key const& k, std::size_t hash) const
+        {
+            return table_.count(table_.hash_from_value(hash), k);
+        }
+
+        template <class Key>
+        typename boost::unordered::detail::enable_if_transparent<
+            H, P, Key, std::pair<const_iterator, const_iterator> >::type
+        equal_range(Key const& k, std::size_t hash) const
+        {
+            return table_.equal_range(table_.hash_from_value(hash), k);
+        }
+
         // bucket interface
 
         size_type bucket_count() const BOOST_NOEXCEPT
@@ -0,0 +1,173 @@
+//
+// basic_sharded_acceptor.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/basic_sharded_acceptor.hpp>
+
+#include <vector>
+#include <boost/asio/detail/mutex.hpp>
+#include <boost/asio/io_service_pool.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include "unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <boost/bind.hpp>
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+#if defined(SO_REUSEPORT)
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+using std::placeholders::_1;
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+namespace ip = boost::asio::ip;
+
+typedef boost::asio::basic_sharded_acceptor<ip::tcp> sharded_acceptor;
+
+struct accept_state
+{
+  boost::asio::detail::mutex mutex;
+  std::vector<ip::tcp::socket*> sockets;
+  std::vector<int> accepted;
+  int total;
+  int expected;
+};
+
+void start_accept(boost::asio::io_service_pool* pool,
+    sharded_acceptor* acceptor, accept_state* state, std::size_t index);
+
+void handle_accept(const boost::system::error_code& err,
+    boost::asio::io_service_pool* pool, sharded_acceptor* acceptor,
+    accept_state* state, std::size_t index)
+{
+  BOOST_ASIO_CHECK(!err);
+  if (err)
+    return;
+
+  // The accepted socket belongs to the same shard as the acceptor.
+  BOOST_ASIO_CHECK(&state->sockets[index]->get_io_service()
+      == &pool->get_io_service(index));
+  state->sockets[index]->close();
+
+  boost::asio::detail::mutex::scoped_lock lock(state->mutex);
+  ++state->accepted[index];
+  if (++state->total == state->expected)
+    pool->stop();
+  else
+    start_accept(pool, acceptor, state, index);
+}
+
+void start_accept(boost::asio::io_service_pool* pool,
+    sharded_acceptor* acceptor, accept_state* state, std::size_t index)
+{
+  acceptor->acceptor(index).async_accept(*state->sockets[index],
+      bindns::bind(handle_accept, _1, pool, acceptor, state, index));
+}
+
+void test_sharded_accept()
+{
+  boost::asio::io_service_pool pool(2);
+
+  sharded_acceptor acceptor(pool,
+      ip::tcp::endpoint(ip::address_v4::loopback(), 0));
+  BOOST_ASIO_CHECK(acceptor.size() == 2);
+
+  // All acceptors share the port chosen for the first one.
+  ip::tcp::endpoint endpoint = acceptor.local_endpoint();
+  BOOST_ASIO_CHECK(endpoint.port() != 0);
+  for (std::size_t i = 0; i < acceptor.size(); ++i)
+  {
+    BOOST_ASIO_CHECK(&acceptor.acceptor(i).get_io_service()
+        == &pool.get_io_service(i));
+    BOOST_ASIO_CHECK(acceptor.acceptor(i).local_endpoint() == endpoint);
+  }
+
+  // Connect a number of clients. The connections remain in the listen
+  // backlogs until the pool is run.
+  boost::asio::io_service client_io_service;
+  std::vector<ip::tcp::socket*> clients;
+  for (int i = 0; i < 16; ++i)
+  {
+    clients.push_back(new ip::tcp::socket(client_io_service));
+    clients.back()->connect(endpoint);
+  }
+
+  accept_state state;
+  state.accepted.assign(acceptor.size(), 0);
+  state.total = 0;
+  state.expected = static_cast<int>(clients.size());
+  for (std::size_t i = 0; i < acceptor.size(); ++i)
+  {
+    state.sockets.push_back(new ip::tcp::socket(pool.get_io_service(i)));
+    start_accept(&pool, &acceptor, &state, i);
+  }
+
+  pool.run();
+
+  BOOST_ASIO_CHECK(state.total == state.expected);
+
+  acceptor.close();
+  for (std::size_t i = 0; i < acceptor.size(); ++i)
+    BOOST_ASIO_CHECK(!acceptor.acceptor(i).is_open());
+
+  for (std::size_t i = 0; i < clients.size(); ++i)
+    delete clients[i];
+  for (std::size_t i = 0; i < state.sockets.size(); ++i)
+    delete state.sockets[i];
+}
+
+void test_bind_failure()
+{
+  boost::asio::io_service_pool pool(2);
+
+  // A port that is already bound without SO_REUSEPORT cannot be shared.
+  boost::asio::io_service ios;
+  ip::tcp::acceptor plain_acceptor(ios,
+      ip::tcp::endpoint(ip::address_v4::loopback(), 0));
+
+  try
+  {
+    sharded_acceptor acceptor(pool, plain_acceptor.local_endpoint());
+    BOOST_ASIO_ERROR("basic_sharded_acceptor did not throw");
+  }
+  catch (boost::system::system_error& e)
+  {
+    BOOST_ASIO_CHECK(e.code() == boost::asio::error::address_in_use);
+  }
+}
+
+#else // defined(SO_REUSEPORT)
+
+void test_sharded_accept()
+{
+}
+
+void test_bind_failure()
+{
+}
+
+#endif // defined(SO_REUSEPORT)
+
+BOOST_ASIO_TEST_SUITE
+(
+  "basic_sharded_acceptor",
+  BOOST_ASIO_TEST_CASE(test_sharded_accept)
+  BOOST_ASIO_TEST_CASE(test_bind_failure)
+)
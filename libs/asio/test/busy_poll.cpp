@@ -0,0 +1,193 @@
+//
+// busy_poll.cpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/busy_poll.hpp>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/thread/thread.hpp>
+#include "unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <boost/bind.hpp>
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+using std::placeholders::_1;
+using std::placeholders::_2;
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+using namespace boost::asio;
+
+void increment(int* count)
+{
+  ++(*count);
+}
+
+void timer_handler(const boost::system::error_code& ec,
+    deadline_timer* t, int* count)
+{
+  BOOST_ASIO_CHECK(!ec);
+  if (++(*count) < 5)
+  {
+    t->expires_at(t->expires_at() + boost::posix_time::milliseconds(2));
+    t->async_wait(bindns::bind(timer_handler, _1, t, count));
+  }
+}
+
+void reset_work(io_service::work** w)
+{
+  delete *w;
+  *w = 0;
+}
+
+void post_after_delay(io_service* ios, io_service::work** w, int* count)
+{
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+  ios->post(bindns::bind(increment, count));
+  ios->post(bindns::bind(reset_work, w));
+}
+
+void stop_after_delay(io_service* ios)
+{
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+  ios->stop();
+}
+
+void receive_handler(const boost::system::error_code& ec,
+    std::size_t bytes_transferred, int* count)
+{
+  BOOST_ASIO_CHECK(!ec);
+  BOOST_ASIO_CHECK(bytes_transferred == 5);
+  ++(*count);
+}
+
+void send_after_delay(ip::udp::socket* socket, ip::udp::endpoint target)
+{
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+  socket->send_to(buffer("hello", 5), target);
+}
+
+void busy_poll_handlers_test()
+{
+  // Handlers and timers behave the same whether or not the thread spins, and
+  // whether or not the spin period is adapted.
+  for (int adaptive = 0; adaptive < 2; ++adaptive)
+  {
+    io_service ios(1);
+    set_busy_poll(ios, 1000, adaptive != 0);
+
+    int count = 0;
+    for (int i = 0; i < 10; ++i)
+      ios.post(bindns::bind(increment, &count));
+    ios.run();
+    BOOST_ASIO_CHECK(count == 10);
+
+    count = 0;
+    deadline_timer t(ios, boost::posix_time::milliseconds(2));
+    t.async_wait(bindns::bind(timer_handler, _1, &t, &count));
+    ios.reset();
+    ios.run();
+    BOOST_ASIO_CHECK(count == 5);
+  }
+
+  // Busy polling can be disabled again.
+  io_service ios;
+  set_busy_poll(ios, 1000);
+  set_busy_poll(ios, 0);
+  int count = 0;
+  ios.post(bindns::bind(increment, &count));
+  ios.run();
+  BOOST_ASIO_CHECK(count == 1);
+}
+
+void busy_poll_cross_thread_test()
+{
+  // A handler posted from another thread while the task is spinning must be
+  // noticed without the task being interrupted. The spin period is long
+  // enough that the thread is still spinning when the handler arrives.
+  io_service ios(1);
+  set_busy_poll(ios, 1000000, false);
+
+  int count = 0;
+  io_service::work* w = new io_service::work(ios);
+  boost::thread poster(bindns::bind(post_after_delay, &ios, &w, &count));
+  ios.run();
+  poster.join();
+  BOOST_ASIO_CHECK(count == 1);
+  BOOST_ASIO_CHECK(w == 0);
+
+  // The same holds once the spin gives up and the task blocks.
+  set_busy_poll(ios, 1000);
+  count = 0;
+  w = new io_service::work(ios);
+  ios.reset();
+  boost::thread poster2(bindns::bind(post_after_delay, &ios, &w, &count));
+  ios.run();
+  poster2.join();
+  BOOST_ASIO_CHECK(count == 1);
+  BOOST_ASIO_CHECK(w == 0);
+
+  // Stopping the io_service ends the spin.
+  set_busy_poll(ios, 1000000, false);
+  io_service::work work(ios);
+  ios.reset();
+  boost::thread stopper(bindns::bind(stop_after_delay, &ios));
+  ios.run();
+  stopper.join();
+  BOOST_ASIO_CHECK(ios.stopped());
+}
+
+void busy_poll_socket_test()
+{
+  // A datagram that arrives while the task is spinning is picked up by a
+  // non-blocking poll of the reactor.
+  for (int spin_usec = 1000000; spin_usec >= 1000; spin_usec /= 1000)
+  {
+    io_service ios(1);
+    set_busy_poll(ios, spin_usec);
+
+    ip::udp::socket receiver(ios, ip::udp::endpoint(ip::udp::v4(), 0));
+    ip::udp::endpoint target = receiver.local_endpoint();
+    target.address(ip::address_v4::loopback());
+    ip::udp::socket sender(ios, ip::udp::endpoint(ip::udp::v4(), 0));
+
+    char data[16];
+    int count = 0;
+    receiver.async_receive(buffer(data),
+        bindns::bind(receive_handler, _1, _2, &count));
+
+    boost::thread sender_thread(
+        bindns::bind(send_after_delay, &sender, target));
+    ios.run();
+    sender_thread.join();
+    BOOST_ASIO_CHECK(count == 1);
+  }
+}
+
+BOOST_ASIO_TEST_SUITE
+(
+  "busy_poll",
+  BOOST_ASIO_TEST_CASE(busy_poll_handlers_test)
+  BOOST_ASIO_TEST_CASE(busy_poll_cross_thread_test)
+  BOOST_ASIO_TEST_CASE(busy_poll_socket_test)
+)
@@ -16,7 +16,9 @@
 // Test that header file is self-contained.
 #include <boost/asio/io_service.hpp>
 
+#include <cstring>
 #include <sstream>
+#include <boost/asio/handler_alloc_hook.hpp>
 #include "unit_test.hpp"
 
 #if defined(BOOST_ASIO_HAS_BOOST_DATE_TIME)
@@ -351,9 +353,145 @@ void io_service_service_test()
   BOOST_ASIO_CHECK(!boost::asio::has_service<test_service>(ios3));
 }
 
+// A handler whose size places the operation wrapping it in a particular size
+// class of the default allocation hooks. Each invocation posts its successor.
+template <std::size_t Size>
+struct sized_handler
+{
+  sized_handler(io_service* ios, int* count, int remaining)
+    : ios_(ios),
+      count_(count),
+      remaining_(remaining)
+  {
+    std::memset(data_, static_cast<unsigned char>(Size), Size);
+  }
+
+  void operator()()
+  {
+    for (std::size_t i = 0; i < Size; ++i)
+      if (data_[i] != static_cast<unsigned char>(Size))
+        return;
+    ++(*count_);
+    if (remaining_ > 0)
+      ios_->post(sized_handler(ios_, count_, remaining_ - 1));
+  }
+
+  io_service* ios_;
+  int* count_;
+  int remaining_;
+  unsigned char data_[Size];
+};
+
+void io_service_handler_memory_test()
+{
+#if defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+  handler_memory_statistics before = get_handler_memory_statistics();
+#endif // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
+  io_service ios;
+  int count = 0;
+
+  // Three chains of handlers in different size classes run interleaved. The
+  // memory freed before each upcall is reused for the successor, except for
+  // the largest handler which is too big to be cached.
+  ios.post(sized_handler<8>(&ios, &count, 9));
+  ios.post(sized_handler<200>(&ios, &count, 9));
+  ios.post(sized_handler<4000>(&ios, &count, 9));
+  ios.run();
+  BOOST_ASIO_CHECK(count == 30);
+
+#if defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+  handler_memory_statistics after = get_handler_memory_statistics();
+  BOOST_ASIO_CHECK(after.allocations - before.allocations == 30);
+  BOOST_ASIO_CHECK(after.deallocations - before.deallocations == 30);
+  BOOST_ASIO_CHECK(after.cache_hits - before.cache_hits == 18);
+  BOOST_ASIO_CHECK(after.cache_returns - before.cache_returns == 20);
+  BOOST_ASIO_CHECK(after.oversized - before.oversized == 10);
+#endif // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+}
+
+void repost_until_expired(io_service* ios, bool* expired, int* count)
+{
+  if (!*expired && ++(*count) < 10000000)
+    ios->post(bindns::bind(repost_until_expired, ios, expired, count));
+}
+
+void set_expired(bool* expired)
+{
+  *expired = true;
+}
+
+void sleep_record_thread(io_service* ios, boost::thread::id* id)
+{
+  timer t(*ios, chronons::milliseconds(5));
+  t.wait();
+
+  *id = boost::this_thread::get_id();
+}
+
+void post_sleep_record_threads(io_service* ios,
+    boost::thread::id* ids, int n)
+{
+  // Give the other thread a chance to become idle.
+  timer t(*ios, chronons::milliseconds(100));
+  t.wait();
+
+  for (int i = 0; i < n; ++i)
+    ios->post(bindns::bind(sleep_record_thread, ios, &ids[i]));
+}
+
+void io_service_fairness_test()
+{
+  io_service ios;
+  bool expired = false;
+  int count = 0;
+
+  // A handler that keeps reposting itself must not keep the timer from being
+  // delivered.
+  timer t(ios, chronons::milliseconds(10));
+  t.async_wait(bindns::bind(set_expired, &expired));
+  ios.post(bindns::bind(repost_until_expired, &ios, &expired, &count));
+  ios.run();
+
+  BOOST_ASIO_CHECK(expired);
+  BOOST_ASIO_CHECK(count < 10000000);
+}
+
+void io_service_peer_thread_test()
+{
+  io_service ios;
+  boost::thread::id ids[16];
+
+  // The handlers are all posted from a handler running on one thread, and
+  // the other thread must get a share of them.
+  ios.post(bindns::bind(post_sleep_record_threads, &ios, ids, 16));
+  boost::thread thread1(bindns::bind(io_service_run, &ios));
+  boost::thread thread2(bindns::bind(io_service_run, &ios));
+  boost::thread::id id1 = thread1.get_id();
+  boost::thread::id id2 = thread2.get_id();
+  thread1.join();
+  thread2.join();
+
+  int ran_on_thread1 = 0;
+  int ran_on_thread2 = 0;
+  for (int i = 0; i < 16; ++i)
+  {
+    if (ids[i] == id1)
+      ++ran_on_thread1;
+    else if (ids[i] == id2)
+      ++ran_on_thread2;
+  }
+  BOOST_ASIO_CHECK(ran_on_thread1 + ran_on_thread2 == 16);
+  BOOST_ASIO_CHECK(ran_on_thread1 > 0);
+  BOOST_ASIO_CHECK(ran_on_thread2 > 0);
+}
+
 BOOST_ASIO_TEST_SUITE
 (
   "io_service",
   BOOST_ASIO_TEST_CASE(io_service_test)
   BOOST_ASIO_TEST_CASE(io_service_service_test)
+  BOOST_ASIO_TEST_CASE(io_service_handler_memory_test)
+  BOOST_ASIO_TEST_CASE(io_service_fairness_test)
+  BOOST_ASIO_TEST_CASE(io_service_peer_thread_test)
 )
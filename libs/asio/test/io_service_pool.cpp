@@ -0,0 +1,197 @@
+//
+// io_service_pool.cpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/io_service_pool.hpp>
+
+#include <stdexcept>
+#include <vector>
+#include <boost/asio/detail/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include "unit_test.hpp"
+
+#if defined(__linux__)
+# include <sched.h>
+#endif // defined(__linux__)
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <boost/bind.hpp>
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+using namespace boost::asio;
+
+struct shard_state
+{
+  boost::asio::detail::mutex mutex;
+  std::vector<boost::thread::id> thread_ids;
+  std::vector<int> counts;
+  std::size_t finished;
+};
+
+void chain_handler(io_service_pool* pool, shard_state* state,
+    std::size_t index, int remaining)
+{
+  boost::asio::detail::mutex::scoped_lock lock(state->mutex);
+
+  // Every handler posted to a shard must run on the same thread.
+  if (state->counts[index] == 0)
+    state->thread_ids[index] = boost::this_thread::get_id();
+  else
+    BOOST_ASIO_CHECK(state->thread_ids[index] == boost::this_thread::get_id());
+  ++state->counts[index];
+
+  if (remaining > 0)
+  {
+    pool->get_io_service(index).post(bindns::bind(chain_handler,
+          pool, state, index, remaining - 1));
+  }
+  else if (++state->finished == pool->size())
+  {
+    pool->stop();
+  }
+}
+
+void run_chains(io_service_pool& pool, shard_state& state)
+{
+  state.thread_ids.assign(pool.size(), boost::thread::id());
+  state.counts.assign(pool.size(), 0);
+  state.finished = 0;
+
+  for (std::size_t i = 0; i < pool.size(); ++i)
+    pool.get_io_service(i).post(bindns::bind(chain_handler,
+          &pool, &state, i, 99));
+
+  pool.run();
+}
+
+void io_service_pool_test()
+{
+  try
+  {
+    io_service_pool bad_pool(0);
+    BOOST_ASIO_ERROR("io_service_pool did not throw");
+  }
+  catch (std::invalid_argument&)
+  {
+  }
+
+  io_service_pool pool(3);
+  BOOST_ASIO_CHECK(pool.size() == 3);
+
+  // Round-robin selection cycles through the shards.
+  BOOST_ASIO_CHECK(&pool.get_io_service() == &pool.get_io_service(0));
+  BOOST_ASIO_CHECK(&pool.get_io_service() == &pool.get_io_service(1));
+  BOOST_ASIO_CHECK(&pool.get_io_service() == &pool.get_io_service(2));
+  BOOST_ASIO_CHECK(&pool.get_io_service() == &pool.get_io_service(0));
+
+  shard_state state;
+  run_chains(pool, state);
+
+  for (std::size_t i = 0; i < pool.size(); ++i)
+  {
+    BOOST_ASIO_CHECK(state.counts[i] == 100);
+    for (std::size_t j = 0; j < i; ++j)
+      BOOST_ASIO_CHECK(state.thread_ids[i] != state.thread_ids[j]);
+  }
+
+  // The pool may be run again after it has been stopped.
+  run_chains(pool, state);
+  for (std::size_t i = 0; i < pool.size(); ++i)
+    BOOST_ASIO_CHECK(state.counts[i] == 100);
+
+  // Pinning the threads to processors does not change the behaviour.
+  io_service_pool pinned_pool(2, true);
+  run_chains(pinned_pool, state);
+  for (std::size_t i = 0; i < pinned_pool.size(); ++i)
+    BOOST_ASIO_CHECK(state.counts[i] == 100);
+}
+
+#if defined(__linux__) && defined(CPU_SET)
+
+struct affinity_state
+{
+  boost::asio::detail::mutex mutex;
+  std::vector<cpu_set_t> sets;
+  std::size_t finished;
+};
+
+void affinity_handler(io_service_pool* pool,
+    affinity_state* state, std::size_t index)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  BOOST_ASIO_CHECK(::sched_getaffinity(0, sizeof(set), &set) == 0);
+
+  boost::asio::detail::mutex::scoped_lock lock(state->mutex);
+  state->sets[index] = set;
+  if (++state->finished == pool->size())
+    pool->stop();
+}
+
+void io_service_pool_pinning_test()
+{
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  BOOST_ASIO_CHECK(::sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET(cpu, &allowed))
+      cpus.push_back(cpu);
+
+  // Use more shards than processors, so that the allowed ones are reused.
+  io_service_pool pool(cpus.size() + 1, true);
+  affinity_state state;
+  state.sets.resize(pool.size());
+  state.finished = 0;
+  for (std::size_t i = 0; i < pool.size(); ++i)
+    pool.get_io_service(i).post(bindns::bind(affinity_handler,
+          &pool, &state, i));
+
+  boost::system::error_code ec;
+  pool.run(ec);
+  BOOST_ASIO_CHECK(!ec);
+  BOOST_ASIO_CHECK(state.finished == pool.size());
+
+  // Each shard's thread is bound to one of the processors in the mask of the
+  // thread that ran the pool, taken in order.
+  for (std::size_t i = 0; i < state.sets.size(); ++i)
+  {
+    BOOST_ASIO_CHECK(CPU_COUNT(&state.sets[i]) == 1);
+    BOOST_ASIO_CHECK(CPU_ISSET(cpus[i % cpus.size()], &state.sets[i]));
+  }
+}
+
+#else // defined(__linux__) && defined(CPU_SET)
+
+void io_service_pool_pinning_test()
+{
+}
+
+#endif // defined(__linux__) && defined(CPU_SET)
+
+BOOST_ASIO_TEST_SUITE
+(
+  "io_service_pool",
+  BOOST_ASIO_TEST_CASE(io_service_pool_test)
+  BOOST_ASIO_TEST_CASE(io_service_pool_pinning_test)
+)
@@ -19,7 +19,9 @@
 // Test that header file is self-contained.
 #include <boost/asio/ip/tcp.hpp>
 
+#include <cstdio>
 #include <cstring>
+#include <vector>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
@@ -440,6 +442,15 @@ void test()
     (void)i25;
     int i26 = socket1.async_read_some(null_buffers(), lazy);
     (void)i26;
+
+#if defined(BOOST_ASIO_HAS_SENDFILE)
+    socket1.send_file(0, 0, 0);
+    socket1.send_file(0, 0, 0, ec);
+
+    socket1.async_send_file(0, 0, 0, &send_handler);
+    int i27 = socket1.async_send_file(0, 0, 0, lazy);
+    (void)i27;
+#endif // defined(BOOST_ASIO_HAS_SENDFILE)
   }
   catch (std::exception&)
   {
@@ -507,9 +518,17 @@ void handle_read_eof(const boost::system::error_code& err,
   BOOST_ASIO_CHECK(bytes_transferred == 0);
 }
 
+void handle_transfer(const boost::system::error_code& err,
+    size_t bytes_transferred, size_t expected, bool* called)
+{
+  *called = true;
+  BOOST_ASIO_CHECK(!err);
+  BOOST_ASIO_CHECK(bytes_transferred == expected);
+}
+
 void test()
 {
-  using namespace std; // For memcmp.
+  using namespace std; // For memcmp, tmpfile, fwrite, fflush.
   using namespace boost::asio;
   namespace ip = boost::asio::ip;
 
@@ -577,6 +596,62 @@ void test()
   BOOST_ASIO_CHECK(write_completed);
   BOOST_ASIO_CHECK(memcmp(read_buffer, write_data, sizeof(write_data)) == 0);
 
+#if defined(BOOST_ASIO_HAS_SENDFILE)
+  // Send a file region that is larger than the socket buffers, so that the
+  // operation must resume after partial writes.
+
+  const size_t file_size = 4 * 1024 * 1024;
+  std::vector<char> file_data(file_size);
+  for (size_t i = 0; i < file_size; ++i)
+    file_data[i] = static_cast<char>(i % 251);
+  FILE* file = tmpfile();
+  BOOST_ASIO_CHECK(file != 0);
+  fwrite(&file_data[0], 1, file_size, file);
+  fflush(file);
+
+  std::vector<char> file_read_buffer(file_size);
+  bool file_read_completed = false;
+  boost::asio::async_read(client_side_socket,
+      boost::asio::buffer(file_read_buffer),
+      bindns::bind(handle_transfer,
+        _1, _2, file_size, &file_read_completed));
+
+  bool send_file_completed = false;
+  server_side_socket.async_send_file(fileno(file), 0, file_size,
+      bindns::bind(handle_transfer,
+        _1, _2, file_size, &send_file_completed));
+
+  ios.reset();
+  ios.run();
+  BOOST_ASIO_CHECK(file_read_completed);
+  BOOST_ASIO_CHECK(send_file_completed);
+  BOOST_ASIO_CHECK(file_read_buffer == file_data);
+
+  // A synchronous send starting part way into the file.
+
+  boost::system::error_code send_file_ec;
+  size_t bytes_sent = server_side_socket.send_file(
+      fileno(file), file_size - 10, 10, send_file_ec);
+  BOOST_ASIO_CHECK(!send_file_ec);
+  BOOST_ASIO_CHECK(bytes_sent == 10);
+  size_t bytes_read = boost::asio::read(client_side_socket,
+      boost::asio::buffer(read_buffer, 10));
+  BOOST_ASIO_CHECK(bytes_read == 10);
+  BOOST_ASIO_CHECK(memcmp(read_buffer, &file_data[file_size - 10], 10) == 0);
+
+  // A region that extends past the end of the file fails with eof.
+
+  bytes_sent = server_side_socket.send_file(
+      fileno(file), file_size - 10, 20, send_file_ec);
+  BOOST_ASIO_CHECK(send_file_ec == boost::asio::error::eof);
+  BOOST_ASIO_CHECK(bytes_sent == 10);
+  bytes_read = boost::asio::read(client_side_socket,
+      boost::asio::buffer(read_buffer, 10));
+  BOOST_ASIO_CHECK(bytes_read == 10);
+
+  fclose(file);
+#endif // defined(BOOST_ASIO_HAS_SENDFILE)
+
   // Cancelled read.
 
   bool read_cancel_completed = false;
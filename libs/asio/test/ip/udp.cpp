@@ -24,6 +24,12 @@
 #include "../archetypes/io_control_command.hpp"
 #include "../archetypes/settable_socket_option.hpp"
 
+#if defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+# include <boost/array.hpp>
+#else // defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+# include <array>
+#endif // defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+
 #if defined(BOOST_ASIO_HAS_BOOST_BIND)
 # include <boost/bind.hpp>
 #else // defined(BOOST_ASIO_HAS_BOOST_BIND)
@@ -53,6 +59,12 @@ void receive_handler(const boost::system::error_code&, std::size_t)
 
 void test()
 {
+#if defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+  using boost::array;
+#else // defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+  using std::array;
+#endif // defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+
   using namespace boost::asio;
   namespace ip = boost::asio::ip;
 
@@ -378,6 +390,45 @@ void test()
     int i28 = socket1.async_receive_from(null_buffers(),
         endpoint, in_flags, lazy);
     (void)i28;
+
+#if !defined(BOOST_ASIO_HAS_IOCP)
+    array<boost::asio::mutable_buffer, 2> mutable_buffers = {{
+        buffer(mutable_char_buffer), buffer(mutable_char_buffer) }};
+    array<boost::asio::const_buffer, 2> const_buffers = {{
+        buffer(const_char_buffer), buffer(const_char_buffer) }};
+    ip::udp::endpoint endpoints[2];
+    std::size_t sizes[2];
+
+    socket1.send_to_batch(const_buffers, endpoints);
+    socket1.send_to_batch(mutable_buffers, endpoints);
+    socket1.send_to_batch(const_buffers, endpoints, in_flags, ec);
+    socket1.send_to_batch(mutable_buffers, endpoints, in_flags, ec);
+
+    socket1.async_send_to_batch(const_buffers, endpoints, &send_handler);
+    socket1.async_send_to_batch(mutable_buffers, endpoints, &send_handler);
+    socket1.async_send_to_batch(const_buffers,
+        endpoints, in_flags, &send_handler);
+    int i29 = socket1.async_send_to_batch(const_buffers, endpoints, lazy);
+    (void)i29;
+    int i30 = socket1.async_send_to_batch(const_buffers,
+        endpoints, in_flags, lazy);
+    (void)i30;
+
+    socket1.receive_from_batch(mutable_buffers, endpoints, sizes);
+    socket1.receive_from_batch(mutable_buffers, endpoints, sizes,
+        in_flags, ec);
+
+    socket1.async_receive_from_batch(mutable_buffers,
+        endpoints, sizes, &receive_handler);
+    socket1.async_receive_from_batch(mutable_buffers,
+        endpoints, sizes, in_flags, &receive_handler);
+    int i31 = socket1.async_receive_from_batch(mutable_buffers,
+        endpoints, sizes, lazy);
+    (void)i31;
+    int i32 = socket1.async_receive_from_batch(mutable_buffers,
+        endpoints, sizes, in_flags, lazy);
+    (void)i32;
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
   }
   catch (std::exception&)
   {
@@ -410,6 +461,12 @@ void handle_recv(size_t expected_bytes_recvd,
 
 void test()
 {
+#if defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+  using boost::array;
+#else // defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+  using std::array;
+#endif // defined(BOOST_ASIO_HAS_BOOST_ARRAY)
+
   using namespace std; // For memcmp and memset.
   using namespace boost::asio;
   namespace ip = boost::asio::ip;
@@ -453,6 +510,37 @@ void test()
   ios.run();
 
   BOOST_ASIO_CHECK(memcmp(send_msg, recv_msg, sizeof(send_msg)) == 0);
+
+#if !defined(BOOST_ASIO_HAS_IOCP)
+  // Send three datagrams of different lengths in one batch, and receive them
+  // again in a second batch.
+  array<const_buffer, 3> send_bufs = {{
+      buffer(send_msg, 10), buffer(send_msg, 20), buffer(send_msg, 30) }};
+  ip::udp::endpoint destinations[3] = {
+      target_endpoint, target_endpoint, target_endpoint };
+  size_t msgs_sent = s1.send_to_batch(send_bufs, destinations);
+  BOOST_ASIO_CHECK(msgs_sent == 3);
+
+  char recv_msgs[4][sizeof(send_msg)];
+  array<mutable_buffer, 4> recv_bufs = {{
+      buffer(recv_msgs[0]), buffer(recv_msgs[1]),
+      buffer(recv_msgs[2]), buffer(recv_msgs[3]) }};
+  ip::udp::endpoint senders[4];
+  size_t sizes[4] = { 0, 0, 0, 0 };
+
+  ios.reset();
+  s2.async_receive_from_batch(recv_bufs, senders, sizes,
+      bindns::bind(handle_recv, 3, _1, _2));
+  ios.run();
+
+  for (int i = 0; i < 3; ++i)
+  {
+    BOOST_ASIO_CHECK(sizes[i] == static_cast<size_t>(10 * (i + 1)));
+    BOOST_ASIO_CHECK(senders[i] == sender_endpoint);
+    BOOST_ASIO_CHECK(memcmp(send_msg, recv_msgs[i], sizes[i]) == 0);
+  }
+  BOOST_ASIO_CHECK(sizes[3] == 0);
+#endif // !defined(BOOST_ASIO_HAS_IOCP)
 }
 
 } // namespace ip_udp_socket_runtime
@@ -0,0 +1,196 @@
+//
+// accept_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/basic_sharded_acceptor.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/io_service_pool.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using boost::asio::ip::tcp;
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+// Reads a single byte from the client, echoes it back, and closes.
+class connection
+  : public boost::enable_shared_from_this<connection>
+{
+public:
+  explicit connection(boost::asio::io_service& io_service)
+    : socket_(io_service)
+  {
+  }
+
+  tcp::socket& socket()
+  {
+    return socket_;
+  }
+
+  void start()
+  {
+    boost::asio::async_read(socket_, boost::asio::buffer(data_),
+        boost::bind(&connection::handle_read, shared_from_this(), _1));
+  }
+
+private:
+  void handle_read(const boost::system::error_code& ec)
+  {
+    if (!ec)
+    {
+      boost::asio::async_write(socket_, boost::asio::buffer(data_),
+          boost::bind(&connection::handle_write, shared_from_this()));
+    }
+  }
+
+  void handle_write()
+  {
+  }
+
+  tcp::socket socket_;
+  char data_[1];
+};
+
+// Accepts connections on one acceptor, creating each connection on the given
+// io_service.
+class server
+{
+public:
+  server(tcp::acceptor& acceptor)
+    : acceptor_(acceptor)
+  {
+  }
+
+  void start()
+  {
+    boost::shared_ptr<connection> c(
+        new connection(acceptor_.get_io_service()));
+    acceptor_.async_accept(c->socket(),
+        boost::bind(&server::handle_accept, this, c, _1));
+  }
+
+private:
+  void handle_accept(boost::shared_ptr<connection> c,
+      const boost::system::error_code& ec)
+  {
+    if (!ec)
+    {
+      c->start();
+      start();
+    }
+  }
+
+  tcp::acceptor& acceptor_;
+};
+
+void run_clients(tcp::endpoint endpoint, int count)
+{
+  boost::asio::io_service io_service;
+  char data[1] = { 'x' };
+  for (int i = 0; i < count; ++i)
+  {
+    tcp::socket socket(io_service);
+    socket.connect(endpoint);
+    socket.set_option(tcp::no_delay(true));
+    boost::asio::write(socket, boost::asio::buffer(data));
+    boost::asio::read(socket, boost::asio::buffer(data));
+  }
+}
+
+double run_test(tcp::endpoint endpoint, int num_clients, int num_connections)
+{
+  ptime start = microsec_clock::universal_time();
+
+  std::vector<boost::shared_ptr<boost::thread> > clients;
+  for (int i = 0; i < num_clients; ++i)
+  {
+    clients.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+            boost::bind(run_clients, endpoint,
+              num_connections / num_clients))));
+  }
+  for (std::size_t i = 0; i < clients.size(); ++i)
+    clients[i]->join();
+
+  ptime stop = microsec_clock::universal_time();
+  double elapsed_sec = (stop - start).total_microseconds() / 1000000.0;
+  return num_connections / elapsed_sec;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: accept_throughput <nthreads> <nclients> "
+        "<nconnections> {shared|sharded}\n");
+    return 1;
+  }
+
+  int num_threads = std::atoi(argv[1]);
+  int num_clients = std::atoi(argv[2]);
+  int num_connections = std::atoi(argv[3]);
+  bool sharded = (std::strcmp(argv[4], "sharded") == 0);
+
+  tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), 0);
+  double rate = 0;
+
+  if (sharded)
+  {
+    // One io_service per thread, each with its own listening socket.
+    boost::asio::io_service_pool pool(num_threads);
+    boost::asio::basic_sharded_acceptor<tcp> acceptor(pool, endpoint);
+    std::vector<boost::shared_ptr<server> > servers;
+    for (std::size_t i = 0; i < acceptor.size(); ++i)
+    {
+      servers.push_back(boost::shared_ptr<server>(
+            new server(acceptor.acceptor(i))));
+      servers.back()->start();
+    }
+
+    boost::thread t(boost::bind(&boost::asio::io_service_pool::run, &pool));
+    rate = run_test(acceptor.local_endpoint(), num_clients, num_connections);
+    pool.stop();
+    t.join();
+  }
+  else
+  {
+    // One io_service and acceptor shared by all threads.
+    boost::asio::io_service io_service;
+    tcp::acceptor acceptor(io_service, endpoint);
+    server s(acceptor);
+    s.start();
+
+    boost::asio::io_service::work work(io_service);
+    std::vector<boost::shared_ptr<boost::thread> > threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+              boost::bind(&boost::asio::io_service::run, &io_service))));
+    }
+
+    rate = run_test(acceptor.local_endpoint(), num_clients, num_connections);
+    io_service.stop();
+    for (std::size_t i = 0; i < threads.size(); ++i)
+      threads[i]->join();
+  }
+
+  std::printf("%s\t%d threads\t%.0f connections/sec\n",
+      sharded ? "sharded" : "shared", num_threads, rate);
+  return 0;
+}
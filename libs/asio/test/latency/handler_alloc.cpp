@@ -0,0 +1,122 @@
+//
+// handler_alloc.cpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/handler_alloc_hook.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+// A handler that carries a payload of the given size, so that the operations
+// wrapping it fall into different size classes.
+template <std::size_t Size>
+struct payload_handler
+{
+  void operator()() {}
+  char data_[Size];
+};
+
+// A chain of handlers, each of which posts its successor along with a number
+// of payload handlers of varying sizes. More than one block is therefore
+// freed and allocated on each step, which defeats a single-slot cache.
+class chain
+{
+public:
+  chain(boost::asio::io_service& io_service, long remaining, int fanout)
+    : io_service_(io_service),
+      remaining_(remaining),
+      fanout_(fanout)
+  {
+  }
+
+  void operator()()
+  {
+    if (--remaining_ > 0)
+    {
+      for (int i = 0; i < fanout_; ++i)
+      {
+        switch (i % 4)
+        {
+        case 0: io_service_.post(payload_handler<16>()); break;
+        case 1: io_service_.post(payload_handler<100>()); break;
+        case 2: io_service_.post(payload_handler<200>()); break;
+        default: io_service_.post(payload_handler<400>()); break;
+        }
+      }
+      io_service_.post(*this);
+    }
+  }
+
+private:
+  boost::asio::io_service& io_service_;
+  long remaining_;
+  int fanout_;
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: handler_alloc <nthreads> <nchains> <nsteps> <fanout>\n");
+    return 1;
+  }
+
+  int num_threads = std::atoi(argv[1]);
+  int num_chains = std::atoi(argv[2]);
+  long num_steps = std::atol(argv[3]);
+  int fanout = std::atoi(argv[4]);
+
+  boost::asio::io_service io_service(num_threads);
+
+  for (int i = 0; i < num_chains; ++i)
+    io_service.post(chain(io_service, num_steps / num_chains, fanout));
+
+  ptime start = microsec_clock::universal_time();
+
+  std::vector<boost::shared_ptr<boost::thread> > threads;
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+            boost::bind(&boost::asio::io_service::run, &io_service))));
+  }
+
+  for (std::size_t i = 0; i < threads.size(); ++i)
+    threads[i]->join();
+
+  ptime stop = microsec_clock::universal_time();
+  double elapsed_sec = (stop - start).total_microseconds() / 1000000.0;
+  double total = static_cast<double>(num_steps) * (fanout + 1);
+  std::printf("handlers/sec\t%.0f\n", total / elapsed_sec);
+
+#if defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+  boost::asio::handler_memory_statistics stats =
+    boost::asio::get_handler_memory_statistics();
+  std::printf("allocations\t%lu\n",
+      static_cast<unsigned long>(stats.allocations));
+  std::printf("cache hits\t%lu\n",
+      static_cast<unsigned long>(stats.cache_hits));
+  std::printf("deallocations\t%lu\n",
+      static_cast<unsigned long>(stats.deallocations));
+  std::printf("cache returns\t%lu\n",
+      static_cast<unsigned long>(stats.cache_returns));
+  std::printf("oversized\t%lu\n",
+      static_cast<unsigned long>(stats.oversized));
+#endif // defined(BOOST_ASIO_ENABLE_HANDLER_MEMORY_STATS)
+
+  return 0;
+}
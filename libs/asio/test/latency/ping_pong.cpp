@@ -0,0 +1,200 @@
+//
+// ping_pong.cpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/busy_poll.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/resource.h>
+#include "high_res_clock.hpp"
+
+using boost::asio::ip::udp;
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+// Echoes every datagram back to its sender.
+class pong
+{
+public:
+  pong(boost::asio::io_service& io_service)
+    : socket_(io_service,
+        udp::endpoint(boost::asio::ip::address_v4::loopback(), 0))
+  {
+  }
+
+  udp::endpoint local_endpoint() const
+  {
+    return socket_.local_endpoint();
+  }
+
+  void start()
+  {
+    socket_.async_receive_from(boost::asio::buffer(data_, sizeof(data_)),
+        sender_, boost::bind(&pong::handle_receive, this, _1, _2));
+  }
+
+  void stop()
+  {
+    socket_.close();
+  }
+
+private:
+  void handle_receive(const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec)
+      return;
+    socket_.async_send_to(boost::asio::buffer(data_, n), sender_,
+        boost::bind(&pong::handle_send, this, _1));
+  }
+
+  void handle_send(const boost::system::error_code& ec)
+  {
+    if (!ec)
+      start();
+  }
+
+  udp::socket socket_;
+  udp::endpoint sender_;
+  char data_[64];
+};
+
+// Sends a datagram, waits for the echo and records the round trip time.
+class ping
+{
+public:
+  ping(boost::asio::io_service& io_service,
+      const udp::endpoint& target, std::size_t num_samples)
+    : socket_(io_service,
+        udp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+      target_(target),
+      samples_(num_samples),
+      count_(0)
+  {
+    std::memset(data_, 0, sizeof(data_));
+  }
+
+  void start()
+  {
+    start_ = high_res_clock();
+    socket_.async_send_to(boost::asio::buffer(data_, sizeof(data_)), target_,
+        boost::bind(&ping::handle_send, this, _1));
+  }
+
+  const std::vector<boost::uint64_t>& samples() const
+  {
+    return samples_;
+  }
+
+private:
+  void handle_send(const boost::system::error_code& ec)
+  {
+    if (ec)
+      return;
+    socket_.async_receive(boost::asio::buffer(data_, sizeof(data_)),
+        boost::bind(&ping::handle_receive, this, _1));
+  }
+
+  void handle_receive(const boost::system::error_code& ec)
+  {
+    if (ec)
+      return;
+    samples_[count_] = high_res_clock() - start_;
+    if (++count_ < samples_.size())
+      start();
+  }
+
+  udp::socket socket_;
+  udp::endpoint target_;
+  std::vector<boost::uint64_t> samples_;
+  std::size_t count_;
+  boost::uint64_t start_;
+  char data_[16];
+};
+
+void run_io_service(boost::asio::io_service* io_service)
+{
+  io_service->run();
+}
+
+double cpu_seconds()
+{
+  rusage usage;
+  ::getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+    + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4)
+  {
+    std::fprintf(stderr,
+        "Usage: ping_pong <samples> <spin_usec> {fixed|adaptive}\n");
+    return 1;
+  }
+
+  std::size_t num_samples = std::atoi(argv[1]);
+  std::size_t spin_usec = std::atoi(argv[2]);
+  bool adaptive = (std::strcmp(argv[3], "adaptive") == 0);
+
+  // Each side has its own single-threaded io_service, as it would if the two
+  // ends were separate processes.
+  boost::asio::io_service pong_io_service(1);
+  boost::asio::io_service ping_io_service(1);
+  boost::asio::set_busy_poll(pong_io_service, spin_usec, adaptive);
+  boost::asio::set_busy_poll(ping_io_service, spin_usec, adaptive);
+
+  pong p(pong_io_service);
+  p.start();
+  boost::thread pong_thread(boost::bind(run_io_service, &pong_io_service));
+
+  ping c(ping_io_service, p.local_endpoint(), num_samples);
+
+  ptime start = microsec_clock::universal_time();
+  boost::uint64_t start_hr = high_res_clock();
+  double start_cpu = cpu_seconds();
+
+  c.start();
+  ping_io_service.run();
+
+  ptime stop = microsec_clock::universal_time();
+  boost::uint64_t stop_hr = high_res_clock();
+  double stop_cpu = cpu_seconds();
+
+  pong_io_service.post(boost::bind(&pong::stop, &p));
+  pong_thread.join();
+
+  boost::uint64_t elapsed_usec = (stop - start).total_microseconds();
+  boost::uint64_t elapsed_hr = stop_hr - start_hr;
+  double scale = 1.0 * elapsed_usec / elapsed_hr;
+
+  std::vector<boost::uint64_t> samples(c.samples());
+  std::sort(samples.begin(), samples.end());
+  std::printf(" 50.0%%\t%f\n", samples[num_samples * 5 / 10 - 1] * scale);
+  std::printf(" 90.0%%\t%f\n", samples[num_samples * 9 / 10 - 1] * scale);
+  std::printf(" 99.0%%\t%f\n", samples[num_samples * 99 / 100 - 1] * scale);
+  std::printf(" 99.9%%\t%f\n", samples[num_samples * 999 / 1000 - 1] * scale);
+  std::printf("100.0%%\t%f\n", samples[num_samples - 1] * scale);
+
+  double total = 0.0;
+  for (std::size_t i = 0; i < num_samples; ++i) total += samples[i] * scale;
+  std::printf("  mean\t%f\n", total / num_samples);
+
+  // The CPU time used by both threads, as a percentage of one processor.
+  std::printf("   cpu\t%.0f%%\n",
+      100.0 * (stop_cpu - start_cpu) * 1000000.0 / elapsed_usec);
+}
@@ -0,0 +1,104 @@
+//
+// post_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+// A chain of handlers, each of which posts (or dispatches) its successor from
+// within the io_service. With BOOST_ASIO_ENABLE_WORK_STEALING defined these
+// posts go to the running thread's local queue.
+class chain
+{
+public:
+  chain(boost::asio::io_service& io_service, long remaining, bool dispatch)
+    : io_service_(io_service),
+      remaining_(remaining),
+      dispatch_(dispatch)
+  {
+  }
+
+  void operator()()
+  {
+    if (--remaining_ > 0)
+    {
+      if (dispatch_)
+        io_service_.dispatch(noop());
+      io_service_.post(*this);
+    }
+  }
+
+private:
+  struct noop
+  {
+    void operator()() {}
+  };
+
+  boost::asio::io_service& io_service_;
+  long remaining_;
+  bool dispatch_;
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: post_throughput <maxthreads> <nchains> "
+        "<nhandlers> {post|dispatch}\n");
+    return 1;
+  }
+
+  int max_threads = std::atoi(argv[1]);
+  int num_chains = std::atoi(argv[2]);
+  long num_handlers = std::atol(argv[3]);
+  bool dispatch = (std::strcmp(argv[4], "dispatch") == 0);
+
+#if defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  std::printf("scheduler: work stealing\n");
+#else // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  std::printf("scheduler: shared queue\n");
+#endif // defined(BOOST_ASIO_ENABLE_WORK_STEALING)
+  std::printf("threads\thandlers/sec\n");
+
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+  {
+    boost::asio::io_service io_service(num_threads);
+
+    for (int i = 0; i < num_chains; ++i)
+      io_service.post(chain(io_service, num_handlers / num_chains, dispatch));
+
+    ptime start = microsec_clock::universal_time();
+
+    std::vector<boost::shared_ptr<boost::thread> > threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+              boost::bind(&boost::asio::io_service::run, &io_service))));
+    }
+
+    for (std::size_t i = 0; i < threads.size(); ++i)
+      threads[i]->join();
+
+    ptime stop = microsec_clock::universal_time();
+    double elapsed_sec = (stop - start).total_microseconds() / 1000000.0;
+    double total = static_cast<double>(num_handlers) * (dispatch ? 2 : 1);
+    std::printf("%d\t%.0f\n", num_threads, total / elapsed_sec);
+  }
+}
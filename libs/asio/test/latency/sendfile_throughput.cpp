@@ -0,0 +1,202 @@
+//
+// sendfile_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/splice.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+using boost::asio::ip::tcp;
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+const std::size_t chunk_size = 65536;
+
+// Reads and discards everything sent by the server.
+class sink
+{
+public:
+  sink(tcp::socket& socket, std::size_t total)
+    : socket_(socket),
+      remaining_(total),
+      buffer_(chunk_size)
+  {
+  }
+
+  void start()
+  {
+    socket_.async_read_some(boost::asio::buffer(buffer_),
+        boost::bind(&sink::handle_read, this, _1, _2));
+  }
+
+private:
+  void handle_read(const boost::system::error_code& ec, std::size_t n)
+  {
+    remaining_ -= n;
+    if (!ec && remaining_ > 0)
+      start();
+  }
+
+  tcp::socket& socket_;
+  std::size_t remaining_;
+  std::vector<char> buffer_;
+};
+
+// Sends the file the given number of times, either by reading it into a
+// buffer and calling async_write, by async_send_file, or by splicing it
+// through a pipe.
+class source
+{
+public:
+  source(tcp::socket& socket, int file, std::size_t file_size,
+      int repeats, const char* mode)
+    : socket_(socket),
+      file_(file),
+      file_size_(file_size),
+      repeats_(repeats),
+      offset_(0),
+      buffer_(chunk_size),
+      pipe_read_(socket.get_io_service()),
+      pipe_write_(-1),
+      mode_(mode)
+  {
+    if (std::strcmp(mode_, "splice") == 0)
+    {
+      int fds[2];
+      if (::pipe(fds) == 0)
+      {
+        pipe_read_.assign(fds[0]);
+        pipe_write_ = fds[1];
+      }
+    }
+  }
+
+  void start()
+  {
+    if (std::strcmp(mode_, "sendfile") == 0)
+    {
+      socket_.async_send_file(file_, 0, file_size_,
+          boost::bind(&source::handle_send_file, this, _1, _2));
+    }
+    else if (std::strcmp(mode_, "splice") == 0)
+    {
+      // Move the next chunk of the file into the pipe, then splice it on to
+      // the socket.
+      std::size_t n = file_size_ - offset_;
+      if (n > chunk_size)
+        n = chunk_size;
+      loff_t off = offset_;
+      ssize_t result = ::splice(file_, &off,
+          pipe_write_, 0, n, SPLICE_F_MOVE);
+      if (result <= 0)
+        return;
+      boost::asio::async_splice(pipe_read_, socket_, result,
+          boost::bind(&source::handle_write, this, _1, _2));
+    }
+    else
+    {
+      std::size_t n = file_size_ - offset_;
+      if (n > chunk_size)
+        n = chunk_size;
+      ssize_t result = ::pread(file_, &buffer_[0], n, offset_);
+      if (result <= 0)
+        return;
+      boost::asio::async_write(socket_,
+          boost::asio::buffer(buffer_, result),
+          boost::bind(&source::handle_write, this, _1, _2));
+    }
+  }
+
+private:
+  void handle_send_file(const boost::system::error_code& ec, std::size_t)
+  {
+    if (!ec && --repeats_ > 0)
+      start();
+  }
+
+  void handle_write(const boost::system::error_code& ec, std::size_t n)
+  {
+    if (ec)
+      return;
+    offset_ += n;
+    if (offset_ == file_size_)
+    {
+      offset_ = 0;
+      if (--repeats_ == 0)
+        return;
+    }
+    start();
+  }
+
+  tcp::socket& socket_;
+  int file_;
+  std::size_t file_size_;
+  int repeats_;
+  std::size_t offset_;
+  std::vector<char> buffer_;
+  boost::asio::posix::stream_descriptor pipe_read_;
+  int pipe_write_;
+  const char* mode_;
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4)
+  {
+    std::fprintf(stderr,
+        "Usage: sendfile_throughput <file_mb> <repeats> "
+        "{write|sendfile|splice}\n");
+    return 1;
+  }
+
+  std::size_t file_size = std::atoi(argv[1]) * 1024 * 1024;
+  int repeats = std::atoi(argv[2]);
+  const char* mode = argv[3];
+
+  FILE* file = std::tmpfile();
+  std::vector<char> data(chunk_size, 'x');
+  for (std::size_t n = 0; n < file_size; n += chunk_size)
+    std::fwrite(&data[0], 1, chunk_size, file);
+  std::fflush(file);
+
+  boost::asio::io_service io_service;
+  tcp::acceptor acceptor(io_service, tcp::endpoint(tcp::v4(), 0));
+  tcp::endpoint endpoint = acceptor.local_endpoint();
+  endpoint.address(boost::asio::ip::address_v4::loopback());
+  tcp::socket client_socket(io_service);
+  tcp::socket server_socket(io_service);
+  client_socket.connect(endpoint);
+  acceptor.accept(server_socket);
+
+  sink s(client_socket, file_size * repeats);
+  source src(server_socket, fileno(file), file_size, repeats, mode);
+
+  ptime start = microsec_clock::universal_time();
+
+  s.start();
+  src.start();
+  io_service.run();
+
+  ptime stop = microsec_clock::universal_time();
+  double elapsed_sec = (stop - start).total_microseconds() / 1000000.0;
+  double total_mb = static_cast<double>(file_size) * repeats / 1048576.0;
+  std::printf("%s\t%.0f MB/s\n", mode, total_mb / elapsed_sec);
+
+  std::fclose(file);
+  return 0;
+}
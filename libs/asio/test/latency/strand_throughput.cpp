@@ -0,0 +1,135 @@
+//
+// strand_throughput.cpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono/duration.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+
+// Number of handlers currently running on any strand, and the highest value
+// seen. Independent strands should be able to run concurrently up to the
+// number of threads; a lower peak means that some strands were serialised.
+boost::detail::atomic_count running(0);
+volatile long peak_running = 0;
+
+// Number of times a strand was found to be running two handlers at once.
+boost::detail::atomic_count violations(0);
+
+// A chain of handlers, each of which posts its successor through the strand.
+// Each handler may block for a while to model work that does not need the
+// CPU, so that the number of handlers running at once is limited only by the
+// number of threads and by any serialisation between strands.
+class chain
+{
+public:
+  chain(boost::asio::io_service::strand& strand, long remaining,
+      long block_usec, volatile bool* busy)
+    : strand_(strand),
+      remaining_(remaining),
+      block_usec_(block_usec),
+      busy_(busy)
+  {
+  }
+
+  void operator()()
+  {
+    if (*busy_)
+      ++violations;
+    *busy_ = true;
+
+    long now_running = ++running;
+    if (now_running > peak_running)
+      peak_running = now_running;
+
+    if (block_usec_ > 0)
+      boost::this_thread::sleep_for(boost::chrono::microseconds(block_usec_));
+
+    --running;
+    *busy_ = false;
+
+    if (--remaining_ > 0)
+      strand_.post(*this);
+  }
+
+private:
+  boost::asio::io_service::strand strand_;
+  long remaining_;
+  long block_usec_;
+  volatile bool* busy_;
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: strand_throughput <nthreads> <nstrands> "
+        "<nhandlers> <block_usec>\n");
+    return 1;
+  }
+
+  int num_threads = std::atoi(argv[1]);
+  int num_strands = std::atoi(argv[2]);
+  long num_handlers = std::atol(argv[3]);
+  long block_usec = std::atol(argv[4]);
+
+#if defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+  std::printf("strands: pooled\n");
+#else // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+  std::printf("strands: hashed\n");
+#endif // defined(BOOST_ASIO_ENABLE_STRAND_POOL)
+
+  boost::asio::io_service io_service(num_threads);
+
+  std::vector<boost::shared_ptr<boost::asio::io_service::strand> > strands;
+  boost::scoped_array<volatile bool> busy(new volatile bool[num_strands]());
+  for (int i = 0; i < num_strands; ++i)
+  {
+    strands.push_back(boost::shared_ptr<boost::asio::io_service::strand>(
+          new boost::asio::io_service::strand(io_service)));
+    strands.back()->post(chain(*strands.back(),
+          num_handlers / num_strands, block_usec, &busy[i]));
+  }
+
+  // The strand objects may be destroyed while their handlers are pending.
+  strands.clear();
+
+  ptime start = microsec_clock::universal_time();
+
+  std::vector<boost::shared_ptr<boost::thread> > threads;
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+            boost::bind(&boost::asio::io_service::run, &io_service))));
+  }
+
+  for (std::size_t i = 0; i < threads.size(); ++i)
+    threads[i]->join();
+
+  ptime stop = microsec_clock::universal_time();
+  double elapsed_sec = (stop - start).total_microseconds() / 1000000.0;
+
+  std::printf("handlers/sec\tpeak concurrency\tviolations\n");
+  std::printf("%.0f\t%ld\t%ld\n", num_handlers / elapsed_sec,
+      static_cast<long>(peak_running), static_cast<long>(violations));
+
+  return violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+//
+// timer_rearm.cpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/timer_wheel.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using boost::posix_time::ptime;
+using boost::posix_time::microsec_clock;
+using boost::posix_time::milliseconds;
+
+struct idle_handler
+{
+  void operator()(const boost::system::error_code&) {}
+};
+
+// Simulates per-connection idle timeouts: every timer is pushed back by the
+// timeout each time its connection sees activity, so the timers are almost
+// always cancelled and restarted rather than allowed to expire.
+double run_test(long resolution, int num_timers, long num_rearms,
+    long timeout_msec)
+{
+  boost::asio::io_service io_service;
+  if (resolution)
+    boost::asio::use_timer_wheel(io_service, resolution);
+
+  std::vector<boost::shared_ptr<boost::asio::deadline_timer> > timers;
+  for (int i = 0; i < num_timers; ++i)
+  {
+    timers.push_back(boost::shared_ptr<boost::asio::deadline_timer>(
+          new boost::asio::deadline_timer(io_service)));
+    timers.back()->expires_from_now(milliseconds(timeout_msec + i % 1000));
+    timers.back()->async_wait(idle_handler());
+  }
+
+  ptime start = microsec_clock::universal_time();
+
+  for (long n = 0; n < num_rearms; ++n)
+  {
+    boost::asio::deadline_timer& t = *timers[std::rand() % num_timers];
+    t.expires_from_now(milliseconds(timeout_msec + n % 1000));
+    t.async_wait(idle_handler());
+
+    // Deliver the cancellations.
+    if (n % 1024 == 0)
+      io_service.poll();
+  }
+  io_service.poll();
+
+  ptime stop = microsec_clock::universal_time();
+  double elapsed_sec = (stop - start).total_microseconds() / 1000000.0;
+
+  io_service.stop();
+  return num_rearms / elapsed_sec;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::fprintf(stderr,
+        "Usage: timer_rearm <ntimers> <nrearms> <timeout_ms> <resolution_us>\n");
+    return 1;
+  }
+
+  int num_timers = std::atoi(argv[1]);
+  long num_rearms = std::atol(argv[2]);
+  long timeout_msec = std::atol(argv[3]);
+  long resolution = std::atol(argv[4]);
+
+  std::printf("queue\trearms/sec\n");
+  std::srand(0);
+  std::printf("heap\t%.0f\n",
+      run_test(0, num_timers, num_rearms, timeout_msec));
+  std::srand(0);
+  std::printf("wheel\t%.0f\n",
+      run_test(resolution, num_timers, num_rearms, timeout_msec));
+}
@@ -0,0 +1,144 @@
+//
+// metrics.cpp
+// ~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/metrics.hpp>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include "unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <boost/bind.hpp>
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+using namespace boost::asio;
+
+std::size_t histogram_total(const std::size_t (&histogram)[
+    io_service_metrics::histogram_buckets])
+{
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < io_service_metrics::histogram_buckets; ++i)
+    total += histogram[i];
+  return total;
+}
+
+void increment(int* count)
+{
+  ++(*count);
+}
+
+void check_running_metrics(io_service* ios, io_service_metrics* m)
+{
+  *m = get_metrics(*ios);
+}
+
+void timer_handler(const boost::system::error_code&)
+{
+}
+
+void metrics_test()
+{
+  io_service ios;
+  int count = 0;
+
+  io_service_metrics m = get_metrics(ios);
+  BOOST_ASIO_CHECK(m.handlers_executed == 0);
+  BOOST_ASIO_CHECK(m.thread_handlers_executed.empty());
+  BOOST_ASIO_CHECK(m.queue_depth == 0);
+  BOOST_ASIO_CHECK(histogram_total(m.handler_latency) == 0);
+
+  for (int i = 0; i < 10; ++i)
+    ios.post(bindns::bind(increment, &count));
+
+  m = get_metrics(ios);
+#if defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.queue_depth == 10);
+#else // defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.queue_depth == 0);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+  // Take a snapshot from within a handler, while the thread is running.
+  io_service_metrics running;
+  ios.post(bindns::bind(check_running_metrics, &ios, &running));
+
+  ios.run();
+  BOOST_ASIO_CHECK(count == 10);
+
+  m = get_metrics(ios);
+#if defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(running.thread_handlers_executed.size() == 1);
+  BOOST_ASIO_CHECK(running.thread_handlers_executed[0] == 10);
+  BOOST_ASIO_CHECK(running.handlers_executed == 10);
+  BOOST_ASIO_CHECK(m.handlers_executed == 11);
+  BOOST_ASIO_CHECK(m.thread_handlers_executed.empty());
+  BOOST_ASIO_CHECK(m.queue_depth == 0);
+  BOOST_ASIO_CHECK(histogram_total(m.handler_latency) >= 1);
+  BOOST_ASIO_CHECK(histogram_total(m.handler_latency) <= 11);
+#else // defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.handlers_executed == 0);
+  BOOST_ASIO_CHECK(running.thread_handlers_executed.empty());
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+  // Timers exercise the reactor as well as the timer counts.
+  deadline_timer t1(ios, boost::posix_time::milliseconds(1));
+  t1.async_wait(timer_handler);
+  deadline_timer t2(ios, boost::posix_time::hours(1));
+  t2.async_wait(timer_handler);
+
+  m = get_metrics(ios);
+#if defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.pending_timers == 2);
+#else // defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.pending_timers == 0);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+  t2.cancel();
+
+  m = get_metrics(ios);
+#if defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.pending_timers == 1);
+  BOOST_ASIO_CHECK(m.queue_depth == 1);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+
+  ios.reset();
+  ios.run();
+
+  m = get_metrics(ios);
+#if defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.pending_timers == 0);
+  BOOST_ASIO_CHECK(m.queue_depth == 0);
+  BOOST_ASIO_CHECK(m.reactor_runs > 0);
+  BOOST_ASIO_CHECK(histogram_total(m.reactor_batch_sizes) == m.reactor_runs);
+  BOOST_ASIO_CHECK(m.reactor_batch_sizes[1] >= 1);
+  BOOST_ASIO_CHECK(m.handlers_executed == 13);
+#else // defined(BOOST_ASIO_HAS_METRICS)
+  BOOST_ASIO_CHECK(m.reactor_runs == 0);
+#endif // defined(BOOST_ASIO_HAS_METRICS)
+}
+
+BOOST_ASIO_TEST_SUITE
+(
+  "metrics",
+  BOOST_ASIO_TEST_CASE(metrics_test)
+)
@@ -144,6 +144,19 @@ void test()
     (void)static_cast<bool>(!reuse_address1);
     (void)static_cast<bool>(reuse_address1.value());
 
+#if defined(SO_REUSEPORT)
+    // reuse_port class.
+
+    socket_base::reuse_port reuse_port1(true);
+    sock.set_option(reuse_port1);
+    socket_base::reuse_port reuse_port2;
+    sock.get_option(reuse_port2);
+    reuse_port1 = true;
+    (void)static_cast<bool>(reuse_port1);
+    (void)static_cast<bool>(!reuse_port1);
+    (void)static_cast<bool>(reuse_port1.value());
+#endif // defined(SO_REUSEPORT)
+
     // linger class.
 
     socket_base::linger linger1(true, 30);
@@ -570,6 +583,38 @@ void test()
   BOOST_ASIO_CHECK(!static_cast<bool>(reuse_address4));
   BOOST_ASIO_CHECK(!reuse_address4);
 
+#if defined(SO_REUSEPORT)
+  // reuse_port class.
+
+  socket_base::reuse_port reuse_port1(true);
+  BOOST_ASIO_CHECK(reuse_port1.value());
+  BOOST_ASIO_CHECK(static_cast<bool>(reuse_port1));
+  BOOST_ASIO_CHECK(!!reuse_port1);
+  tcp_sock.set_option(reuse_port1, ec);
+  BOOST_ASIO_CHECK_MESSAGE(!ec, ec.value() << ", " << ec.message());
+
+  socket_base::reuse_port reuse_port2;
+  tcp_sock.get_option(reuse_port2, ec);
+  BOOST_ASIO_CHECK_MESSAGE(!ec, ec.value() << ", " << ec.message());
+  BOOST_ASIO_CHECK(reuse_port2.value());
+  BOOST_ASIO_CHECK(static_cast<bool>(reuse_port2));
+  BOOST_ASIO_CHECK(!!reuse_port2);
+
+  socket_base::reuse_port reuse_port3(false);
+  BOOST_ASIO_CHECK(!reuse_port3.value());
+  BOOST_ASIO_CHECK(!static_cast<bool>(reuse_port3));
+  BOOST_ASIO_CHECK(!reuse_port3);
+  tcp_sock.set_option(reuse_port3, ec);
+  BOOST_ASIO_CHECK_MESSAGE(!ec, ec.value() << ", " << ec.message());
+
+  socket_base::reuse_port reuse_port4;
+  tcp_sock.get_option(reuse_port4, ec);
+  BOOST_ASIO_CHECK_MESSAGE(!ec, ec.value() << ", " << ec.message());
+  BOOST_ASIO_CHECK(!reuse_port4.value());
+  BOOST_ASIO_CHECK(!static_cast<bool>(reuse_port4));
+  BOOST_ASIO_CHECK(!reuse_port4);
+#endif // defined(SO_REUSEPORT)
+
   // linger class.
 
   socket_base::linger linger1(true, 60);
@@ -0,0 +1,249 @@
+//
+// splice.cpp
+// ~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/splice.hpp>
+
+#include <cstring>
+#include <vector>
+#include "archetypes/async_result.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include "unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <boost/bind.hpp>
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+#if defined(BOOST_ASIO_HAS_SPLICE)
+
+#include <unistd.h>
+
+using namespace std; // For memcmp.
+
+#if defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(BOOST_ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+using std::placeholders::_1;
+using std::placeholders::_2;
+#endif // defined(BOOST_ASIO_HAS_BOOST_BIND)
+
+static const char write_data[]
+  = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+// A pipe whose ends are wrapped as stream descriptors.
+struct test_pipe
+{
+  boost::asio::posix::stream_descriptor read_end;
+  boost::asio::posix::stream_descriptor write_end;
+
+  explicit test_pipe(boost::asio::io_service& ios)
+    : read_end(ios),
+      write_end(ios)
+  {
+    int fds[2];
+    BOOST_ASIO_CHECK(::pipe(fds) == 0);
+    read_end.assign(fds[0]);
+    write_end.assign(fds[1]);
+  }
+};
+
+void splice_handler(const boost::system::error_code& e,
+    size_t bytes_transferred, boost::system::error_code* out_e,
+    size_t* out_bytes_transferred, bool* called)
+{
+  *out_e = e;
+  *out_bytes_transferred = bytes_transferred;
+  *called = true;
+}
+
+void test_splice_pipe_to_pipe()
+{
+  boost::asio::io_service ios;
+  test_pipe source(ios);
+  test_pipe sink(ios);
+
+  boost::asio::write(source.write_end, boost::asio::buffer(write_data));
+
+  size_t bytes_transferred = boost::asio::splice(
+      source.read_end, sink.write_end, sizeof(write_data));
+  BOOST_ASIO_CHECK(bytes_transferred == sizeof(write_data));
+
+  char read_buffer[sizeof(write_data)];
+  boost::asio::read(sink.read_end, boost::asio::buffer(read_buffer));
+  BOOST_ASIO_CHECK(memcmp(read_buffer, write_data, sizeof(write_data)) == 0);
+
+  // The source ending before all of the data is moved fails with eof.
+  boost::asio::write(source.write_end, boost::asio::buffer(write_data, 10));
+  source.write_end.close();
+
+  boost::system::error_code error;
+  bytes_transferred = boost::asio::splice(
+      source.read_end, sink.write_end, sizeof(write_data), error);
+  BOOST_ASIO_CHECK(error == boost::asio::error::eof);
+  BOOST_ASIO_CHECK(bytes_transferred == 10);
+}
+
+void test_async_splice_pipe_to_pipe()
+{
+  boost::asio::io_service ios;
+  test_pipe source(ios);
+  test_pipe sink(ios);
+
+  // Start the operation before the data is available, so that it must wait
+  // for the source to become readable.
+  boost::system::error_code error;
+  size_t bytes_transferred = 0;
+  bool called = false;
+  boost::asio::async_splice(source.read_end, sink.write_end,
+      sizeof(write_data), bindns::bind(splice_handler,
+        _1, _2, &error, &bytes_transferred, &called));
+
+  ios.poll();
+  BOOST_ASIO_CHECK(!called);
+
+  boost::asio::write(source.write_end, boost::asio::buffer(write_data));
+
+  ios.reset();
+  ios.run();
+  BOOST_ASIO_CHECK(called);
+  BOOST_ASIO_CHECK(!error);
+  BOOST_ASIO_CHECK(bytes_transferred == sizeof(write_data));
+
+  char read_buffer[sizeof(write_data)];
+  boost::asio::read(sink.read_end, boost::asio::buffer(read_buffer));
+  BOOST_ASIO_CHECK(memcmp(read_buffer, write_data, sizeof(write_data)) == 0);
+
+  // A zero-length splice completes immediately, but not from within the
+  // initiating function.
+  called = false;
+  boost::asio::async_splice(source.read_end, sink.write_end,
+      0, bindns::bind(splice_handler,
+        _1, _2, &error, &bytes_transferred, &called));
+  BOOST_ASIO_CHECK(!called);
+
+  ios.reset();
+  ios.run();
+  BOOST_ASIO_CHECK(called);
+  BOOST_ASIO_CHECK(!error);
+  BOOST_ASIO_CHECK(bytes_transferred == 0);
+
+  // Closing the source fails the operation with eof.
+  called = false;
+  boost::asio::async_splice(source.read_end, sink.write_end,
+      sizeof(write_data), bindns::bind(splice_handler,
+        _1, _2, &error, &bytes_transferred, &called));
+  source.write_end.close();
+
+  ios.reset();
+  ios.run();
+  BOOST_ASIO_CHECK(called);
+  BOOST_ASIO_CHECK(error == boost::asio::error::eof);
+  BOOST_ASIO_CHECK(bytes_transferred == 0);
+
+  archetypes::lazy_handler lazy;
+  test_pipe source2(ios);
+  int i = boost::asio::async_splice(source2.read_end, sink.write_end, 0, lazy);
+  BOOST_ASIO_CHECK(i == 42);
+  ios.reset();
+  ios.run();
+}
+
+void test_async_splice_pipe_to_socket()
+{
+  boost::asio::io_service ios;
+  test_pipe source(ios);
+
+  namespace ip = boost::asio::ip;
+  ip::tcp::acceptor acceptor(ios, ip::tcp::endpoint(ip::tcp::v4(), 0));
+  ip::tcp::endpoint server_endpoint = acceptor.local_endpoint();
+  server_endpoint.address(ip::address_v4::loopback());
+
+  ip::tcp::socket client_side_socket(ios);
+  ip::tcp::socket server_side_socket(ios);
+
+  client_side_socket.connect(server_endpoint);
+  acceptor.accept(server_side_socket);
+
+  // Move more data than the pipe and socket buffers can hold, so that the
+  // operation must wait for both the source and the sink.
+  const size_t data_size = 4 * 1024 * 1024;
+  std::vector<char> data(data_size);
+  for (size_t i = 0; i < data_size; ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  boost::system::error_code error;
+  size_t bytes_transferred = 0;
+  bool called = false;
+  boost::asio::async_splice(source.read_end, server_side_socket,
+      data_size, bindns::bind(splice_handler,
+        _1, _2, &error, &bytes_transferred, &called));
+
+  boost::system::error_code write_error;
+  size_t bytes_written = 0;
+  bool write_called = false;
+  boost::asio::async_write(source.write_end, boost::asio::buffer(data),
+      bindns::bind(splice_handler,
+        _1, _2, &write_error, &bytes_written, &write_called));
+
+  std::vector<char> read_buffer(data_size);
+  boost::system::error_code read_error;
+  size_t bytes_read = 0;
+  bool read_called = false;
+  boost::asio::async_read(client_side_socket,
+      boost::asio::buffer(read_buffer),
+      bindns::bind(splice_handler,
+        _1, _2, &read_error, &bytes_read, &read_called));
+
+  ios.run();
+  BOOST_ASIO_CHECK(called);
+  BOOST_ASIO_CHECK(!error);
+  BOOST_ASIO_CHECK(bytes_transferred == data_size);
+  BOOST_ASIO_CHECK(write_called);
+  BOOST_ASIO_CHECK(bytes_written == data_size);
+  BOOST_ASIO_CHECK(read_called);
+  BOOST_ASIO_CHECK(bytes_read == data_size);
+  BOOST_ASIO_CHECK(read_buffer == data);
+}
+
+#else // defined(BOOST_ASIO_HAS_SPLICE)
+
+void test_splice_pipe_to_pipe()
+{
+}
+
+void test_async_splice_pipe_to_pipe()
+{
+}
+
+void test_async_splice_pipe_to_socket()
+{
+}
+
+#endif // defined(BOOST_ASIO_HAS_SPLICE)
+
+BOOST_ASIO_TEST_SUITE
+(
+  "splice",
+  BOOST_ASIO_TEST_CASE(test_splice_pipe_to_pipe)
+  BOOST_ASIO_TEST_CASE(test_async_splice_pipe_to_pipe)
+  BOOST_ASIO_TEST_CASE(test_async_splice_pipe_to_socket)
+)
@@ -0,0 +1,237 @@
+//
+// timer_wheel.cpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2013 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include <boost/asio/timer_wheel.hpp>
+
+#include "unit_test.hpp"
+
+#if defined(BOOST_ASIO_HAS_BOOST_DATE_TIME)
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/asio/basic_deadline_timer.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/placeholders.hpp>
+#include <boost/asio/time_traits.hpp>
+
+using namespace boost::posix_time;
+
+ptime now()
+{
+#if defined(BOOST_DATE_TIME_HAS_HIGH_PRECISION_CLOCK)
+  return microsec_clock::universal_time();
+#else // defined(BOOST_DATE_TIME_HAS_HIGH_PRECISION_CLOCK)
+  return second_clock::universal_time();
+#endif // defined(BOOST_DATE_TIME_HAS_HIGH_PRECISION_CLOCK)
+}
+
+// Time traits for a clock that the test can step backwards.
+time_duration clock_offset;
+
+struct stepped_time_traits
+  : boost::asio::time_traits<ptime>
+{
+  static time_type now()
+  {
+    return ::now() + clock_offset;
+  }
+};
+
+typedef boost::asio::basic_deadline_timer<ptime, stepped_time_traits>
+  stepped_timer;
+
+void record(std::vector<int>* order, int id, ptime expiry,
+    const boost::system::error_code& ec)
+{
+  BOOST_ASIO_CHECK(!ec);
+
+  // The timer must not fire before its expiry time.
+  ptime end = now();
+  BOOST_ASIO_CHECK(expiry < end || expiry == end);
+
+  order->push_back(id);
+}
+
+void record_cancel(int* count, const boost::system::error_code& ec)
+{
+  if (ec == boost::asio::error::operation_aborted)
+    ++(*count);
+}
+
+void timer_wheel_order_test()
+{
+  boost::asio::io_service ios;
+  boost::asio::use_timer_wheel(ios, 1000);
+
+  std::vector<int> order;
+  ptime start = now();
+
+  // Expiry times chosen to land in the first and second levels of the wheel,
+  // including one that has already passed.
+  boost::asio::deadline_timer t1(ios, start + milliseconds(600));
+  boost::asio::deadline_timer t2(ios, start + milliseconds(20));
+  boost::asio::deadline_timer t3(ios, start - milliseconds(10));
+  boost::asio::deadline_timer t4(ios, start + milliseconds(300));
+  t1.async_wait(boost::bind(record, &order, 4, t1.expires_at(),
+        boost::asio::placeholders::error));
+  t2.async_wait(boost::bind(record, &order, 2, t2.expires_at(),
+        boost::asio::placeholders::error));
+  t3.async_wait(boost::bind(record, &order, 1, t3.expires_at(),
+        boost::asio::placeholders::error));
+  t4.async_wait(boost::bind(record, &order, 3, t4.expires_at(),
+        boost::asio::placeholders::error));
+
+  ios.run();
+
+  BOOST_ASIO_CHECK(order.size() == 4);
+  for (std::size_t i = 0; i < order.size(); ++i)
+    BOOST_ASIO_CHECK(order[i] == static_cast<int>(i + 1));
+}
+
+void timer_wheel_cancel_test()
+{
+  boost::asio::io_service ios;
+  boost::asio::use_timer_wheel(ios, 1000);
+
+  int count = 0;
+  ptime start = now();
+
+  // Timers beyond the range of every level must still be cancellable.
+  boost::asio::deadline_timer t1(ios, hours(24 * 100));
+  boost::asio::deadline_timer t2(ios, hours(1));
+  boost::asio::deadline_timer t3(ios, milliseconds(5));
+  t1.async_wait(boost::bind(record_cancel, &count,
+        boost::asio::placeholders::error));
+  t2.async_wait(boost::bind(record_cancel, &count,
+        boost::asio::placeholders::error));
+  t3.async_wait(boost::bind(record_cancel, &count,
+        boost::asio::placeholders::error));
+
+  BOOST_ASIO_CHECK(t1.cancel() == 1);
+  BOOST_ASIO_CHECK(t2.cancel() == 1);
+  BOOST_ASIO_CHECK(t3.cancel() == 1);
+
+  ios.run();
+
+  BOOST_ASIO_CHECK(count == 3);
+  BOOST_ASIO_CHECK(now() < start + seconds(1));
+}
+
+void timer_wheel_rearm_test()
+{
+  boost::asio::io_service ios;
+  boost::asio::use_timer_wheel(ios, 1000);
+
+  std::vector<int> order;
+  int cancelled = 0;
+
+  // Repeatedly pushing a timer's expiry back leaves only the last wait.
+  boost::asio::deadline_timer t1(ios);
+  for (int i = 0; i < 1000; ++i)
+  {
+    t1.expires_from_now(milliseconds(50 + i % 7));
+    t1.async_wait(boost::bind(record_cancel, &cancelled,
+          boost::asio::placeholders::error));
+  }
+  t1.expires_from_now(milliseconds(50));
+  t1.async_wait(boost::bind(record, &order, 1, t1.expires_at(),
+        boost::asio::placeholders::error));
+
+  ios.run();
+
+  BOOST_ASIO_CHECK(cancelled == 1000);
+  BOOST_ASIO_CHECK(order.size() == 1);
+}
+
+void record_stepped(std::vector<int>* order, int id, ptime expiry,
+    const boost::system::error_code& ec)
+{
+  BOOST_ASIO_CHECK(!ec);
+
+  // The timer must not fire before its expiry time on the stepped clock.
+  ptime end = stepped_time_traits::now();
+  BOOST_ASIO_CHECK(expiry < end || expiry == end);
+
+  order->push_back(id);
+}
+
+void timer_wheel_clock_step_test()
+{
+  boost::asio::io_service ios;
+  boost::asio::use_timer_wheel(ios, 1000);
+
+  std::vector<int> order;
+  int cancelled = 0;
+  clock_offset = time_duration();
+
+  // A timer that is pending across both clock steps.
+  stepped_timer t1(ios, hours(1));
+  t1.async_wait(boost::bind(record_cancel, &cancelled,
+        boost::asio::placeholders::error));
+
+  // Move the wheel forward to the current time.
+  stepped_timer t2(ios, milliseconds(10));
+  t2.async_wait(boost::bind(record_stepped, &order, 1, t2.expires_at(),
+        boost::asio::placeholders::error));
+  ios.run_one();
+  BOOST_ASIO_CHECK(order.size() == 1);
+
+  // After the clock goes back, a short wait must take about as long as it
+  // would have with the heap, rather than as long as the step.
+  clock_offset = -seconds(10);
+  ptime start = now();
+  stepped_timer t3(ios, milliseconds(20));
+  t3.async_wait(boost::bind(record_stepped, &order, 2, t3.expires_at(),
+        boost::asio::placeholders::error));
+  ios.run_one();
+  BOOST_ASIO_CHECK(order.size() == 2);
+  BOOST_ASIO_CHECK(now() < start + seconds(5));
+
+  // The same applies when the clock goes back to before the wheel was
+  // created.
+  clock_offset = -hours(2);
+  start = now();
+  stepped_timer t4(ios, milliseconds(20));
+  t4.async_wait(boost::bind(record_stepped, &order, 3, t4.expires_at(),
+        boost::asio::placeholders::error));
+  ios.run_one();
+  BOOST_ASIO_CHECK(order.size() == 3);
+  BOOST_ASIO_CHECK(now() < start + seconds(5));
+
+  // The first timer is still in the wheel.
+  BOOST_ASIO_CHECK(t1.cancel() == 1);
+  ios.run();
+  BOOST_ASIO_CHECK(cancelled == 1);
+  BOOST_ASIO_CHECK(order.size() == 3);
+  clock_offset = time_duration();
+}
+
+BOOST_ASIO_TEST_SUITE
+(
+  "timer_wheel",
+  BOOST_ASIO_TEST_CASE(timer_wheel_order_test)
+  BOOST_ASIO_TEST_CASE(timer_wheel_cancel_test)
+  BOOST_ASIO_TEST_CASE(timer_wheel_rearm_test)
+  BOOST_ASIO_TEST_CASE(timer_wheel_clock_step_test)
+)
+#else // defined(BOOST_ASIO_HAS_BOOST_DATE_TIME)
+BOOST_ASIO_TEST_SUITE
+(
+  "timer_wheel",
+  BOOST_ASIO_TEST_CASE(null_test)
+)
+#endif // defined(BOOST_ASIO_HAS_BOOST_DATE_TIME)
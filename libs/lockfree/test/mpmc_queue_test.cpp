@@ -0,0 +1,312 @@
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/lockfree/mpmc_queue.hpp>
+#include <boost/thread.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include <memory>
+#include <stdexcept>
+
+#include "test_helpers.hpp"
+
+using namespace boost;
+using namespace boost::lockfree;
+using namespace std;
+
+BOOST_AUTO_TEST_CASE( simple_mpmc_queue_test )
+{
+    mpmc_queue<int> f(64);
+
+    BOOST_WARN(f.is_lock_free());
+
+    BOOST_REQUIRE(f.empty());
+    f.push(1);
+    f.push(2);
+
+    int i1(0), i2(0);
+
+    BOOST_REQUIRE(f.pop(i1));
+    BOOST_REQUIRE_EQUAL(i1, 1);
+
+    BOOST_REQUIRE(f.pop(i2));
+    BOOST_REQUIRE_EQUAL(i2, 2);
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( simple_mpmc_queue_test_capacity )
+{
+    mpmc_queue<int, capacity<64> > f;
+
+    BOOST_WARN(f.is_lock_free());
+
+    BOOST_REQUIRE(f.empty());
+    f.push(1);
+    f.push(2);
+
+    int i1(0), i2(0);
+
+    BOOST_REQUIRE(f.pop(i1));
+    BOOST_REQUIRE_EQUAL(i1, 1);
+
+    BOOST_REQUIRE(f.pop(i2));
+    BOOST_REQUIRE_EQUAL(i2, 2);
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_fixed_sized_test )
+{
+    // the queue accepts the same policies as boost::lockfree::queue
+    mpmc_queue<int, fixed_sized<true>, capacity<16> > f;
+    BOOST_REQUIRE(f.bounded_push(1));
+
+    int i1(0);
+    BOOST_REQUIRE(f.pop(i1));
+    BOOST_REQUIRE_EQUAL(i1, 1);
+}
+
+template <typename queue_type>
+void test_full_and_wrap_around(queue_type & f, int capacity)
+{
+    // fill and drain the queue a few times, so that the positions wrap around the ringbuffer
+    for (int round = 0; round != 5; ++round) {
+        for (int i = 0; i != capacity; ++i)
+            BOOST_REQUIRE(f.push(round * capacity + i));
+
+        BOOST_REQUIRE(!f.push(-1));
+        BOOST_REQUIRE(!f.bounded_push(-1));
+        BOOST_REQUIRE(!f.empty());
+
+        for (int i = 0; i != capacity; ++i) {
+            int out;
+            BOOST_REQUIRE(f.pop(out));
+            BOOST_REQUIRE_EQUAL(out, round * capacity + i);
+        }
+
+        int out;
+        BOOST_REQUIRE(!f.pop(out));
+        BOOST_REQUIRE(f.empty());
+    }
+
+    // a partially filled queue across the end of the ringbuffer
+    for (int i = 0; i != capacity / 2; ++i)
+        BOOST_REQUIRE(f.push(i));
+    for (int i = 0; i != capacity; ++i) {
+        int out;
+        BOOST_REQUIRE(f.pop(out));
+        BOOST_REQUIRE_EQUAL(out, i);
+        BOOST_REQUIRE(f.push(capacity / 2 + i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_full_test )
+{
+    mpmc_queue<int> f(7);
+    test_full_and_wrap_around(f, 7);
+
+    mpmc_queue<int, capacity<8> > f2;
+    test_full_and_wrap_around(f2, 8);
+}
+
+BOOST_AUTO_TEST_CASE( unsafe_mpmc_queue_test )
+{
+    mpmc_queue<int> f(2);
+
+    BOOST_WARN(f.is_lock_free());
+    BOOST_REQUIRE(f.empty());
+
+    int i1(0), i2(0);
+
+    BOOST_REQUIRE(f.unsynchronized_push(1));
+    BOOST_REQUIRE(f.unsynchronized_push(2));
+    BOOST_REQUIRE(!f.unsynchronized_push(3));
+
+    BOOST_REQUIRE(f.unsynchronized_pop(i1));
+    BOOST_REQUIRE_EQUAL(i1, 1);
+
+    // synchronized and unsynchronized operations can be mixed
+    BOOST_REQUIRE(f.push(3));
+
+    BOOST_REQUIRE(f.unsynchronized_pop(i2));
+    BOOST_REQUIRE_EQUAL(i2, 2);
+    BOOST_REQUIRE(f.pop(i2));
+    BOOST_REQUIRE_EQUAL(i2, 3);
+    BOOST_REQUIRE(!f.unsynchronized_pop(i2));
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_consume_one_test )
+{
+    mpmc_queue<int> f(64);
+
+    BOOST_WARN(f.is_lock_free());
+    BOOST_REQUIRE(f.empty());
+
+    f.push(1);
+    f.push(2);
+
+#ifdef BOOST_NO_CXX11_LAMBDAS
+    bool success1 = f.consume_one(test_equal(1));
+    bool success2 = f.consume_one(test_equal(2));
+#else
+    bool success1 = f.consume_one([] (int i) {
+        BOOST_REQUIRE_EQUAL(i, 1);
+    });
+
+    bool success2 = f.consume_one([] (int i) {
+        BOOST_REQUIRE_EQUAL(i, 2);
+    });
+#endif
+
+    BOOST_REQUIRE(success1);
+    BOOST_REQUIRE(success2);
+
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_consume_all_test )
+{
+    mpmc_queue<int> f(64);
+
+    BOOST_WARN(f.is_lock_free());
+    BOOST_REQUIRE(f.empty());
+
+    f.push(1);
+    f.push(2);
+
+#ifdef BOOST_NO_CXX11_LAMBDAS
+    size_t consumed = f.consume_all(dummy_functor());
+#else
+    size_t consumed = f.consume_all([] (int i) {
+    });
+#endif
+
+    BOOST_REQUIRE_EQUAL(consumed, 2u);
+
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_convert_pop_test )
+{
+    mpmc_queue<int*> f(128);
+    BOOST_REQUIRE(f.empty());
+    f.push(new int(1));
+    f.push(new int(2));
+    f.push(new int(3));
+
+    {
+        int * i1;
+
+        BOOST_REQUIRE(f.pop(i1));
+        BOOST_REQUIRE_EQUAL(*i1, 1);
+        delete i1;
+    }
+
+    {
+        boost::shared_ptr<int> i2;
+        BOOST_REQUIRE(f.pop(i2));
+        BOOST_REQUIRE_EQUAL(*i2, 2);
+    }
+
+    {
+        boost::shared_ptr<int> i3;
+        BOOST_REQUIRE(f.pop(i3));
+
+        BOOST_REQUIRE_EQUAL(*i3, 3);
+    }
+
+    BOOST_REQUIRE(f.empty());
+}
+
+namespace {
+
+int live_elements = 0;
+int elements_until_throw = -1;
+int live_allocations = 0;
+
+struct throwing_element
+{
+    throwing_element(void)
+    {
+        if (elements_until_throw-- == 0)
+            throw std::runtime_error("throwing_element");
+        ++live_elements;
+    }
+
+    throwing_element(throwing_element const &)
+    {
+        ++live_elements;
+    }
+
+    ~throwing_element(void)
+    {
+        --live_elements;
+    }
+
+    throwing_element & operator=(throwing_element const &)
+    {
+        return *this;
+    }
+};
+
+template <typename T>
+struct counting_allocator:
+    std::allocator<T>
+{
+    typedef T * pointer;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator(void)
+    {}
+
+    template <typename U>
+    counting_allocator(counting_allocator<U> const &)
+    {}
+
+    pointer allocate(std::size_t n)
+    {
+        ++live_allocations;
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(pointer p, std::size_t n)
+    {
+        --live_allocations;
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_throwing_constructor_test )
+{
+    typedef mpmc_queue<throwing_element,
+                       boost::lockfree::allocator<counting_allocator<void> > > queue_type;
+
+    elements_until_throw = 5;
+    BOOST_REQUIRE_THROW(queue_type f(16), std::runtime_error);
+    BOOST_REQUIRE_EQUAL(live_elements, 0);
+    BOOST_REQUIRE_EQUAL(live_allocations, 0);
+
+    elements_until_throw = -1;
+    {
+        queue_type f(16);
+        BOOST_REQUIRE(f.push(throwing_element()));
+    }
+    BOOST_REQUIRE_EQUAL(live_elements, 0);
+    BOOST_REQUIRE_EQUAL(live_allocations, 0);
+}
@@ -84,6 +84,81 @@ BOOST_AUTO_TEST_CASE( unsafe_queue_test )
 }
 
 
+BOOST_AUTO_TEST_CASE( ranged_queue_test )
+{
+    queue<int> f(64);
+
+    int data[5] = {1, 2, 3, 4, 5};
+    BOOST_REQUIRE_EQUAL(f.push(data, data + 5), data + 5);
+    BOOST_REQUIRE_EQUAL(f.push(data, data), data);
+    f.push(6);
+
+    int out[4];
+    BOOST_REQUIRE_EQUAL(f.pop(out, 4), 4u);
+    for (int i = 0; i != 4; ++i)
+        BOOST_REQUIRE_EQUAL(out[i], i + 1);
+
+    BOOST_REQUIRE_EQUAL(f.pop(out, 4), 2u);
+    BOOST_REQUIRE_EQUAL(out[0], 5);
+    BOOST_REQUIRE_EQUAL(out[1], 6);
+
+    BOOST_REQUIRE_EQUAL(f.pop(out, 4), 0u);
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( ranged_queue_test_exhausted )
+{
+    queue<int, capacity<3> > f;
+
+    int data[5] = {1, 2, 3, 4, 5};
+    BOOST_REQUIRE_EQUAL(f.bounded_push(data, data + 5), data + 3);
+
+    int out[5];
+    BOOST_REQUIRE_EQUAL(f.pop(out, 5), 3u);
+    for (int i = 0; i != 3; ++i)
+        BOOST_REQUIRE_EQUAL(out[i], i + 1);
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( ranged_unsafe_queue_test )
+{
+    queue<int, fixed_sized<true> > f(64);
+
+    int data[3] = {1, 2, 3};
+    BOOST_REQUIRE_EQUAL(f.unsynchronized_push(data, data + 3), data + 3);
+    BOOST_REQUIRE(f.unsynchronized_push(4));
+
+    int out[8];
+    BOOST_REQUIRE_EQUAL(f.unsynchronized_pop(out, 8), 4u);
+    for (int i = 0; i != 4; ++i)
+        BOOST_REQUIRE_EQUAL(out[i], i + 1);
+    BOOST_REQUIRE(f.empty());
+}
+
+BOOST_AUTO_TEST_CASE( queue_shrink_to_fit_test )
+{
+    queue<int, memory_reclamation<true> > f(16);
+
+    for (int i = 0; i != 1000; ++i)
+        f.push(i);
+
+    int out;
+    for (int i = 0; i != 1000; ++i) {
+        BOOST_REQUIRE(f.pop(out));
+        BOOST_REQUIRE_EQUAL(out, i);
+    }
+
+    /* without concurrent operations, the free nodes are released immediately. one node is the dummy node of the queue */
+    BOOST_REQUIRE_EQUAL(f.shrink_to_fit(), 1000u);
+    BOOST_REQUIRE_EQUAL(f.shrink_to_fit(), 0u);
+    BOOST_REQUIRE(!f.bounded_push(1));
+
+    BOOST_REQUIRE(f.push(1));
+    BOOST_REQUIRE(f.pop(out));
+    BOOST_REQUIRE_EQUAL(out, 1);
+    BOOST_REQUIRE(f.empty());
+}
+
 BOOST_AUTO_TEST_CASE( queue_consume_one_test )
 {
     queue<int> f(64);
@@ -0,0 +1,45 @@
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  compares the throughput of the node-based queue with the ringbuffer-based mpmc_queue, for the same capacity.
+//  define BOOST_LOCKFREE_STRESS_TEST for meaningful numbers.
+
+#include <boost/lockfree/mpmc_queue.hpp>
+#include <boost/lockfree/queue.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include "test_common.hpp"
+
+using namespace boost::lockfree;
+
+template <typename queue_type>
+void run_throughput_test(const char * name)
+{
+    static const int thread_counts[] = { 1, 4, 16 };
+
+    for (int i = 0; i != 3; ++i) {
+        typedef queue_throughput_tester<true> tester_type;
+        boost::scoped_ptr<tester_type> tester(new tester_type(thread_counts[i], thread_counts[i]));
+        boost::scoped_ptr<queue_type> q(new queue_type);
+        tester->run(*q, name);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( queue_throughput_test )
+{
+    run_throughput_test<queue<long, capacity<1024> > >("queue");
+}
+
+BOOST_AUTO_TEST_CASE( mpmc_queue_throughput_test )
+{
+    run_throughput_test<mpmc_queue<long, capacity<1024> > >("mpmc_queue");
+}
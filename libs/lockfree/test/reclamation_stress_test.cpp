@@ -0,0 +1,67 @@
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/stack.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include "test_common.hpp"
+
+using namespace boost::lockfree;
+
+/* returns the free nodes to the allocator, while the stress test is running */
+template <typename data_structure>
+struct shrinker
+{
+    data_structure & ds;
+    boost::lockfree::detail::atomic<bool> running;
+    size_t released;
+
+    explicit shrinker(data_structure & d):
+        ds(d), running(true), released(0)
+    {}
+
+    void run(void)
+    {
+        while (running.load())
+            released += ds.shrink_to_fit();
+    }
+};
+
+template <typename data_structure>
+void run_reclamation_test(void)
+{
+    typedef queue_stress_tester<false> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    data_structure ds(128);
+    shrinker<data_structure> s(ds);
+
+    boost::thread shrink_thread(boost::bind(&shrinker<data_structure>::run, &s));
+    tester->run(ds);
+    s.running.store(false);
+    shrink_thread.join();
+
+    s.released += ds.shrink_to_fit();
+    std::cout << s.released << " nodes released" << std::endl;
+    BOOST_REQUIRE(s.released != 0);
+}
+
+BOOST_AUTO_TEST_CASE( queue_reclamation_test )
+{
+    run_reclamation_test<queue<long, memory_reclamation<true> > >();
+}
+
+BOOST_AUTO_TEST_CASE( stack_reclamation_test )
+{
+    run_reclamation_test<stack<long, memory_reclamation<true> > >();
+}
@@ -0,0 +1,38 @@
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/lockfree/stack.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include "test_common.hpp"
+
+using namespace boost::lockfree;
+
+BOOST_AUTO_TEST_CASE( stack_test_elimination_unbounded )
+{
+    typedef queue_stress_tester<false> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    stack<long, elimination_backoff<4>, contention_statistics<true> > q(128);
+    tester->run(q);
+
+    std::cout << q.cas_failures() << " failed CAS, " << q.eliminations() << " eliminations" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE( stack_test_elimination_fixedsize )
+{
+    typedef queue_stress_tester<true> tester_type;
+    boost::scoped_ptr<tester_type> tester(new tester_type(4, 4) );
+
+    stack<long, capacity<128>, elimination_backoff<4> > q;
+    tester->run(q);
+}
@@ -69,6 +69,81 @@ BOOST_AUTO_TEST_CASE( ranged_unsynchronized_push_test )
     BOOST_REQUIRE(!stk.unsynchronized_pop(out));
 }
 
+BOOST_AUTO_TEST_CASE( batch_pop_test )
+{
+    boost::lockfree::stack<long> stk(128);
+
+    long data[5] = {1, 2, 3, 4, 5};
+    stk.push(data, data + 5);
+
+    long out[3];
+    BOOST_REQUIRE_EQUAL(stk.pop(out, 3), 3u);
+    BOOST_REQUIRE_EQUAL(out[0], 5);
+    BOOST_REQUIRE_EQUAL(out[1], 4);
+    BOOST_REQUIRE_EQUAL(out[2], 3);
+
+    BOOST_REQUIRE_EQUAL(stk.pop(out, 3), 2u);
+    BOOST_REQUIRE_EQUAL(out[0], 2);
+    BOOST_REQUIRE_EQUAL(out[1], 1);
+
+    BOOST_REQUIRE_EQUAL(stk.pop(out, 3), 0u);
+    BOOST_REQUIRE(stk.empty());
+}
+
+BOOST_AUTO_TEST_CASE( batch_unsynchronized_pop_test )
+{
+    boost::lockfree::stack<long, boost::lockfree::capacity<128> > stk;
+
+    long data[3] = {1, 2, 3};
+    stk.unsynchronized_push(data, data + 3);
+
+    long out[4];
+    BOOST_REQUIRE_EQUAL(stk.unsynchronized_pop(out, 4), 3u);
+    BOOST_REQUIRE_EQUAL(out[0], 3);
+    BOOST_REQUIRE_EQUAL(out[1], 2);
+    BOOST_REQUIRE_EQUAL(out[2], 1);
+    BOOST_REQUIRE(stk.empty());
+}
+
+BOOST_AUTO_TEST_CASE( elimination_stack_test )
+{
+    boost::lockfree::stack<long, boost::lockfree::elimination_backoff<4>,
+                           boost::lockfree::contention_statistics<true> > stk(128);
+
+    stk.push(1);
+    stk.push(2);
+    long out;
+    BOOST_REQUIRE(stk.pop(out)); BOOST_REQUIRE_EQUAL(out, 2);
+    BOOST_REQUIRE(stk.pop(out)); BOOST_REQUIRE_EQUAL(out, 1);
+    BOOST_REQUIRE(!stk.pop(out));
+    BOOST_REQUIRE(stk.empty());
+
+    /* without concurrent access, only spurious compare-and-swap failures are possible, and nothing can be eliminated */
+    BOOST_WARN_EQUAL(stk.cas_failures(), 0u);
+    BOOST_REQUIRE_EQUAL(stk.eliminations(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE( shrink_to_fit_stack_test )
+{
+    boost::lockfree::stack<long, boost::lockfree::memory_reclamation<true> > stk(16);
+
+    for (long i = 0; i != 1000; ++i)
+        stk.push(i);
+
+    long out;
+    while (stk.pop(out))
+        ;
+
+    BOOST_REQUIRE_EQUAL(stk.shrink_to_fit(), 1000u);
+    BOOST_REQUIRE_EQUAL(stk.shrink_to_fit(), 0u);
+    BOOST_REQUIRE(!stk.bounded_push(1));
+
+    BOOST_REQUIRE(stk.push(1));
+    BOOST_REQUIRE(stk.pop(out));
+    BOOST_REQUIRE_EQUAL(out, 1);
+    BOOST_REQUIRE(stk.empty());
+}
+
 BOOST_AUTO_TEST_CASE( fixed_size_stack_test )
 {
     boost::lockfree::stack<long, boost::lockfree::capacity<128> > stk;
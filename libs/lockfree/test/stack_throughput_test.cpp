@@ -0,0 +1,46 @@
+//  Copyright (C) 2013 Tim Blechmann
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+//  compares the throughput of the stack with and without elimination backoff under symmetric push/pop load.
+//  define BOOST_LOCKFREE_STRESS_TEST for meaningful numbers.
+
+#include <boost/lockfree/stack.hpp>
+
+#define BOOST_TEST_MAIN
+#ifdef BOOST_LOCKFREE_INCLUDE_TESTS
+#include <boost/test/included/unit_test.hpp>
+#else
+#include <boost/test/unit_test.hpp>
+#endif
+
+#include "test_common.hpp"
+
+using namespace boost::lockfree;
+
+template <typename stack_type>
+void run_throughput_test(const char * name)
+{
+    static const int thread_counts[] = { 1, 2, 4, 8, 16 };
+
+    for (int i = 0; i != 5; ++i) {
+        typedef queue_throughput_tester<true> tester_type;
+        boost::scoped_ptr<tester_type> tester(new tester_type(thread_counts[i], thread_counts[i]));
+        boost::scoped_ptr<stack_type> s(new stack_type(1024));
+        tester->run(*s, name);
+
+        std::cout << "    " << s->cas_failures() << " failed CAS, " << s->eliminations() << " eliminations" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( stack_throughput_test )
+{
+    run_throughput_test<stack<long, contention_statistics<true> > >("stack");
+}
+
+BOOST_AUTO_TEST_CASE( stack_elimination_throughput_test )
+{
+    run_throughput_test<stack<long, elimination_backoff<8>, contention_statistics<true> > >("stack, elimination_backoff<8>");
+}
@@ -7,7 +7,10 @@
 #include <cassert>
 #include "test_helpers.hpp"
 
+#include <iostream>
+
 #include <boost/array.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/thread.hpp>
 
 namespace impl {
@@ -130,6 +133,220 @@ struct queue_stress_tester
     }
 };
 
+/* like queue_stress_tester, but the writers push ranges of elements and the readers pop up to batch_size elements at
+ * once. */
+template <bool Bounded = false>
+struct batch_stress_tester
+{
+    static const unsigned int buckets = 1<<13;
+#ifndef BOOST_LOCKFREE_STRESS_TEST
+    static const long node_count =  5000;
+#else
+    static const long node_count = 500000;
+#endif
+    static const int batch_size = 16;
+
+    const int reader_threads;
+    const int writer_threads;
+
+    boost::lockfree::detail::atomic<int> writers_finished;
+
+    static_hashed_set<long, buckets> data;
+    static_hashed_set<long, buckets> dequeued;
+
+    boost::lockfree::detail::atomic<int> push_count, pop_count;
+
+    batch_stress_tester(int reader, int writer):
+        reader_threads(reader), writer_threads(writer), push_count(0), pop_count(0)
+    {}
+
+    template <typename queue>
+    void add_items(queue & q)
+    {
+        long batch[batch_size];
+
+        for (long i = 0; i < node_count; i += batch_size) {
+            for (int j = 0; j != batch_size; ++j) {
+                batch[j] = generate_id<long>();
+                bool inserted = data.insert(batch[j]);
+                assert(inserted);
+            }
+
+            long * begin = batch;
+            long * end = batch + batch_size;
+            while (begin != end) {
+                if (Bounded)
+                    begin = q.bounded_push(begin, end);
+                else
+                    begin = q.push(begin, end);
+            }
+            push_count += batch_size;
+        }
+        writers_finished += 1;
+    }
+
+    template <typename queue>
+    bool consume_elements(queue & q)
+    {
+        long batch[batch_size];
+        size_t count = q.pop(batch, batch_size);
+
+        for (size_t i = 0; i != count; ++i) {
+            bool erased = data.erase(batch[i]);
+            bool inserted = dequeued.insert(batch[i]);
+            assert(erased);
+            assert(inserted);
+        }
+        pop_count += count;
+        return count != 0;
+    }
+
+    template <typename queue>
+    void get_items(queue & q)
+    {
+        for (;;) {
+            if (consume_elements(q))
+                continue;
+
+            if ( writers_finished.load() == writer_threads )
+                break;
+        }
+
+        while (consume_elements(q));
+    }
+
+    template <typename queue>
+    void run(queue & q)
+    {
+        BOOST_WARN(q.is_lock_free());
+        writers_finished.store(0);
+
+        thread_group writer;
+        thread_group reader;
+
+        BOOST_REQUIRE(q.empty());
+
+        for (int i = 0; i != reader_threads; ++i)
+            reader.create_thread(boost::bind(&batch_stress_tester::template get_items<queue>, this, boost::ref(q)));
+
+        for (int i = 0; i != writer_threads; ++i)
+            writer.create_thread(boost::bind(&batch_stress_tester::template add_items<queue>, this, boost::ref(q)));
+
+        writer.join_all();
+        reader.join_all();
+
+        BOOST_REQUIRE_EQUAL(data.count_nodes(), (size_t)0);
+        BOOST_REQUIRE(q.empty());
+
+        BOOST_REQUIRE_EQUAL(push_count, pop_count);
+        BOOST_REQUIRE_EQUAL(push_count, writer_threads * ((node_count + batch_size - 1) / batch_size) * batch_size);
+    }
+};
+
+/* measures the throughput of a queue: the writers push consecutive numbers as fast as they can, the readers pop them
+ * and sum them up. unlike queue_stress_tester, no bookkeeping is done per element, so the cost of the queue itself
+ * dominates. */
+template <bool Bounded = false>
+struct queue_throughput_tester
+{
+#ifndef BOOST_LOCKFREE_STRESS_TEST
+    static const long node_count = 50000;
+#else
+    static const long node_count = 5000000;
+#endif
+    const int reader_threads;
+    const int writer_threads;
+
+    boost::lockfree::detail::atomic<int> writers_finished;
+    boost::lockfree::detail::atomic<long> pop_count;
+    boost::lockfree::detail::atomic<boost::uint64_t> pop_sum;
+
+    queue_throughput_tester(int reader, int writer):
+        reader_threads(reader), writer_threads(writer), writers_finished(0), pop_count(0), pop_sum(0)
+    {}
+
+    template <typename queue>
+    void add_items(queue & q)
+    {
+        for (long i = 1; i <= node_count; ++i) {
+            /* yield instead of spinning, so that the results stay meaningful with more threads than cores */
+            if (Bounded)
+                while (q.bounded_push(i) == false)
+                    thread::yield();
+            else
+                while (q.push(i) == false)
+                    thread::yield();
+        }
+        writers_finished += 1;
+    }
+
+    template <typename queue>
+    void get_items(queue & q)
+    {
+        long count = 0;
+        boost::uint64_t sum = 0;
+        for (;;) {
+            long id;
+            if (q.pop(id)) {
+                ++count;
+                sum += id;
+                continue;
+            }
+
+            if ( writers_finished.load() == writer_threads ) {
+                while (q.pop(id)) {
+                    ++count;
+                    sum += id;
+                }
+                break;
+            }
+            thread::yield();
+        }
+        pop_count += count;
+        pop_sum += sum;
+    }
+
+    /* runs the test and returns the number of elements that passed through the queue per second */
+    template <typename queue>
+    double run(queue & q, const char * name)
+    {
+        writers_finished.store(0);
+        pop_count.store(0);
+        pop_sum.store(0);
+
+        thread_group writer;
+        thread_group reader;
+
+        BOOST_REQUIRE(q.empty());
+
+        boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+        for (int i = 0; i != reader_threads; ++i)
+            reader.create_thread(boost::bind(&queue_throughput_tester::template get_items<queue>, this, boost::ref(q)));
+
+        for (int i = 0; i != writer_threads; ++i)
+            writer.create_thread(boost::bind(&queue_throughput_tester::template add_items<queue>, this, boost::ref(q)));
+
+        writer.join_all();
+        reader.join_all();
+
+        boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+        BOOST_REQUIRE(q.empty());
+        BOOST_REQUIRE_EQUAL(pop_count.load(), writer_threads * node_count);
+        BOOST_REQUIRE_EQUAL(pop_sum.load(), (boost::uint64_t)writer_threads * node_count * (node_count + 1) / 2);
+
+        double seconds = (stop - start).total_microseconds() / 1000000.0;
+        double throughput = writer_threads * node_count / seconds;
+
+        cout << name << ": " << writer_threads << " writers, " << reader_threads << " readers: "
+             << (long)throughput << " elements/s" << endl;
+        return throughput;
+    }
+};
+
 }
 
 using impl::queue_stress_tester;
+using impl::batch_stress_tester;
+using impl::queue_throughput_tester;
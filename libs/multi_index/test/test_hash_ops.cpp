@@ -38,6 +38,13 @@ typedef multi_index_container<
   >
 > hash_container;
 
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_non_unique<identity<int> >
+  >
+> hash_multi_container;
+
 void test_hash_ops()
 {
   hash_container hc;
@@ -90,4 +97,23 @@ void test_hash_ops()
   hc.rehash(1);
   BOOST_TEST(hc.bucket_count()>=1);
   check_load_factor(hc);
+
+  /* lookup with a precomputed hash, shared by two indices */
+
+  hc.clear();
+  hash_multi_container hmc;
+  for(int n=0;n<100;++n){
+    hc.insert(n);
+    hmc.insert(n/2);
+  }
+  for(int m=-1;m<=100;++m){
+    std::size_t h=hc.hash_function()(m);
+    BOOST_TEST(hc.find(m,h)==hc.find(m));
+    BOOST_TEST(hc.count(m,h)==hc.count(m));
+    BOOST_TEST(hc.equal_range(m,h)==hc.equal_range(m));
+    BOOST_TEST(hmc.find(m,h)==hmc.find(m));
+    BOOST_TEST(hmc.count(m,h)==hmc.count(m));
+    BOOST_TEST(hmc.equal_range(m,h)==hmc.equal_range(m));
+  }
+  BOOST_TEST(hmc.count(10,hc.hash_function()(10))==2);
 }
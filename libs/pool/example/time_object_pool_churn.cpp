@@ -0,0 +1,135 @@
+// Copyright (C) 2013 John Maddock
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares object_pool with fast_object_pool on a pool holding many objects:
+//
+//  destroy   - construct N objects, then destroy them all in random order.
+//  churn     - construct N objects, then repeatedly destroy a random half
+//              of them and construct replacements.
+//  teardown  - construct N objects, destroy a random half, then destroy the
+//              pool, which runs the destructors of the rest.
+//
+// usage: time_object_pool_churn [N] [churn rounds]
+
+#include <boost/pool/object_pool.hpp>
+#include <boost/pool/fast_object_pool.hpp>
+#include <boost/chrono.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct node
+{
+  node * next;
+  int value[6];
+
+  node() : next(0) { value[0] = 0; }
+};
+
+std::size_t count = 100000;
+unsigned rounds = 10;
+
+typedef boost::chrono::duration<double, boost::milli> milliseconds;
+
+milliseconds since(boost::chrono::steady_clock::time_point start)
+{
+  return boost::chrono::steady_clock::now() - start;
+}
+
+unsigned long next_random(unsigned long & state)
+{
+  state = state * 1103515245ul + 12345ul;
+  return (state >> 16) & 0x7fff;
+}
+
+// Every timing uses the same shuffle, so both pools see the same sequence
+// of operations.
+void shuffle(std::vector<node*> & v, unsigned long seed)
+{
+  for (std::size_t i = v.size(); i > 1; --i)
+  {
+    std::size_t r = (next_random(seed) << 15 | next_random(seed)) % i;
+    std::swap(v[i - 1], v[r]);
+  }
+}
+
+template <typename Pool>
+double time_destroy()
+{
+  Pool pool;
+  std::vector<node*> v(count);
+  for (std::size_t i = 0; i < count; ++i)
+    v[i] = pool.construct();
+  shuffle(v, 1);
+
+  boost::chrono::steady_clock::time_point start =
+      boost::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; ++i)
+    pool.destroy(v[i]);
+  return since(start).count();
+}
+
+template <typename Pool>
+double time_churn()
+{
+  Pool pool;
+  std::vector<node*> v(count);
+  for (std::size_t i = 0; i < count; ++i)
+    v[i] = pool.construct();
+
+  boost::chrono::steady_clock::time_point start =
+      boost::chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; ++r)
+  {
+    shuffle(v, r + 2);
+    for (std::size_t i = 0; i < count / 2; ++i)
+      pool.destroy(v[i]);
+    for (std::size_t i = 0; i < count / 2; ++i)
+      v[i] = pool.construct();
+  }
+  return since(start).count();
+}
+
+template <typename Pool>
+double time_teardown()
+{
+  Pool * pool = new Pool;
+  std::vector<node*> v(count);
+  for (std::size_t i = 0; i < count; ++i)
+    v[i] = pool->construct();
+  shuffle(v, 1);
+  for (std::size_t i = 0; i < count / 2; ++i)
+    pool->destroy(v[i]);
+
+  boost::chrono::steady_clock::time_point start =
+      boost::chrono::steady_clock::now();
+  delete pool;
+  return since(start).count();
+}
+
+template <typename Pool>
+void run(const char * name)
+{
+  std::printf("%-18s %10.1f %10.1f %10.1f\n", name,
+      time_destroy<Pool>(), time_churn<Pool>(), time_teardown<Pool>());
+}
+
+int main(int argc, char * argv[])
+{
+  if (argc > 1)
+    count = std::strtoul(argv[1], 0, 10);
+  if (argc > 2)
+    rounds = std::atoi(argv[2]);
+
+  std::printf("%lu objects, %u churn rounds, times in ms\n",
+      static_cast<unsigned long>(count), rounds);
+  std::printf("%-18s %10s %10s %10s\n", "", "destroy", "churn", "teardown");
+  run<boost::object_pool<node> >("object_pool");
+  run<boost::fast_object_pool<node> >("fast_object_pool");
+  return 0;
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2013 John Maddock
+//
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares singleton_pool with thread_cached_pool when several threads
+// allocate and free chunks at the same time. Each thread repeatedly
+// allocates a batch of chunks and then frees them all.
+//
+// usage: time_thread_cached_pool [threads] [iterations per thread]
+
+#include <boost/pool/singleton_pool.hpp>
+#include <boost/pool/thread_cached_pool.hpp>
+#include <boost/thread.hpp>
+#include <boost/chrono.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct singleton_tag { };
+struct cached_tag { };
+
+typedef boost::singleton_pool<singleton_tag, 32> singleton_type;
+typedef boost::thread_cached_pool<cached_tag, 32> cached_type;
+
+unsigned long iterations = 100000;
+const unsigned batch = 64;
+
+template <typename Pool>
+void run_thread()
+{
+  std::vector<void*> chunks(batch);
+  for (unsigned long i = 0; i < iterations; ++i)
+  {
+    for (unsigned j = 0; j < batch; ++j)
+      chunks[j] = (Pool::malloc)();
+    for (unsigned j = 0; j < batch; ++j)
+      (Pool::free)(chunks[j]);
+  }
+}
+
+template <typename Pool>
+double time_threads(unsigned threads)
+{
+  boost::chrono::steady_clock::time_point start =
+      boost::chrono::steady_clock::now();
+  boost::thread_group group;
+  for (unsigned i = 0; i < threads; ++i)
+    group.create_thread(&run_thread<Pool>);
+  group.join_all();
+  boost::chrono::duration<double, boost::nano> elapsed =
+      boost::chrono::steady_clock::now() - start;
+  // One malloc and one free per operation.
+  return elapsed.count() / (double(threads) * iterations * batch);
+}
+
+int main(int argc, char * argv[])
+{
+  unsigned threads = argc > 1 ? std::atoi(argv[1]) : 4;
+  if (argc > 2)
+    iterations = std::strtoul(argv[2], 0, 10);
+
+  std::printf("%u threads, %lu x %u chunks each, ns per malloc/free pair\n",
+      threads, iterations, batch);
+
+  std::printf("singleton_pool       %8.1f\n",
+      time_threads<singleton_type>(threads));
+
+  cached_type::reset_counters();
+  double cached = time_threads<cached_type>(threads);
+  cached_type::counters_type c = cached_type::counters();
+  std::printf("thread_cached_pool   %8.1f\n", cached);
+  std::printf("  shared pool locked %lu times (%lu contended), "
+      "%lu refills, %lu flushes\n",
+      static_cast<unsigned long>(c.lock_acquisitions),
+      static_cast<unsigned long>(c.contended_acquisitions),
+      static_cast<unsigned long>(c.refills),
+      static_cast<unsigned long>(c.flushes));
+  return 0;
+}
@@ -0,0 +1,254 @@
+/* Copyright (C) 2013 John Maddock
+*
+* Use, modification and distribution is subject to the
+* Boost Software License, Version 1.0. (See accompanying
+* file LICENSE_1_0.txt or http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <boost/pool/fast_object_pool.hpp>
+#include <boost/pool/object_pool.hpp>
+
+#include "track_allocator.hpp"
+
+#include <boost/detail/lightweight_test.hpp>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+// Counts the objects that are alive, and remembers a value so that the
+// tests can check that live objects are never overwritten.
+struct counted
+{
+   static int live;
+   int value;
+
+   counted(int v) : value(v) { ++live; }
+   ~counted() { --live; }
+};
+
+int counted::live = 0;
+
+// Refuses to allocate while 'fail' is set, so that fast_object_pool has to
+// work without its free map.
+struct failing_allocator : track_allocator
+{
+   static bool fail;
+
+   static char* malloc(const size_type bytes)
+   {
+      return fail ? 0 : track_allocator::malloc(bytes);
+   }
+};
+
+bool failing_allocator::fail = false;
+
+// Deterministic so that failures are reproducible.
+unsigned next_random(unsigned& state)
+{
+   state = state * 1103515245u + 12345u;
+   return state >> 16;
+}
+
+template <class Pool>
+void test_teardown()
+{
+   {
+      Pool pool;
+      std::vector<counted*> v;
+      for(int i = 0; i < 1000; ++i)
+         v.push_back(pool.construct(i));
+      BOOST_TEST(counted::live == 1000);
+
+      unsigned state = 1;
+      for(std::size_t i = v.size(); i > 1; --i)
+         std::swap(v[i - 1], v[next_random(state) % i]);
+      for(int i = 0; i < 500; ++i)
+         pool.destroy(v[i]);
+      BOOST_TEST(counted::live == 500);
+   }
+   // The pool destroyed each remaining object exactly once.
+   BOOST_TEST(counted::live == 0);
+   BOOST_TEST(track_allocator::ok());
+}
+
+template <class Pool>
+void test_throwing_constructor()
+{
+   {
+      // Objects whose constructor throws are not destroyed.
+      Pool pool;
+      for(int i = 0; i < 5; ++i)
+         pool.construct();
+      for(int i = 0; i < 5; ++i)
+      {
+         try
+         {
+            pool.construct(true);
+         }
+         catch(const std::logic_error &) {}
+      }
+   }
+   BOOST_TEST(mem.ok());
+   BOOST_TEST(track_allocator::ok());
+}
+
+template <class Pool>
+void test_destroy_all()
+{
+   Pool pool(8);
+   for(int round = 0; round < 3; ++round)
+   {
+      std::vector<counted*> v;
+      for(int i = 0; i < 300; ++i)
+         v.push_back(pool.construct(i));
+      for(int i = 0; i < 300; i += 3)
+         pool.destroy(v[i]);
+      BOOST_TEST(counted::live == 200);
+
+      pool.destroy_all();
+      BOOST_TEST(counted::live == 0);
+      BOOST_TEST(track_allocator::ok());
+   }
+
+   // destroy_all on an empty pool does nothing.
+   pool.destroy_all();
+   BOOST_TEST(track_allocator::ok());
+}
+
+template <class Pool>
+void test_release_memory()
+{
+   Pool pool(8);
+   BOOST_TEST(!pool.release_memory());
+
+   std::vector<counted*> v;
+   for(int i = 0; i < 1000; ++i)
+      v.push_back(pool.construct(i));
+   BOOST_TEST(track_allocator::allocated_blocks.size() > 1);
+
+   // Nothing can be released while every chunk is in use.
+   BOOST_TEST(!pool.release_memory());
+
+   counted* keep = v[617];
+   unsigned state = 2;
+   for(std::size_t i = v.size(); i > 1; --i)
+      std::swap(v[i - 1], v[next_random(state) % i]);
+   for(std::size_t i = 0; i < v.size(); ++i)
+      if(v[i] != keep)
+         pool.destroy(v[i]);
+
+   // Only the block holding the remaining object is kept.
+   BOOST_TEST(pool.release_memory());
+   BOOST_TEST(track_allocator::allocated_blocks.size() == 1);
+   BOOST_TEST(keep->value == 617);
+   BOOST_TEST(pool.is_from(keep));
+
+   // The pool can still be used afterwards.
+   for(int i = 0; i < 100; ++i)
+      v[i] = pool.construct(i);
+   for(int i = 0; i < 100; ++i)
+      BOOST_TEST(v[i]->value == i);
+   BOOST_TEST(keep->value == 617);
+   BOOST_TEST(counted::live == 101);
+}
+
+template <class Pool>
+void test_churn()
+{
+   {
+      Pool pool;
+      std::vector<counted*> live;
+      std::vector<int> values;
+      unsigned state = 3;
+      for(int i = 0; i < 100000; ++i)
+      {
+         unsigned r = next_random(state);
+         if(live.empty() || r % 5 < 3)
+         {
+            live.push_back(pool.construct(i));
+            values.push_back(i);
+         }
+         else
+         {
+            std::size_t pos = r % live.size();
+            BOOST_TEST(live[pos]->value == values[pos]);
+            std::swap(live[pos], live.back());
+            std::swap(values[pos], values.back());
+            pool.destroy(live.back());
+            live.pop_back();
+            values.pop_back();
+         }
+         if(i % 10000 == 0)
+            pool.release_memory();
+      }
+
+      std::set<counted*> distinct(live.begin(), live.end());
+      BOOST_TEST(distinct.size() == live.size());
+      BOOST_TEST(counted::live == static_cast<int>(live.size()));
+      for(std::size_t i = 0; i < live.size(); ++i)
+         BOOST_TEST(live[i]->value == values[i]);
+   }
+   BOOST_TEST(counted::live == 0);
+   BOOST_TEST(track_allocator::ok());
+}
+
+void test_no_free_map()
+{
+   boost::fast_object_pool<counted, failing_allocator> pool(8);
+   std::vector<counted*> v;
+   for(int i = 0; i < 1000; ++i)
+      v.push_back(pool.construct(i));
+   unsigned state = 4;
+   for(std::size_t i = v.size(); i > 1; --i)
+      std::swap(v[i - 1], v[next_random(state) % i]);
+   for(int i = 0; i < 990; ++i)
+      pool.destroy(v[i]);
+
+   failing_allocator::fail = true;
+   std::size_t blocks = track_allocator::allocated_blocks.size();
+   BOOST_TEST(pool.release_memory());
+   BOOST_TEST(track_allocator::allocated_blocks.size() < blocks);
+   BOOST_TEST(track_allocator::allocated_blocks.size() <= 10);
+   for(int i = 990; i < 1000; ++i)
+      BOOST_TEST(pool.is_from(v[i]));
+
+   for(int i = 990; i < 995; ++i)
+      pool.destroy(v[i]);
+   BOOST_TEST(counted::live == 5);
+   pool.destroy_all();
+   BOOST_TEST(counted::live == 0);
+   BOOST_TEST(track_allocator::ok());
+   failing_allocator::fail = false;
+}
+
+template <class T>
+struct pools
+{
+   typedef boost::object_pool<T, track_allocator> ordered;
+   typedef boost::fast_object_pool<T, track_allocator> fast;
+};
+
+int main()
+{
+   test_teardown<pools<counted>::ordered>();
+   test_teardown<pools<counted>::fast>();
+   test_throwing_constructor<pools<tester>::ordered>();
+   test_throwing_constructor<pools<tester>::fast>();
+
+   test_destroy_all<pools<counted>::ordered>();
+   test_destroy_all<pools<counted>::fast>();
+
+   test_release_memory<pools<counted>::ordered>();
+   test_release_memory<pools<counted>::fast>();
+   BOOST_TEST(counted::live == 0);
+   BOOST_TEST(track_allocator::ok());
+
+   test_churn<pools<counted>::ordered>();
+   test_churn<pools<counted>::fast>();
+
+   test_no_free_map();
+
+   return boost::report_errors();
+}
@@ -0,0 +1,208 @@
+/* Copyright (C) 2013 John Maddock
+*
+* Use, modification and distribution is subject to the
+* Boost Software License, Version 1.0. (See accompanying
+* file LICENSE_1_0.txt or http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include <boost/pool/thread_cached_pool.hpp>
+#include <boost/thread.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#include "track_allocator.hpp"
+
+#include <algorithm>
+#include <list>
+#include <set>
+#include <vector>
+
+struct single_thread_tag { };
+struct handoff_tag { };
+struct churn_tag { };
+struct release_tag { };
+
+typedef boost::thread_cached_pool<single_thread_tag, sizeof(int),
+    boost::default_user_allocator_new_delete,
+    boost::details::pool::default_mutex, 32, 0, 8> single_thread_pool;
+typedef boost::thread_cached_pool<handoff_tag, sizeof(int)> handoff_pool;
+typedef boost::thread_cached_pool<churn_tag, 24> churn_pool;
+typedef boost::thread_cached_pool<release_tag, sizeof(int), track_allocator,
+    boost::details::pool::default_mutex, 32, 0, 8> release_pool;
+
+void test_single_thread()
+{
+   single_thread_pool::reset_counters();
+
+   std::vector<int*> chunks;
+   for(int i = 0; i < 100; ++i)
+   {
+      int* p = static_cast<int*>((single_thread_pool::malloc)());
+      BOOST_TEST(p != 0);
+      BOOST_TEST(single_thread_pool::is_from(p));
+      *p = i;
+      chunks.push_back(p);
+   }
+   std::set<int*> distinct(chunks.begin(), chunks.end());
+   BOOST_TEST(distinct.size() == chunks.size());
+   for(int i = 0; i < 100; ++i)
+      BOOST_TEST(*chunks[i] == i);
+
+   // 100 chunks in batches of 8: the shared pool is only locked 13 times.
+   single_thread_pool::counters_type c = single_thread_pool::counters();
+   BOOST_TEST(c.refills == 13);
+   BOOST_TEST(c.lock_acquisitions == 13);
+   BOOST_TEST(c.contended_acquisitions == 0);
+   BOOST_TEST(c.flushes == 0);
+
+   // Freeing them returns a batch to the shared pool whenever the cache
+   // reaches 16 chunks.
+   for(int i = 0; i < 100; ++i)
+      (single_thread_pool::free)(chunks[i]);
+   c = single_thread_pool::counters();
+   BOOST_TEST(c.flushes > 0);
+
+   // Chunks come back out of the cache before the shared pool is used
+   // again.
+   int* p = static_cast<int*>((single_thread_pool::malloc)());
+   BOOST_TEST(distinct.count(p) == 1);
+   BOOST_TEST(single_thread_pool::counters().refills == c.refills);
+   (single_thread_pool::free)(p);
+
+   single_thread_pool::release_cache();
+   BOOST_TEST(single_thread_pool::counters().flushes == c.flushes + 1);
+
+   // Contiguous chunks go straight to the shared pool.
+   int* array = static_cast<int*>(single_thread_pool::ordered_malloc(10));
+   BOOST_TEST(array != 0);
+   BOOST_TEST(single_thread_pool::is_from(array + 9));
+   (single_thread_pool::free)(array, 10);
+}
+
+void test_release_memory()
+{
+   std::vector<int*> chunks;
+   for(int i = 0; i < 1000; ++i)
+      chunks.push_back(static_cast<int*>((release_pool::malloc)()));
+   BOOST_TEST(track_allocator::allocated_blocks.size() > 1);
+   BOOST_TEST(!release_pool::release_memory());
+
+   // Free the chunks in random order, so that they reach the shared pool
+   // out of address order.
+   int* keep = chunks[617];
+   unsigned state = 1;
+   for(std::size_t i = chunks.size(); i > 1; --i)
+   {
+      state = state * 1103515245u + 12345u;
+      std::swap(chunks[i - 1], chunks[(state >> 16) % i]);
+   }
+   for(std::size_t i = 0; i < chunks.size(); ++i)
+      if(chunks[i] != keep)
+         (release_pool::free)(chunks[i]);
+   release_pool::release_cache();
+
+   // Only the block holding the remaining chunk is kept.
+   BOOST_TEST(release_pool::release_memory());
+   BOOST_TEST(track_allocator::allocated_blocks.size() == 1);
+   BOOST_TEST(release_pool::is_from(keep));
+
+   (release_pool::free)(keep);
+   release_pool::release_cache();
+   BOOST_TEST(release_pool::release_memory());
+   BOOST_TEST(track_allocator::ok());
+}
+
+// Chunks allocated by one thread and freed by another.
+void allocate_chunks(std::vector<int*>& chunks)
+{
+   for(int i = 0; i < 1000; ++i)
+   {
+      int* p = static_cast<int*>((handoff_pool::malloc)());
+      *p = i;
+      chunks.push_back(p);
+   }
+}
+
+void test_handoff()
+{
+   std::vector<int*> chunks;
+   boost::thread t(&allocate_chunks, boost::ref(chunks));
+   t.join();
+
+   BOOST_TEST(chunks.size() == 1000);
+   std::set<int*> distinct(chunks.begin(), chunks.end());
+   BOOST_TEST(distinct.size() == chunks.size());
+   for(int i = 0; i < 1000; ++i)
+   {
+      BOOST_TEST(*chunks[i] == i);
+      (handoff_pool::free)(chunks[i]);
+   }
+
+   // The thread's cache was returned to the shared pool when it exited.
+   BOOST_TEST(handoff_pool::counters().flushes > 0);
+}
+
+void churn(int seed)
+{
+   std::vector<unsigned char*> live;
+   unsigned state = seed;
+   for(int i = 0; i < 20000; ++i)
+   {
+      state = state * 1103515245u + 12345u;
+      if(live.empty() || (state >> 16) % 3)
+      {
+         unsigned char* p = static_cast<unsigned char*>((churn_pool::malloc)());
+         std::fill(p, p + 24, static_cast<unsigned char>(seed));
+         live.push_back(p);
+      }
+      else
+      {
+         unsigned char* p = live.back();
+         live.pop_back();
+         BOOST_TEST(std::count(p, p + 24, static_cast<unsigned char>(seed)) == 24);
+         (churn_pool::free)(p);
+      }
+   }
+   for(std::size_t i = 0; i < live.size(); ++i)
+   {
+      BOOST_TEST(live[i][0] == static_cast<unsigned char>(seed));
+      (churn_pool::free)(live[i]);
+   }
+}
+
+void use_list()
+{
+   std::list<int, boost::thread_cached_pool_allocator<int> > l;
+   for(int i = 0; i < 10000; ++i)
+      l.push_back(i);
+   int expected = 0;
+   for(std::list<int, boost::thread_cached_pool_allocator<int> >::iterator
+      it = l.begin(); it != l.end(); ++it)
+   {
+      BOOST_TEST(*it == expected++);
+   }
+   while(!l.empty())
+      l.pop_front();
+}
+
+void test_threads()
+{
+   boost::thread_group threads;
+   for(int i = 1; i <= 4; ++i)
+      threads.create_thread(boost::bind(&churn, i));
+   for(int i = 0; i < 4; ++i)
+      threads.create_thread(&use_list);
+   threads.join_all();
+
+   churn_pool::counters_type c = churn_pool::counters();
+   BOOST_TEST(c.refills > 0);
+   BOOST_TEST(c.contended_acquisitions <= c.lock_acquisitions);
+}
+
+int main()
+{
+   test_single_thread();
+   test_release_memory();
+   test_handoff();
+   test_threads();
+   return boost::report_errors();
+}
@@ -0,0 +1,92 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+// Compares boost::mutex and adaptive_mutex on threads hammering a short critical section, reporting
+// the time per lock and, where getrusage is available, the context switches of the process.
+//
+// usage: perf_adaptive_mutex [threads] [locks per thread] [spin limit]
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/adaptive_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
+#include <cstdio>
+#include <cstdlib>
+#if defined(BOOST_THREAD_PLATFORM_PTHREAD)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+  typedef boost::chrono::steady_clock clock_type;
+
+  long context_switches()
+  {
+#if defined(BOOST_THREAD_PLATFORM_PTHREAD)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+#else
+    return 0;
+#endif
+  }
+
+  // a few cache lines of work under the lock
+  struct shared_data
+  {
+    long values[32];
+    shared_data() { for (int i = 0; i < 32; ++i) values[i] = 0; }
+  };
+
+  template <typename Mutex>
+  void hammer(Mutex* m, shared_data* d, long locks)
+  {
+    for (long i = 0; i < locks; ++i)
+    {
+      boost::unique_lock<Mutex> lk(*m);
+      for (int j = 0; j < 32; j += 8)
+        ++d->values[j];
+    }
+  }
+
+  template <typename Mutex>
+  void run(const char* name, Mutex& m, int threads, long locks)
+  {
+    shared_data d;
+    long switches = context_switches();
+    clock_type::time_point start = clock_type::now();
+    boost::thread_group group;
+    for (int i = 0; i < threads; ++i)
+      group.create_thread(boost::bind(hammer<Mutex>, &m, &d, locks));
+    group.join_all();
+    double ns = boost::chrono::duration<double, boost::nano>(clock_type::now() - start).count();
+    switches = context_switches() - switches;
+    long total = threads * locks;
+    std::printf("%-16s %2d threads: %7.1f ns/lock, %8ld context switches%s", name, threads, ns / total,
+        switches, d.values[0] == total ? "" : " MISMATCH");
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int max_threads = argc > 1 ? std::atoi(argv[1]) : 8;
+  long locks = argc > 2 ? std::atol(argv[2]) : 1000000;
+  unsigned spin_limit = argc > 3 ? unsigned(std::atoi(argv[3])) : boost::adaptive_mutex::default_spin_limit();
+  std::printf("%u hardware threads, adaptive_mutex spin limit %u\n", boost::thread::hardware_concurrency(), spin_limit);
+  for (int threads = 1; threads <= max_threads; threads *= 2)
+  {
+    boost::mutex m;
+    run("mutex", m, threads, locks);
+    std::printf("\n");
+    boost::adaptive_mutex am(spin_limit);
+    run("adaptive_mutex", am, threads, locks);
+    std::printf(", %lu contended, %lu blocked\n", am.contended_locks(), am.blocked_locks());
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+// Prints the NUMA topology and the read bandwidth of threads pinned to one node streaming over
+// memory placed on each node, so the cost of remote accesses can be seen.
+//
+// usage: perf_numa [MB per thread] [threads per node]
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/numa.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+  typedef boost::chrono::steady_clock clock_type;
+
+  void stream(const long* data, std::size_t n, int passes, long* sum)
+  {
+    long s = 0;
+    for (int pass = 0; pass < passes; ++pass)
+      for (std::size_t i = 0; i < n; ++i)
+        s += data[i];
+    *sum = s;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::size_t bytes = std::size_t(argc > 1 ? std::atoi(argv[1]) : 64) << 20;
+  std::vector<boost::numa_node> const& nodes = boost::numa_nodes();
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    std::printf("node %u: %u cores, cpus", nodes[i].id, nodes[i].cores);
+    for (std::size_t j = 0; j < nodes[i].cpus.size(); ++j)
+      std::printf(" %u", nodes[i].cpus[j]);
+    std::printf("\n");
+  }
+
+  const int passes = 4;
+  std::printf("read GB/s, threads on node (rows) x memory on node (columns)\n");
+  for (std::size_t cpu_node = 0; cpu_node < nodes.size(); ++cpu_node)
+  {
+    unsigned threads = argc > 2 ? std::atoi(argv[2]) : nodes[cpu_node].cores;
+    std::printf("%4u:", nodes[cpu_node].id);
+    for (std::size_t mem_node = 0; mem_node < nodes.size(); ++mem_node)
+    {
+      std::vector<long*> buffers(threads);
+      for (unsigned t = 0; t < threads; ++t)
+      {
+        buffers[t] = static_cast<long*>(boost::allocate_on_node(bytes, nodes[mem_node].id));
+        // first touch places the pages
+        std::memset(buffers[t], 1, bytes);
+      }
+      std::vector<long> sums(threads);
+      clock_type::time_point start = clock_type::now();
+      {
+        boost::thread_group group;
+        for (unsigned t = 0; t < threads; ++t)
+          boost::create_thread_on_node(group, nodes[cpu_node],
+              boost::bind(stream, buffers[t], bytes / sizeof(long), passes, &sums[t]));
+        group.join_all();
+      }
+      double secs = boost::chrono::duration<double>(clock_type::now() - start).count();
+      std::printf(" %8.2f", double(bytes) * threads * passes / secs / 1e9);
+      for (unsigned t = 0; t < threads; ++t)
+        boost::deallocate_on_node(buffers[t], bytes);
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
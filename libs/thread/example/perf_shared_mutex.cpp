@@ -7,66 +7,79 @@
 //
 // This performance test is based on the performance test provided by maxim.yegorushkin
 // at https://svn.boost.org/trac/boost/ticket/7422
+//
+// usage: perf_shared_mutex [shared threads]
 
 #define BOOST_THREAD_USES_CHRONO
 
 #include <iostream>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/thread_only.hpp>
+#include <boost/thread/detail/thread_group.hpp>
 #include <boost/chrono/chrono_io.hpp>
 
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/bind.hpp>
+#include <cstdlib>
 
 using namespace boost;
 
-shared_mutex mtx;
 const int cycles = 10000;
 
-void shared()
+template <typename Mutex>
+void shared(Mutex& mtx)
 {
   int cycle(0);
   while (++cycle < cycles)
   {
-    shared_lock<shared_mutex> lock(mtx);
+    shared_lock<Mutex> lock(mtx);
   }
 }
 
-void unique()
+template <typename Mutex>
+void unique(Mutex& mtx)
 {
   int cycle(0);
   while (++cycle < cycles)
   {
-    unique_lock<shared_mutex> lock(mtx);
+    unique_lock<Mutex> lock(mtx);
   }
 }
 
-int main()
+// runs readers threads taking the shared lock and writers threads taking the exclusive one
+template <typename Mutex>
+void run(const char* name, int readers, int writers)
 {
   boost::chrono::high_resolution_clock::duration best_time(std::numeric_limits<boost::chrono::high_resolution_clock::duration::rep>::max BOOST_PREVENT_MACRO_SUBSTITUTION ());
   for (int i =100; i>0; --i) {
+    Mutex mtx;
     boost::chrono::high_resolution_clock clock;
     boost::chrono::high_resolution_clock::time_point s1 = clock.now();
-    thread t0(shared);
-    thread t1(shared);
-    thread t2(unique);
-    //thread t11(shared);
-    //thread t12(shared);
-    //thread t13(shared);
-
-    t0.join();
-    t1.join();
-    t2.join();
-    //t11.join();
-//    t12.join();
-  //  t13.join();
+    thread_group threads;
+    for (int r = 0; r < readers; ++r)
+      threads.create_thread(boost::bind(shared<Mutex>, boost::ref(mtx)));
+    for (int w = 0; w < writers; ++w)
+      threads.create_thread(boost::bind(unique<Mutex>, boost::ref(mtx)));
+    threads.join_all();
     boost::chrono::high_resolution_clock::time_point f1 = clock.now();
     //std::cout << "     Time spent:" << (f1 - s1) << std::endl;
     best_time = std::min BOOST_PREVENT_MACRO_SUBSTITUTION (best_time, f1 - s1);
 
   }
+  std::cout << name << " " << readers << " shared, " << writers << " unique" << std::endl;
   std::cout << "Best Time spent:" << best_time << std::endl;
-  std::cout << "Time spent/cycle:" << best_time/cycles/3 << std::endl;
+  std::cout << "Time spent/cycle:" << best_time/cycles/(readers+writers) << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  int readers = argc > 1 ? std::atoi(argv[1]) : 2;
+  run<shared_mutex>("shared_mutex", readers, 1);
+  run<reader_biased_shared_mutex>("reader_biased_shared_mutex", readers, 1);
+  // read only
+  run<shared_mutex>("shared_mutex", readers, 0);
+  run<reader_biased_shared_mutex>("reader_biased_shared_mutex", readers, 0);
 
   return 1;
 }
-
@@ -0,0 +1,104 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+// Measures the items/s exchanged through sync_bounded_queue and sync_lockfree_bounded_queue by
+// pipeline stages, with single and batched pulls.
+//
+// usage: perf_sync_bounded_queue [items] [pairs]
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/sync_bounded_queue.hpp>
+#include <boost/thread/sync_lockfree_bounded_queue.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+  typedef boost::chrono::steady_clock clock_type;
+
+  template <typename Queue>
+  void produce(Queue* q, long n)
+  {
+    for (long i = 0; i < n; ++i)
+      q->push(i);
+  }
+
+  template <typename Queue>
+  void consume(Queue* q, long* sum)
+  {
+    long s = 0;
+    for (;;)
+    {
+      bool closed = false;
+      long x;
+      q->pull(x, closed);
+      if (closed) break;
+      s += x;
+    }
+    *sum = s;
+  }
+
+  void consume_batch(boost::sync_lockfree_bounded_queue<long>* q, long* sum)
+  {
+    long s = 0;
+    long buf[64];
+    try
+    {
+      for (;;)
+      {
+        std::size_t n = q->pull(buf, 64);
+        for (std::size_t i = 0; i < n; ++i)
+          s += buf[i];
+      }
+    }
+    catch (boost::sync_queue_is_closed&)
+    {
+    }
+    *sum = s;
+  }
+
+  template <typename Queue, typename Consumer>
+  void run(const char* name, long items, int pairs, Consumer consumer)
+  {
+    Queue q(1024);
+    std::vector<long> sums(pairs);
+    clock_type::time_point start = clock_type::now();
+    boost::thread_group consumers, producers;
+    for (int i = 0; i < pairs; ++i)
+      consumers.create_thread(boost::bind(consumer, &q, &sums[i]));
+    for (int i = 0; i < pairs; ++i)
+      producers.create_thread(boost::bind(produce<Queue>, &q, items / pairs));
+    producers.join_all();
+    q.close();
+    consumers.join_all();
+    double secs = boost::chrono::duration<double>(clock_type::now() - start).count();
+    long total = 0;
+    for (int i = 0; i < pairs; ++i)
+      total += sums[i];
+    long n = items / pairs * pairs;
+    long expected = pairs * ((items / pairs) * (items / pairs - 1) / 2);
+    std::printf("%-40s %d:%d  %6.2f M items/s%s\n", name, pairs, pairs, n / secs / 1e6,
+        total == expected ? "" : " MISMATCH");
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  long items = argc > 1 ? std::atol(argv[1]) : 2000000;
+  int max_pairs = argc > 2 ? std::atoi(argv[2]) : 2;
+  for (int pairs = 1; pairs <= max_pairs; pairs *= 2)
+  {
+    typedef boost::sync_bounded_queue<long> locked;
+    typedef boost::sync_lockfree_bounded_queue<long> lockfree;
+    run<locked>("sync_bounded_queue", items, pairs, consume<locked>);
+    run<lockfree>("sync_lockfree_bounded_queue", items, pairs, consume<lockfree>);
+    run<lockfree>("sync_lockfree_bounded_queue batch pull", items, pairs, consume_batch);
+  }
+  return 0;
+}
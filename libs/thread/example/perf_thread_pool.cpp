@@ -0,0 +1,181 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+// Compares fine-grained fork/join on a thread_pool against spawning one thread per task, which is
+// what boost::async(launch::async) does, on a recursive fibonacci and a parallel reduction.
+//
+// usage: perf_thread_pool [threads]
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/thread_pool.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/bind.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+  typedef boost::chrono::steady_clock clock_type;
+
+  double elapsed_ms(clock_type::time_point start)
+  {
+    return boost::chrono::duration<double, boost::milli>(clock_type::now() - start).count();
+  }
+
+  long serial_fib(int n)
+  {
+    return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+  }
+
+  struct pool_fib
+  {
+    boost::thread_pool* pool;
+    int n;
+    int cutoff;
+    pool_fib(boost::thread_pool& p, int m, int c) : pool(&p), n(m), cutoff(c) {}
+
+    long operator()() const
+    {
+      if (n < cutoff) return serial_fib(n);
+      boost::future<long> lhs = pool->submit(pool_fib(*pool, n - 1, cutoff));
+      long rhs = pool_fib(*pool, n - 2, cutoff)();
+      pool->reschedule_until(boost::bind(&boost::future<long>::is_ready, &lhs));
+      return lhs.get() + rhs;
+    }
+  };
+
+  template <typename F>
+  long spawn_and_join(F lhs_task, long rhs)
+  {
+    boost::packaged_task<long()> task(lhs_task);
+    boost::future<long> lhs = task.get_future();
+    boost::thread t(boost::move(task));
+    t.join();
+    return lhs.get() + rhs;
+  }
+
+  struct thread_fib
+  {
+    int n;
+    int cutoff;
+    thread_fib(int m, int c) : n(m), cutoff(c) {}
+
+    long operator()() const
+    {
+      if (n < cutoff) return serial_fib(n);
+      thread_fib lhs(n - 1, cutoff);
+      return spawn_and_join(lhs, thread_fib(n - 2, cutoff)());
+    }
+  };
+
+  typedef std::vector<long>::const_iterator iterator;
+
+  long serial_sum(iterator first, iterator last)
+  {
+    return std::accumulate(first, last, 0L);
+  }
+
+  struct pool_sum
+  {
+    boost::thread_pool* pool;
+    iterator first, last;
+    std::ptrdiff_t grain;
+    pool_sum(boost::thread_pool& p, iterator f, iterator l, std::ptrdiff_t g) : pool(&p), first(f), last(l), grain(g) {}
+
+    long operator()() const
+    {
+      if (last - first <= grain) return serial_sum(first, last);
+      iterator mid = first + (last - first) / 2;
+      boost::future<long> lhs = pool->submit(pool_sum(*pool, first, mid, grain));
+      long rhs = pool_sum(*pool, mid, last, grain)();
+      pool->reschedule_until(boost::bind(&boost::future<long>::is_ready, &lhs));
+      return lhs.get() + rhs;
+    }
+  };
+
+  struct thread_sum
+  {
+    iterator first, last;
+    std::ptrdiff_t grain;
+    thread_sum(iterator f, iterator l, std::ptrdiff_t g) : first(f), last(l), grain(g) {}
+
+    long operator()() const
+    {
+      if (last - first <= grain) return serial_sum(first, last);
+      iterator mid = first + (last - first) / 2;
+      thread_sum lhs(first, mid, grain);
+      return spawn_and_join(lhs, thread_sum(mid, last, grain)());
+    }
+  };
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned threads = argc > 1 ? std::atoi(argv[1]) : boost::thread::hardware_concurrency();
+  std::setvbuf(stdout, 0, _IONBF, 0);
+  boost::thread_pool pool(threads);
+  std::printf("%u worker threads\n", unsigned(pool.size()));
+
+  const int fib_n = 30;
+  const int cutoffs[] = { 20, 15, 10 };
+  for (unsigned i = 0; i < sizeof(cutoffs) / sizeof(cutoffs[0]); ++i)
+  {
+    int cutoff = cutoffs[i];
+    long tasks = serial_fib(fib_n - cutoff + 2);
+
+    clock_type::time_point start = clock_type::now();
+    long r1 = serial_fib(fib_n);
+    double serial = elapsed_ms(start);
+
+    start = clock_type::now();
+    long r2 = pool.submit(pool_fib(pool, fib_n, cutoff)).get();
+    double pooled = elapsed_ms(start);
+
+    std::printf("fib(%d) cutoff %d (~%ld tasks): serial %.1f ms, thread_pool %.1f ms", fib_n, cutoff, tasks, serial, pooled);
+    // a blocked OS thread per pending task: the finest grain would exhaust the process
+    if (tasks < 2000)
+    {
+      start = clock_type::now();
+      long r3 = thread_fib(fib_n, cutoff)();
+      std::printf(", thread per task %.1f ms", elapsed_ms(start));
+      if (r3 != r1) std::printf(" MISMATCH");
+    }
+    std::printf("%s\n", r1 == r2 ? "" : " MISMATCH");
+  }
+
+  std::vector<long> data(1 << 24);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = long(i % 1000);
+  const std::ptrdiff_t grains[] = { 1 << 18, 1 << 14, 1 << 10 };
+  for (unsigned i = 0; i < sizeof(grains) / sizeof(grains[0]); ++i)
+  {
+    std::ptrdiff_t grain = grains[i];
+    long tasks = long(data.size() / grain);
+
+    clock_type::time_point start = clock_type::now();
+    long r1 = serial_sum(data.begin(), data.end());
+    double serial = elapsed_ms(start);
+
+    start = clock_type::now();
+    long r2 = pool.submit(pool_sum(pool, data.begin(), data.end(), grain)).get();
+    double pooled = elapsed_ms(start);
+
+    std::printf("reduce %lu grain %ld (%ld tasks): serial %.1f ms, thread_pool %.1f ms",
+        (unsigned long)data.size(), (long)grain, tasks, serial, pooled);
+    if (tasks < 2000)
+    {
+      start = clock_type::now();
+      long r3 = thread_sum(data.begin(), data.end(), grain)();
+      std::printf(", thread per task %.1f ms", elapsed_ms(start));
+      if (r3 != r1) std::printf(" MISMATCH");
+    }
+    std::printf("%s\n", r1 == r2 ? "" : " MISMATCH");
+  }
+  return 0;
+}
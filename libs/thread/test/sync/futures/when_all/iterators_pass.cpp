@@ -0,0 +1,100 @@
+// Copyright (C) 2013 Vicente Botet
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// template <class InputIterator>
+// future<vector<typename iterator_traits<InputIterator>::value_type>>
+// when_all(InputIterator first, InputIterator last);
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/future.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <stdexcept>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
+
+int p1()
+{
+  return 123;
+}
+
+std::size_t count_ready(boost::future<std::vector<boost::future<int> > >& f)
+{
+  std::vector<boost::future<int> > v = f.get();
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < v.size(); ++i)
+    if (v[i].is_ready()) ++n;
+  return n;
+}
+
+void set_all(std::vector<boost::promise<int> >* promises)
+{
+  for (std::size_t i = 0; i < promises->size(); ++i)
+    (*promises)[i].set_value(int(i));
+}
+
+int main()
+{
+  {
+    // an empty range is ready at once
+    std::vector<boost::future<int> > v;
+    boost::future<std::vector<boost::future<int> > > all = boost::when_all(v.begin(), v.end());
+    BOOST_TEST(all.is_ready());
+    BOOST_TEST(all.get().empty());
+  }
+  {
+    boost::promise<int> p0, p1, p2;
+    std::vector<boost::future<int> > v;
+    v.push_back(p0.get_future());
+    v.push_back(p1.get_future());
+    v.push_back(p2.get_future());
+    boost::future<std::vector<boost::future<int> > > all = boost::when_all(v.begin(), v.end());
+    BOOST_TEST(!v[0].valid());
+    BOOST_TEST(!all.is_ready());
+    p1.set_value(1);
+    p0.set_exception(boost::copy_exception(std::runtime_error("p0")));
+    BOOST_TEST(!all.is_ready());
+    p2.set_value(2);
+    BOOST_TEST(all.is_ready());
+    std::vector<boost::future<int> > r = all.get();
+    BOOST_TEST_EQ(r.size(), 3u);
+    BOOST_TEST(r[0].has_exception());
+    BOOST_TEST_EQ(r[1].get(), 1);
+    BOOST_TEST_EQ(r[2].get(), 2);
+  }
+  {
+    // ready and deferred inputs
+    std::vector<boost::future<int> > v;
+    v.push_back(boost::make_ready_future(7));
+    v.push_back(boost::async(boost::launch::deferred, &p1));
+    boost::future<std::vector<boost::future<int> > > all = boost::when_all(v.begin(), v.end());
+    BOOST_TEST(all.is_ready());
+    std::vector<boost::future<int> > r = all.get();
+    BOOST_TEST_EQ(r[0].get(), 7);
+    BOOST_TEST_EQ(r[1].get(), 123);
+  }
+  {
+    // many futures completed by another thread
+    std::vector<boost::promise<int> > promises(500);
+    std::vector<boost::future<int> > v;
+    for (std::size_t i = 0; i < promises.size(); ++i)
+      v.push_back(promises[i].get_future());
+    boost::future<std::size_t> ready = boost::when_all(v.begin(), v.end()).then(&count_ready);
+    boost::thread t(set_all, &promises);
+    BOOST_TEST_EQ(ready.get(), 500u);
+    t.join();
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
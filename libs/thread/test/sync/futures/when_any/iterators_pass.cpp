@@ -0,0 +1,88 @@
+// Copyright (C) 2013 Vicente Botet
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// template <class InputIterator>
+// future<vector<typename iterator_traits<InputIterator>::value_type>>
+// when_any(InputIterator first, InputIterator last);
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/future.hpp>
+#include <boost/detail/lightweight_test.hpp>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
+
+void set_one(boost::promise<int>* p)
+{
+  boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+  p->set_value(42);
+}
+
+int main()
+{
+  {
+    // an empty range is ready at once
+    std::vector<boost::future<int> > v;
+    boost::future<std::vector<boost::future<int> > > any = boost::when_any(v.begin(), v.end());
+    BOOST_TEST(any.is_ready());
+    BOOST_TEST(any.get().empty());
+  }
+  {
+    boost::promise<int> p0, p1, p2;
+    std::vector<boost::future<int> > v;
+    v.push_back(p0.get_future());
+    v.push_back(p1.get_future());
+    v.push_back(p2.get_future());
+    boost::future<std::vector<boost::future<int> > > any = boost::when_any(v.begin(), v.end());
+    BOOST_TEST(!any.is_ready());
+    p1.set_value(1);
+    BOOST_TEST(any.is_ready());
+    // later completions are harmless
+    p2.set_value(2);
+    std::vector<boost::future<int> > r = any.get();
+    BOOST_TEST_EQ(r.size(), 3u);
+    BOOST_TEST(!r[0].is_ready());
+    BOOST_TEST_EQ(r[1].get(), 1);
+    BOOST_TEST_EQ(r[2].get(), 2);
+    p0.set_value(0);
+    BOOST_TEST_EQ(r[0].get(), 0);
+  }
+  {
+    // the result may be dropped before the other futures complete
+    boost::promise<int> p0, p1;
+    std::vector<boost::future<int> > v;
+    v.push_back(p0.get_future());
+    v.push_back(p1.get_future());
+    {
+      boost::future<std::vector<boost::future<int> > > any = boost::when_any(v.begin(), v.end());
+      p0.set_value(0);
+      BOOST_TEST(any.is_ready());
+    }
+    p1.set_value(1);
+  }
+  {
+    // woken by another thread
+    boost::promise<int> p0, p1;
+    std::vector<boost::future<int> > v;
+    v.push_back(p0.get_future());
+    v.push_back(p1.get_future());
+    boost::future<std::vector<boost::future<int> > > any = boost::when_any(v.begin(), v.end());
+    boost::thread t(set_one, &p1);
+    std::vector<boost::future<int> > r = any.get();
+    BOOST_TEST_EQ(r[1].get(), 42);
+    t.join();
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
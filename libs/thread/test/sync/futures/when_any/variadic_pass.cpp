@@ -0,0 +1,49 @@
+// Copyright (C) 2013 Vicente Botet
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// <boost/thread/future.hpp>
+
+// template <typename... T>
+// future<tuple<decay_t<T>...>> when_any(T&&... futures);
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/future.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <string>
+
+#if defined BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY \
+ && ! defined BOOST_NO_CXX11_VARIADIC_TEMPLATES && ! defined BOOST_NO_CXX11_HDR_TUPLE
+
+int main()
+{
+  {
+    boost::future<std::tuple<> > any = boost::when_any();
+    BOOST_TEST(any.is_ready());
+  }
+  {
+    boost::promise<int> p0;
+    boost::promise<std::string> p1;
+    boost::future<std::tuple<boost::future<int>, boost::future<std::string> > > any =
+        boost::when_any(p0.get_future(), p1.get_future());
+    BOOST_TEST(!any.is_ready());
+    p1.set_value("one");
+    BOOST_TEST(any.is_ready());
+    std::tuple<boost::future<int>, boost::future<std::string> > r = any.get();
+    BOOST_TEST(!std::get<0>(r).is_ready());
+    BOOST_TEST_EQ(std::get<1>(r).get(), "one");
+    p0.set_value(0);
+    BOOST_TEST_EQ(std::get<0>(r).get(), 0);
+  }
+  return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+  return 0;
+}
+#endif
@@ -0,0 +1,148 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/adaptive_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/lock_algorithms.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+namespace
+{
+  const int iterations = 100000;
+
+  template <typename Mutex>
+  void increment(Mutex* m, long* counter)
+  {
+    for (int i = 0; i < iterations; ++i)
+    {
+      boost::unique_lock<Mutex> lk(*m);
+      ++*counter;
+    }
+  }
+
+  void lock_both(boost::adaptive_mutex* m1, boost::adaptive_mutex* m2, long* counter)
+  {
+    for (int i = 0; i < iterations / 10; ++i)
+    {
+      boost::lock(*m1, *m2);
+      ++*counter;
+      m1->unlock();
+      m2->unlock();
+    }
+  }
+
+  void try_lock_for(boost::adaptive_timed_mutex* m, bool* locked)
+  {
+    *locked = m->try_lock_for(boost::chrono::milliseconds(50));
+    if (*locked)
+      m->unlock();
+  }
+
+  void notify_ready(boost::adaptive_mutex* m, boost::condition_variable_any* cv, bool* ready)
+  {
+    boost::unique_lock<boost::adaptive_mutex> lk(*m);
+    *ready = true;
+    cv->notify_one();
+  }
+}
+
+void test_single_thread()
+{
+  boost::adaptive_mutex m;
+  BOOST_TEST(m.try_lock());
+  BOOST_TEST(!m.try_lock());
+  m.unlock();
+  {
+    boost::unique_lock<boost::adaptive_mutex> lk(m);
+    BOOST_TEST(lk.owns_lock());
+  }
+  BOOST_TEST_EQ(m.contended_locks(), 0u);
+
+  boost::adaptive_timed_mutex tm(0);
+  BOOST_TEST_EQ(tm.spin_limit(), 0u);
+  BOOST_TEST(tm.try_lock_for(boost::chrono::milliseconds(1)));
+  BOOST_TEST(!tm.try_lock());
+  tm.unlock();
+}
+
+void test_timed()
+{
+  boost::adaptive_timed_mutex m;
+  bool locked = true;
+  m.lock();
+  boost::thread t(try_lock_for, &m, &locked);
+  t.join();
+  BOOST_TEST(!locked);
+  BOOST_TEST(m.contended_locks() >= 1u);
+  BOOST_TEST(m.blocked_locks() >= 1u);
+  m.unlock();
+  // the timed out waiter left the mutex usable
+  BOOST_TEST(m.try_lock());
+  m.unlock();
+  boost::thread t2(try_lock_for, &m, &locked);
+  t2.join();
+  BOOST_TEST(locked);
+  m.reset_contention_counters();
+  BOOST_TEST_EQ(m.contended_locks(), 0u);
+}
+
+void test_condition_variable_any()
+{
+  boost::adaptive_mutex m;
+  boost::condition_variable_any cv;
+  bool ready = false;
+  boost::unique_lock<boost::adaptive_mutex> lk(m);
+  boost::thread t(notify_ready, &m, &cv, &ready);
+  while (!ready)
+    cv.wait(lk);
+  lk.unlock();
+  t.join();
+  BOOST_TEST(ready);
+}
+
+template <typename Mutex>
+void test_concurrent(unsigned spin_limit)
+{
+  Mutex m(spin_limit);
+  long counter = 0;
+  boost::thread_group threads;
+  for (int i = 0; i < 4; ++i)
+    threads.create_thread(boost::bind(increment<Mutex>, &m, &counter));
+  threads.join_all();
+  BOOST_TEST_EQ(counter, 4L * iterations);
+  BOOST_TEST(m.blocked_locks() <= m.contended_locks());
+}
+
+void test_lock_algorithm()
+{
+  boost::adaptive_mutex m1, m2;
+  long counter = 0;
+  boost::thread t1(lock_both, &m1, &m2, &counter);
+  boost::thread t2(lock_both, &m2, &m1, &counter);
+  t1.join();
+  t2.join();
+  BOOST_TEST_EQ(counter, 2L * (iterations / 10));
+}
+
+int main()
+{
+  test_single_thread();
+  test_timed();
+  test_condition_variable_any();
+  // blocking only, and spinning
+  test_concurrent<boost::adaptive_mutex>(0);
+  test_concurrent<boost::adaptive_mutex>(100000);
+  test_concurrent<boost::adaptive_timed_mutex>(1000);
+  test_lock_algorithm();
+  return boost::report_errors();
+}
@@ -0,0 +1,136 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/numa.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  boost::atomic<int> misplaced(0);
+  boost::atomic<int> ran(0);
+
+  void check_cpu(std::vector<unsigned> const* allowed)
+  {
+    ++ran;
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && std::find(allowed->begin(), allowed->end(), unsigned(cpu)) == allowed->end())
+      ++misplaced;
+#else
+    (void)allowed;
+#endif
+  }
+
+  void run()
+  {
+    ++ran;
+  }
+}
+
+void test_parse_cpu_list()
+{
+  std::vector<unsigned> cpus = boost::thread_detail::parse_cpu_list("0-3,8,10-11\n");
+  const unsigned expected[] = { 0, 1, 2, 3, 8, 10, 11 };
+  BOOST_TEST_EQ(cpus.size(), 7u);
+  BOOST_TEST(std::equal(cpus.begin(), cpus.end(), expected));
+  BOOST_TEST(boost::thread_detail::parse_cpu_list("").empty());
+}
+
+void test_topology()
+{
+  std::vector<boost::numa_node> const& nodes = boost::numa_nodes();
+  BOOST_TEST(!nodes.empty());
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    BOOST_TEST(!nodes[i].cpus.empty());
+    BOOST_TEST(nodes[i].cores >= 1u);
+    BOOST_TEST(nodes[i].cores <= nodes[i].cpus.size());
+    if (i > 0)
+      BOOST_TEST(nodes[i - 1].id < nodes[i].id);
+  }
+
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+  // only the processors the process may run on are reported
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  BOOST_TEST_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+    for (std::size_t j = 0; j < nodes[i].cpus.size(); ++j)
+      BOOST_TEST(CPU_ISSET(nodes[i].cpus[j], &allowed));
+#endif
+}
+
+void test_affinity()
+{
+#if defined BOOST_THREAD_DEFINES_THREAD_ATTRIBUTES_AFFINITY
+  std::vector<unsigned> first_cpu(1, boost::numa_nodes().front().cpus.front());
+  boost::thread::attributes attrs;
+  attrs.set_affinity(first_cpu);
+  BOOST_TEST(attrs.get_affinity() == first_cpu);
+  misplaced = 0;
+  boost::thread::attributes const& const_attrs = attrs;
+  boost::thread t(const_attrs, boost::bind(check_cpu, &first_cpu));
+  t.join();
+  BOOST_TEST_EQ(misplaced.load(), 0);
+#endif
+}
+
+void test_thread_group()
+{
+  std::vector<boost::numa_node> const& nodes = boost::numa_nodes();
+  misplaced = 0;
+  ran = 0;
+  {
+    boost::thread_group group;
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+      boost::create_thread_on_node(group, nodes[i], boost::bind(check_cpu, &nodes[i].cpus));
+    group.join_all();
+  }
+  BOOST_TEST_EQ(ran.load(), int(nodes.size()));
+  BOOST_TEST_EQ(misplaced.load(), 0);
+
+  ran = 0;
+  {
+    boost::thread_group group;
+    boost::create_threads_on_nodes(group, run, 2);
+    BOOST_TEST_EQ(group.size(), 2 * nodes.size());
+    group.join_all();
+  }
+  BOOST_TEST_EQ(ran.load(), int(2 * nodes.size()));
+}
+
+void test_allocate()
+{
+  const std::size_t bytes = 1 << 20;
+  std::vector<boost::numa_node> const& nodes = boost::numa_nodes();
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    char* p = static_cast<char*>(boost::allocate_on_node(bytes, nodes[i].id));
+    BOOST_TEST(p != 0);
+    std::memset(p, 1, bytes);
+    BOOST_TEST_EQ(p[bytes - 1], 1);
+    boost::deallocate_on_node(p, bytes);
+  }
+}
+
+int main()
+{
+  test_parse_cpu_list();
+  test_topology();
+  test_affinity();
+  test_thread_group();
+  test_allocate();
+  return boost::report_errors();
+}
@@ -0,0 +1,231 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/reader_biased_shared_mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/shared_lock_guard.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+
+namespace
+{
+  typedef boost::reader_biased_shared_mutex mutex_type;
+
+  const int iterations = 20000;
+
+  // the writers increment both counters, the readers check they are always equal
+  struct shared_data
+  {
+    mutex_type mtx;
+    long a;
+    long b;
+    boost::atomic<int> writers_inside;
+    boost::atomic<int> readers_inside;
+    boost::atomic<int> errors;
+    shared_data() : a(0), b(0), writers_inside(0), readers_inside(0), errors(0) {}
+  };
+
+  void reader(shared_data* d)
+  {
+    for (int i = 0; i < iterations; ++i)
+    {
+      boost::shared_lock<mutex_type> lk(d->mtx);
+      ++d->readers_inside;
+      if (d->a != d->b || d->writers_inside.load() != 0)
+        ++d->errors;
+      --d->readers_inside;
+    }
+  }
+
+  void writer(shared_data* d)
+  {
+    for (int i = 0; i < iterations / 10; ++i)
+    {
+      boost::unique_lock<mutex_type> lk(d->mtx);
+      if (++d->writers_inside != 1 || d->readers_inside.load() != 0)
+        ++d->errors;
+      ++d->a;
+      ++d->b;
+      --d->writers_inside;
+    }
+  }
+
+  void try_shared(mutex_type* m, bool* locked)
+  {
+    *locked = m->try_lock_shared();
+    if (*locked)
+      m->unlock_shared();
+  }
+
+  void try_shared_for(mutex_type* m, bool* locked)
+  {
+    *locked = m->try_lock_shared_for(boost::chrono::milliseconds(50));
+    if (*locked)
+      m->unlock_shared();
+  }
+
+  void try_unique(mutex_type* m, bool* locked)
+  {
+    *locked = m->try_lock();
+    if (*locked)
+      m->unlock();
+  }
+
+  void try_unique_for(mutex_type* m, bool* locked)
+  {
+    *locked = m->try_lock_for(boost::chrono::milliseconds(50));
+    if (*locked)
+      m->unlock();
+  }
+
+  void lock_unique(mutex_type* m, boost::atomic<bool>* locked)
+  {
+    boost::unique_lock<mutex_type> lk(*m);
+    *locked = true;
+  }
+
+  void try_unique_for_us(mutex_type* m, int us)
+  {
+    if (m->try_lock_for(boost::chrono::microseconds(us)))
+      m->unlock();
+  }
+}
+
+void test_single_thread()
+{
+  mutex_type m;
+  m.lock_shared();
+  BOOST_TEST(m.try_lock_shared());
+  m.unlock_shared();
+  m.unlock_shared();
+  BOOST_TEST(m.try_lock());
+  m.unlock();
+  m.lock();
+  m.unlock();
+  {
+    boost::shared_lock_guard<mutex_type> lk(m);
+  }
+  BOOST_TEST(m.try_lock_for(boost::chrono::milliseconds(1)));
+  m.unlock();
+  BOOST_TEST(m.try_lock_shared_for(boost::chrono::milliseconds(1)));
+  m.unlock_shared();
+}
+
+void test_exclusion()
+{
+  mutex_type m;
+  bool locked = true;
+  m.lock();
+  {
+    boost::thread t(try_shared, &m, &locked);
+    t.join();
+    BOOST_TEST(!locked);
+  }
+  {
+    boost::thread t(try_shared_for, &m, &locked);
+    t.join();
+    BOOST_TEST(!locked);
+  }
+  {
+    boost::thread t(try_unique_for, &m, &locked);
+    t.join();
+    BOOST_TEST(!locked);
+  }
+  m.unlock();
+
+  m.lock_shared();
+  {
+    // other readers are admitted
+    boost::thread t(try_shared, &m, &locked);
+    t.join();
+    BOOST_TEST(locked);
+  }
+  {
+    boost::thread t(try_unique, &m, &locked);
+    t.join();
+    BOOST_TEST(!locked);
+  }
+  {
+    // a timed out writer lets readers in again
+    boost::thread t(try_unique_for, &m, &locked);
+    t.join();
+    BOOST_TEST(!locked);
+    boost::thread t2(try_shared, &m, &locked);
+    t2.join();
+    BOOST_TEST(locked);
+  }
+  {
+    // a writer waits for the readers to drain
+    boost::atomic<bool> writer_locked(false);
+    boost::thread t(lock_unique, &m, &writer_locked);
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    BOOST_TEST(!writer_locked.load());
+    m.unlock_shared();
+    t.join();
+    BOOST_TEST(writer_locked.load());
+  }
+}
+
+void test_timed_and_untimed_writers()
+{
+  // The mutex is released around the time the timed writer gives up, so that
+  // the writer is sometimes woken and times out at once. The untimed writer
+  // must still get the mutex.
+  mutex_type m;
+  int stuck = 0;
+  for (int i = 0; i < 200; ++i)
+  {
+    const int timeout_us = 2000;
+    m.lock();
+    boost::thread timed(try_unique_for_us, &m, timeout_us);
+    boost::this_thread::sleep_for(boost::chrono::microseconds(500));
+    boost::atomic<bool> writer_locked(false);
+    boost::thread untimed(lock_unique, &m, &writer_locked);
+    boost::this_thread::sleep_for(
+        boost::chrono::microseconds(timeout_us - 500 - 250 + (i % 10) * 50));
+    m.unlock();
+    timed.join();
+    for (int j = 0; j < 1000 && !writer_locked.load(); ++j)
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+    if (!writer_locked.load())
+    {
+      ++stuck;
+      // wake the untimed writer so that it can be joined
+      if (m.try_lock())
+        m.unlock();
+    }
+    untimed.join();
+  }
+  BOOST_TEST_EQ(stuck, 0);
+}
+
+void test_concurrent()
+{
+  shared_data d;
+  boost::thread_group threads;
+  for (int i = 0; i < 4; ++i)
+    threads.create_thread(boost::bind(reader, &d));
+  for (int i = 0; i < 2; ++i)
+    threads.create_thread(boost::bind(writer, &d));
+  threads.join_all();
+  BOOST_TEST_EQ(d.errors.load(), 0);
+  BOOST_TEST_EQ(d.a, 2L * (iterations / 10));
+}
+
+int main()
+{
+  test_single_thread();
+  test_exclusion();
+  test_timed_and_untimed_writers();
+  test_concurrent();
+  return boost::report_errors();
+}
@@ -0,0 +1,228 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/sync_lockfree_bounded_queue.hpp>
+#include <boost/atomic.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <string>
+
+namespace
+{
+  typedef boost::sync_lockfree_bounded_queue<int> queue_type;
+
+  const int n_items = 200000;
+
+  void producer(queue_type* q, int first, int count)
+  {
+    for (int i = first; i < first + count; ++i)
+      q->push(i);
+  }
+
+  void consumer(queue_type* q, boost::atomic<long>* sum, boost::atomic<int>* pulled)
+  {
+    for (;;)
+    {
+      bool closed = false;
+      int x;
+      q->pull(x, closed);
+      if (closed) return;
+      *sum += x;
+      ++*pulled;
+    }
+  }
+
+  void batch_consumer(queue_type* q, boost::atomic<long>* sum, boost::atomic<int>* pulled)
+  {
+    int buf[32];
+    try
+    {
+      for (;;)
+      {
+        std::size_t n = q->pull(buf, 32);
+        for (std::size_t i = 0; i < n; ++i)
+          *sum += buf[i];
+        *pulled += int(n);
+      }
+    }
+    catch (boost::sync_queue_is_closed&)
+    {
+    }
+  }
+
+  void pull_one(queue_type* q, int* x)
+  {
+    *x = q->pull();
+  }
+
+  void pull_closed(queue_type* q, bool* thrown)
+  {
+    try
+    {
+      q->pull();
+    }
+    catch (boost::sync_queue_is_closed&)
+    {
+      *thrown = true;
+    }
+  }
+}
+
+void test_single_thread()
+{
+  queue_type q(3);
+  BOOST_TEST_EQ(q.capacity(), 4u);
+  BOOST_TEST(q.empty());
+  BOOST_TEST(!q.full());
+  for (int i = 0; i < 4; ++i)
+    BOOST_TEST(q.try_push(i));
+  BOOST_TEST(q.full());
+  BOOST_TEST(!q.try_push(4));
+  BOOST_TEST(!q.try_push(boost::no_block, 4));
+  BOOST_TEST_EQ(q.size(), 4u);
+  int x = -1;
+  BOOST_TEST(q.try_pull(x));
+  BOOST_TEST_EQ(x, 0);
+  BOOST_TEST_EQ(q.pull(), 1);
+  BOOST_TEST(q.try_pull(boost::no_block, x));
+  BOOST_TEST_EQ(x, 2);
+  BOOST_TEST_EQ(*q.ptr_pull(), 3);
+  BOOST_TEST(!q.try_pull(x));
+  BOOST_TEST(!q.try_pull());
+  BOOST_TEST(q.empty());
+
+  // wrap around several times
+  for (int i = 0; i < 100; ++i)
+  {
+    q << i;
+    q >> x;
+    BOOST_TEST_EQ(x, i);
+  }
+}
+
+void test_batch()
+{
+  queue_type q(8);
+  for (int i = 0; i < 6; ++i)
+    q.push(i);
+  int buf[4];
+  BOOST_TEST_EQ(q.try_pull(buf, 4), 4u);
+  for (int i = 0; i < 4; ++i)
+    BOOST_TEST_EQ(buf[i], i);
+  BOOST_TEST_EQ(q.pull(buf, 4), 2u);
+  BOOST_TEST_EQ(buf[0], 4);
+  BOOST_TEST_EQ(buf[1], 5);
+  BOOST_TEST_EQ(q.try_pull(buf, 4), 0u);
+}
+
+void test_closed()
+{
+  boost::sync_lockfree_bounded_queue<std::string> q(4);
+  q.push(std::string("a"));
+  q.push("b");
+  q.close();
+  BOOST_TEST(q.closed());
+  try
+  {
+    q.push("c");
+    BOOST_TEST(false);
+  }
+  catch (boost::sync_queue_is_closed&)
+  {
+  }
+  // the elements pushed before closing can still be pulled
+  BOOST_TEST_EQ(q.pull(), "a");
+  bool closed = false;
+  std::string s;
+  q.pull(s, closed);
+  BOOST_TEST(!closed);
+  BOOST_TEST_EQ(s, "b");
+  q.pull(s, closed);
+  BOOST_TEST(closed);
+  try
+  {
+    q.try_pull(s);
+    BOOST_TEST(false);
+  }
+  catch (boost::sync_queue_is_closed&)
+  {
+  }
+}
+
+void test_blocking()
+{
+  {
+    // a pull waiting on an empty queue is woken by a push
+    queue_type q(2);
+    int x = 0;
+    boost::thread t(pull_one, &q, &x);
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    q.push(42);
+    t.join();
+    BOOST_TEST_EQ(x, 42);
+  }
+  {
+    // a push waiting on a full queue is woken by a pull
+    queue_type q(2);
+    q.push(1);
+    q.push(2);
+    boost::thread t(producer, &q, 3, 1);
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    BOOST_TEST_EQ(q.pull(), 1);
+    t.join();
+    BOOST_TEST_EQ(q.pull(), 2);
+    BOOST_TEST_EQ(q.pull(), 3);
+  }
+  {
+    // closing wakes a waiting pull
+    queue_type q(2);
+    bool thrown = false;
+    boost::thread t(pull_closed, &q, &thrown);
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    q.close();
+    t.join();
+    BOOST_TEST(thrown);
+  }
+}
+
+void test_mpmc(bool batch, std::size_t capacity)
+{
+  const int n_producers = 3;
+  const int n_consumers = 3;
+  queue_type q(capacity);
+  boost::atomic<long> sum(0);
+  boost::atomic<int> pulled(0);
+  boost::thread_group consumers;
+  for (int i = 0; i < n_consumers; ++i)
+    consumers.create_thread(boost::bind(batch ? batch_consumer : consumer, &q, &sum, &pulled));
+  boost::thread_group producers;
+  for (int i = 0; i < n_producers; ++i)
+    producers.create_thread(boost::bind(producer, &q, i * n_items, n_items));
+  producers.join_all();
+  q.close();
+  consumers.join_all();
+  long total = long(n_producers) * n_items;
+  BOOST_TEST_EQ(pulled.load(), n_producers * n_items);
+  BOOST_TEST_EQ(sum.load(), total * (total - 1) / 2);
+}
+
+int main()
+{
+  test_single_thread();
+  test_batch();
+  test_closed();
+  test_blocking();
+  test_mpmc(false, 64);
+  test_mpmc(true, 64);
+  // mostly full or empty: exercises the waits
+  test_mpmc(false, 2);
+  test_mpmc(true, 2);
+  return boost::report_errors();
+}
@@ -0,0 +1,210 @@
+// Distributed under the Boost Software License, Version 1.0. (See
+// accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+// (C) Copyright 2013 Vicente J. Botet Escriba
+
+#define BOOST_THREAD_VERSION 4
+
+#include <boost/thread/detail/config.hpp>
+
+#include <boost/thread/thread_pool.hpp>
+#include <boost/thread/detail/work_stealing_deque.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/detail/lightweight_test.hpp>
+#include <stdexcept>
+
+namespace
+{
+  boost::atomic<int> counter(0);
+
+  void increment()
+  {
+    ++counter;
+  }
+
+  int forty_two()
+  {
+    return 42;
+  }
+
+  int throws()
+  {
+    throw std::runtime_error("throws");
+  }
+
+  int twice(boost::future<int>& f)
+  {
+    return 2 * f.get();
+  }
+
+  void record_thread(boost::future<int>& f, boost::thread::id* id)
+  {
+    f.get();
+    *id = boost::this_thread::get_id();
+  }
+
+  struct fib
+  {
+    boost::thread_pool* pool;
+    int n;
+    fib(boost::thread_pool& p, int m) : pool(&p), n(m) {}
+
+    int operator()() const
+    {
+      if (n < 2) return n;
+      boost::future<int> lhs = pool->submit(fib(*pool, n - 1));
+      int rhs = fib(*pool, n - 2)();
+      // keep the worker busy rather than blocking it
+      pool->reschedule_until(boost::bind(&boost::future<int>::is_ready, &lhs));
+      return lhs.get() + rhs;
+    }
+  };
+
+  void stealer(boost::thread_detail::work_stealing_deque<int>* d, boost::atomic<long>* sum, boost::atomic<bool>* done)
+  {
+    int x;
+    for (;;)
+    {
+      if (d->steal(x))
+        *sum += x;
+      else if (done->load() && d->empty())
+        break;
+    }
+  }
+}
+
+void test_deque_owner()
+{
+  boost::thread_detail::work_stealing_deque<int> d(1);
+  for (int i = 0; i < 100; ++i)
+    d.push(i);
+  int x;
+  BOOST_TEST(d.steal(x));
+  BOOST_TEST_EQ(x, 0);
+  for (int i = 99; i > 0; --i)
+  {
+    BOOST_TEST(d.pop(x));
+    BOOST_TEST_EQ(x, i);
+  }
+  BOOST_TEST(!d.pop(x));
+  BOOST_TEST(!d.steal(x));
+  BOOST_TEST(d.empty());
+}
+
+void test_deque_concurrent()
+{
+  const int n = 100000;
+  boost::thread_detail::work_stealing_deque<int> d(2);
+  boost::atomic<long> sum(0);
+  boost::atomic<bool> done(false);
+  boost::thread t1(stealer, &d, &sum, &done);
+  boost::thread t2(stealer, &d, &sum, &done);
+  long own = 0;
+  int x;
+  for (int i = 1; i <= n; ++i)
+  {
+    d.push(i);
+    if (i % 3 == 0 && d.pop(x))
+      own += x;
+  }
+  while (d.pop(x))
+    own += x;
+  done = true;
+  t1.join();
+  t2.join();
+  BOOST_TEST_EQ(own + sum.load(), long(n) * (n + 1) / 2);
+}
+
+void test_execute()
+{
+  counter = 0;
+  {
+    boost::thread_pool pool(4);
+    BOOST_TEST_EQ(pool.size(), 4u);
+    for (int i = 0; i < 1000; ++i)
+      pool.execute(&increment);
+  }
+  BOOST_TEST_EQ(counter.load(), 1000);
+}
+
+void test_submit()
+{
+  boost::thread_pool pool(2);
+  boost::future<int> f = pool.submit(&forty_two);
+  BOOST_TEST_EQ(f.get(), 42);
+
+  boost::future<int> g = boost::async(pool, &throws);
+  try
+  {
+    g.get();
+    BOOST_TEST(false);
+  }
+  catch (std::runtime_error&)
+  {
+  }
+}
+
+void test_closed()
+{
+  boost::thread_pool pool(1);
+  pool.close();
+  BOOST_TEST(pool.closed());
+  try
+  {
+    pool.execute(&increment);
+    BOOST_TEST(false);
+  }
+  catch (boost::sync_queue_is_closed&)
+  {
+  }
+}
+
+void test_fork_join()
+{
+  boost::thread_pool pool(3);
+  BOOST_TEST_EQ(pool.submit(fib(pool, 20)).get(), 6765);
+  // a single worker must not deadlock on nested tasks
+  boost::thread_pool one(1);
+  BOOST_TEST_EQ(one.submit(fib(one, 15)).get(), 610);
+}
+
+void test_then()
+{
+  boost::thread_pool pool(2);
+
+  boost::future<int> f = pool.submit(&forty_two);
+  boost::future<int> f2 = f.then(pool, &twice);
+  BOOST_TEST_EQ(f2.get(), 84);
+
+  // the continuation of a ready future is scheduled too
+  boost::future<int> ready = boost::make_ready_future(21);
+  boost::thread::id id;
+  boost::future<void> f3 = ready.then(pool, boost::bind(record_thread, _1, &id));
+  f3.get();
+  BOOST_TEST(id != boost::thread::id());
+  BOOST_TEST(id != boost::this_thread::get_id());
+
+  boost::future<int> f4 = pool.submit(&throws).then(pool, &twice);
+  try
+  {
+    f4.get();
+    BOOST_TEST(false);
+  }
+  catch (std::runtime_error&)
+  {
+  }
+}
+
+int main()
+{
+  test_deque_owner();
+  test_deque_concurrent();
+  test_execute();
+  test_submit();
+  test_closed();
+  test_fork_join();
+  test_then();
+  return boost::report_errors();
+}
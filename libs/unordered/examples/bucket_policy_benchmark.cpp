@@ -0,0 +1,126 @@
+// Copyright 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures lookup latency in unordered_map with the prime and the power of
+// two bucket policies, for several key types. Each lookup's key depends on
+// the result of the previous one, so the times are latencies rather than
+// throughput.
+//
+// usage: bucket_policy_benchmark [number of elements]
+
+#include <boost/unordered_map.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace
+{
+    template <class T>
+    struct prime_hash : boost::hash<T> {};
+
+    template <class T>
+    struct power_of_two_hash : boost::hash<T> {};
+}
+
+namespace boost { namespace unordered {
+    template <class T>
+    struct bucket_policy<prime_hash<T> >
+    {
+        typedef prime_bucket_policy type;
+    };
+
+    template <class T>
+    struct bucket_policy<power_of_two_hash<T> >
+    {
+        typedef power_of_two_bucket_policy type;
+    };
+}}
+
+namespace
+{
+    boost::uint64_t next_random(boost::uint64_t& state)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    template <class Key>
+    Key make_key(boost::uint64_t r)
+    {
+        return static_cast<Key>(r);
+    }
+
+    template <>
+    std::string make_key<std::string>(boost::uint64_t r)
+    {
+        return "key-" + boost::lexical_cast<std::string>(r);
+    }
+
+    // Maps each key to the index of the next key to look up, following a
+    // single random cycle through all of them.
+    template <class Key, class Hash>
+    double lookup_ns(std::vector<Key> const& keys,
+            std::vector<std::size_t> const& order, std::size_t lookups)
+    {
+        std::size_t n = keys.size();
+        boost::unordered_map<Key, std::size_t, Hash> map;
+        for (std::size_t i = 0; i < n; ++i)
+            map[keys[order[i]]] = order[(i + 1) % n];
+
+        std::size_t index = order[0];
+        std::clock_t start = std::clock();
+        for (std::size_t i = 0; i < lookups; ++i)
+            index = map.find(keys[index])->second;
+        double ns = double(std::clock() - start) * 1e9 / CLOCKS_PER_SEC /
+            lookups;
+        if (index == n) std::printf("unreachable\n");
+        return ns;
+    }
+
+    template <class Key>
+    void run(char const* name, std::size_t n, std::size_t lookups)
+    {
+        boost::uint64_t state = 88172645463325252ULL;
+        std::vector<Key> keys;
+        keys.reserve(n);
+        // Dense integers are the best case for prime modulo, so use them
+        // for half the integer keys.
+        for (std::size_t i = 0; i < n; ++i)
+            keys.push_back(make_key<Key>(i % 2 ? next_random(state) : i));
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::vector<std::size_t> order(keys.size());
+        for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+        for (std::size_t i = order.size(); i > 1; --i)
+            std::swap(order[i - 1], order[next_random(state) % i]);
+
+        double prime = lookup_ns<Key, prime_hash<Key> >(keys, order, lookups);
+        double power = lookup_ns<Key, power_of_two_hash<Key> >(
+            keys, order, lookups);
+        std::printf("%-14s %10.1f %10.1f\n", name, prime, power);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? std::strtoul(argv[1], 0, 10) : 1000;
+    std::size_t lookups = 10000000;
+
+    std::printf("%lu elements, ns per dependent lookup\n",
+        static_cast<unsigned long>(n));
+    std::printf("%-14s %10s %10s\n", "", "prime", "pow2+mix");
+    run<int>("int", n, lookups);
+    run<boost::uint64_t>("uint64_t", n, lookups);
+    run<double>("double", n, lookups);
+    run<std::string>("std::string", n, lookups);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares unordered_flat_map with unordered_map: inserting random keys,
+// looking up keys that are present and keys that aren't, and erasing.
+//
+// usage: flat_map_benchmark [number of elements]
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/cstdint.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+namespace
+{
+    boost::uint64_t next_random(boost::uint64_t& state)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    double elapsed_ns(std::clock_t start, std::size_t n)
+    {
+        return double(std::clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+    }
+
+    template <class Map>
+    void run(char const* name, std::vector<boost::uint64_t> const& keys,
+            std::vector<boost::uint64_t> const& missing)
+    {
+        std::size_t n = keys.size();
+        boost::uint64_t sum = 0;
+        Map map;
+
+        std::clock_t start = std::clock();
+        for (std::size_t i = 0; i < n; ++i)
+            map.insert(std::make_pair(keys[i], boost::uint64_t(i)));
+        double insert = elapsed_ns(start, n);
+
+        start = std::clock();
+        for (std::size_t i = 0; i < n; ++i)
+            sum += map.find(keys[i])->second;
+        double hit = elapsed_ns(start, n);
+
+        start = std::clock();
+        for (std::size_t i = 0; i < n; ++i)
+            sum += map.count(missing[i]);
+        double miss = elapsed_ns(start, n);
+
+        start = std::clock();
+        for (std::size_t i = 0; i < n; ++i)
+            sum += map.erase(keys[i]);
+        double erase = elapsed_ns(start, n);
+
+        std::printf("%-20s %8.1f %8.1f %8.1f %8.1f   (%lu)\n", name,
+            insert, hit, miss, erase, static_cast<unsigned long>(sum % 10));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? std::strtoul(argv[1], 0, 10) : 1000000;
+
+    // Keys are odd and misses even, so they never collide.
+    boost::uint64_t state = 88172645463325252ULL;
+    std::vector<boost::uint64_t> keys(n), missing(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = next_random(state) | 1;
+        missing[i] = next_random(state) & ~boost::uint64_t(1);
+    }
+
+    std::printf("%lu elements, ns per operation\n",
+        static_cast<unsigned long>(n));
+    std::printf("%-20s %8s %8s %8s %8s\n", "", "insert", "hit", "miss",
+        "erase");
+    run<boost::unordered_map<boost::uint64_t, boost::uint64_t> >(
+        "unordered_map", keys, missing);
+    run<boost::unordered_flat_map<boost::uint64_t, boost::uint64_t> >(
+        "unordered_flat_map", keys, missing);
+    return 0;
+}
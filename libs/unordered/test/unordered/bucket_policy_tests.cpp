@@ -0,0 +1,115 @@
+// Copyright 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include "../helpers/postfix.hpp"
+
+#include "../helpers/test.hpp"
+#include <string>
+
+namespace bucket_policy_tests {
+
+template <class T>
+struct prime_hash : boost::hash<T> {};
+
+template <class T>
+struct power_of_two_hash : boost::hash<T> {};
+
+}
+
+namespace boost { namespace unordered {
+
+template <class T>
+struct bucket_policy<bucket_policy_tests::prime_hash<T> >
+{
+    typedef prime_bucket_policy type;
+};
+
+template <class T>
+struct bucket_policy<bucket_policy_tests::power_of_two_hash<T> >
+{
+    typedef power_of_two_bucket_policy type;
+};
+
+}}
+
+namespace bucket_policy_tests {
+
+bool is_prime(std::size_t n)
+{
+    if (n < 2) return false;
+    for (std::size_t i = 2; i * i <= n; ++i)
+        if (n % i == 0) return false;
+    return true;
+}
+
+bool is_power_of_two(std::size_t n)
+{
+    return n && !(n & (n - 1));
+}
+
+template <class X>
+void fill_and_check(X& x)
+{
+    for (int i = 0; i < 10000; ++i)
+        x.insert(typename X::value_type(i * 7, i));
+    for (int i = 0; i < 10000; i += 2)
+        x.erase(i * 7);
+    BOOST_TEST(x.size() == 5000);
+    for (int i = 0; i < 10000; ++i)
+        BOOST_TEST(x.count(i * 7) == static_cast<std::size_t>(i % 2));
+    BOOST_TEST(x.load_factor() <= x.max_load_factor());
+}
+
+UNORDERED_AUTO_TEST(prime_policy_test) {
+    boost::unordered_map<int, int, prime_hash<int> > x;
+    fill_and_check(x);
+    BOOST_TEST(is_prime(x.bucket_count()));
+    x.rehash(1000000);
+    BOOST_TEST(is_prime(x.bucket_count()));
+    BOOST_TEST(x.bucket_count() >= 1000000);
+
+    boost::unordered_multimap<int, int, prime_hash<int> > y;
+    fill_and_check(y);
+    BOOST_TEST(is_prime(y.bucket_count()));
+}
+
+UNORDERED_AUTO_TEST(power_of_two_policy_test) {
+    boost::unordered_map<int, int, power_of_two_hash<int> > x;
+    fill_and_check(x);
+    BOOST_TEST(is_power_of_two(x.bucket_count()));
+    x.rehash(1000000);
+    BOOST_TEST(is_power_of_two(x.bucket_count()));
+    BOOST_TEST(x.bucket_count() >= 1000000);
+
+    boost::unordered_multimap<int, int, power_of_two_hash<int> > y;
+    fill_and_check(y);
+    BOOST_TEST(is_power_of_two(y.bucket_count()));
+
+    // Sequential keys should be spread over the buckets by the mixing.
+    boost::unordered_set<std::size_t, power_of_two_hash<std::size_t> > z;
+    z.rehash(1024);
+    for (std::size_t i = 0; i < 1024; ++i) z.insert(i << 10);
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < z.bucket_count(); ++i)
+        if (z.bucket_size(i)) ++used;
+    BOOST_TEST(used > z.bucket_count() / 2);
+}
+
+UNORDERED_AUTO_TEST(default_policy_test) {
+    boost::unordered_map<std::string, int> x;
+    x["one"] = 1;
+    if (std::numeric_limits<std::size_t>::digits == 64) {
+        BOOST_TEST(is_power_of_two(x.bucket_count()));
+    }
+    else {
+        BOOST_TEST(is_prime(x.bucket_count()));
+    }
+}
+
+}
+
+RUN_TESTS()
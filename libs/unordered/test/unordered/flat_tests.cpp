@@ -0,0 +1,355 @@
+// Copyright 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/unordered_flat_set.hpp>
+#include "../helpers/postfix.hpp"
+
+#include "../helpers/test.hpp"
+#include "../objects/cxx11_allocator.hpp"
+#include <boost/lexical_cast.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace flat_tests {
+
+// Counts live instances, to check that every value is destroyed.
+struct counted
+{
+    static int instances;
+    int value;
+
+    counted(int v = 0) : value(v) { ++instances; }
+    counted(counted const& x) : value(x.value) { ++instances; }
+    ~counted() { --instances; }
+    counted& operator=(counted const& x) { value = x.value; return *this; }
+    bool operator==(counted const& x) const { return value == x.value; }
+};
+
+int counted::instances = 0;
+
+std::size_t hash_value(counted const& x) { return x.value; }
+
+// Sends every key to the same group, so that groups fill up and probing
+// and deleted markers get exercised.
+struct collide_hash
+{
+    std::size_t operator()(int) const { return 0; }
+};
+
+template <class X, class Reference>
+void compare(X const& x, Reference const& reference)
+{
+    BOOST_TEST(x.size() == reference.size());
+    std::size_t n = 0;
+    for (typename X::const_iterator it = x.begin(); it != x.end(); ++it)
+        ++n;
+    BOOST_TEST(n == reference.size());
+    for (typename Reference::const_iterator it = reference.begin();
+            it != reference.end(); ++it) {
+        typename X::const_iterator pos = x.find(it->first);
+        BOOST_TEST(pos != x.end() && pos->second == it->second);
+    }
+    BOOST_TEST(x.load_factor() <= x.max_load_factor());
+}
+
+UNORDERED_AUTO_TEST(flat_map_basic) {
+    boost::unordered_flat_map<std::string, int> x;
+    BOOST_TEST(x.empty());
+    BOOST_TEST(x.begin() == x.end());
+    BOOST_TEST(x.find("one") == x.end());
+    BOOST_TEST(x.count("one") == 0);
+    BOOST_TEST(x.erase("one") == 0);
+
+    x["one"] = 1;
+    BOOST_TEST(x.insert(std::make_pair(std::string("two"), 2)).second);
+    BOOST_TEST(!x.insert(std::make_pair(std::string("two"), 3)).second);
+    BOOST_TEST(x.emplace("three", 3).second);
+    BOOST_TEST(x.size() == 3);
+    BOOST_TEST(x.at("two") == 2);
+    BOOST_TEST(x["three"] == 3);
+    BOOST_TEST(x.count("one") == 1);
+
+    std::pair<boost::unordered_flat_map<std::string, int>::iterator,
+        boost::unordered_flat_map<std::string, int>::iterator> r =
+            x.equal_range("one");
+    BOOST_TEST(r.first != r.second && r.first->second == 1);
+    BOOST_TEST(++r.first == r.second);
+
+    try {
+        x.at("four");
+        BOOST_ERROR("Should have thrown.");
+    }
+    catch(std::out_of_range&) {
+    }
+
+    BOOST_TEST(x.erase("one") == 1);
+    BOOST_TEST(x.find("one") == x.end());
+    BOOST_TEST(x.size() == 2);
+
+    x.clear();
+    BOOST_TEST(x.empty());
+    BOOST_TEST(x.begin() == x.end());
+    BOOST_TEST(x.find("two") == x.end());
+}
+
+UNORDERED_AUTO_TEST(flat_map_random) {
+    boost::unordered_flat_map<int, int> x;
+    std::map<int, int> reference;
+
+    std::srand(4986);
+    for (int i = 0; i < 20000; ++i) {
+        int key = std::rand() % 2000;
+        switch (std::rand() % 3) {
+        case 0:
+            BOOST_TEST(x.insert(std::make_pair(key, i)).second ==
+                reference.insert(std::make_pair(key, i)).second);
+            break;
+        case 1:
+            x[key] = i;
+            reference[key] = i;
+            break;
+        case 2:
+            BOOST_TEST(x.erase(key) == reference.erase(key));
+            break;
+        }
+    }
+    compare(x, reference);
+
+    // Erase everything through iterators.
+    for (boost::unordered_flat_map<int, int>::iterator it = x.begin();
+            it != x.end();) {
+        BOOST_TEST(reference.erase(it->first) == 1);
+        it = x.erase(it);
+    }
+    BOOST_TEST(x.empty());
+    BOOST_TEST(reference.empty());
+}
+
+UNORDERED_AUTO_TEST(flat_map_collisions) {
+    boost::unordered_flat_map<int, int, collide_hash> x;
+    std::map<int, int> reference;
+
+    // Repeatedly fill and empty the table, which leaves deleted markers
+    // behind since all the keys share a probe sequence.
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            x.insert(std::make_pair(round * 50 + i, i));
+            reference.insert(std::make_pair(round * 50 + i, i));
+        }
+        for (int i = 0; i < 100; i += 2) {
+            BOOST_TEST(x.erase(round * 50 + i) ==
+                reference.erase(round * 50 + i));
+        }
+        compare(x, reference);
+    }
+}
+
+UNORDERED_AUTO_TEST(flat_map_churn) {
+    // Deleted markers are cleared out rather than growing the table when
+    // the size doesn't change.
+    boost::unordered_flat_map<int, int> x;
+    for (int i = 0; i < 100000; ++i) {
+        x[i] = i;
+        if (i >= 1000) BOOST_TEST(x.erase(i - 1000) == 1);
+    }
+    BOOST_TEST(x.size() == 1000);
+    BOOST_TEST(x.bucket_count() <= 2048);
+    for (int i = 99000; i < 100000; ++i) BOOST_TEST(x.at(i) == i);
+}
+
+UNORDERED_AUTO_TEST(flat_map_copy_move_swap) {
+    boost::unordered_flat_map<int, std::string> x;
+    for (int i = 0; i < 1000; ++i)
+        x[i] = boost::lexical_cast<std::string>(i);
+    for (int i = 0; i < 1000; i += 3)
+        x.erase(i);
+
+    boost::unordered_flat_map<int, std::string> y(x);
+    BOOST_TEST(x == y);
+    y[0] = "0";
+    BOOST_TEST(x != y);
+
+    boost::unordered_flat_map<int, std::string> z;
+    z = x;
+    BOOST_TEST(z == x);
+
+    z.swap(y);
+    BOOST_TEST(z.size() == x.size() + 1);
+    BOOST_TEST(y == x);
+
+    boost::unordered_flat_map<int, std::string> w(boost::move(z));
+    BOOST_TEST(w.size() == x.size() + 1);
+    BOOST_TEST(w.at(0) == "0");
+
+    boost::unordered_flat_map<int, std::string> v(x.begin(), x.end());
+    BOOST_TEST(v == x);
+}
+
+#if defined(BOOST_UNORDERED_USE_MOVE) || !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#define BOOST_UNORDERED_TEST_MOVING 1
+#else
+#define BOOST_UNORDERED_TEST_MOVING 0
+#endif
+
+// Allocators with different tags compare unequal.
+template <class Flags>
+struct tagged_map
+{
+    typedef test::cxx11_allocator<std::pair<int const, int>, Flags> allocator;
+    typedef boost::unordered_flat_map<int, int,
+        boost::hash<int>, std::equal_to<int>, allocator> type;
+
+    static void fill(type& x, int n)
+    {
+        for (int i = 0; i < n; ++i) x.emplace(i, i * 2);
+    }
+
+    static bool check(type const& x, int n, int tag)
+    {
+        if (x.size() != static_cast<std::size_t>(n)) return false;
+        for (int i = 0; i < n; ++i)
+            if (x.at(i) != i * 2) return false;
+        return x.get_allocator() == allocator(tag);
+    }
+};
+
+UNORDERED_AUTO_TEST(flat_map_allocator_propagation) {
+    {
+        // Without propagation the elements are moved one at a time into
+        // memory from the target's allocator.
+        typedef tagged_map<test::no_propagate_move> m;
+        m::type x(m::allocator(1)), y(m::allocator(2));
+        m::fill(x, 10);
+        m::fill(y, 100);
+        x = boost::move(y);
+        // Without move emulation this is a copy, which does propagate.
+        BOOST_TEST(m::check(x, 100, BOOST_UNORDERED_TEST_MOVING ? 1 : 2));
+    }
+
+    {
+        typedef tagged_map<test::propagate_move> m;
+        m::type x(m::allocator(1)), y(m::allocator(2));
+        m::fill(x, 10);
+        m::fill(y, 100);
+        x = boost::move(y);
+        BOOST_TEST(m::check(x, 100, BOOST_UNORDERED_TEST_MOVING ? 2 : 1));
+    }
+
+    {
+        typedef tagged_map<test::no_propagate_assign> m;
+        m::type x(m::allocator(1)), y(m::allocator(2));
+        m::fill(y, 100);
+        x = y;
+        BOOST_TEST(m::check(x, 100, 1));
+    }
+
+    {
+        typedef tagged_map<test::propagate_assign> m;
+        m::type x(m::allocator(1)), y(m::allocator(2));
+        m::fill(x, 10);
+        m::fill(y, 100);
+        x = y;
+        BOOST_TEST(m::check(x, 100, 2));
+    }
+
+    {
+        typedef tagged_map<test::propagate_swap> m;
+        m::type x(m::allocator(1)), y(m::allocator(2));
+        m::fill(x, 10);
+        m::fill(y, 100);
+        x.swap(y);
+        BOOST_TEST(m::check(x, 100, 2));
+        BOOST_TEST(m::check(y, 10, 1));
+    }
+
+    {
+        // Swapping without propagation requires equal allocators, which
+        // stay where they are.
+        typedef tagged_map<test::no_propagate_swap> m;
+        m::type x(m::allocator(1)), y(m::allocator(1));
+        m::fill(x, 10);
+        m::fill(y, 100);
+        x.swap(y);
+        BOOST_TEST(m::check(x, 100, 1));
+        BOOST_TEST(m::check(y, 10, 1));
+    }
+}
+
+UNORDERED_AUTO_TEST(flat_map_rehash) {
+    boost::unordered_flat_map<int, int> x;
+    x.reserve(1000);
+    std::size_t buckets = x.bucket_count();
+    BOOST_TEST(buckets >= 1000);
+    for (int i = 0; i < 1000; ++i) x[i] = i;
+    BOOST_TEST(x.bucket_count() == buckets);
+
+    x.rehash(10000);
+    BOOST_TEST(x.bucket_count() >= 10000);
+    x.rehash(0);
+    BOOST_TEST(x.bucket_count() < buckets * 2);
+    BOOST_TEST(x.size() == 1000);
+    for (int i = 0; i < 1000; ++i) BOOST_TEST(x.at(i) == i);
+
+    x.max_load_factor(0.5f);
+    BOOST_TEST(x.max_load_factor() == 0.5f);
+    BOOST_TEST(x.load_factor() <= 0.5f);
+    x.max_load_factor(2.0f);
+    BOOST_TEST(x.max_load_factor() <= 1.0f);
+
+    x.clear();
+    x.rehash(0);
+    BOOST_TEST(x.bucket_count() == 0);
+    x[1] = 1;
+    BOOST_TEST(x.at(1) == 1);
+}
+
+UNORDERED_AUTO_TEST(flat_map_instances) {
+    {
+        boost::unordered_flat_map<counted, counted> x;
+        for (int i = 0; i < 500; ++i) x[counted(i)] = counted(i);
+        for (int i = 0; i < 500; i += 2) x.erase(counted(i));
+        boost::unordered_flat_map<counted, counted> y(x);
+        BOOST_TEST(counted::instances == 1000);
+        x.clear();
+        BOOST_TEST(counted::instances == 500);
+    }
+    BOOST_TEST(counted::instances == 0);
+}
+
+UNORDERED_AUTO_TEST(flat_set_tests) {
+    boost::unordered_flat_set<int> x;
+    std::set<int> reference;
+
+    std::srand(83);
+    for (int i = 0; i < 5000; ++i) {
+        int key = std::rand() % 500;
+        if (std::rand() % 2) {
+            BOOST_TEST(x.insert(key).second == reference.insert(key).second);
+        }
+        else {
+            BOOST_TEST(x.erase(key) == reference.erase(key));
+        }
+    }
+
+    BOOST_TEST(x.size() == reference.size());
+    for (std::set<int>::const_iterator it = reference.begin();
+            it != reference.end(); ++it) {
+        BOOST_TEST(x.count(*it) == 1);
+    }
+
+    boost::unordered_flat_set<int> y(reference.begin(), reference.end());
+    BOOST_TEST(x == y);
+    y.emplace(-1);
+    BOOST_TEST(x != y);
+    BOOST_TEST(*y.find(-1) == -1);
+}
+
+}
+
+RUN_TESTS()
@@ -0,0 +1,197 @@
+// Copyright 2013 Daniel James.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/unordered_flat_set.hpp>
+#include "../helpers/postfix.hpp"
+
+#include "../helpers/test.hpp"
+#include <boost/functional/hash.hpp>
+#include <cstring>
+#include <string>
+
+namespace transparent_tests {
+
+// Counts the number of strings constructed, so that the tests can check
+// that lookup doesn't create a key_type.
+struct counted_string
+{
+    static int constructed;
+    std::string value;
+
+    counted_string(char const* x) : value(x) { ++constructed; }
+    counted_string(counted_string const& x) : value(x.value)
+        { ++constructed; }
+};
+
+int counted_string::constructed = 0;
+
+struct transparent_hash
+{
+    typedef void is_transparent;
+
+    std::size_t operator()(counted_string const& x) const
+    {
+        return boost::hash_range(x.value.begin(), x.value.end());
+    }
+
+    std::size_t operator()(char const* x) const
+    {
+        return boost::hash_range(x, x + std::strlen(x));
+    }
+};
+
+struct transparent_equal
+{
+    typedef void is_transparent;
+
+    bool operator()(counted_string const& x, counted_string const& y) const
+    {
+        return x.value == y.value;
+    }
+
+    bool operator()(char const* x, counted_string const& y) const
+    {
+        return y.value == x;
+    }
+};
+
+counted_string make_value(counted_string*, char const* x)
+{
+    return counted_string(x);
+}
+
+std::pair<counted_string const, int> make_value(
+        std::pair<counted_string const, int>*, char const* x)
+{
+    return std::pair<counted_string const, int>(x, 0);
+}
+
+template <class X>
+void insert(X& x, char const* k)
+{
+    x.insert(make_value(static_cast<typename X::value_type*>(0), k));
+}
+
+template <class X>
+void check_unique(X& x)
+{
+    insert(x, "one");
+    insert(x, "two");
+    insert(x, "three");
+
+    int constructed = counted_string::constructed;
+    X const& cx = x;
+
+    BOOST_TEST(x.find("two") != x.end());
+    BOOST_TEST(cx.find("two") != cx.end());
+    BOOST_TEST(x.find("four") == x.end());
+    BOOST_TEST(x.count("one") == 1);
+    BOOST_TEST(x.count("four") == 0);
+    BOOST_TEST(x.equal_range("three").first != x.end());
+    BOOST_TEST(cx.equal_range("four").first == cx.end());
+
+    std::size_t hash = x.hash_function()("one");
+    BOOST_TEST(x.find("one", hash) != x.end());
+    BOOST_TEST(cx.count("one", hash) == 1);
+    BOOST_TEST(x.equal_range("one", hash).first != x.end());
+
+    BOOST_TEST(counted_string::constructed == constructed);
+}
+
+UNORDERED_AUTO_TEST(transparent_unique) {
+    boost::unordered_map<counted_string, int,
+        transparent_hash, transparent_equal> map;
+    check_unique(map);
+
+    boost::unordered_set<counted_string,
+        transparent_hash, transparent_equal> set;
+    check_unique(set);
+
+    boost::unordered_flat_map<counted_string, int,
+        transparent_hash, transparent_equal> flat_map;
+    check_unique(flat_map);
+
+    boost::unordered_flat_set<counted_string,
+        transparent_hash, transparent_equal> flat_set;
+    check_unique(flat_set);
+}
+
+template <class X>
+void check_equivalent(X& x)
+{
+    insert(x, "one");
+    insert(x, "two");
+    insert(x, "two");
+
+    int constructed = counted_string::constructed;
+
+    BOOST_TEST(x.count("one") == 1);
+    BOOST_TEST(x.count("two") == 2);
+    BOOST_TEST(x.count("three") == 0);
+
+    std::size_t hash = x.hash_function()("two");
+    BOOST_TEST(x.count("two", hash) == 2);
+    BOOST_TEST(std::distance(x.equal_range("two", hash).first,
+        x.equal_range("two", hash).second) == 2);
+    BOOST_TEST(x.find("two", hash) == x.equal_range("two").first);
+
+    BOOST_TEST(counted_string::constructed == constructed);
+}
+
+UNORDERED_AUTO_TEST(transparent_equivalent) {
+    boost::unordered_multimap<counted_string, int,
+        transparent_hash, transparent_equal> map;
+    check_equivalent(map);
+
+    boost::unordered_multiset<counted_string,
+        transparent_hash, transparent_equal> set;
+    check_equivalent(set);
+}
+
+// The same hash value can be used for lookup in several containers, as
+// long as they use the same hash function.
+template <class X>
+void check_precomputed_hash()
+{
+    X x1, x2;
+    for (int i = 0; i < 100; ++i) {
+        x1.insert(typename X::value_type(i, i));
+        if (i % 2) x2.insert(typename X::value_type(i, -i));
+    }
+
+    boost::hash<int> hf;
+    for (int i = 0; i < 100; ++i) {
+        std::size_t hash = hf(i);
+        BOOST_TEST(x1.find(i, hash) == x1.find(i));
+        BOOST_TEST(x2.find(i, hash) == x2.find(i));
+        BOOST_TEST(x1.count(i, hash) == 1);
+        BOOST_TEST(x2.count(i, hash) == static_cast<std::size_t>(i % 2));
+        BOOST_TEST(x2.equal_range(i, hash) == x2.equal_range(i));
+    }
+}
+
+UNORDERED_AUTO_TEST(precomputed_hash) {
+    check_precomputed_hash<boost::unordered_map<int, int> >();
+    check_precomputed_hash<boost::unordered_multimap<int, int> >();
+    check_precomputed_hash<boost::unordered_flat_map<int, int> >();
+
+    boost::unordered_set<std::string> x;
+    x.insert("one");
+    std::string one("one");
+    std::size_t hash = x.hash_function()(one);
+    BOOST_TEST(*x.find(one, hash) == "one");
+    BOOST_TEST(x.count(one, hash) == 1);
+
+    // Without transparent function objects the key is still converted.
+    BOOST_TEST(x.find("one") != x.end());
+    BOOST_TEST(x.count("one", hash) == 1);
+}
+
+}
+
+RUN_TESTS()